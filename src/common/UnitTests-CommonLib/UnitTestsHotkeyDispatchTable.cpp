@@ -0,0 +1,135 @@
+#include "pch.h"
+
+#include <hotkey_dispatch_table.h>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsHotkeyDispatchTable
+{
+    // Hotkey lookup as done by the runner before the dispatch table, used as the baseline of the benchmark
+    struct HotkeyDescriptor
+    {
+        uint8_t modifiers = 0;
+        unsigned char key = 0;
+        std::wstring moduleName;
+        std::function<bool()> action;
+
+        bool operator<(const HotkeyDescriptor& other) const
+        {
+            return std::tie(modifiers, key) < std::tie(other.modifiers, other.key);
+        }
+    };
+
+    std::function<bool()> returnValue(int value, int& result)
+    {
+        return [value, &result] {
+            result = value;
+            return true;
+        };
+    }
+
+    TEST_CLASS (UnitTestsHotkeyDispatchTable)
+    {
+    public:
+        TEST_METHOD (findShouldReturnActionOfHotkey)
+        {
+            int result = 0;
+            HotkeyDispatchTable sut({ { .key = 'A', .modifiers = HotkeyDispatchTable::Win, .action = returnValue(1, result) },
+                                      { .key = 'A', .modifiers = HotkeyDispatchTable::Win | HotkeyDispatchTable::Shift, .action = returnValue(2, result) },
+                                      { .key = VK_SPACE, .modifiers = HotkeyDispatchTable::Alt, .action = returnValue(3, result) } });
+
+            Assert::AreEqual(size_t{ 3 }, sut.size());
+            Assert::IsTrue((*sut.find('A', HotkeyDispatchTable::Win))());
+            Assert::AreEqual(1, result);
+            Assert::IsTrue((*sut.find('A', HotkeyDispatchTable::Win | HotkeyDispatchTable::Shift))());
+            Assert::AreEqual(2, result);
+            Assert::IsTrue((*sut.find(VK_SPACE, HotkeyDispatchTable::Alt))());
+            Assert::AreEqual(3, result);
+        }
+        TEST_METHOD (findShouldReturnNullForUnregisteredHotkeys)
+        {
+            int result = 0;
+            HotkeyDispatchTable sut({ { .key = 'A', .modifiers = HotkeyDispatchTable::Win, .action = returnValue(1, result) } });
+
+            Assert::IsNull(sut.find('A', 0));
+            Assert::IsNull(sut.find('A', HotkeyDispatchTable::Ctrl));
+            Assert::IsNull(sut.find('A', HotkeyDispatchTable::Win | HotkeyDispatchTable::Alt));
+            Assert::IsNull(sut.find('B', HotkeyDispatchTable::Win));
+            Assert::IsNull(HotkeyDispatchTable().find('A', HotkeyDispatchTable::Win));
+        }
+        TEST_METHOD (findShouldReturnFirstActionForDuplicateHotkeys)
+        {
+            int result = 0;
+            HotkeyDispatchTable sut({ { .key = 'A', .modifiers = HotkeyDispatchTable::Ctrl, .action = returnValue(1, result) },
+                                      { .key = 'A', .modifiers = HotkeyDispatchTable::Ctrl, .action = returnValue(2, result) } });
+
+            Assert::AreEqual(size_t{ 1 }, sut.size());
+            Assert::IsTrue((*sut.find('A', HotkeyDispatchTable::Ctrl))());
+            Assert::AreEqual(1, result);
+        }
+        TEST_METHOD (modifierMaskShouldHaveBitForEachModifier)
+        {
+            Assert::AreEqual(0, static_cast<int>(HotkeyDispatchTable::modifier_mask(false, false, false, false)));
+            Assert::AreEqual(HotkeyDispatchTable::Win | HotkeyDispatchTable::Alt, static_cast<int>(HotkeyDispatchTable::modifier_mask(true, false, false, true)));
+            Assert::AreEqual(15, static_cast<int>(HotkeyDispatchTable::modifier_mask(true, true, true, true)));
+        }
+        // Benchmark which logs the cost of looking up every key down of a stream in the table and in a multiset under a mutex, as the hook did before
+        TEST_METHOD (findBenchmark)
+        {
+            int result = 0;
+            std::vector<HotkeyDispatchTable::Entry> entries;
+            std::multiset<HotkeyDescriptor> descriptors;
+            for (unsigned char key = 'A'; key <= 'Z'; key++)
+            {
+                const auto modifiers = static_cast<uint8_t>(HotkeyDispatchTable::Win | (key % 2 ? HotkeyDispatchTable::Shift : 0));
+                entries.push_back({ .key = key, .modifiers = modifiers, .action = returnValue(key, result) });
+                descriptors.insert({ .modifiers = modifiers, .key = key, .moduleName = L"Module", .action = returnValue(key, result) });
+            }
+            HotkeyDispatchTable table(std::move(entries));
+            std::mutex mutex;
+
+            // Mostly keys typed without modifiers, which match no hotkey
+            const int iterations = 1000000;
+            auto streamKey = [](int i) { return static_cast<unsigned char>(0x30 + i % 43); };
+            auto streamModifiers = [](int i) { return static_cast<uint8_t>(i % 16 == 0 ? HotkeyDispatchTable::Win : 0); };
+
+            size_t multisetHits = 0;
+            const auto multisetStart = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                std::function<bool()> action;
+                {
+                    std::unique_lock lock{ mutex };
+                    HotkeyDescriptor dummy{ .modifiers = streamModifiers(i), .key = streamKey(i) };
+                    auto it = descriptors.find(dummy);
+                    if (it != descriptors.end())
+                    {
+                        action = it->action;
+                    }
+                }
+                multisetHits += static_cast<bool>(action);
+            }
+            const auto multisetEnd = std::chrono::high_resolution_clock::now();
+
+            size_t tableHits = 0;
+            const auto tableStart = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                tableHits += table.find(streamKey(i), streamModifiers(i)) != nullptr;
+            }
+            const auto tableEnd = std::chrono::high_resolution_clock::now();
+
+            const double multisetNanoseconds = std::chrono::duration<double, std::nano>(multisetEnd - multisetStart).count() / iterations;
+            const double tableNanoseconds = std::chrono::duration<double, std::nano>(tableEnd - tableStart).count() / iterations;
+            Logger::WriteMessage((L"std::multiset under mutex: " + std::to_wstring(multisetNanoseconds) + L" ns\n").c_str());
+            Logger::WriteMessage((L"HotkeyDispatchTable::find: " + std::to_wstring(tableNanoseconds) + L" ns\n").c_str());
+            Assert::AreEqual(multisetHits, tableHits);
+            Assert::IsTrue(tableHits > 0);
+        }
+    };
+}
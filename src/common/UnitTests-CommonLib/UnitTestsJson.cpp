@@ -0,0 +1,282 @@
+#include "pch.h"
+
+#include <json.h>
+#include <winrt/Windows.Data.Json.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsJson
+{
+    // Lists the changes sorted by path, since the order of the members of an object isn't specified
+    std::wstring describe(std::vector<json::Change> changes)
+    {
+        std::sort(changes.begin(), changes.end(), [](const json::Change& lhs, const json::Change& rhs) { return lhs.path < rhs.path; });
+        std::wstring result;
+        for (const auto& change : changes)
+        {
+            result += change.path + L"=" + change.value.value_or(L"<removed>") + L";";
+        }
+        return result;
+    }
+
+    std::string to_utf8(const json::JsonValue& value)
+    {
+        std::string result;
+        json::stringify_utf8(value, [&](std::string_view chunk) { result += chunk; });
+        return result;
+    }
+
+    // Settings file of the size FancyZones writes for many monitors and layouts
+    std::string make_benchmark_document()
+    {
+        std::string result = R"({"devices":[)";
+        for (int i = 0; i < 500; i++)
+        {
+            result += (i ? "," : "");
+            result += R"({"device-id":"DELA026#5&10a58c63&0&UID16777488_1920_1200_{39B25DD2-130D-4B5D-8851-4791D66B1539})" + std::to_string(i) + R"(",)";
+            result += R"("active-zoneset":{"uuid":"{568EBC3A-C09C-483E-A64D-6F1F2AF4E48D}","type":"priority-grid"},)";
+            result += R"("editor-show-spacing":true,"editor-spacing":16,"editor-zone-count":)" + std::to_string(i % 8 + 1) + R"(,"editor-sensitivity-radius":20})";
+        }
+        result += R"(],"custom-zone-sets":[)";
+        for (int i = 0; i < 200; i++)
+        {
+            result += (i ? "," : "");
+            result += R"({"uuid":"{33A2B101-06E0-437B-A61E-CDBECF502906}","name":"Layout )" + std::to_string(i) + " \xC3\xA9\xC3\xA8" R"(","type":"grid","info":{)";
+            result += R"("rows":2,"columns":3,"rows-percentage":[5000,5000],"columns-percentage":[3333,3334,3333],"cell-child-map":[[0,1,2],[3,4,5]],)";
+            result += R"("show-spacing":true,"spacing":-10,"sensitivity-radius":0.25}})";
+        }
+        result += "]}";
+        return result;
+    }
+
+    TEST_CLASS (UnitTestsJson)
+    {
+    public:
+        TEST_METHOD (diffShouldBeEmptyForEqualObjects)
+        {
+            const auto config = json::JsonObject::Parse(LR"({"name":"Shortcut Guide","properties":{"press_time":{"value":900},"theme":{"value":"dark"}},"version":"1.0"})");
+            const auto sameConfig = json::JsonObject::Parse(LR"({"version":"1.0","properties":{"theme":{"value":"dark"},"press_time":{"value":900}},"name":"Shortcut Guide"})");
+
+            Assert::IsTrue(json::diff(config, sameConfig).empty());
+        }
+        TEST_METHOD (diffShouldReturnPathsOfChangedValues)
+        {
+            const auto oldConfig = json::JsonObject::Parse(LR"({"properties":{"press_time":{"value":900},"theme":{"value":"dark"},"overlay_opacity":{"value":90}}})");
+            const auto newConfig = json::JsonObject::Parse(LR"({"properties":{"press_time":{"value":600},"theme":{"value":"light"},"overlay_opacity":{"value":90}}})");
+
+            Assert::AreEqual(std::wstring{ LR"(/properties/press_time/value=600;/properties/theme/value="light";)" }, describe(json::diff(oldConfig, newConfig)));
+        }
+        TEST_METHOD (diffShouldReturnAddedAndRemovedValues)
+        {
+            const auto oldConfig = json::JsonObject::Parse(LR"({"properties":{"a/b":{"value":true},"removed":{"value":1}}})");
+            const auto newConfig = json::JsonObject::Parse(LR"({"properties":{"a/b":{"value":true},"added~":{"value":[1,2]}}})");
+
+            Assert::AreEqual(std::wstring{ LR"(/properties/added~0={"value":[1,2]};/properties/removed=<removed>;)" }, describe(json::diff(oldConfig, newConfig)));
+        }
+        TEST_METHOD (diffShouldCompareArraysAndChangedTypesAsAWhole)
+        {
+            const auto oldConfig = json::JsonObject::Parse(LR"({"zones":[1,2,3],"value":{"x":1},"flag":false})");
+            const auto newConfig = json::JsonObject::Parse(LR"({"zones":[1,2,4],"value":5,"flag":false})");
+
+            Assert::AreEqual(std::wstring{ LR"(/value=5;/zones=[1,2,4];)" }, describe(json::diff(oldConfig, newConfig)));
+        }
+
+        TEST_METHOD (parseShouldAcceptValidDocuments)
+        {
+            const wchar_t* documents[] = {
+                L"{}",
+                L"[]",
+                L" \t\r\n{ \"a\" : [ 1 , -2.5 , 3e2 , 4E-1 , 0 , -0 , true , false , null , \"\" ] } ",
+                L"\"\\u00e9\\\"\\\\\\/\\b\\f\\n\\r\\t\"",
+                L"123",
+                L"null",
+            };
+            for (const auto document : documents)
+            {
+                json::JsonValue value;
+                Assert::IsTrue(json::JsonValue::TryParse(document, value), document);
+            }
+        }
+        TEST_METHOD (parseShouldRejectInvalidDocuments)
+        {
+            const wchar_t* documents[] = {
+                L"",
+                L"{",
+                L"{\"a\":1,}",
+                L"[1,]",
+                L"{a:1}",
+                L"{'a':1}",
+                L"[01]",
+                L"[1.]",
+                L"[.5]",
+                L"[-]",
+                L"[1e]",
+                L"[1e999]",
+                L"[tru]",
+                L"[NaN]",
+                L"[\"a\nb\"]",
+                L"[\"\\x\"]",
+                L"[\"\\u12\"]",
+                L"[\"abc]",
+                L"[1] [2]",
+            };
+            for (const auto document : documents)
+            {
+                json::JsonValue value;
+                Assert::IsFalse(json::JsonValue::TryParse(document, value), document);
+                Assert::ExpectException<json::JsonError>([&] { json::JsonValue::Parse(document); });
+            }
+            Assert::ExpectException<json::JsonError>([] { json::JsonObject::Parse(L"[1]"); });
+        }
+        TEST_METHOD (parseShouldLimitNesting)
+        {
+            const std::wstring allowed = std::wstring(256, L'[') + std::wstring(256, L']');
+            const std::wstring tooDeep = std::wstring(257, L'[') + std::wstring(257, L']');
+
+            json::JsonValue value;
+            Assert::IsTrue(json::JsonValue::TryParse(allowed, value));
+            Assert::IsFalse(json::JsonValue::TryParse(tooDeep, value));
+        }
+        TEST_METHOD (parseShouldDecodeEscapesAndSurrogatePairs)
+        {
+            const auto value = json::JsonValue::Parse(LR"("a\"b\\c\/d\u00e9\ud83d\ude00\u0001")");
+
+            Assert::AreEqual(std::wstring{ L"a\"b\\c/d\u00e9\U0001F600\u0001" }, value.GetString());
+            Assert::AreEqual(std::wstring{ L"\"a\\\"b\\\\c/d\u00e9\U0001F600\\u0001\"" }, value.Stringify());
+        }
+        TEST_METHOD (parseShouldKeepTheLastOfDuplicateNames)
+        {
+            const auto object = json::JsonObject::Parse(LR"({"b":1,"a":2,"b":3})");
+
+            Assert::AreEqual(2u, object.Size());
+            Assert::AreEqual(3.0, object.GetNamedNumber(L"b"));
+            Assert::AreEqual(std::wstring{ LR"({"a":2,"b":3})" }, object.Stringify());
+        }
+        TEST_METHOD (stringifyShouldWriteNumbersInTheirShortestForm)
+        {
+            const auto array = json::JsonArray::Parse(L"[100,1e2,-3,0.1,2.5e-7,1e300,-0]");
+
+            Assert::AreEqual(std::wstring{ L"[100,100,-3,0.1,2.5e-07,1e+300,0]" }, array.Stringify());
+
+            json::JsonArray infinity;
+            infinity.Append(json::value(std::numeric_limits<double>::infinity()));
+            Assert::AreEqual(std::wstring{ L"[null]" }, infinity.Stringify());
+        }
+        TEST_METHOD (utf8ShouldRoundTripAndSkipByteOrderMark)
+        {
+            const std::string document = "\xEF\xBB\xBF{\"list\":[1,\"\\n\"],\"name\":\"caf\xC3\xA9 \xF0\x9F\x98\x80\"}";
+            const auto value = json::parse_utf8(document);
+
+            Assert::AreEqual(std::wstring{ L"caf\u00e9 \U0001F600" }, value.GetObjectW().GetNamedString(L"name"));
+            Assert::AreEqual(document.substr(3), to_utf8(value));
+        }
+        TEST_METHOD (utf8ShouldReplaceInvalidSequences)
+        {
+            const auto value = json::parse_utf8("[\"a\xFF\xC3" "b\"]");
+
+            Assert::AreEqual(std::wstring{ L"a\uFFFD\uFFFDb" }, value.GetArray().GetStringAt(0));
+            Assert::AreEqual(std::string{ "[\"a\xEF\xBF\xBD\xEF\xBF\xBD" "b\"]" }, to_utf8(value));
+        }
+        TEST_METHOD (objectsShouldShareMembersBetweenCopies)
+        {
+            auto config = json::JsonObject::Parse(LR"({"properties":{"theme":{"value":"dark"}}})");
+            auto properties = config.GetNamedObject(L"properties");
+            properties.GetNamedObject(L"theme").SetNamedValue(L"value", json::value(L"light"));
+            properties.SetNamedValue(L"press_time", json::value(900));
+
+            Assert::AreEqual(std::wstring{ LR"({"properties":{"press_time":900,"theme":{"value":"light"}}})" }, config.Stringify());
+            Assert::IsFalse(static_cast<bool>(json::JsonObject{ nullptr }));
+        }
+        TEST_METHOD (gettersShouldThrowForMissingNamesAndOtherTypes)
+        {
+            const auto object = json::JsonObject::Parse(LR"({"number":1,"text":"a"})");
+
+            Assert::ExpectException<json::JsonError>([&] { object.GetNamedString(L"missing"); });
+            Assert::ExpectException<json::JsonError>([&] { object.GetNamedString(L"number"); });
+            Assert::ExpectException<json::JsonError>([&] { object.GetNamedBoolean(L"text", false); });
+            Assert::AreEqual(std::wstring{ L"default" }, object.GetNamedString(L"missing", L"default"));
+            Assert::AreEqual(2.0, object.GetNamedNumber(L"missing", 2.0));
+        }
+        TEST_METHOD (fileShouldRoundTrip)
+        {
+            wchar_t tempPath[MAX_PATH];
+            Assert::IsTrue(GetTempPathW(MAX_PATH, tempPath) > 0);
+            const std::wstring fileName = std::wstring{ tempPath } + L"UnitTestsJson-" + std::to_wstring(GetCurrentProcessId()) + L".json";
+            const auto config = json::JsonObject::Parse(LR"({"name":"Image Resizer \u00e9","sizes":[{"width":854},{"width":1920}],"enabled":true})");
+
+            Assert::IsTrue(json::to_file(fileName, config));
+            const auto loaded = json::from_file(fileName);
+            Assert::IsTrue(json::to_file(fileName, json::JsonObject{}));
+            const auto empty = json::from_file(fileName);
+            DeleteFileW(fileName.c_str());
+
+            Assert::IsTrue(loaded.has_value());
+            Assert::AreEqual(config.Stringify(), loaded->Stringify());
+            Assert::IsTrue(empty.has_value() && empty->Size() == 0);
+            Assert::IsFalse(json::from_file(fileName).has_value());
+        }
+        TEST_METHOD (toFileShouldReplaceFileOpenedByReader)
+        {
+            wchar_t tempPath[MAX_PATH];
+            Assert::IsTrue(GetTempPathW(MAX_PATH, tempPath) > 0);
+            const std::wstring fileName = std::wstring{ tempPath } + L"UnitTestsJson-reader-" + std::to_wstring(GetCurrentProcessId()) + L".json";
+            Assert::IsTrue(json::to_file(fileName, json::JsonObject::Parse(LR"({"version":1})")));
+
+            // A reader which shares access like from_file doesn't keep the file from being replaced
+            const HANDLE reader = CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            Assert::IsTrue(reader != INVALID_HANDLE_VALUE);
+            const bool saved = json::to_file(fileName, json::JsonObject::Parse(LR"({"version":2})"));
+            CloseHandle(reader);
+            const auto loaded = json::from_file(fileName);
+            DeleteFileW(fileName.c_str());
+
+            Assert::IsTrue(saved);
+            Assert::IsTrue(loaded.has_value());
+            Assert::AreEqual(2.0, loaded->GetNamedNumber(L"version"));
+        }
+        TEST_METHOD (toFileShouldFailForMissingDirectory)
+        {
+            wchar_t tempPath[MAX_PATH];
+            Assert::IsTrue(GetTempPathW(MAX_PATH, tempPath) > 0);
+            const std::wstring fileName = std::wstring{ tempPath } + L"UnitTestsJson-missing-" + std::to_wstring(GetCurrentProcessId()) + L"\\settings.json";
+            Assert::IsFalse(json::to_file(fileName, json::JsonObject{}));
+        }
+        TEST_METHOD (parseAndStringifyBenchmark)
+        {
+            // Same steps as the file functions took before: UTF-8 to UTF-16, parsing, and back to UTF-8
+            const std::string document = make_benchmark_document();
+            const int iterations = 20;
+
+            std::string winrtOutput;
+            const auto winrtStart = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                const auto object = winrt::Windows::Data::Json::JsonValue::Parse(winrt::to_hstring(document)).GetObjectW();
+                winrtOutput = winrt::to_string(object.Stringify());
+            }
+            const auto winrtEnd = std::chrono::high_resolution_clock::now();
+
+            std::string output;
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                const auto object = json::parse_utf8(document).GetObjectW();
+                output = to_utf8(object);
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const double winrtMilliseconds = std::chrono::duration<double, std::milli>(winrtEnd - winrtStart).count() / iterations;
+            const double milliseconds = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+            Logger::WriteMessage((L"Document size: " + std::to_wstring(document.size() / 1024) + L" KB\n").c_str());
+            Logger::WriteMessage((L"Windows.Data.Json: " + std::to_wstring(winrtMilliseconds) + L" ms\n").c_str());
+            Logger::WriteMessage((L"json::parse_utf8 and json::stringify_utf8: " + std::to_wstring(milliseconds) + L" ms\n").c_str());
+
+            // Both produce the same document, apart from the order of the members
+            Assert::IsTrue(json::diff(json::parse_utf8(winrtOutput).GetObjectW(), json::parse_utf8(output).GetObjectW()).empty());
+        }
+    };
+}
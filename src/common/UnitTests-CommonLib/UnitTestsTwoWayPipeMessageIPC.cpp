@@ -0,0 +1,180 @@
+#include "pch.h"
+
+#include <two_way_pipe_message_ipc.h>
+#include <ipc_framing.h>
+#include <ipc_transport.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsTwoWayPipeMessageIPC
+{
+    std::mutex receivedMutex;
+    std::condition_variable receivedChanged;
+    std::vector<std::wstring> received;
+    std::vector<std::chrono::high_resolution_clock::time_point> receivedTimes;
+
+    void receive(const std::wstring& message)
+    {
+        {
+            std::unique_lock lock{ receivedMutex };
+            received.push_back(message);
+            receivedTimes.push_back(std::chrono::high_resolution_clock::now());
+        }
+        receivedChanged.notify_all();
+    }
+
+    bool waitForMessages(size_t count)
+    {
+        std::unique_lock lock{ receivedMutex };
+        return receivedChanged.wait_for(lock, std::chrono::seconds(30), [count] { return received.size() >= count; });
+    }
+
+    std::vector<uint8_t> frame(const std::wstring& message)
+    {
+        const ipc_framing::frame_header header = ipc_framing::make_header(message);
+        std::vector<uint8_t> result(sizeof(header) + header);
+        memcpy(result.data(), &header, sizeof(header));
+        memcpy(result.data() + sizeof(header), message.data(), header);
+        return result;
+    }
+
+    // Settings payload of about the size sent for a long list of remaps
+    std::wstring largeMessage(size_t size, wchar_t first)
+    {
+        std::wstring result(size, L'x');
+        for (size_t i = 0; i < size; i++)
+        {
+            result[i] = static_cast<wchar_t>(first + i % 26);
+        }
+        return result;
+    }
+
+    TEST_CLASS (UnitTestsTwoWayPipeMessageIPC)
+    {
+    public:
+        TEST_METHOD_INITIALIZE(Init)
+        {
+            std::unique_lock lock{ receivedMutex };
+            received.clear();
+            receivedTimes.clear();
+        }
+        TEST_METHOD (decoderShouldReturnMessagesReceivedInChunksOfAnySize)
+        {
+            const std::vector<std::wstring> messages = { L"{\"name\":\"FancyZones\"}", L"", largeMessage(3000, L'a') };
+            std::vector<uint8_t> stream;
+            for (const auto& message : messages)
+            {
+                const auto bytes = frame(message);
+                stream.insert(stream.end(), bytes.begin(), bytes.end());
+            }
+
+            for (size_t chunkSize = 1; chunkSize <= stream.size(); chunkSize += chunkSize < 16 ? 1 : 997)
+            {
+                ipc_framing::FrameDecoder sut;
+                std::vector<std::wstring> decoded;
+                for (size_t offset = 0; offset < stream.size(); offset += chunkSize)
+                {
+                    Assert::IsTrue(sut.append(stream.data() + offset, (std::min)(chunkSize, stream.size() - offset)));
+                    while (auto message = sut.next())
+                    {
+                        decoded.push_back(std::move(*message));
+                    }
+                }
+                Assert::IsTrue(messages == decoded);
+            }
+        }
+        TEST_METHOD (decoderShouldRejectInvalidFrames)
+        {
+            const ipc_framing::frame_header oddSize = 3;
+            ipc_framing::FrameDecoder oddSizeDecoder;
+            Assert::IsFalse(oddSizeDecoder.append(reinterpret_cast<const uint8_t*>(&oddSize), sizeof(oddSize)));
+
+            const ipc_framing::frame_header tooLarge = static_cast<ipc_framing::frame_header>(ipc_framing::MAX_MESSAGE_SIZE + 2);
+            ipc_framing::FrameDecoder tooLargeDecoder;
+            Assert::IsFalse(tooLargeDecoder.append(reinterpret_cast<const uint8_t*>(&tooLarge), sizeof(tooLarge)));
+            Assert::IsFalse(tooLargeDecoder.next().has_value());
+        }
+        TEST_METHOD (loopbackShouldDeliverMessagesInOrder)
+        {
+            auto [first, second] = make_loopback_transports(1024);
+            TwoWayPipeMessageIPC sender(std::move(first), nullptr);
+            TwoWayPipeMessageIPC receiver(std::move(second), receive);
+            sender.start(nullptr);
+            receiver.start(nullptr);
+
+            std::vector<std::wstring> messages;
+            for (int i = 0; i < 100; i++)
+            {
+                messages.push_back(i % 10 == 0 ? largeMessage(100000, L'A') : std::to_wstring(i));
+                sender.send(messages.back());
+            }
+            sender.send(L"");
+            messages.push_back(L"");
+
+            Assert::IsTrue(waitForMessages(messages.size()));
+            sender.end();
+            receiver.end();
+            Assert::IsTrue(messages == received);
+        }
+        TEST_METHOD (namedPipesShouldDeliverMessagesLargerThanPipeBuffer)
+        {
+            const std::wstring pipeName = L"\\\\.\\pipe\\powertoys_unit_tests_" + std::to_wstring(GetCurrentProcessId());
+            TwoWayPipeMessageIPC receiver(pipeName + L"_receiver", pipeName + L"_sender", receive);
+            TwoWayPipeMessageIPC sender(pipeName + L"_sender", pipeName + L"_receiver", nullptr);
+            receiver.start(nullptr);
+            sender.start(nullptr);
+
+            const std::vector<std::wstring> messages = { largeMessage(200000, L'a'), L"", L"{}", largeMessage(1000, L'A') };
+            for (const auto& message : messages)
+            {
+                sender.send(message);
+            }
+
+            Assert::IsTrue(waitForMessages(messages.size()));
+            sender.end();
+            receiver.end();
+            Assert::IsTrue(messages == received);
+        }
+        // Measures the throughput and latency of large settings payloads through the framing and dispatch, without the pipes
+        TEST_METHOD (loopbackBenchmark)
+        {
+            auto [first, second] = make_loopback_transports();
+            TwoWayPipeMessageIPC sender(std::move(first), nullptr);
+            TwoWayPipeMessageIPC receiver(std::move(second), receive);
+            sender.start(nullptr);
+            receiver.start(nullptr);
+
+            const size_t count = 200;
+            const std::wstring payload = largeMessage(128 * 1024, L'a');
+            std::vector<std::chrono::high_resolution_clock::time_point> sendTimes;
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < count; i++)
+            {
+                sendTimes.push_back(std::chrono::high_resolution_clock::now());
+                sender.send(payload);
+            }
+
+            Assert::IsTrue(waitForMessages(count));
+            const auto end = std::chrono::high_resolution_clock::now();
+            sender.end();
+            receiver.end();
+
+            double totalLatency = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                Assert::IsTrue(received[i] == payload);
+                totalLatency += std::chrono::duration<double, std::micro>(receivedTimes[i] - sendTimes[i]).count();
+            }
+
+            const double seconds = std::chrono::duration<double>(end - start).count();
+            const double megabytes = static_cast<double>(count * payload.size() * sizeof(wchar_t)) / (1024 * 1024);
+            Logger::WriteMessage((L"Throughput: " + std::to_wstring(megabytes / seconds) + L" MB/s\n").c_str());
+            Logger::WriteMessage((L"Average latency: " + std::to_wstring(totalLatency / count) + L" us\n").c_str());
+        }
+    };
+}
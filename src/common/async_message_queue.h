@@ -3,6 +3,7 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <optional>
 #include <string>
 
 class AsyncMessageQueue
@@ -24,11 +25,12 @@ public:
     void queue_message(std::wstring message)
     {
         this->queue_mutex.lock();
-        this->message_queue.push(message);
+        this->message_queue.push(std::move(message));
         this->queue_mutex.unlock();
         this->message_ready.notify_one();
     }
-    std::wstring pop_message()
+    // Returns nothing if the queue was interrupted, so empty messages can be queued as well.
+    std::optional<std::wstring> pop_message()
     {
         std::unique_lock<std::mutex> lock(this->queue_mutex);
         while (message_queue.empty() && !this->interrupted)
@@ -37,10 +39,9 @@ public:
         }
         if (this->interrupted)
         {
-            //Just returns a empty string if the queue was interrupted.
-            return std::wstring(L"");
+            return std::nullopt;
         }
-        std::wstring message = this->message_queue.front();
+        std::wstring message = std::move(this->message_queue.front());
         this->message_queue.pop();
         return message;
     }
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Table of hotkey actions indexed by virtual key and modifier mask.
+// The table is immutable once built, so a keyboard hook can look up actions without locking or allocating while a new table is built for the next change.
+class HotkeyDispatchTable
+{
+public:
+    enum Modifier : uint8_t
+    {
+        Win = 1,
+        Ctrl = 2,
+        Shift = 4,
+        Alt = 8,
+    };
+
+    static constexpr size_t ModifierMaskCount = 16;
+    static constexpr size_t KeyCount = 256;
+
+    struct Entry
+    {
+        unsigned char key = 0;
+        uint8_t modifiers = 0;
+        std::function<bool()> action;
+    };
+
+    static constexpr uint8_t modifier_mask(bool win, bool ctrl, bool shift, bool alt) noexcept
+    {
+        return (win ? Win : 0) | (ctrl ? Ctrl : 0) | (shift ? Shift : 0) | (alt ? Alt : 0);
+    }
+
+    HotkeyDispatchTable() = default;
+
+    // If several entries have the same key and modifiers, the first one is used.
+    explicit HotkeyDispatchTable(std::vector<Entry> entries)
+    {
+        actions.reserve(entries.size());
+        for (auto& entry : entries)
+        {
+            auto& slot = slots[entry.key][entry.modifiers & (ModifierMaskCount - 1)];
+            if (slot == 0 && actions.size() < UINT16_MAX)
+            {
+                actions.push_back(std::move(entry.action));
+                slot = static_cast<uint16_t>(actions.size());
+            }
+        }
+    }
+
+    // Returns the action for the hotkey or nullptr if there is none. The pointer is valid as long as the table is.
+    const std::function<bool()>* find(unsigned char key, uint8_t modifiers) const noexcept
+    {
+        const uint16_t slot = slots[key][modifiers & (ModifierMaskCount - 1)];
+        return slot ? &actions[slot - 1] : nullptr;
+    }
+
+    size_t size() const noexcept
+    {
+        return actions.size();
+    }
+
+private:
+    // Index + 1 of the action of each hotkey, 0 if the hotkey has no action.
+    std::array<std::array<uint16_t, ModifierMaskCount>, KeyCount> slots{};
+    std::vector<std::function<bool()>> actions;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <optional>
+#include <string>
+
+// Messages are sent over the IPC transports as frames made of the size of the message in bytes,
+// followed by the UTF-16 message without a terminating null.
+namespace ipc_framing
+{
+    using frame_header = uint32_t;
+
+    // Larger messages are not sent, and a frame announcing one is treated as corrupt.
+    constexpr size_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+    inline frame_header make_header(const std::wstring& message)
+    {
+        return static_cast<frame_header>(message.size() * sizeof(wchar_t));
+    }
+
+    // Reassembles the messages from frames received in chunks of any size.
+    // The payload is copied once, straight into the message which is then moved out.
+    class FrameDecoder
+    {
+    public:
+        // Returns false if the data contains an invalid frame, after which nothing else should be read from the connection.
+        bool append(const uint8_t* data, size_t size)
+        {
+            while (size > 0 && valid)
+            {
+                size_t count;
+                if (header_received < sizeof(frame_header))
+                {
+                    count = (std::min)(size, sizeof(frame_header) - header_received);
+                    std::memcpy(header_bytes + header_received, data, count);
+                    header_received += count;
+                    if (header_received == sizeof(frame_header))
+                    {
+                        start_message();
+                    }
+                }
+                else
+                {
+                    count = (std::min)(size, message_size - message_received);
+                    std::memcpy(reinterpret_cast<uint8_t*>(message.data()) + message_received, data, count);
+                    message_received += count;
+                    if (message_received == message_size)
+                    {
+                        finish_message();
+                    }
+                }
+
+                data += count;
+                size -= count;
+            }
+
+            return valid;
+        }
+
+        // Returns the next message which was completely received, if any.
+        std::optional<std::wstring> next()
+        {
+            if (ready.empty())
+            {
+                return std::nullopt;
+            }
+
+            std::optional<std::wstring> result{ std::move(ready.front()) };
+            ready.pop_front();
+            return result;
+        }
+
+    private:
+        uint8_t header_bytes[sizeof(frame_header)] = {};
+        size_t header_received = 0;
+        std::wstring message;
+        size_t message_size = 0;
+        size_t message_received = 0;
+        std::deque<std::wstring> ready;
+        bool valid = true;
+
+        void start_message()
+        {
+            frame_header header;
+            std::memcpy(&header, header_bytes, sizeof(header));
+            if (header > MAX_MESSAGE_SIZE || header % sizeof(wchar_t) != 0)
+            {
+                valid = false;
+                return;
+            }
+
+            message_size = header;
+            message_received = 0;
+            message.resize(message_size / sizeof(wchar_t));
+            if (message_size == 0)
+            {
+                finish_message();
+            }
+        }
+
+        void finish_message()
+        {
+            ready.push_back(std::move(message));
+            message = std::wstring{};
+            header_received = 0;
+        }
+    };
+}
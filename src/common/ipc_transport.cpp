@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "ipc_transport.h"
+#include "ipc_framing.h"
+
+#include <deque>
+
+namespace
+{
+    // Messages sent in one direction of a loopback
+    struct LoopbackChannel
+    {
+        std::mutex mutex;
+        std::condition_variable message_ready;
+        std::deque<std::wstring> messages;
+        bool stopped = false;
+    };
+
+    class LoopbackTransport : public IpcTransport
+    {
+    public:
+        LoopbackTransport(std::shared_ptr<LoopbackChannel> _input, std::shared_ptr<LoopbackChannel> _output, size_t _read_size) :
+            input(std::move(_input)), output(std::move(_output)), read_size(_read_size)
+        {
+        }
+
+        ~LoopbackTransport()
+        {
+            stop();
+        }
+
+        void start(HANDLE, message_callback on_message) override
+        {
+            receive_thread = std::thread(&LoopbackTransport::receive, this, std::move(on_message));
+        }
+
+        void send(std::wstring message) override
+        {
+            if (message.size() * sizeof(wchar_t) > ipc_framing::MAX_MESSAGE_SIZE)
+            {
+                return;
+            }
+
+            {
+                std::unique_lock lock{ output->mutex };
+                output->messages.push_back(std::move(message));
+            }
+            output->message_ready.notify_one();
+        }
+
+        void stop() override
+        {
+            if (!receive_thread.joinable())
+            {
+                return;
+            }
+
+            {
+                std::unique_lock lock{ input->mutex };
+                input->stopped = true;
+            }
+            input->message_ready.notify_all();
+            receive_thread.join();
+        }
+
+    private:
+        std::shared_ptr<LoopbackChannel> input;
+        std::shared_ptr<LoopbackChannel> output;
+        size_t read_size;
+        std::thread receive_thread;
+
+        void receive(message_callback on_message)
+        {
+            ipc_framing::FrameDecoder decoder;
+            while (true)
+            {
+                std::wstring message;
+                {
+                    std::unique_lock lock{ input->mutex };
+                    input->message_ready.wait(lock, [this] { return input->stopped || !input->messages.empty(); });
+                    if (input->stopped)
+                    {
+                        return;
+                    }
+
+                    message = std::move(input->messages.front());
+                    input->messages.pop_front();
+                }
+
+                const ipc_framing::frame_header header = ipc_framing::make_header(message);
+                decoder.append(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+                const uint8_t* payload = reinterpret_cast<const uint8_t*>(message.data());
+                for (size_t offset = 0; offset < header; offset += read_size)
+                {
+                    decoder.append(payload + offset, (std::min)(read_size, header - offset));
+                }
+
+                while (auto received = decoder.next())
+                {
+                    on_message(std::move(*received));
+                }
+            }
+        }
+    };
+}
+
+std::pair<std::unique_ptr<IpcTransport>, std::unique_ptr<IpcTransport>> make_loopback_transports(size_t read_size)
+{
+    auto first_to_second = std::make_shared<LoopbackChannel>();
+    auto second_to_first = std::make_shared<LoopbackChannel>();
+    return { std::make_unique<LoopbackTransport>(second_to_first, first_to_second, read_size),
+             std::make_unique<LoopbackTransport>(first_to_second, second_to_first, read_size) };
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <Windows.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+// Carries whole messages between the two ends of a TwoWayPipeMessageIPC.
+class IpcTransport
+{
+public:
+    using message_callback = std::function<void(std::wstring message)>;
+
+    virtual ~IpcTransport() = default;
+
+    // Starts receiving messages. on_message is called on the transport's own thread, so it shouldn't block.
+    // If restricted_token isn't NULL, processes running with it are allowed to connect.
+    virtual void start(HANDLE restricted_token, message_callback on_message) = 0;
+
+    // Queues the message to be sent to the other end. Can be called from any thread.
+    virtual void send(std::wstring message) = 0;
+
+    // Stops receiving messages and drops the ones which weren't sent yet.
+    virtual void stop() = 0;
+};
+
+// Creates two connected in-process transports, which receive the messages sent by each other.
+// Messages go through the same framing as on the named pipes and are received in reads of read_size bytes,
+// so TwoWayPipeMessageIPC can be tested and benchmarked without creating pipes.
+std::pair<std::unique_ptr<IpcTransport>, std::unique_ptr<IpcTransport>> make_loopback_transports(size_t read_size = 64 * 1024);
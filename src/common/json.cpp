@@ -1,32 +1,1377 @@
 #include "pch.h"
 #include "json.h"
 
-#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string>
 
 namespace json
 {
-    std::optional<JsonObject> from_file(std::wstring_view file_name)
+    // Gives the parser and the serializer access to the representation of values
+    struct ValueAccess
     {
-        try
+        using Variant = decltype(JsonValue::m_value);
+
+        static inline const Variant& get(const JsonValue& value) noexcept
+        {
+            return value.m_value;
+        }
+
+        template<typename T>
+        static inline JsonValue make(T&& content)
+        {
+            JsonValue result;
+            result.m_value = std::forward<T>(content);
+            return result;
+        }
+    };
+}
+
+namespace
+{
+    using json::JsonError;
+    using json::JsonValue;
+    using json::ValueAccess;
+
+    // Nesting deeper than this is treated as malformed JSON, so that the recursive parser can't run out of stack
+    constexpr size_t MAX_DEPTH = 256;
+
+    constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+    inline bool is_digit(char32_t ch) noexcept
+    {
+        return ch >= '0' && ch <= '9';
+    }
+
+    inline int hex_value(char32_t ch) noexcept
+    {
+        if (ch >= '0' && ch <= '9')
+        {
+            return static_cast<int>(ch - '0');
+        }
+        if (ch >= 'a' && ch <= 'f')
+        {
+            return static_cast<int>(ch - 'a' + 10);
+        }
+        if (ch >= 'A' && ch <= 'F')
+        {
+            return static_cast<int>(ch - 'A' + 10);
+        }
+        return -1;
+    }
+
+    inline bool is_high_surrogate(char32_t ch) noexcept
+    {
+        return ch >= 0xD800 && ch <= 0xDBFF;
+    }
+
+    inline bool is_low_surrogate(char32_t ch) noexcept
+    {
+        return ch >= 0xDC00 && ch <= 0xDFFF;
+    }
+
+    void append_code_point(std::wstring& value, char32_t code_point)
+    {
+        if constexpr (sizeof(wchar_t) == 2)
+        {
+            if (code_point >= 0x10000)
+            {
+                code_point -= 0x10000;
+                value.push_back(static_cast<wchar_t>(0xD800 + (code_point >> 10)));
+                value.push_back(static_cast<wchar_t>(0xDC00 + (code_point & 0x3FF)));
+                return;
+            }
+        }
+        value.push_back(static_cast<wchar_t>(code_point));
+    }
+
+    // \u escapes are UTF-16 code units. Surrogate pairs are combined where wchar_t holds whole code points,
+    // and passed through as they are otherwise.
+    void append_code_unit(std::wstring& value, char32_t code_unit)
+    {
+        if constexpr (sizeof(wchar_t) == 4)
+        {
+            if (is_low_surrogate(code_unit) && !value.empty() && is_high_surrogate(static_cast<char32_t>(value.back())))
+            {
+                value.back() = static_cast<wchar_t>(0x10000 + ((static_cast<char32_t>(value.back()) - 0xD800) << 10) + (code_unit - 0xDC00));
+                return;
+            }
+        }
+        value.push_back(static_cast<wchar_t>(code_unit));
+    }
+
+    // Decodes one UTF-8 sequence starting at position. Invalid sequences decode to the replacement character,
+    // the same way MultiByteToWideChar treats them.
+    char32_t decode_utf8(std::string_view text, size_t& position) noexcept
+    {
+        const auto lead = static_cast<uint8_t>(text[position++]);
+        size_t length = 0;
+        char32_t code_point = 0;
+        if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            length = 3;
+            code_point = lead & 0x07;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            length = 2;
+            code_point = lead & 0x0F;
+        }
+        else if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            length = 1;
+            code_point = lead & 0x1F;
+        }
+        else
+        {
+            return REPLACEMENT_CHARACTER;
+        }
+
+        for (size_t i = 0; i < length; i++)
+        {
+            if (position >= text.size() || (static_cast<uint8_t>(text[position]) & 0xC0) != 0x80)
+            {
+                return REPLACEMENT_CHARACTER;
+            }
+            code_point = (code_point << 6) | (static_cast<uint8_t>(text[position++]) & 0x3F);
+        }
+
+        const bool overlong = (length == 2 && code_point < 0x800) || (length == 3 && code_point < 0x10000);
+        if (overlong || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF))
+        {
+            return REPLACEMENT_CHARACTER;
+        }
+
+        return code_point;
+    }
+
+    // Recursive descent parser over UTF-8 (char) or UTF-16 (wchar_t) text, building the document model directly
+    template<typename Char>
+    class Parser
+    {
+    public:
+        explicit Parser(std::basic_string_view<Char> text) noexcept :
+            m_text(text)
+        {
+        }
+
+        JsonValue parse_document()
+        {
+            if constexpr (std::is_same_v<Char, char>)
+            {
+                if (m_text.substr(0, 3) == "\xEF\xBB\xBF")
+                {
+                    m_position = 3;
+                }
+            }
+            else
+            {
+                if (!m_text.empty() && m_text[0] == 0xFEFF)
+                {
+                    m_position = 1;
+                }
+            }
+
+            JsonValue result = parse_value(0);
+            skip_whitespace();
+            if (m_position != m_text.size())
+            {
+                fail("unexpected text after the value");
+            }
+            return result;
+        }
+
+    private:
+        [[noreturn]] void fail(const char* message) const
+        {
+            throw JsonError("Invalid JSON at offset " + std::to_string(m_position) + ": " + message);
+        }
+
+        inline char32_t peek() const noexcept
+        {
+            return m_position < m_text.size() ? static_cast<char32_t>(static_cast<std::make_unsigned_t<Char>>(m_text[m_position])) : 0;
+        }
+
+        void skip_whitespace() noexcept
+        {
+            while (m_position < m_text.size())
+            {
+                const Char ch = m_text[m_position];
+                if (ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r')
+                {
+                    break;
+                }
+                m_position++;
+            }
+        }
+
+        void expect(char ch)
+        {
+            skip_whitespace();
+            if (peek() != static_cast<char32_t>(ch))
+            {
+                fail("unexpected character");
+            }
+            m_position++;
+        }
+
+        JsonValue parse_value(size_t depth)
+        {
+            skip_whitespace();
+            switch (peek())
+            {
+            case '{':
+                return parse_object(depth + 1);
+            case '[':
+                return parse_array(depth + 1);
+            case '"':
+            {
+                std::wstring value;
+                parse_string(value);
+                return ValueAccess::make(std::move(value));
+            }
+            case 't':
+                parse_literal("true");
+                return JsonValue::CreateBooleanValue(true);
+            case 'f':
+                parse_literal("false");
+                return JsonValue::CreateBooleanValue(false);
+            case 'n':
+                parse_literal("null");
+                return JsonValue::CreateNullValue();
+            default:
+                if (peek() == '-' || is_digit(peek()))
+                {
+                    return JsonValue::CreateNumberValue(parse_number());
+                }
+                fail(m_position < m_text.size() ? "unexpected character" : "unexpected end of text");
+            }
+        }
+
+        JsonValue parse_object(size_t depth)
+        {
+            if (depth > MAX_DEPTH)
+            {
+                fail("nesting is too deep");
+            }
+
+            auto data = std::make_shared<json::details::ObjectData>();
+            m_position++;
+            skip_whitespace();
+            if (peek() == '}')
+            {
+                m_position++;
+                return ValueAccess::make(std::move(data));
+            }
+
+            auto& members = data->members;
+            bool sorted = true;
+            for (;;)
+            {
+                skip_whitespace();
+                if (peek() != '"')
+                {
+                    fail("expected a member name");
+                }
+
+                json::JsonMember member;
+                parse_string(member.name);
+                expect(':');
+                member.value = parse_value(depth);
+                sorted = sorted && (members.empty() || members.back().name < member.name);
+                members.push_back(std::move(member));
+
+                skip_whitespace();
+                if (peek() == ',')
+                {
+                    m_position++;
+                }
+                else if (peek() == '}')
+                {
+                    m_position++;
+                    break;
+                }
+                else
+                {
+                    fail("expected ',' or '}'");
+                }
+            }
+
+            if (!sorted)
+            {
+                sort_members(members);
+            }
+            return ValueAccess::make(std::move(data));
+        }
+
+        // Sorts the members by name. Of members with the same name, the last one is kept.
+        static void sort_members(std::vector<json::JsonMember>& members)
+        {
+            std::stable_sort(members.begin(), members.end(), [](const json::JsonMember& lhs, const json::JsonMember& rhs) { return lhs.name < rhs.name; });
+            auto last = members.begin();
+            for (auto it = members.begin(); it != members.end(); ++it)
+            {
+                const auto next = std::next(it);
+                if (next != members.end() && next->name == it->name)
+                {
+                    continue;
+                }
+                if (last != it)
+                {
+                    *last = std::move(*it);
+                }
+                ++last;
+            }
+            members.erase(last, members.end());
+        }
+
+        JsonValue parse_array(size_t depth)
+        {
+            if (depth > MAX_DEPTH)
+            {
+                fail("nesting is too deep");
+            }
+
+            auto data = std::make_shared<json::details::ArrayData>();
+            m_position++;
+            skip_whitespace();
+            if (peek() == ']')
+            {
+                m_position++;
+                return ValueAccess::make(std::move(data));
+            }
+
+            for (;;)
+            {
+                data->elements.push_back(parse_value(depth));
+                skip_whitespace();
+                if (peek() == ',')
+                {
+                    m_position++;
+                }
+                else if (peek() == ']')
+                {
+                    m_position++;
+                    break;
+                }
+                else
+                {
+                    fail("expected ',' or ']'");
+                }
+            }
+            return ValueAccess::make(std::move(data));
+        }
+
+        void parse_string(std::wstring& value)
+        {
+            // Opening quote was checked by the caller
+            m_position++;
+            for (;;)
+            {
+                // Copy runs of characters which need no decoding at once
+                const size_t start = m_position;
+                while (m_position < m_text.size())
+                {
+                    const char32_t ch = peek();
+                    if (ch == '"' || ch == '\\' || ch < 0x20 || (std::is_same_v<Char, char> && ch >= 0x80))
+                    {
+                        break;
+                    }
+                    m_position++;
+                }
+                value.append(m_text.begin() + start, m_text.begin() + m_position);
+
+                if (m_position >= m_text.size())
+                {
+                    fail("unterminated string");
+                }
+
+                const char32_t ch = peek();
+                if (ch == '"')
+                {
+                    m_position++;
+                    return;
+                }
+
+                if (ch == '\\')
+                {
+                    parse_escape(value);
+                }
+                else if (ch < 0x20)
+                {
+                    fail("control character in a string");
+                }
+                else if constexpr (std::is_same_v<Char, char>)
+                {
+                    append_code_point(value, decode_utf8(m_text, m_position));
+                }
+            }
+        }
+
+        void parse_escape(std::wstring& value)
+        {
+            m_position++;
+            const char32_t ch = peek();
+            m_position++;
+            switch (ch)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                value.push_back(static_cast<wchar_t>(ch));
+                break;
+            case 'b':
+                value.push_back(L'\b');
+                break;
+            case 'f':
+                value.push_back(L'\f');
+                break;
+            case 'n':
+                value.push_back(L'\n');
+                break;
+            case 'r':
+                value.push_back(L'\r');
+                break;
+            case 't':
+                value.push_back(L'\t');
+                break;
+            case 'u':
+            {
+                char32_t code_unit = 0;
+                for (size_t i = 0; i < 4; i++)
+                {
+                    const int digit = hex_value(peek());
+                    if (digit < 0)
+                    {
+                        fail("invalid \\u escape");
+                    }
+                    code_unit = (code_unit << 4) | static_cast<char32_t>(digit);
+                    m_position++;
+                }
+                append_code_unit(value, code_unit);
+                break;
+            }
+            default:
+                m_position--;
+                fail("invalid escape");
+            }
+        }
+
+        double parse_number()
+        {
+            const size_t start = m_position;
+            const auto digits = [this]() {
+                const size_t first = m_position;
+                while (is_digit(peek()))
+                {
+                    m_position++;
+                }
+                return m_position - first;
+            };
+
+            if (peek() == '-')
+            {
+                m_position++;
+            }
+
+            if (peek() == '0')
+            {
+                m_position++;
+            }
+            else if (digits() == 0)
+            {
+                fail("invalid number");
+            }
+
+            if (peek() == '.')
+            {
+                m_position++;
+                if (digits() == 0)
+                {
+                    fail("invalid number");
+                }
+            }
+
+            if (peek() == 'e' || peek() == 'E')
+            {
+                m_position++;
+                if (peek() == '+' || peek() == '-')
+                {
+                    m_position++;
+                }
+                if (digits() == 0)
+                {
+                    fail("invalid number");
+                }
+            }
+
+            // The number was validated above, so it's plain ASCII which from_chars reads the same way
+            double value = 0;
+            std::from_chars_result result;
+            if constexpr (std::is_same_v<Char, char>)
+            {
+                result = std::from_chars(m_text.data() + start, m_text.data() + m_position, value);
+            }
+            else
+            {
+                const std::string number(m_text.begin() + start, m_text.begin() + m_position);
+                result = std::from_chars(number.data(), number.data() + number.size(), value);
+            }
+
+            if (result.ec == std::errc::result_out_of_range)
+            {
+                fail("number out of range");
+            }
+            return value;
+        }
+
+        void parse_literal(std::string_view literal)
+        {
+            for (const char ch : literal)
+            {
+                if (peek() != static_cast<char32_t>(ch))
+                {
+                    fail("invalid literal");
+                }
+                m_position++;
+            }
+        }
+
+        std::basic_string_view<Char> m_text;
+        size_t m_position = 0;
+    };
+
+    // Output of Stringify()
+    class WideWriter
+    {
+    public:
+        explicit WideWriter(std::wstring& output) noexcept :
+            m_output(output)
+        {
+        }
+
+        inline void ascii(std::string_view text)
+        {
+            m_output.append(text.begin(), text.end());
+        }
+
+        inline void text(std::wstring_view text)
+        {
+            m_output.append(text);
+        }
+
+    private:
+        std::wstring& m_output;
+    };
+
+    // UTF-8 output, handed to the callback in chunks of about the size of the buffer
+    class Utf8Writer
+    {
+    public:
+        static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+        explicit Utf8Writer(const std::function<void(std::string_view)>& write) :
+            m_write(write)
+        {
+            m_buffer.reserve(BUFFER_SIZE + 4);
+        }
+
+        ~Utf8Writer()
+        {
+            flush();
+        }
+
+        inline void ascii(std::string_view text)
+        {
+            m_buffer.append(text);
+            flush_if_full();
+        }
+
+        // Unpaired surrogates are written as the replacement character, the same way WideCharToMultiByte writes them
+        void text(std::wstring_view text)
+        {
+            for (size_t i = 0; i < text.size(); i++)
+            {
+                char32_t code_point = static_cast<char32_t>(text[i]);
+                if (code_point < 0x80)
+                {
+                    m_buffer.push_back(static_cast<char>(code_point));
+                    continue;
+                }
+
+                if constexpr (sizeof(wchar_t) == 2)
+                {
+                    if (is_high_surrogate(code_point) && i + 1 < text.size() && is_low_surrogate(static_cast<char32_t>(text[i + 1])))
+                    {
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (static_cast<char32_t>(text[++i]) - 0xDC00);
+                    }
+                }
+                if ((code_point >= 0xD800 && code_point <= 0xDFFF) || code_point > 0x10FFFF)
+                {
+                    code_point = REPLACEMENT_CHARACTER;
+                }
+
+                if (code_point < 0x800)
+                {
+                    m_buffer.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+                }
+                else if (code_point < 0x10000)
+                {
+                    m_buffer.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+                    m_buffer.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+                }
+                else
+                {
+                    m_buffer.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+                    m_buffer.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+                    m_buffer.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+                }
+                m_buffer.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+                flush_if_full();
+            }
+            flush_if_full();
+        }
+
+        void flush()
+        {
+            if (!m_buffer.empty())
+            {
+                m_write(m_buffer);
+                m_buffer.clear();
+            }
+        }
+
+    private:
+        inline void flush_if_full()
+        {
+            if (m_buffer.size() >= BUFFER_SIZE)
+            {
+                flush();
+            }
+        }
+
+        const std::function<void(std::string_view)>& m_write;
+        std::string m_buffer;
+    };
+
+    // Writes values in the compact form Windows.Data.Json used, e.g. {"name":"value","list":[1,2]}
+    template<typename Writer>
+    class Serializer
+    {
+    public:
+        explicit Serializer(Writer& writer) noexcept :
+            m_writer(writer)
+        {
+        }
+
+        void write(const JsonValue& value)
         {
-            std::ifstream file(file_name.data(), std::ios::binary);
-            if (file.is_open())
+            const auto& content = ValueAccess::get(value);
+            switch (static_cast<json::JsonValueType>(content.index()))
             {
-                using isbi = std::istreambuf_iterator<char>;
-                std::string obj_str{ isbi{ file }, isbi{} };
-                return JsonValue::Parse(winrt::to_hstring(obj_str)).GetObjectW();
+            case json::JsonValueType::Null:
+                m_writer.ascii("null");
+                break;
+            case json::JsonValueType::Boolean:
+                m_writer.ascii(std::get<bool>(content) ? "true" : "false");
+                break;
+            case json::JsonValueType::Number:
+                write_number(std::get<double>(content));
+                break;
+            case json::JsonValueType::String:
+                write_string(std::get<std::wstring>(content));
+                break;
+            case json::JsonValueType::Array:
+                write_array(*std::get<std::shared_ptr<json::details::ArrayData>>(content));
+                break;
+            case json::JsonValueType::Object:
+                write_object(*std::get<std::shared_ptr<json::details::ObjectData>>(content));
+                break;
             }
-            return std::nullopt;
         }
-        catch (...)
+
+        void write_object(const json::details::ObjectData& object)
+        {
+            m_writer.ascii("{");
+            bool first = true;
+            for (const auto& member : object.members)
+            {
+                if (!first)
+                {
+                    m_writer.ascii(",");
+                }
+                first = false;
+                write_string(member.name);
+                m_writer.ascii(":");
+                write(member.value);
+            }
+            m_writer.ascii("}");
+        }
+
+        void write_array(const json::details::ArrayData& array)
+        {
+            m_writer.ascii("[");
+            bool first = true;
+            for (const auto& element : array.elements)
+            {
+                if (!first)
+                {
+                    m_writer.ascii(",");
+                }
+                first = false;
+                write(element);
+            }
+            m_writer.ascii("]");
+        }
+
+    private:
+        // Integers are written without a fraction or an exponent, other numbers in their shortest form which reads back the same
+        void write_number(double value)
+        {
+            if (!std::isfinite(value))
+            {
+                m_writer.ascii("null");
+                return;
+            }
+
+            char buffer[32];
+            std::to_chars_result result;
+            if (value == std::trunc(value) && std::abs(value) < 1e15)
+            {
+                result = std::to_chars(std::begin(buffer), std::end(buffer), static_cast<int64_t>(value));
+            }
+            else
+            {
+                result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+            }
+            m_writer.ascii({ buffer, static_cast<size_t>(result.ptr - buffer) });
+        }
+
+        void write_string(std::wstring_view value)
         {
-            return std::nullopt;
+            m_writer.ascii("\"");
+            size_t start = 0;
+            for (size_t i = 0; i < value.size(); i++)
+            {
+                const wchar_t ch = value[i];
+                if (ch != L'"' && ch != L'\\' && ch >= 0x20)
+                {
+                    continue;
+                }
+
+                m_writer.text(value.substr(start, i - start));
+                start = i + 1;
+                switch (ch)
+                {
+                case L'"':
+                    m_writer.ascii("\\\"");
+                    break;
+                case L'\\':
+                    m_writer.ascii("\\\\");
+                    break;
+                case L'\b':
+                    m_writer.ascii("\\b");
+                    break;
+                case L'\f':
+                    m_writer.ascii("\\f");
+                    break;
+                case L'\n':
+                    m_writer.ascii("\\n");
+                    break;
+                case L'\r':
+                    m_writer.ascii("\\r");
+                    break;
+                case L'\t':
+                    m_writer.ascii("\\t");
+                    break;
+                default:
+                {
+                    const char escape[] = { '\\', 'u', '0', '0', "0123456789abcdef"[ch >> 4], "0123456789abcdef"[ch & 0xF] };
+                    m_writer.ascii({ escape, sizeof(escape) });
+                    break;
+                }
+                }
+            }
+            m_writer.text(value.substr(start));
+            m_writer.ascii("\"");
         }
+
+        Writer& m_writer;
+    };
+
+    std::wstring stringify(const JsonValue& value)
+    {
+        std::wstring result;
+        WideWriter writer{ result };
+        Serializer<WideWriter>{ writer }.write(value);
+        return result;
+    }
+
+    // Escapes a name for a JSON Pointer, as described in RFC 6901
+    std::wstring escape_pointer_token(std::wstring_view name)
+    {
+        std::wstring result;
+        result.reserve(name.size());
+        for (const wchar_t c : name)
+        {
+            if (c == L'~')
+            {
+                result += L"~0";
+            }
+            else if (c == L'/')
+            {
+                result += L"~1";
+            }
+            else
+            {
+                result += c;
+            }
+        }
+        return result;
+    }
+
+    void diff_objects(const json::JsonObject& old_object, const json::JsonObject& new_object, const std::wstring& path, std::vector<json::Change>& changes)
+    {
+        for (const auto& element : new_object)
+        {
+            const std::wstring value_path = path + L"/" + escape_pointer_token(element.Key());
+            const auto& new_value = element.Value();
+            const JsonValue* old_value = old_object.Find(element.Key());
+            if (!old_value)
+            {
+                changes.push_back({ value_path, new_value.Stringify() });
+                continue;
+            }
+
+            if (old_value->ValueType() == json::JsonValueType::Object && new_value.ValueType() == json::JsonValueType::Object)
+            {
+                diff_objects(old_value->GetObjectW(), new_value.GetObjectW(), value_path, changes);
+                continue;
+            }
+
+            auto new_string = new_value.Stringify();
+            if (old_value->ValueType() != new_value.ValueType() || old_value->Stringify() != new_string)
+            {
+                changes.push_back({ value_path, std::move(new_string) });
+            }
+        }
+
+        for (const auto& element : old_object)
+        {
+            if (!new_object.HasKey(element.Key()))
+            {
+                changes.push_back({ path + L"/" + escape_pointer_token(element.Key()), std::nullopt });
+            }
+        }
+    }
+
+    template<typename Result>
+    Result parse_as(std::wstring_view text, json::JsonValueType type)
+    {
+        const JsonValue value = Parser<wchar_t>{ text }.parse_document();
+        if (value.ValueType() != type)
+        {
+            throw JsonError("Invalid JSON: unexpected type of the root value");
+        }
+
+        if constexpr (std::is_same_v<Result, json::JsonObject>)
+        {
+            return value.GetObjectW();
+        }
+        else
+        {
+            return value.GetArray();
+        }
+    }
+
+    template<typename Result>
+    bool try_parse_as(std::wstring_view text, json::JsonValueType type, Result& result)
+    {
+        try
+        {
+            result = parse_as<Result>(text, type);
+            return true;
+        }
+        catch (const JsonError&)
+        {
+            return false;
+        }
+    }
+
+    [[noreturn]] void throw_missing()
+    {
+        throw JsonError("No value with the name was found");
+    }
+
+    [[noreturn]] void throw_unexpected_type()
+    {
+        throw JsonError("The value has another type than requested");
+    }
+
+    // Position at which a member with the name is or would be inserted
+    std::vector<json::JsonMember>::iterator find_position(std::vector<json::JsonMember>& members, std::wstring_view name) noexcept
+    {
+        return std::lower_bound(members.begin(), members.end(), name, [](const json::JsonMember& member, std::wstring_view key) { return std::wstring_view{ member.name } < key; });
+    }
+}
+
+namespace json
+{
+    JsonValue::JsonValue(const JsonObject& object) :
+        m_value(object.m_data)
+    {
+    }
+
+    JsonValue::JsonValue(const JsonArray& array) :
+        m_value(array.m_data)
+    {
+    }
+
+    JsonValue JsonValue::Parse(std::wstring_view text)
+    {
+        return Parser<wchar_t>{ text }.parse_document();
+    }
+
+    bool JsonValue::TryParse(std::wstring_view text, JsonValue& result)
+    {
+        try
+        {
+            result = Parse(text);
+            return true;
+        }
+        catch (const JsonError&)
+        {
+            return false;
+        }
+    }
+
+    JsonValue JsonValue::CreateNullValue() noexcept
+    {
+        return {};
+    }
+
+    JsonValue JsonValue::CreateBooleanValue(bool value) noexcept
+    {
+        JsonValue result;
+        result.m_value = value;
+        return result;
+    }
+
+    JsonValue JsonValue::CreateNumberValue(double value) noexcept
+    {
+        JsonValue result;
+        result.m_value = value;
+        return result;
+    }
+
+    JsonValue JsonValue::CreateStringValue(std::wstring_view value)
+    {
+        JsonValue result;
+        result.m_value = std::wstring{ value };
+        return result;
+    }
+
+    JsonValueType JsonValue::ValueType() const noexcept
+    {
+        return static_cast<JsonValueType>(m_value.index());
+    }
+
+    bool JsonValue::GetBoolean() const
+    {
+        if (const auto value = std::get_if<bool>(&m_value))
+        {
+            return *value;
+        }
+        throw_unexpected_type();
+    }
+
+    double JsonValue::GetNumber() const
+    {
+        if (const auto value = std::get_if<double>(&m_value))
+        {
+            return *value;
+        }
+        throw_unexpected_type();
+    }
+
+    std::wstring JsonValue::GetString() const
+    {
+        if (const auto value = std::get_if<std::wstring>(&m_value))
+        {
+            return *value;
+        }
+        throw_unexpected_type();
+    }
+
+    JsonArray JsonValue::GetArray() const
+    {
+        if (const auto value = std::get_if<std::shared_ptr<details::ArrayData>>(&m_value))
+        {
+            return JsonArray{ *value };
+        }
+        throw_unexpected_type();
+    }
+
+    JsonObject JsonValue::GetObjectW() const
+    {
+        if (const auto value = std::get_if<std::shared_ptr<details::ObjectData>>(&m_value))
+        {
+            return JsonObject{ *value };
+        }
+        throw_unexpected_type();
+    }
+
+    std::wstring JsonValue::Stringify() const
+    {
+        return stringify(*this);
+    }
+
+    std::wstring JsonValue::ToString() const
+    {
+        return Stringify();
+    }
+
+    JsonObject::JsonObject() :
+        m_data(std::make_shared<details::ObjectData>())
+    {
+    }
+
+    JsonObject::JsonObject(std::nullptr_t) noexcept
+    {
+    }
+
+    JsonObject::JsonObject(std::shared_ptr<details::ObjectData> data) noexcept :
+        m_data(std::move(data))
+    {
+    }
+
+    JsonObject JsonObject::Parse(std::wstring_view text)
+    {
+        return parse_as<JsonObject>(text, JsonValueType::Object);
+    }
+
+    bool JsonObject::TryParse(std::wstring_view text, JsonObject& result)
+    {
+        return try_parse_as(text, JsonValueType::Object, result);
+    }
+
+    uint32_t JsonObject::Size() const noexcept
+    {
+        return static_cast<uint32_t>(m_data->members.size());
+    }
+
+    bool JsonObject::HasKey(std::wstring_view name) const noexcept
+    {
+        return Find(name) != nullptr;
+    }
+
+    const JsonValue* JsonObject::Find(std::wstring_view name) const noexcept
+    {
+        const auto it = find_position(m_data->members, name);
+        return it != m_data->members.end() && it->name == name ? &it->value : nullptr;
+    }
+
+    JsonValue JsonObject::GetNamedValue(std::wstring_view name) const
+    {
+        if (const JsonValue* value = Find(name))
+        {
+            return *value;
+        }
+        throw_missing();
+    }
+
+    JsonValue JsonObject::GetNamedValue(std::wstring_view name, const JsonValue& default_value) const
+    {
+        const JsonValue* value = Find(name);
+        return value ? *value : default_value;
+    }
+
+    JsonObject JsonObject::GetNamedObject(std::wstring_view name) const
+    {
+        if (const JsonValue* value = Find(name))
+        {
+            return value->GetObjectW();
+        }
+        throw_missing();
+    }
+
+    JsonObject JsonObject::GetNamedObject(std::wstring_view name, const JsonObject& default_value) const
+    {
+        const JsonValue* value = Find(name);
+        return value ? value->GetObjectW() : default_value;
+    }
+
+    JsonArray JsonObject::GetNamedArray(std::wstring_view name) const
+    {
+        if (const JsonValue* value = Find(name))
+        {
+            return value->GetArray();
+        }
+        throw_missing();
+    }
+
+    JsonArray JsonObject::GetNamedArray(std::wstring_view name, const JsonArray& default_value) const
+    {
+        const JsonValue* value = Find(name);
+        return value ? value->GetArray() : default_value;
+    }
+
+    std::wstring JsonObject::GetNamedString(std::wstring_view name) const
+    {
+        if (const JsonValue* value = Find(name))
+        {
+            return value->GetString();
+        }
+        throw_missing();
+    }
+
+    std::wstring JsonObject::GetNamedString(std::wstring_view name, std::wstring_view default_value) const
+    {
+        const JsonValue* value = Find(name);
+        return value ? value->GetString() : std::wstring{ default_value };
+    }
+
+    double JsonObject::GetNamedNumber(std::wstring_view name) const
+    {
+        if (const JsonValue* value = Find(name))
+        {
+            return value->GetNumber();
+        }
+        throw_missing();
+    }
+
+    double JsonObject::GetNamedNumber(std::wstring_view name, double default_value) const
+    {
+        const JsonValue* value = Find(name);
+        return value ? value->GetNumber() : default_value;
+    }
+
+    bool JsonObject::GetNamedBoolean(std::wstring_view name) const
+    {
+        if (const JsonValue* value = Find(name))
+        {
+            return value->GetBoolean();
+        }
+        throw_missing();
+    }
+
+    bool JsonObject::GetNamedBoolean(std::wstring_view name, bool default_value) const
+    {
+        const JsonValue* value = Find(name);
+        return value ? value->GetBoolean() : default_value;
+    }
+
+    void JsonObject::SetNamedValue(std::wstring_view name, const JsonValue& value)
+    {
+        Insert(name, value);
+    }
+
+    bool JsonObject::Insert(std::wstring_view name, const JsonValue& value)
+    {
+        auto& members = m_data->members;
+        const auto it = find_position(members, name);
+        if (it != members.end() && it->name == name)
+        {
+            it->value = value;
+            return true;
+        }
+        members.insert(it, JsonMember{ std::wstring{ name }, value });
+        return false;
+    }
+
+    JsonValue JsonObject::Lookup(std::wstring_view name) const
+    {
+        return GetNamedValue(name);
+    }
+
+    void JsonObject::Remove(std::wstring_view name)
+    {
+        auto& members = m_data->members;
+        const auto it = find_position(members, name);
+        if (it != members.end() && it->name == name)
+        {
+            members.erase(it);
+        }
+    }
+
+    void JsonObject::Clear() noexcept
+    {
+        m_data->members.clear();
+    }
+
+    JsonObject::Iterator JsonObject::First() const noexcept
+    {
+        return Iterator{ m_data };
+    }
+
+    std::vector<JsonMember>::const_iterator JsonObject::begin() const noexcept
+    {
+        return m_data->members.cbegin();
+    }
+
+    std::vector<JsonMember>::const_iterator JsonObject::end() const noexcept
+    {
+        return m_data->members.cend();
+    }
+
+    std::wstring JsonObject::Stringify() const
+    {
+        std::wstring result;
+        WideWriter writer{ result };
+        Serializer<WideWriter>{ writer }.write_object(*m_data);
+        return result;
+    }
+
+    std::wstring JsonObject::ToString() const
+    {
+        return Stringify();
+    }
+
+    JsonArray::JsonArray() :
+        m_data(std::make_shared<details::ArrayData>())
+    {
+    }
+
+    JsonArray::JsonArray(std::nullptr_t) noexcept
+    {
+    }
+
+    JsonArray::JsonArray(std::shared_ptr<details::ArrayData> data) noexcept :
+        m_data(std::move(data))
+    {
+    }
+
+    JsonArray JsonArray::Parse(std::wstring_view text)
+    {
+        return parse_as<JsonArray>(text, JsonValueType::Array);
+    }
+
+    bool JsonArray::TryParse(std::wstring_view text, JsonArray& result)
+    {
+        return try_parse_as(text, JsonValueType::Array, result);
+    }
+
+    uint32_t JsonArray::Size() const noexcept
+    {
+        return static_cast<uint32_t>(m_data->elements.size());
+    }
+
+    JsonValue JsonArray::GetAt(uint32_t index) const
+    {
+        if (index >= m_data->elements.size())
+        {
+            throw JsonError("Index out of range");
+        }
+        return m_data->elements[index];
+    }
+
+    JsonObject JsonArray::GetObjectAt(uint32_t index) const
+    {
+        return GetAt(index).GetObjectW();
+    }
+
+    JsonArray JsonArray::GetArrayAt(uint32_t index) const
+    {
+        return GetAt(index).GetArray();
+    }
+
+    std::wstring JsonArray::GetStringAt(uint32_t index) const
+    {
+        return GetAt(index).GetString();
+    }
+
+    double JsonArray::GetNumberAt(uint32_t index) const
+    {
+        return GetAt(index).GetNumber();
+    }
+
+    bool JsonArray::GetBooleanAt(uint32_t index) const
+    {
+        return GetAt(index).GetBoolean();
+    }
+
+    void JsonArray::Append(const JsonValue& value)
+    {
+        m_data->elements.push_back(value);
+    }
+
+    void JsonArray::SetAt(uint32_t index, const JsonValue& value)
+    {
+        if (index >= m_data->elements.size())
+        {
+            throw JsonError("Index out of range");
+        }
+        m_data->elements[index] = value;
+    }
+
+    void JsonArray::InsertAt(uint32_t index, const JsonValue& value)
+    {
+        if (index > m_data->elements.size())
+        {
+            throw JsonError("Index out of range");
+        }
+        m_data->elements.insert(m_data->elements.begin() + index, value);
+    }
+
+    void JsonArray::RemoveAt(uint32_t index)
+    {
+        if (index >= m_data->elements.size())
+        {
+            throw JsonError("Index out of range");
+        }
+        m_data->elements.erase(m_data->elements.begin() + index);
+    }
+
+    void JsonArray::Clear() noexcept
+    {
+        m_data->elements.clear();
+    }
+
+    JsonArray::Iterator JsonArray::First() const noexcept
+    {
+        return Iterator{ m_data };
+    }
+
+    std::vector<JsonValue>::const_iterator JsonArray::begin() const noexcept
+    {
+        return m_data->elements.cbegin();
+    }
+
+    std::vector<JsonValue>::const_iterator JsonArray::end() const noexcept
+    {
+        return m_data->elements.cend();
+    }
+
+    std::wstring JsonArray::Stringify() const
+    {
+        std::wstring result;
+        WideWriter writer{ result };
+        Serializer<WideWriter>{ writer }.write_array(*m_data);
+        return result;
+    }
+
+    std::wstring JsonArray::ToString() const
+    {
+        return Stringify();
+    }
+
+    JsonValue parse_utf8(std::string_view text)
+    {
+        return Parser<char>{ text }.parse_document();
+    }
+
+    void stringify_utf8(const JsonValue& value, const std::function<void(std::string_view)>& write)
+    {
+        Utf8Writer writer{ write };
+        Serializer<Utf8Writer>{ writer }.write(value);
+        writer.flush();
     }
 
-    void to_file(std::wstring_view file_name, const JsonObject& obj)
+    std::vector<Change> diff(const JsonObject& old_object, const JsonObject& new_object)
     {
-        std::wstring obj_str{ obj.Stringify().c_str() };
-        std::ofstream{ file_name.data(), std::ios::binary } << winrt::to_string(obj_str);
+        std::vector<Change> changes;
+        diff_objects(old_object, new_object, L"", changes);
+        return changes;
     }
 }
@@ -1,31 +1,294 @@
 #pragma once
 
-#include <winrt/Windows.Foundation.h>
-#include <winrt/Windows.Foundation.Collections.h>
-#include <winrt/Windows.Data.Json.h>
-
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
+// Portable JSON document model with the API of Windows.Data.Json, which it replaced. Objects and arrays are
+// reference types like their WinRT counterparts: copies share the same members, and changes made through
+// GetNamedObject() are visible in the parent. Files are read and written as UTF-8 without converting the
+// whole document to UTF-16 first.
 namespace json
 {
-    using namespace winrt::Windows::Data::Json;
+    enum class JsonValueType
+    {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    // Thrown for malformed JSON, missing names and values of another type than requested
+    class JsonError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    class JsonObject;
+    class JsonArray;
+
+    namespace details
+    {
+        struct ObjectData;
+        struct ArrayData;
+    }
+
+    class JsonValue
+    {
+    public:
+        JsonValue() noexcept = default;
+
+        // Objects and arrays are values themselves, as in Windows.Data.Json
+        JsonValue(const JsonObject& object);
+        JsonValue(const JsonArray& array);
+
+        static JsonValue Parse(std::wstring_view text);
+        static bool TryParse(std::wstring_view text, JsonValue& result);
+
+        static JsonValue CreateNullValue() noexcept;
+        static JsonValue CreateBooleanValue(bool value) noexcept;
+        static JsonValue CreateNumberValue(double value) noexcept;
+        static JsonValue CreateStringValue(std::wstring_view value);
+
+        JsonValueType ValueType() const noexcept;
+
+        bool GetBoolean() const;
+        double GetNumber() const;
+        std::wstring GetString() const;
+        JsonArray GetArray() const;
+
+        // Named like the method windows.h turns GetObject into, so both spellings keep working on Windows
+        JsonObject GetObjectW() const;
+
+        std::wstring Stringify() const;
+        std::wstring ToString() const;
+
+    private:
+        friend class JsonObject;
+        friend class JsonArray;
+        friend struct ValueAccess;
+
+        std::variant<std::monostate, bool, double, std::wstring, std::shared_ptr<details::ArrayData>, std::shared_ptr<details::ObjectData>> m_value;
+    };
+
+    // Member of an object, named like the WinRT key value pairs it replaced
+    struct JsonMember
+    {
+        std::wstring name;
+        JsonValue value;
+
+        inline const std::wstring& Key() const noexcept
+        {
+            return name;
+        }
+
+        inline const JsonValue& Value() const noexcept
+        {
+            return value;
+        }
+    };
+
+    namespace details
+    {
+        // Members are kept sorted by name, which makes the serialized form independent of the insertion order
+        struct ObjectData
+        {
+            std::vector<JsonMember> members;
+        };
+
+        struct ArrayData
+        {
+            std::vector<JsonValue> elements;
+        };
+
+        // Iteration in the style of the WinRT collections: First(), then HasCurrent(), Current() and MoveNext()
+        template<typename Data, typename Element, std::vector<Element> Data::*Items>
+        class Iterator
+        {
+        public:
+            explicit Iterator(std::shared_ptr<const Data> data) noexcept :
+                m_data(std::move(data))
+            {
+            }
+
+            inline bool HasCurrent() const noexcept
+            {
+                return m_index < ((*m_data).*Items).size();
+            }
+
+            inline const Element& Current() const
+            {
+                return ((*m_data).*Items).at(m_index);
+            }
+
+            inline bool MoveNext() noexcept
+            {
+                m_index++;
+                return HasCurrent();
+            }
+
+        private:
+            std::shared_ptr<const Data> m_data;
+            size_t m_index = 0;
+        };
+    }
+
+    class JsonObject
+    {
+    public:
+        using Iterator = details::Iterator<details::ObjectData, JsonMember, &details::ObjectData::members>;
+
+        JsonObject();
+        JsonObject(std::nullptr_t) noexcept;
+
+        static JsonObject Parse(std::wstring_view text);
+        static bool TryParse(std::wstring_view text, JsonObject& result);
+
+        uint32_t Size() const noexcept;
+        bool HasKey(std::wstring_view name) const noexcept;
+
+        // Returns the member's value, or nullptr if there's no member with the name. The pointer is valid until the object is changed.
+        const JsonValue* Find(std::wstring_view name) const noexcept;
+
+        JsonValue GetNamedValue(std::wstring_view name) const;
+        JsonValue GetNamedValue(std::wstring_view name, const JsonValue& default_value) const;
+        JsonObject GetNamedObject(std::wstring_view name) const;
+        JsonObject GetNamedObject(std::wstring_view name, const JsonObject& default_value) const;
+        JsonArray GetNamedArray(std::wstring_view name) const;
+        JsonArray GetNamedArray(std::wstring_view name, const JsonArray& default_value) const;
+        std::wstring GetNamedString(std::wstring_view name) const;
+        std::wstring GetNamedString(std::wstring_view name, std::wstring_view default_value) const;
+        double GetNamedNumber(std::wstring_view name) const;
+        double GetNamedNumber(std::wstring_view name, double default_value) const;
+        bool GetNamedBoolean(std::wstring_view name) const;
+        bool GetNamedBoolean(std::wstring_view name, bool default_value) const;
+
+        void SetNamedValue(std::wstring_view name, const JsonValue& value);
+
+        // Returns true if a value with the same name was replaced
+        bool Insert(std::wstring_view name, const JsonValue& value);
+        JsonValue Lookup(std::wstring_view name) const;
+        void Remove(std::wstring_view name);
+        void Clear() noexcept;
+
+        Iterator First() const noexcept;
+        std::vector<JsonMember>::const_iterator begin() const noexcept;
+        std::vector<JsonMember>::const_iterator end() const noexcept;
+
+        std::wstring Stringify() const;
+        std::wstring ToString() const;
+
+        // False only for objects created from nullptr
+        inline explicit operator bool() const noexcept
+        {
+            return m_data != nullptr;
+        }
+
+    private:
+        friend class JsonValue;
+        friend struct ValueAccess;
+
+        explicit JsonObject(std::shared_ptr<details::ObjectData> data) noexcept;
+
+        std::shared_ptr<details::ObjectData> m_data;
+    };
+
+    class JsonArray
+    {
+    public:
+        using Iterator = details::Iterator<details::ArrayData, JsonValue, &details::ArrayData::elements>;
+
+        JsonArray();
+        JsonArray(std::nullptr_t) noexcept;
+
+        static JsonArray Parse(std::wstring_view text);
+        static bool TryParse(std::wstring_view text, JsonArray& result);
+
+        uint32_t Size() const noexcept;
+
+        JsonValue GetAt(uint32_t index) const;
+        JsonObject GetObjectAt(uint32_t index) const;
+        JsonArray GetArrayAt(uint32_t index) const;
+        std::wstring GetStringAt(uint32_t index) const;
+        double GetNumberAt(uint32_t index) const;
+        bool GetBooleanAt(uint32_t index) const;
+
+        void Append(const JsonValue& value);
+        void SetAt(uint32_t index, const JsonValue& value);
+        void InsertAt(uint32_t index, const JsonValue& value);
+        void RemoveAt(uint32_t index);
+        void Clear() noexcept;
+
+        Iterator First() const noexcept;
+        std::vector<JsonValue>::const_iterator begin() const noexcept;
+        std::vector<JsonValue>::const_iterator end() const noexcept;
+
+        std::wstring Stringify() const;
+        std::wstring ToString() const;
+
+        // False only for arrays created from nullptr
+        inline explicit operator bool() const noexcept
+        {
+            return m_data != nullptr;
+        }
+
+    private:
+        friend class JsonValue;
+        friend struct ValueAccess;
+
+        explicit JsonArray(std::shared_ptr<details::ArrayData> data) noexcept;
+
+        std::shared_ptr<details::ArrayData> m_data;
+    };
+
+    // Parses a UTF-8 document in place, e.g. straight from a memory-mapped file. A leading byte order mark is skipped.
+    JsonValue parse_utf8(std::string_view text);
+
+    // Serializes the value as UTF-8, handing the output to write in chunks as it's produced
+    void stringify_utf8(const JsonValue& value, const std::function<void(std::string_view)>& write);
 
     std::optional<JsonObject> from_file(std::wstring_view file_name);
 
-    void to_file(std::wstring_view file_name, const JsonObject& obj);
+    // Writes the file as a whole: readers see either the old or the new content, never a partially written file.
+    // The new content is written to a temporary file which is then renamed over the target. Returns false if the file was not saved
+    bool to_file(std::wstring_view file_name, const JsonObject& obj);
+
+    // A value which differs between two versions of an object
+    struct Change
+    {
+        // JSON Pointer to the value, e.g. "/properties/press_time/value"
+        std::wstring path;
+        // Serialized new value, or nothing if the value was removed
+        std::optional<std::wstring> value;
+    };
+
+    // Returns the values which were added, changed or removed in new_object, going into the objects present in both.
+    // Other values, including arrays, are compared as a whole.
+    std::vector<Change> diff(const JsonObject& old_object, const JsonObject& new_object);
 
     inline bool has(
         const json::JsonObject& o,
         std::wstring_view name,
         const json::JsonValueType type = JsonValueType::Object)
     {
-        return o.HasKey(name) && o.GetNamedValue(name).ValueType() == type;
+        const JsonValue* value = o.Find(name);
+        return value && value->ValueType() == type;
     }
 
     template<typename T>
     inline std::enable_if_t<std::is_arithmetic_v<T>, JsonValue> value(const T arithmetic)
     {
-        return json::JsonValue::CreateNumberValue(arithmetic);
+        return json::JsonValue::CreateNumberValue(static_cast<double>(arithmetic));
     }
 
     template<typename T>
@@ -41,7 +304,12 @@ namespace json
 
     inline JsonValue value(JsonObject value)
     {
-        return value.as<JsonValue>();
+        return JsonValue{ value };
+    }
+
+    inline JsonValue value(JsonArray value)
+    {
+        return JsonValue{ value };
     }
 
     inline JsonValue value(JsonValue value)
@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "json.h"
+
+#include <wil/resource.h>
+
+// Reading and writing of JSON files. The document model in json.cpp is portable, this part uses the Windows file APIs.
+namespace
+{
+    // Attempts to replace a file which a reader keeps open, and the delay between them
+    const int REPLACE_ATTEMPTS = 20;
+    const DWORD REPLACE_RETRY_DELAY_MS = 25;
+
+    // Reads the whole file. Other processes can still write, rename or delete the file while it's read, so readers never make a save fail
+    std::optional<std::string> read_file(const std::wstring& file_name)
+    {
+        wil::unique_hfile file{ CreateFileW(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        LARGE_INTEGER file_size{};
+        if (!file || !GetFileSizeEx(file.get(), &file_size) || file_size.QuadPart > MAXDWORD)
+        {
+            return std::nullopt;
+        }
+
+        std::string content(static_cast<size_t>(file_size.QuadPart), '\0');
+        DWORD read = 0;
+        if (!ReadFile(file.get(), content.data(), static_cast<DWORD>(content.size()), &read, nullptr))
+        {
+            return std::nullopt;
+        }
+
+        content.resize(read);
+        return content;
+    }
+
+    // Writes the object to a new file, returning false if any write failed
+    bool write_file(const std::wstring& file_name, const json::JsonObject& obj)
+    {
+        wil::unique_hfile file{ CreateFileW(file_name.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        if (!file)
+        {
+            return false;
+        }
+
+        // Stops writing after a failed write
+        bool written = true;
+        json::stringify_utf8(obj, [&](std::string_view chunk) {
+            DWORD chunk_written = 0;
+            written = written && WriteFile(file.get(), chunk.data(), static_cast<DWORD>(chunk.size()), &chunk_written, nullptr) && chunk_written == chunk.size();
+        });
+        return written;
+    }
+
+    // Moves the file over the target, retrying while a reader which doesn't share delete access has the target open
+    bool replace_file(const std::wstring& source, const std::wstring& target)
+    {
+        for (int attempt = 1;; attempt++)
+        {
+            if (MoveFileExW(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING))
+            {
+                return true;
+            }
+
+            const DWORD error = GetLastError();
+            if ((error != ERROR_SHARING_VIOLATION && error != ERROR_ACCESS_DENIED && error != ERROR_USER_MAPPED_FILE) || attempt == REPLACE_ATTEMPTS)
+            {
+                return false;
+            }
+            Sleep(REPLACE_RETRY_DELAY_MS);
+        }
+    }
+}
+
+namespace json
+{
+    std::optional<JsonObject> from_file(std::wstring_view file_name)
+    {
+        const auto content = read_file(std::wstring{ file_name });
+        if (!content || content->empty())
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            return parse_utf8(*content).GetObjectW();
+        }
+        catch (...)
+        {
+            return std::nullopt;
+        }
+    }
+
+    bool to_file(std::wstring_view file_name, const JsonObject& obj)
+    {
+        // The temporary file is next to the target, so that moving it over the target is a rename on the same volume
+        const std::wstring target{ file_name };
+        const std::wstring temporary = target + L"." + std::to_wstring(GetCurrentProcessId()) + L"-" + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+        if (write_file(temporary, obj) && replace_file(temporary, target))
+        {
+            return true;
+        }
+
+        DeleteFileW(temporary.c_str());
+        return false;
+    }
+}
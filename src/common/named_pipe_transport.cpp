@@ -0,0 +1,602 @@
+#include "pch.h"
+#include "named_pipe_transport.h"
+
+#include <WinSafer.h>
+#include <accctrl.h>
+#include <aclapi.h>
+
+#pragma comment(lib, "advapi32.lib")
+
+namespace
+{
+    // Size of the pipe buffers and of each read. Larger messages are received in several reads.
+    const DWORD PIPE_BUFFER_SIZE = 64 * 1024;
+
+    // The wake, listen and write events are waited on along with the read event of each connection.
+    const size_t MAX_INPUT_CONNECTIONS = MAXIMUM_WAIT_OBJECTS - 3;
+
+    // How long to keep trying to connect to the output pipe while all its instances are busy
+    const auto OUTPUT_PIPE_BUSY_TIMEOUT = std::chrono::seconds(20);
+    const DWORD OUTPUT_PIPE_BUSY_RETRY_MS = 50;
+
+    // Cancels the pending I/O of the handle and waits until it's done, so its buffers can be released.
+    void cancel_io(HANDLE handle, OVERLAPPED& overlapped)
+    {
+        DWORD unused = 0;
+        CancelIoEx(handle, &overlapped);
+        GetOverlappedResult(handle, &overlapped, &unused, TRUE);
+    }
+}
+
+NamedPipeTransport::NamedPipeTransport(std::wstring _input_pipe_name, std::wstring _output_pipe_name) :
+    input_pipe_name(std::move(_input_pipe_name)), output_pipe_name(std::move(_output_pipe_name))
+{
+    wake_event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    listen_overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    write_overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+}
+
+NamedPipeTransport::~NamedPipeTransport()
+{
+    stop();
+    CloseHandle(write_overlapped.hEvent);
+    CloseHandle(listen_overlapped.hEvent);
+    CloseHandle(wake_event);
+}
+
+void NamedPipeTransport::start(HANDLE _restricted_token, message_callback _on_message)
+{
+    restricted_token = _restricted_token;
+    on_message = std::move(_on_message);
+
+    // The first instance of the input pipe is created before returning, so the other end can connect as soon as it's started.
+    listen();
+    io_thread = std::thread(&NamedPipeTransport::run_io_thread, this);
+}
+
+void NamedPipeTransport::send(std::wstring message)
+{
+    if (message.size() * sizeof(wchar_t) > ipc_framing::MAX_MESSAGE_SIZE)
+    {
+        return;
+    }
+
+    {
+        std::unique_lock lock{ output_mutex };
+        output_messages.push_back(std::move(message));
+    }
+    SetEvent(wake_event);
+}
+
+void NamedPipeTransport::stop()
+{
+    if (!io_thread.joinable())
+    {
+        return;
+    }
+
+    stopping = true;
+    SetEvent(wake_event);
+    io_thread.join();
+}
+
+void NamedPipeTransport::run_io_thread()
+{
+    write_next();
+    while (!stopping)
+    {
+        // The order of the events decides which one is handled first when several are signaled.
+        HANDLE events[MAXIMUM_WAIT_OBJECTS];
+        DWORD event_count = 0;
+        events[event_count++] = wake_event;
+        const DWORD listen_index = listening_pipe != INVALID_HANDLE_VALUE ? event_count++ : MAXIMUM_WAIT_OBJECTS;
+        if (listen_index != MAXIMUM_WAIT_OBJECTS)
+        {
+            events[listen_index] = listen_overlapped.hEvent;
+        }
+        const DWORD write_index = write_pending ? event_count++ : MAXIMUM_WAIT_OBJECTS;
+        if (write_index != MAXIMUM_WAIT_OBJECTS)
+        {
+            events[write_index] = write_overlapped.hEvent;
+        }
+        const DWORD first_connection_index = event_count;
+        for (auto& connection : connections)
+        {
+            events[event_count++] = connection->overlapped.hEvent;
+        }
+
+        const DWORD timeout = output_busy_since ? OUTPUT_PIPE_BUSY_RETRY_MS : INFINITE;
+        const DWORD result = WaitForMultipleObjects(event_count, events, FALSE, timeout);
+        if (result == WAIT_TIMEOUT || result == WAIT_OBJECT_0)
+        {
+            write_next();
+        }
+        else if (result == WAIT_OBJECT_0 + listen_index)
+        {
+            complete_connect();
+        }
+        else if (result == WAIT_OBJECT_0 + write_index)
+        {
+            complete_write();
+        }
+        else if (result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + event_count)
+        {
+            complete_read(result - WAIT_OBJECT_0 - first_connection_index);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    close_all();
+}
+
+// Creates an instance of the input pipe and waits for a client to connect to it. Clients which are already connected are accepted right away.
+void NamedPipeTransport::listen()
+{
+    while (listening_pipe == INVALID_HANDLE_VALUE && connections.size() < MAX_INPUT_CONNECTIONS)
+    {
+        HANDLE pipe = CreateNamedPipeW(
+            input_pipe_name.c_str(),
+            PIPE_ACCESS_DUPLEX |
+                WRITE_DAC |
+                FILE_FLAG_OVERLAPPED,
+            PIPE_TYPE_BYTE |
+                PIPE_READMODE_BYTE |
+                PIPE_WAIT,
+            PIPE_UNLIMITED_INSTANCES,
+            PIPE_BUFFER_SIZE,
+            PIPE_BUFFER_SIZE,
+            0,
+            NULL);
+
+        if (pipe == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        if (restricted_token != NULL)
+        {
+            change_pipe_security_allow_restricted_token(pipe, restricted_token);
+        }
+
+        ResetEvent(listen_overlapped.hEvent);
+        if (ConnectNamedPipe(pipe, &listen_overlapped) || GetLastError() == ERROR_PIPE_CONNECTED)
+        {
+            accept_connection(pipe);
+        }
+        else if (GetLastError() == ERROR_IO_PENDING)
+        {
+            listening_pipe = pipe;
+        }
+        else
+        {
+            CloseHandle(pipe);
+            return;
+        }
+    }
+}
+
+void NamedPipeTransport::complete_connect()
+{
+    DWORD unused = 0;
+    HANDLE pipe = listening_pipe;
+    listening_pipe = INVALID_HANDLE_VALUE;
+    if (GetOverlappedResult(pipe, &listen_overlapped, &unused, FALSE))
+    {
+        accept_connection(pipe);
+    }
+    else
+    {
+        CloseHandle(pipe);
+    }
+    listen();
+}
+
+void NamedPipeTransport::accept_connection(HANDLE pipe)
+{
+    auto connection = std::make_unique<InputConnection>();
+    connection->pipe = pipe;
+    connection->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    connection->buffer.resize(PIPE_BUFFER_SIZE);
+    connections.push_back(std::move(connection));
+    if (!start_read(*connections.back()))
+    {
+        close_connection(connections.size() - 1);
+    }
+}
+
+bool NamedPipeTransport::start_read(InputConnection& connection)
+{
+    // The event is signaled when the read is done, even if ReadFile completes it right away.
+    ResetEvent(connection.overlapped.hEvent);
+    connection.read_pending = ReadFile(connection.pipe, connection.buffer.data(), static_cast<DWORD>(connection.buffer.size()), NULL, &connection.overlapped) ||
+                              GetLastError() == ERROR_IO_PENDING;
+    return connection.read_pending;
+}
+
+void NamedPipeTransport::complete_read(size_t index)
+{
+    InputConnection& connection = *connections[index];
+    connection.read_pending = false;
+
+    // The client closing the pipe ends the read with ERROR_BROKEN_PIPE.
+    DWORD bytes_read = 0;
+    bool keep_reading = GetOverlappedResult(connection.pipe, &connection.overlapped, &bytes_read, FALSE);
+    if (keep_reading)
+    {
+        keep_reading = connection.decoder.append(connection.buffer.data(), bytes_read);
+        while (auto message = connection.decoder.next())
+        {
+            on_message(std::move(*message));
+        }
+    }
+
+    if (!keep_reading || !start_read(connection))
+    {
+        close_connection(index);
+        listen();
+    }
+}
+
+void NamedPipeTransport::close_connection(size_t index)
+{
+    InputConnection& connection = *connections[index];
+    if (connection.read_pending)
+    {
+        cancel_io(connection.pipe, connection.overlapped);
+    }
+    DisconnectNamedPipe(connection.pipe);
+    CloseHandle(connection.pipe);
+    CloseHandle(connection.overlapped.hEvent);
+    connections.erase(connections.begin() + index);
+}
+
+// Writes the queued messages until one of the writes is pending.
+void NamedPipeTransport::write_next()
+{
+    while (!write_pending)
+    {
+        if (!writing_message)
+        {
+            std::unique_lock lock{ output_mutex };
+            if (output_messages.empty())
+            {
+                return;
+            }
+
+            writing_message = std::move(output_messages.front());
+            output_messages.pop_front();
+            header_written = false;
+            write_retried = false;
+        }
+
+        if (output_pipe == INVALID_HANDLE_VALUE && !connect_output())
+        {
+            if (writing_message)
+            {
+                // All the instances of the output pipe are busy, the wait in run_io_thread times out to retry.
+                return;
+            }
+            continue;
+        }
+
+        if (!start_write())
+        {
+            handle_write_error();
+        }
+    }
+}
+
+// Returns false if the output pipe can't be connected to. If it's busy, the message is kept to retry later, otherwise it's dropped.
+bool NamedPipeTransport::connect_output()
+{
+    output_pipe = CreateFileW(
+        output_pipe_name.c_str(), // pipe name
+        GENERIC_READ | // read and write access
+            GENERIC_WRITE,
+        0, // no sharing
+        NULL, // default security attributes
+        OPEN_EXISTING, // opens existing pipe
+        FILE_FLAG_OVERLAPPED, // overlapped writes
+        NULL); // no template file
+
+    if (output_pipe != INVALID_HANDLE_VALUE)
+    {
+        output_busy_since.reset();
+        return true;
+    }
+
+    if (GetLastError() == ERROR_PIPE_BUSY)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (!output_busy_since)
+        {
+            output_busy_since = now;
+        }
+        if (now - *output_busy_since < OUTPUT_PIPE_BUSY_TIMEOUT)
+        {
+            return false;
+        }
+    }
+
+    output_busy_since.reset();
+    writing_message.reset();
+    return false;
+}
+
+// Writes the header of the frame, then its payload, directly from the queued message.
+bool NamedPipeTransport::start_write()
+{
+    const void* data = &writing_header;
+    DWORD size = sizeof(writing_header);
+    if (header_written)
+    {
+        data = writing_message->data();
+        size = writing_header;
+    }
+    else
+    {
+        writing_header = ipc_framing::make_header(*writing_message);
+    }
+
+    ResetEvent(write_overlapped.hEvent);
+    write_pending = WriteFile(output_pipe, data, size, NULL, &write_overlapped) || GetLastError() == ERROR_IO_PENDING;
+    return write_pending;
+}
+
+void NamedPipeTransport::complete_write()
+{
+    write_pending = false;
+    DWORD written = 0;
+    if (!GetOverlappedResult(output_pipe, &write_overlapped, &written, FALSE))
+    {
+        handle_write_error();
+    }
+    else if (!header_written && writing_header != 0)
+    {
+        header_written = true;
+    }
+    else
+    {
+        writing_message.reset();
+    }
+
+    write_next();
+}
+
+// The other end closes the connection when it's restarted, so the frame is sent again once on a new connection before being dropped.
+void NamedPipeTransport::handle_write_error()
+{
+    close_output();
+    header_written = false;
+    if (write_retried)
+    {
+        writing_message.reset();
+    }
+    write_retried = true;
+}
+
+void NamedPipeTransport::close_output()
+{
+    if (output_pipe == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    if (write_pending)
+    {
+        cancel_io(output_pipe, write_overlapped);
+        write_pending = false;
+    }
+    CloseHandle(output_pipe);
+    output_pipe = INVALID_HANDLE_VALUE;
+}
+
+void NamedPipeTransport::close_all()
+{
+    if (listening_pipe != INVALID_HANDLE_VALUE)
+    {
+        cancel_io(listening_pipe, listen_overlapped);
+        CloseHandle(listening_pipe);
+        listening_pipe = INVALID_HANDLE_VALUE;
+    }
+
+    while (!connections.empty())
+    {
+        close_connection(connections.size() - 1);
+    }
+
+    close_output();
+    writing_message.reset();
+    output_busy_since.reset();
+}
+
+BOOL NamedPipeTransport::GetLogonSID(HANDLE hToken, PSID* ppsid)
+{
+    // From https://docs.microsoft.com/en-us/previous-versions/aa446670(v=vs.85)
+    BOOL bSuccess = FALSE;
+    DWORD dwIndex;
+    DWORD dwLength = 0;
+    PTOKEN_GROUPS ptg = NULL;
+
+    // Verify the parameter passed in is not NULL.
+    if (NULL == ppsid)
+        goto Cleanup;
+
+    // Get required buffer size and allocate the TOKEN_GROUPS buffer.
+
+    if (!GetTokenInformation(
+            hToken, // handle to the access token
+            TokenGroups, // get information about the token's groups
+            (LPVOID)ptg, // pointer to TOKEN_GROUPS buffer
+            0, // size of buffer
+            &dwLength // receives required buffer size
+            ))
+    {
+        if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+            goto Cleanup;
+
+        ptg = (PTOKEN_GROUPS)HeapAlloc(GetProcessHeap(),
+                                       HEAP_ZERO_MEMORY,
+                                       dwLength);
+
+        if (ptg == NULL)
+            goto Cleanup;
+    }
+
+    // Get the token group information from the access token.
+
+    if (!GetTokenInformation(
+            hToken, // handle to the access token
+            TokenGroups, // get information about the token's groups
+            (LPVOID)ptg, // pointer to TOKEN_GROUPS buffer
+            dwLength, // size of buffer
+            &dwLength // receives required buffer size
+            ))
+    {
+        goto Cleanup;
+    }
+
+    // Loop through the groups to find the logon SID.
+
+    for (dwIndex = 0; dwIndex < ptg->GroupCount; dwIndex++)
+        if ((ptg->Groups[dwIndex].Attributes & SE_GROUP_LOGON_ID) == SE_GROUP_LOGON_ID)
+        {
+            // Found the logon SID; make a copy of it.
+
+            dwLength = GetLengthSid(ptg->Groups[dwIndex].Sid);
+            *ppsid = (PSID)HeapAlloc(GetProcessHeap(),
+                                     HEAP_ZERO_MEMORY,
+                                     dwLength);
+            if (*ppsid == NULL)
+                goto Cleanup;
+            if (!CopySid(dwLength, *ppsid, ptg->Groups[dwIndex].Sid))
+            {
+                HeapFree(GetProcessHeap(), 0, (LPVOID)*ppsid);
+                goto Cleanup;
+            }
+            break;
+        }
+
+    bSuccess = TRUE;
+
+Cleanup:
+
+    // Free the buffer for the token groups.
+
+    if (ptg != NULL)
+        HeapFree(GetProcessHeap(), 0, (LPVOID)ptg);
+
+    return bSuccess;
+}
+
+VOID NamedPipeTransport::FreeLogonSID(PSID* ppsid)
+{
+    // From https://docs.microsoft.com/en-us/previous-versions/aa446670(v=vs.85)
+    HeapFree(GetProcessHeap(), 0, (LPVOID)*ppsid);
+}
+
+int NamedPipeTransport::change_pipe_security_allow_restricted_token(HANDLE handle, HANDLE token)
+{
+    PACL old_dacl, new_dacl;
+    PSECURITY_DESCRIPTOR sd;
+    EXPLICIT_ACCESS ea;
+    PSID user_restricted;
+    int error;
+
+    if (!GetLogonSID(token, &user_restricted))
+    {
+        error = 5; // No access error.
+        goto Ldone;
+    }
+
+    if (GetSecurityInfo(handle,
+                        SE_KERNEL_OBJECT,
+                        DACL_SECURITY_INFORMATION,
+                        NULL,
+                        NULL,
+                        &old_dacl,
+                        NULL,
+                        &sd))
+    {
+        error = GetLastError();
+        goto Lclean_sid;
+    }
+
+    memset(&ea, 0, sizeof(EXPLICIT_ACCESS));
+    ea.grfAccessPermissions |= GENERIC_READ | FILE_WRITE_ATTRIBUTES;
+    ea.grfAccessPermissions |= GENERIC_WRITE | FILE_READ_ATTRIBUTES;
+    ea.grfAccessPermissions |= SYNCHRONIZE;
+    ea.grfAccessMode = SET_ACCESS;
+    ea.grfInheritance = NO_INHERITANCE;
+    ea.Trustee.TrusteeForm = TRUSTEE_IS_SID;
+    ea.Trustee.TrusteeType = TRUSTEE_IS_USER;
+    ea.Trustee.ptstrName = (LPTSTR)user_restricted;
+
+    if (SetEntriesInAcl(1, &ea, old_dacl, &new_dacl))
+    {
+        error = GetLastError();
+        goto Lclean_sd;
+    }
+
+    if (SetSecurityInfo(handle,
+                        SE_KERNEL_OBJECT,
+                        DACL_SECURITY_INFORMATION,
+                        NULL,
+                        NULL,
+                        new_dacl,
+                        NULL))
+    {
+        error = GetLastError();
+        goto Lclean_dacl;
+    }
+
+    error = 0;
+
+Lclean_dacl:
+    LocalFree((HLOCAL)new_dacl);
+Lclean_sd:
+    LocalFree((HLOCAL)sd);
+Lclean_sid:
+    FreeLogonSID(&user_restricted);
+Ldone:
+    return error;
+}
+
+HANDLE NamedPipeTransport::create_medium_integrity_token()
+{
+    HANDLE restricted_token_handle;
+    SAFER_LEVEL_HANDLE level_handle = NULL;
+    DWORD sid_size = SECURITY_MAX_SID_SIZE;
+    BYTE medium_sid[SECURITY_MAX_SID_SIZE];
+    if (!SaferCreateLevel(SAFER_SCOPEID_USER, SAFER_LEVELID_NORMALUSER, SAFER_LEVEL_OPEN, &level_handle, NULL))
+    {
+        return NULL;
+    }
+    if (!SaferComputeTokenFromLevel(level_handle, NULL, &restricted_token_handle, 0, NULL))
+    {
+        SaferCloseLevel(level_handle);
+        return NULL;
+    }
+    SaferCloseLevel(level_handle);
+
+    if (!CreateWellKnownSid(WinMediumLabelSid, nullptr, medium_sid, &sid_size))
+    {
+        CloseHandle(restricted_token_handle);
+        return NULL;
+    }
+
+    TOKEN_MANDATORY_LABEL integrity_level = { 0 };
+    integrity_level.Label.Attributes = SE_GROUP_INTEGRITY;
+    integrity_level.Label.Sid = reinterpret_cast<PSID>(medium_sid);
+
+    if (!SetTokenInformation(restricted_token_handle, TokenIntegrityLevel, &integrity_level, sizeof(integrity_level)))
+    {
+        CloseHandle(restricted_token_handle);
+        return NULL;
+    }
+
+    return restricted_token_handle;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "ipc_transport.h"
+#include "ipc_framing.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Transport receiving messages on a named pipe server and sending them to the named pipe server of the other end.
+// Every connection stays open and carries any number of frames. All the pipe I/O is overlapped and done on a single thread.
+class NamedPipeTransport : public IpcTransport
+{
+public:
+    NamedPipeTransport(std::wstring _input_pipe_name, std::wstring _output_pipe_name);
+    ~NamedPipeTransport();
+
+    void start(HANDLE restricted_token, message_callback on_message) override;
+    void send(std::wstring message) override;
+    void stop() override;
+
+private:
+    // Client connected to the input pipe, with the buffer of its pending read
+    struct InputConnection
+    {
+        HANDLE pipe = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        bool read_pending = false;
+        std::vector<uint8_t> buffer;
+        ipc_framing::FrameDecoder decoder;
+    };
+
+    std::wstring input_pipe_name;
+    std::wstring output_pipe_name;
+    HANDLE restricted_token = NULL;
+    message_callback on_message;
+    std::thread io_thread;
+    std::atomic<bool> stopping = false;
+
+    // Messages queued by send, and the event waking the I/O thread up to send them or to stop
+    std::mutex output_mutex;
+    std::deque<std::wstring> output_messages;
+    HANDLE wake_event = NULL;
+
+    // State of the I/O thread
+    HANDLE listening_pipe = INVALID_HANDLE_VALUE;
+    OVERLAPPED listen_overlapped = {};
+    std::vector<std::unique_ptr<InputConnection>> connections;
+    HANDLE output_pipe = INVALID_HANDLE_VALUE;
+    OVERLAPPED write_overlapped = {};
+    bool write_pending = false;
+    std::optional<std::wstring> writing_message;
+    ipc_framing::frame_header writing_header = 0;
+    bool header_written = false;
+    bool write_retried = false;
+    std::optional<std::chrono::steady_clock::time_point> output_busy_since;
+
+    void run_io_thread();
+    void listen();
+    void complete_connect();
+    void accept_connection(HANDLE pipe);
+    bool start_read(InputConnection& connection);
+    void complete_read(size_t index);
+    void close_connection(size_t index);
+    void write_next();
+    bool connect_output();
+    bool start_write();
+    void complete_write();
+    void handle_write_error();
+    void close_output();
+    void close_all();
+
+    BOOL GetLogonSID(HANDLE hToken, PSID* ppsid);
+    VOID FreeLogonSID(PSID* ppsid);
+    int change_pipe_security_allow_restricted_token(HANDLE handle, HANDLE token);
+    HANDLE create_medium_integrity_token();
+};
@@ -46,10 +46,10 @@ namespace PTSettingsHelper
         return get_root_save_folder_location() + settings_filename;
     }
 
-    void save_module_settings(std::wstring_view powertoy_key, json::JsonObject& settings)
+    bool save_module_settings(std::wstring_view powertoy_key, json::JsonObject& settings)
     {
         const std::wstring save_file_location = get_module_save_file_location(powertoy_key);
-        json::to_file(save_file_location, settings);
+        return json::to_file(save_file_location, settings);
     }
 
     json::JsonObject load_module_settings(std::wstring_view powertoy_key)
@@ -59,10 +59,10 @@ namespace PTSettingsHelper
         return saved_settings.has_value() ? std::move(*saved_settings) : json::JsonObject{};
     }
 
-    void save_general_settings(const json::JsonObject& settings)
+    bool save_general_settings(const json::JsonObject& settings)
     {
         const std::wstring save_file_location = get_powertoys_general_save_file_location();
-        json::to_file(save_file_location, settings);
+        return json::to_file(save_file_location, settings);
     }
 
     json::JsonObject load_general_settings()
@@ -9,9 +9,10 @@ namespace PTSettingsHelper
     std::wstring get_module_save_folder_location(std::wstring_view powertoy_name);
     std::wstring get_root_save_folder_location();
 
-    void save_module_settings(std::wstring_view powertoy_name, json::JsonObject& settings);
+    // The save functions return false if the settings file was not written
+    bool save_module_settings(std::wstring_view powertoy_name, json::JsonObject& settings);
     json::JsonObject load_module_settings(std::wstring_view powertoy_name);
-    void save_general_settings(const json::JsonObject& settings);
+    bool save_general_settings(const json::JsonObject& settings);
     json::JsonObject load_general_settings();
 
 }
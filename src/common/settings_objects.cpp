@@ -292,7 +292,7 @@ namespace PowerToysSettings
         json::JsonObject jsonObject = json::JsonValue::Parse(json).GetObjectW();
         if (!jsonObject.HasKey(L"name"))
         {
-            throw winrt::hresult_error(E_NOT_SET, L"name field not set");
+            throw json::JsonError("name field not set");
         }
 
         result.m_json = json::JsonValue::Parse(json).GetObjectW();
@@ -364,7 +364,10 @@ namespace PowerToysSettings
     void PowerToyValues::save_to_settings_file()
     {
         set_version();
-        PTSettingsHelper::save_module_settings(_key, m_json);
+        if (!PTSettingsHelper::save_module_settings(_key, m_json))
+        {
+            throw json::JsonError("settings file could not be saved");
+        }
     }
 
     void PowerToyValues::set_version()
@@ -86,6 +86,7 @@ namespace PowerToysSettings
         json::JsonObject get_raw_json();
 
         std::wstring serialize();
+        // Throws json::JsonError if the settings file could not be written
         void save_to_settings_file();
 
     private:
@@ -0,0 +1,169 @@
+#include "pch.h"
+#include "shell_extension_settings.h"
+
+#include <Sddl.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const wchar_t SHARED_MEMORY_NAME[] = L"Local\\PowerToysShellExtensionSettings-3f0f7a52-5b1d-4cf6-9f2c-61e1c9a1d0b7";
+
+    // How long a process waits before trying to open the shared memory again after it didn't exist
+    const ULONGLONG OPEN_RETRY_INTERVAL_MS = 1000;
+
+    // The low byte of a module's value holds its flags and the rest its generation, so both are read with one load
+    const int GENERATION_SHIFT = 8;
+
+    struct SharedState
+    {
+        std::atomic<uint64_t> modules[static_cast<size_t>(ShellExtensionSettings::Module::Count)];
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "The shared memory is accessed from several processes");
+
+    // View of the shared memory in this module, unmapped when the module is unloaded
+    struct SharedStateView
+    {
+        std::atomic<SharedState*> state = nullptr;
+        std::atomic<ULONGLONG> next_open_attempt = 0;
+
+        ~SharedStateView()
+        {
+            if (auto view = state.load())
+            {
+                UnmapViewOfFile(view);
+            }
+        }
+    } shared_state_view;
+
+    SharedState* get_shared_state()
+    {
+        if (auto state = shared_state_view.state.load(std::memory_order_acquire))
+        {
+            return state;
+        }
+
+        const ULONGLONG now = GetTickCount64();
+        if (now < shared_state_view.next_open_attempt.load(std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        shared_state_view.next_open_attempt = now + OPEN_RETRY_INTERVAL_MS;
+
+        HANDLE mapping = OpenFileMappingW(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, SHARED_MEMORY_NAME);
+        if (!mapping)
+        {
+            return nullptr;
+        }
+
+        // The view keeps the shared memory alive, even after the runner exits
+        auto state = static_cast<SharedState*>(MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, sizeof(SharedState)));
+        CloseHandle(mapping);
+        if (!state)
+        {
+            return nullptr;
+        }
+
+        SharedState* expected = nullptr;
+        if (!shared_state_view.state.compare_exchange_strong(expected, state))
+        {
+            UnmapViewOfFile(state);
+            return expected;
+        }
+        return state;
+    }
+
+    // Explorer runs at medium integrity and has to be able to write to the shared memory, while the runner might be elevated.
+    std::wstring make_security_descriptor()
+    {
+        std::wstring result = L"D:(A;;GA;;;SY)(A;;GA;;;BA)";
+        HANDLE token = nullptr;
+        if (OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token))
+        {
+            DWORD size = 0;
+            GetTokenInformation(token, TokenUser, nullptr, 0, &size);
+            std::vector<uint8_t> buffer(size);
+            wchar_t* user_sid = nullptr;
+            if (size > 0 &&
+                GetTokenInformation(token, TokenUser, buffer.data(), size, &size) &&
+                ConvertSidToStringSidW(reinterpret_cast<TOKEN_USER*>(buffer.data())->User.Sid, &user_sid))
+            {
+                result += L"(A;;GA;;;";
+                result += user_sid;
+                result += L")";
+                LocalFree(user_sid);
+            }
+            CloseHandle(token);
+        }
+        return result + L"S:(ML;;NW;;;ME)";
+    }
+}
+
+namespace ShellExtensionSettings
+{
+    HANDLE create()
+    {
+        PSECURITY_DESCRIPTOR security_descriptor = nullptr;
+        if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(make_security_descriptor().c_str(), SDDL_REVISION_1, &security_descriptor, nullptr))
+        {
+            return nullptr;
+        }
+
+        SECURITY_ATTRIBUTES security_attributes{ sizeof(security_attributes), security_descriptor, FALSE };
+        HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, &security_attributes, PAGE_READWRITE, 0, sizeof(SharedState), SHARED_MEMORY_NAME);
+        LocalFree(security_descriptor);
+        return mapping;
+    }
+
+    std::optional<State> read(Module module)
+    {
+        auto state = get_shared_state();
+        if (!state)
+        {
+            return std::nullopt;
+        }
+
+        const uint64_t value = state->modules[static_cast<size_t>(module)].load(std::memory_order_acquire);
+        if (value == 0)
+        {
+            return std::nullopt;
+        }
+        return State{ value >> GENERATION_SHIFT, static_cast<uint8_t>(value) };
+    }
+
+    uint64_t publish(Module module, uint8_t flags)
+    {
+        auto state = get_shared_state();
+        if (!state)
+        {
+            return 0;
+        }
+
+        auto& value = state->modules[static_cast<size_t>(module)];
+        uint64_t current = value.load(std::memory_order_relaxed);
+        uint64_t generation;
+        do
+        {
+            generation = (current >> GENERATION_SHIFT) + 1;
+        } while (!value.compare_exchange_weak(current, (generation << GENERATION_SHIFT) | flags, std::memory_order_release, std::memory_order_relaxed));
+        return generation;
+    }
+
+    uint64_t publish_loaded(Module module, uint8_t flags)
+    {
+        auto state = get_shared_state();
+        if (!state)
+        {
+            return 0;
+        }
+
+        uint64_t expected = 0;
+        const uint64_t generation = 1;
+        if (!state->modules[static_cast<size_t>(module)].compare_exchange_strong(expected, (generation << GENERATION_SHIFT) | flags, std::memory_order_release, std::memory_order_relaxed))
+        {
+            return 0;
+        }
+        return generation;
+    }
+}
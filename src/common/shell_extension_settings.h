@@ -0,0 +1,44 @@
+#pragma once
+#include <Windows.h>
+#include <cstdint>
+#include <optional>
+
+// Generation counters and frequently read flags of the shell extensions' settings, kept in shared memory created by the runner.
+// Explorer checks them with a single atomic load on every context menu query, and the settings file is only parsed again
+// after its generation changed. Without the runner, the shell extensions fall back to checking the file's modification time.
+namespace ShellExtensionSettings
+{
+    enum class Module : uint32_t
+    {
+        PowerRename = 0,
+        ImageResizer,
+        Count
+    };
+
+    enum Flags : uint8_t
+    {
+        Enabled = 1,
+        ExtendedContextMenuOnly = 2,
+        ShowIcon = 4,
+    };
+
+    struct State
+    {
+        // Changes every time the settings are saved, never 0
+        uint64_t generation = 0;
+        uint8_t flags = 0;
+    };
+
+    // Creates the shared memory, or opens it if a shell extension still has it open. The runner keeps the returned handle until it exits.
+    HANDLE create();
+
+    // Returns the published state of the module's settings, or nothing if the shared memory doesn't exist or nothing was published yet.
+    std::optional<State> read(Module module);
+
+    // Publishes the flags of settings which were just saved, under a new generation. Returns the generation, or 0 without the shared memory.
+    uint64_t publish(Module module, uint8_t flags);
+
+    // Publishes the flags of settings loaded from their file, unless a state was already published.
+    // Returns the generation if the state was published by this call, or 0 otherwise.
+    uint64_t publish_loaded(Module module, uint8_t flags);
+}
@@ -1,4 +1,9 @@
 #pragma once
+#include <memory>
+#include <string>
+
+class IpcTransport;
+
 class TwoWayPipeMessageIPC
 {
 public:
@@ -7,6 +12,10 @@ public:
         std::wstring _input_pipe_name, 
         std::wstring _output_pipe_name, 
         callback_function p_func);
+    // Sends and receives the messages through the given transport instead of named pipes, e.g. one made by make_loopback_transports.
+    TwoWayPipeMessageIPC(
+        std::unique_ptr<IpcTransport> _transport,
+        callback_function p_func);
     ~TwoWayPipeMessageIPC();
     void send(std::wstring msg);
     void start(HANDLE _restricted_pipe_token);
@@ -62,10 +62,19 @@ namespace Microsoft.PowerToys.Settings.UI.Library.Utilities
             var watcher = FileSystem.FileSystemWatcher.CreateNew();
             watcher.Path = path;
             watcher.Filter = fileName;
-            watcher.NotifyFilter = NotifyFilters.LastWrite;
+            // The settings files are saved by writing a temporary file and renaming it over the previous one
+            watcher.NotifyFilter = NotifyFilters.LastWrite | NotifyFilters.FileName;
             watcher.EnableRaisingEvents = true;
 
             watcher.Changed += (o, e) => onChangedCallback();
+            watcher.Created += (o, e) => onChangedCallback();
+            watcher.Renamed += (o, e) =>
+            {
+                if (string.Equals(e.Name, fileName, StringComparison.OrdinalIgnoreCase))
+                {
+                    onChangedCallback();
+                }
+            };
 
             return watcher;
         }
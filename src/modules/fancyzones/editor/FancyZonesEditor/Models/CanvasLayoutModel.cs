@@ -201,7 +201,10 @@ namespace FancyZonesEditor.Models
             try
             {
                 string jsonString = JsonSerializer.Serialize(jsonObj, options);
-                FileSystem.File.WriteAllText(Settings.AppliedZoneSetTmpFile, jsonString);
+                if (!EditorHandoff.TryAppend(EditorHandoff.JournalRecordKind.AppliedZoneSet, jsonString))
+                {
+                    FileSystem.File.WriteAllText(Settings.AppliedZoneSetTmpFile, jsonString);
+                }
             }
             catch (Exception ex)
             {
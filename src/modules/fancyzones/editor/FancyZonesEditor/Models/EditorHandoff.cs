@@ -0,0 +1,116 @@
+﻿// Copyright (c) Microsoft Corporation
+// The Microsoft Corporation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+using System;
+using System.IO.MemoryMappedFiles;
+using System.Text;
+using System.Text.Json;
+
+namespace FancyZonesEditor.Models
+{
+    // Shared memory handoff with FancyZones
+    //  FancyZones publishes the edited work area and custom layouts before launching the editor.
+    //  Changes are appended to a journal which FancyZones applies once the editor exits.
+    //  Memory layout must be kept in sync with src/modules/fancyzones/lib/EditorHandoff.h
+    public static class EditorHandoff
+    {
+        public enum JournalRecordKind
+        {
+            ActiveZoneSet = 1,
+            AppliedZoneSet = 2,
+            DeletedCustomZoneSets = 3,
+        }
+
+        private const uint Magic = 0x48455A46;
+        private const uint Version = 1;
+
+        // Header field offsets
+        private const int MagicOffset = 0;
+        private const int VersionOffset = 4;
+        private const int SnapshotOffsetOffset = 12;
+        private const int SnapshotSizeOffset = 16;
+        private const int JournalOffsetOffset = 20;
+        private const int JournalCapacityOffset = 24;
+        private const int JournalSizeOffset = 28;
+        private const int JournalOverflowOffset = 32;
+
+        private const int RecordHeaderSize = 8;
+
+        private static MemoryMappedFile _mappedFile;
+        private static MemoryMappedViewAccessor _view;
+
+        // Parsed snapshot, null if the editor was started without shared memory handoff
+        public static JsonDocument Snapshot { get; private set; }
+
+        public static bool IsOpen
+        {
+            get { return _view != null; }
+        }
+
+        public static bool Open(string name)
+        {
+            try
+            {
+                _mappedFile = MemoryMappedFile.OpenExisting(name, MemoryMappedFileRights.ReadWrite);
+                _view = _mappedFile.CreateViewAccessor();
+
+                if (_view.ReadUInt32(MagicOffset) != Magic || _view.ReadUInt32(VersionOffset) != Version)
+                {
+                    Close();
+                    return false;
+                }
+
+                byte[] snapshot = new byte[_view.ReadUInt32(SnapshotSizeOffset)];
+                _view.ReadArray(_view.ReadUInt32(SnapshotOffsetOffset), snapshot, 0, snapshot.Length);
+                Snapshot = JsonDocument.Parse(snapshot);
+                return true;
+            }
+            catch (Exception)
+            {
+                Close();
+                return false;
+            }
+        }
+
+        public static void Close()
+        {
+            Snapshot = null;
+            _view?.Dispose();
+            _view = null;
+            _mappedFile?.Dispose();
+            _mappedFile = null;
+        }
+
+        // Returns false if the change couldn't be journaled and has to be written to the temp file instead.
+        // The journal is applied before the temp files, so once a change overflowed, all later changes go to the temp files too.
+        public static bool TryAppend(JournalRecordKind kind, string json)
+        {
+            if (!IsOpen || _view.ReadUInt32(JournalOverflowOffset) != 0)
+            {
+                return false;
+            }
+
+            byte[] payload = Encoding.UTF8.GetBytes(json);
+            long journalOffset = _view.ReadUInt32(JournalOffsetOffset);
+            long journalCapacity = _view.ReadUInt32(JournalCapacityOffset);
+            long journalSize = _view.ReadUInt32(JournalSizeOffset);
+            long recordSize = RecordHeaderSize + ((payload.Length + 3) & ~3);
+
+            if (journalSize + recordSize > journalCapacity)
+            {
+                _view.Write(JournalOverflowOffset, 1u);
+                return false;
+            }
+
+            long recordOffset = journalOffset + journalSize;
+            _view.Write(recordOffset, (uint)kind);
+            _view.Write(recordOffset + 4, (uint)payload.Length);
+            _view.WriteArray(recordOffset + RecordHeaderSize, payload, 0, payload.Length);
+
+            // Publish the record only once it's completely written
+            _view.Write(JournalSizeOffset, (uint)(journalSize + recordSize));
+            return true;
+        }
+    }
+}
@@ -197,7 +197,10 @@ namespace FancyZonesEditor.Models
             try
             {
                 string jsonString = JsonSerializer.Serialize(deletedLayouts, options);
-                FileSystem.File.WriteAllText(Settings.DeletedCustomZoneSetsTmpFile, jsonString);
+                if (!EditorHandoff.TryAppend(EditorHandoff.JournalRecordKind.DeletedCustomZoneSets, jsonString))
+                {
+                    FileSystem.File.WriteAllText(Settings.DeletedCustomZoneSetsTmpFile, jsonString);
+                }
             }
             catch (Exception ex)
             {
@@ -205,16 +208,24 @@ namespace FancyZonesEditor.Models
             }
         }
 
-        // Loads all the custom Layouts from tmp file passed by FancyZonesLib
+        // Loads all the custom Layouts from the snapshot shared by FancyZonesLib, or from the settings file
         public static ObservableCollection<LayoutModel> LoadCustomModels()
         {
             _customModels = new ObservableCollection<LayoutModel>();
 
             try
             {
-                Stream inputStream = FileSystem.File.Open(Settings.FancyZonesSettingsFile, FileMode.Open);
-                JsonDocument jsonObject = JsonDocument.Parse(inputStream, options: default);
-                JsonElement.ArrayEnumerator customZoneSetsEnumerator = jsonObject.RootElement.GetProperty(CustomZoneSetsJsonTag).EnumerateArray();
+                JsonElement.ArrayEnumerator customZoneSetsEnumerator;
+                if (EditorHandoff.Snapshot != null && EditorHandoff.Snapshot.RootElement.TryGetProperty(CustomZoneSetsJsonTag, out JsonElement customZoneSets))
+                {
+                    customZoneSetsEnumerator = customZoneSets.EnumerateArray();
+                }
+                else
+                {
+                    Stream inputStream = FileSystem.File.Open(Settings.FancyZonesSettingsFile, FileMode.Open);
+                    JsonDocument jsonObject = JsonDocument.Parse(inputStream, options: default);
+                    customZoneSetsEnumerator = jsonObject.RootElement.GetProperty(CustomZoneSetsJsonTag).EnumerateArray();
+                }
 
                 while (customZoneSetsEnumerator.MoveNext())
                 {
@@ -440,7 +451,10 @@ namespace FancyZonesEditor.Models
             try
             {
                 string jsonString = JsonSerializer.Serialize(zoneSet, options);
-                FileSystem.File.WriteAllText(Settings.ActiveZoneSetTmpFile, jsonString);
+                if (!EditorHandoff.TryAppend(EditorHandoff.JournalRecordKind.ActiveZoneSet, jsonString))
+                {
+                    FileSystem.File.WriteAllText(Settings.ActiveZoneSetTmpFile, jsonString);
+                }
             }
             catch (Exception ex)
             {
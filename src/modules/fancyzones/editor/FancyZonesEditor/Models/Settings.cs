@@ -24,6 +24,7 @@ namespace FancyZonesEditor
         {
             WorkAreaSize = 1,
             PowerToysPID,
+            EditorHandoffName,
         }
 
         private enum WorkAreaCmdArgElements
@@ -444,11 +445,22 @@ namespace FancyZonesEditor
                 ActiveZoneSetUUid = NullUuidStr;
                 JsonElement jsonObject = default(JsonElement);
 
-                if (_fileSystem.File.Exists(Settings.ActiveZoneSetTmpFile))
+                bool hasDeviceInfo = false;
+                if (EditorHandoff.Snapshot != null)
+                {
+                    jsonObject = EditorHandoff.Snapshot.RootElement;
+                    hasDeviceInfo = true;
+                }
+                else if (_fileSystem.File.Exists(Settings.ActiveZoneSetTmpFile))
                 {
                     Stream inputStream = _fileSystem.File.Open(Settings.ActiveZoneSetTmpFile, FileMode.Open);
                     jsonObject = JsonDocument.Parse(inputStream, options: default).RootElement;
                     inputStream.Close();
+                    hasDeviceInfo = true;
+                }
+
+                if (hasDeviceInfo)
+                {
                     UniqueKey = jsonObject.GetProperty(DeviceIdJsonTag).GetString();
                     ActiveZoneSetUUid = jsonObject.GetProperty(ActiveZoneSetJsonTag).GetProperty(UuidJsonTag).GetString();
                     layoutType = jsonObject.GetProperty(ActiveZoneSetJsonTag).GetProperty(TypeJsonTag).GetString();
@@ -518,7 +530,7 @@ namespace FancyZonesEditor
                     ((App)Application.Current).Shutdown();
                 }
             }
-            else if (args.Length == 3)
+            else if (args.Length == 3 || args.Length == 4)
             {
                 UsedWorkAreas.Clear();
                 foreach (var singleMonitorString in args[(int)CmdArgs.WorkAreaSize].Split('/'))
@@ -549,6 +561,13 @@ namespace FancyZonesEditor
                 }
 
                 int.TryParse(args[(int)CmdArgs.PowerToysPID], out _powerToysPID);
+
+                // FancyZones falls back to temp files if it couldn't share the data in memory
+                if (args.Length == 4)
+                {
+                    EditorHandoff.Open(args[(int)CmdArgs.EditorHandoffName]);
+                }
+
                 ParseDeviceInfoData();
             }
             else
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Immutable, reference-counted snapshot of a value, published RCU-style.
+ *
+ * Readers take a reference to the current snapshot without blocking and keep using it for as long as they hold
+ * it, even if a newer snapshot was published meanwhile. Writers serialize among themselves, build a modified copy
+ * and swap it in atomically, so a reader never observes a partially updated value and never waits for a writer.
+ */
+template<typename T>
+class AtomicSnapshot
+{
+public:
+    using Snapshot = std::shared_ptr<const T>;
+
+    AtomicSnapshot() :
+        m_snapshot(std::make_shared<const T>())
+    {
+    }
+
+    explicit AtomicSnapshot(T value) :
+        m_snapshot(std::make_shared<const T>(std::move(value)))
+    {
+    }
+
+    AtomicSnapshot(const AtomicSnapshot&) = delete;
+    AtomicSnapshot& operator=(const AtomicSnapshot&) = delete;
+
+    // Current snapshot, never null.
+    inline Snapshot Load() const noexcept
+    {
+        return m_snapshot.load(std::memory_order_acquire);
+    }
+
+    // Replaces the current snapshot with the given value.
+    void Store(T value)
+    {
+        auto snapshot = std::make_shared<const T>(std::move(value));
+        std::scoped_lock lock(m_writeMutex);
+        m_snapshot.store(std::move(snapshot), std::memory_order_release);
+    }
+
+    // Copies the current value, lets update modify the copy and publishes it. Concurrent writers are serialized,
+    // so no update is lost. Returns whatever update returns.
+    template<typename Fn>
+    auto Update(Fn&& update)
+    {
+        std::scoped_lock lock(m_writeMutex);
+        auto value = std::make_shared<T>(*m_snapshot.load(std::memory_order_relaxed));
+        if constexpr (std::is_void_v<decltype(update(*value))>)
+        {
+            update(*value);
+            m_snapshot.store(std::move(value), std::memory_order_release);
+        }
+        else
+        {
+            auto result = update(*value);
+            m_snapshot.store(std::move(value), std::memory_order_release);
+            return result;
+        }
+    }
+
+private:
+    std::atomic<Snapshot> m_snapshot;
+    std::mutex m_writeMutex;
+};
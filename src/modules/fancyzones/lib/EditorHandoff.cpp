@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "EditorHandoff.h"
+
+#include <cstring>
+
+namespace
+{
+    constexpr size_t Align(size_t size) noexcept
+    {
+        return (size + 3) & ~size_t{ 3 };
+    }
+
+    const EditorHandoff::Header* ValidHeader(const void* buffer, size_t bufferSize) noexcept
+    {
+        if (buffer == nullptr || bufferSize < sizeof(EditorHandoff::Header))
+        {
+            return nullptr;
+        }
+
+        auto header = static_cast<const EditorHandoff::Header*>(buffer);
+        if (header->magic != EditorHandoff::Magic || header->version != EditorHandoff::Version || header->totalSize > bufferSize)
+        {
+            return nullptr;
+        }
+
+        if (static_cast<size_t>(header->journalOffset) + header->journalCapacity > header->totalSize ||
+            header->journalSize > header->journalCapacity)
+        {
+            return nullptr;
+        }
+
+        return header;
+    }
+}
+
+namespace EditorHandoff
+{
+    size_t RequiredSize(size_t snapshotSize, size_t journalCapacity) noexcept
+    {
+        return sizeof(Header) + Align(snapshotSize) + Align(journalCapacity);
+    }
+
+    bool WriteSnapshot(void* buffer, size_t bufferSize, std::string_view snapshot, size_t journalCapacity) noexcept
+    {
+        const size_t totalSize = RequiredSize(snapshot.size(), journalCapacity);
+        if (buffer == nullptr || bufferSize < totalSize || totalSize > UINT32_MAX)
+        {
+            return false;
+        }
+
+        auto bytes = static_cast<uint8_t*>(buffer);
+        Header header{};
+        header.magic = Magic;
+        header.version = Version;
+        header.totalSize = static_cast<uint32_t>(totalSize);
+        header.snapshotOffset = sizeof(Header);
+        header.snapshotSize = static_cast<uint32_t>(snapshot.size());
+        header.journalOffset = static_cast<uint32_t>(sizeof(Header) + Align(snapshot.size()));
+        header.journalCapacity = static_cast<uint32_t>(Align(journalCapacity));
+
+        std::memcpy(bytes + header.snapshotOffset, snapshot.data(), snapshot.size());
+        std::memcpy(bytes, &header, sizeof(header));
+        return true;
+    }
+
+    bool AppendJournalRecord(void* buffer, size_t bufferSize, JournalRecordKind kind, std::string_view payload) noexcept
+    {
+        if (ValidHeader(buffer, bufferSize) == nullptr)
+        {
+            return false;
+        }
+
+        auto bytes = static_cast<uint8_t*>(buffer);
+        auto header = static_cast<Header*>(buffer);
+        if (header->journalOverflow != 0)
+        {
+            return false;
+        }
+
+        const size_t recordSize = sizeof(JournalRecordHeader) + Align(payload.size());
+        if (header->journalSize + recordSize > header->journalCapacity)
+        {
+            header->journalOverflow = 1;
+            return false;
+        }
+
+        uint8_t* record = bytes + header->journalOffset + header->journalSize;
+        const JournalRecordHeader recordHeader{ static_cast<uint32_t>(kind), static_cast<uint32_t>(payload.size()) };
+        std::memcpy(record, &recordHeader, sizeof(recordHeader));
+        std::memcpy(record + sizeof(recordHeader), payload.data(), payload.size());
+        header->journalSize += static_cast<uint32_t>(recordSize);
+        return true;
+    }
+
+    std::vector<JournalRecord> ReadJournal(const void* buffer, size_t bufferSize, bool& overflow)
+    {
+        std::vector<JournalRecord> result;
+        overflow = false;
+
+        const Header* header = ValidHeader(buffer, bufferSize);
+        if (header == nullptr)
+        {
+            return result;
+        }
+
+        overflow = header->journalOverflow != 0;
+
+        const uint8_t* journal = static_cast<const uint8_t*>(buffer) + header->journalOffset;
+        size_t offset = 0;
+        while (offset + sizeof(JournalRecordHeader) <= header->journalSize)
+        {
+            JournalRecordHeader recordHeader;
+            std::memcpy(&recordHeader, journal + offset, sizeof(recordHeader));
+            offset += sizeof(recordHeader);
+            if (offset + recordHeader.size > header->journalSize)
+            {
+                break;
+            }
+
+            const auto payload = reinterpret_cast<const char*>(journal + offset);
+            result.push_back(JournalRecord{ static_cast<JournalRecordKind>(recordHeader.kind), std::string(payload, recordHeader.size) });
+            offset += Align(recordHeader.size);
+        }
+
+        return result;
+    }
+
+    bool SharedMemory::Create(const std::wstring& name, std::string_view snapshot) noexcept
+    {
+        Close();
+
+        const size_t size = RequiredSize(snapshot.size());
+        wil::unique_handle mapping{ CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), name.c_str()) };
+        if (!mapping || GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            return false;
+        }
+
+        wil::unique_mapview_ptr<void> view{ MapViewOfFile(mapping.get(), FILE_MAP_ALL_ACCESS, 0, 0, size) };
+        if (!view || !WriteSnapshot(view.get(), size, snapshot))
+        {
+            return false;
+        }
+
+        m_mapping = std::move(mapping);
+        m_view = std::move(view);
+        m_size = size;
+        m_name = name;
+        return true;
+    }
+
+    void SharedMemory::Close() noexcept
+    {
+        m_view.reset();
+        m_mapping.reset();
+        m_size = 0;
+        m_name.clear();
+    }
+
+    std::vector<JournalRecord> SharedMemory::ReadJournal(bool& overflow) const
+    {
+        return EditorHandoff::ReadJournal(m_view.get(), m_size, overflow);
+    }
+}
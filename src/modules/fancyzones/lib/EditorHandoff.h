@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Shared memory handoff between FancyZones and FancyZonesEditor.
+ *
+ * Before launching the editor, FancyZones publishes a snapshot of the edited work area and the custom
+ * layouts (UTF-8 JSON) in a named file mapping. While running, the editor appends every change it would
+ * otherwise write to a temp file to the journal that follows the snapshot. Once the editor exits,
+ * FancyZones replays the journal. Temp files remain the fallback when the mapping can't be created or
+ * the journal is full.
+ *
+ * The memory layout must be kept in sync with FancyZonesEditor/Models/EditorHandoff.cs.
+ */
+namespace EditorHandoff
+{
+    constexpr uint32_t Magic = 0x48455A46; // "FZEH"
+    constexpr uint32_t Version = 1;
+    constexpr uint32_t DefaultJournalCapacity = 256 * 1024;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t totalSize;
+        uint32_t snapshotOffset;
+        uint32_t snapshotSize;
+        uint32_t journalOffset;
+        uint32_t journalCapacity;
+        // Written by the editor
+        uint32_t journalSize;
+        uint32_t journalOverflow;
+    };
+
+    enum class JournalRecordKind : uint32_t
+    {
+        ActiveZoneSet = 1,
+        AppliedZoneSet = 2,
+        DeletedCustomZoneSets = 3,
+    };
+
+    // Every journal record starts with this header, followed by the payload padded to 4 bytes.
+    struct JournalRecordHeader
+    {
+        uint32_t kind;
+        uint32_t size;
+    };
+
+    struct JournalRecord
+    {
+        JournalRecordKind kind;
+        std::string payload;
+    };
+
+    // Size of the shared memory needed to hold the given snapshot and journal.
+    size_t RequiredSize(size_t snapshotSize, size_t journalCapacity = DefaultJournalCapacity) noexcept;
+
+    // Lays out header and snapshot in the buffer. Returns false if the buffer is too small.
+    bool WriteSnapshot(void* buffer, size_t bufferSize, std::string_view snapshot, size_t journalCapacity = DefaultJournalCapacity) noexcept;
+
+    // Editor side of the protocol. Marks the journal as overflowed and returns false if the record doesn't fit.
+    // Once the journal overflowed, every later record is refused too, so that all changes after the overflow
+    // go to the temp files in the order they were made.
+    bool AppendJournalRecord(void* buffer, size_t bufferSize, JournalRecordKind kind, std::string_view payload) noexcept;
+
+    // Returns journal records in the order they were written. Malformed buffers yield no records.
+    std::vector<JournalRecord> ReadJournal(const void* buffer, size_t bufferSize, bool& overflow);
+
+    // Named file mapping owned by FancyZones for the duration of one editor session.
+    class SharedMemory
+    {
+    public:
+        bool Create(const std::wstring& name, std::string_view snapshot) noexcept;
+        void Close() noexcept;
+
+        inline bool IsOpen() const noexcept
+        {
+            return m_view != nullptr;
+        }
+
+        inline const std::wstring& Name() const noexcept
+        {
+            return m_name;
+        }
+
+        std::vector<JournalRecord> ReadJournal(bool& overflow) const;
+
+    private:
+        wil::unique_handle m_mapping;
+        wil::unique_mapview_ptr<void> m_view;
+        size_t m_size = 0;
+        std::wstring m_name;
+    };
+}
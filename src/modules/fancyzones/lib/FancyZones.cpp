@@ -15,10 +15,14 @@
 #include "lib/util.h"
 #include "trace.h"
 #include "VirtualDesktopUtils.h"
+#include "MonitorTopology.h"
 #include "MonitorWorkAreaHandler.h"
+#include "ReplayTrace.h"
 
 #include <lib/SecondaryMouseButtonsHook.h>
 
+#include <chrono>
+
 extern "C" IMAGE_DOS_HEADER __ImageBase;
 
 enum class DisplayChangeType
@@ -40,6 +44,9 @@ namespace NonLocalizable
     const wchar_t ToolWindowClassName[] = L"SuperFancyZones";
     const wchar_t FZEditorExecutablePath[] = L"modules\\FancyZones\\FancyZonesEditor.exe";
     const wchar_t SplashClassName[] = L"MsoSplash";
+    const wchar_t ReplayTraceVariable[] = L"POWERTOYS_FANCYZONES_REPLAY_TRACE";
+    const wchar_t ReplayTraceFileName[] = L"\\replay-trace.fzrt";
+    const wchar_t EditorHandoffNamePrefix[] = L"Local\\PowerToys_FancyZones_EditorHandoff_";
 }
 
 struct FancyZones : public winrt::implements<FancyZones, IFancyZones, IFancyZonesCallback, IZoneWindowHost>
@@ -63,30 +70,42 @@ public:
     IFACEMETHODIMP_(void)
     Destroy() noexcept;
 
+    // Drag handlers run on the FancyZones window thread and read work areas from a published snapshot,
+    // display and virtual desktop changes can't make them wait.
     void MoveSizeStart(HWND window, HMONITOR monitor, POINT const& ptScreen) noexcept
     {
-        std::unique_lock writeLock(m_lock);
         if (m_settings->GetSettings()->spanZonesAcrossMonitors)
         {
             monitor = NULL;
         }
-        m_windowMoveHandler.MoveSizeStart(window, monitor, ptScreen, m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId));
+        m_windowMoveHandler.MoveSizeStart(window, monitor, ptScreen, *m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId));
+
+        if (m_replayRecorder.IsOpen())
+        {
+            RecordReplayLayout();
+            RecordReplayEvent(ReplayTrace::EventKind::MoveSizeStart, monitor, ptScreen);
+        }
     }
 
     void MoveSizeUpdate(HMONITOR monitor, POINT const& ptScreen) noexcept
     {
-        std::unique_lock writeLock(m_lock);
         if (m_settings->GetSettings()->spanZonesAcrossMonitors)
         {
             monitor = NULL;
         }
-        m_windowMoveHandler.MoveSizeUpdate(monitor, ptScreen, m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId));
+        m_windowMoveHandler.MoveSizeUpdate(monitor, ptScreen, *m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId));
+        RecordReplayEvent(ReplayTrace::EventKind::MoveSizeUpdate, monitor, ptScreen);
     }
 
     void MoveSizeEnd(HWND window, POINT const& ptScreen) noexcept
     {
-        std::unique_lock writeLock(m_lock);
-        m_windowMoveHandler.MoveSizeEnd(window, ptScreen, m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId));
+        m_windowMoveHandler.MoveSizeEnd(window, ptScreen, *m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId));
+
+        if (m_replayRecorder.IsOpen())
+        {
+            RecordReplayEvent(ReplayTrace::EventKind::MoveSizeEnd, m_replayMonitor, ptScreen);
+            m_replayRecorder.Flush();
+        }
     }
 
     IFACEMETHODIMP_(void)
@@ -167,7 +186,6 @@ public:
     IFACEMETHODIMP_(bool)
     InMoveSize() noexcept
     {
-        std::shared_lock readLock(m_lock);
         return m_windowMoveHandler.InMoveSize();
     }
 
@@ -204,6 +222,7 @@ private:
     };
 
     void UpdateZoneWindows() noexcept;
+    void UpdateMonitorTopology() noexcept;
     void UpdateWindowsPositions() noexcept;
     void CycleActiveZoneSet(DWORD vkCode) noexcept;
     bool OnSnapHotkeyBasedOnZoneNumber(HWND window, DWORD vkCode) noexcept;
@@ -211,7 +230,7 @@ private:
     bool OnSnapHotkey(DWORD vkCode) noexcept;
     bool ProcessDirectedSnapHotkey(HWND window, DWORD vkCode, bool cycle, winrt::com_ptr<IZoneWindow> zoneWindow) noexcept;
 
-    void RegisterVirtualDesktopUpdates(std::vector<GUID>& ids) noexcept;
+    void RegisterVirtualDesktopUpdates(const std::vector<GUID>& ids) noexcept;
 
     bool IsSplashScreen(HWND window);
     bool ShouldProcessNewWindow(HWND window) noexcept;
@@ -223,21 +242,33 @@ private:
     void OnEditorExitEvent() noexcept;
     bool ShouldProcessSnapHotkey(DWORD vkCode) noexcept;
 
-    std::vector<std::pair<HMONITOR, RECT>> GetRawMonitorData() noexcept;
     std::vector<HMONITOR> GetMonitorsSorted() noexcept;
 
+    void RecordReplayLayout() noexcept;
+    void RecordReplayEvent(ReplayTrace::EventKind kind, HMONITOR monitor, POINT const& ptScreen, DWORD vkCode = 0) noexcept;
+
     const HINSTANCE m_hinstance{};
 
+    // Guards the window and the editor state. Work areas are published as snapshots by m_workAreaHandler.
     mutable std::shared_mutex m_lock;
     HWND m_window{};
     WindowMoveHandler m_windowMoveHandler;
     MonitorWorkAreaHandler m_workAreaHandler;
+    MonitorTopology m_monitorTopology; // Rebuilt on display and work area changes
+
+    // Drag and snap hotkey sessions are recorded for replay when POWERTOYS_FANCYZONES_REPLAY_TRACE is set
+    ReplayTrace::Recorder m_replayRecorder;
+    std::vector<HMONITOR> m_replayWorkAreas; // Monitors of the work areas in the last recorded layout
+    HMONITOR m_replayMonitor{}; // Monitor of the last recorded event
 
     winrt::com_ptr<IFancyZonesSettings> m_settings{};
     GUID m_previousDesktopId{}; // UUID of previously active virtual desktop.
     GUID m_currentDesktopId{}; // UUID of the current virtual desktop.
     wil::unique_handle m_terminateEditorEvent; // Handle of FancyZonesEditor.exe we launch and wait on
+    EditorHandoff::SharedMemory m_editorHandoff; // Layout data shared with FancyZonesEditor.exe while it's running
+    unsigned int m_editorLaunchCount = 0;
     wil::unique_handle m_terminateVirtualDesktopTrackerEvent;
+    wil::unique_handle m_virtualDesktopSwitchEvent; // Signaled to refresh virtual desktop state before handling a switch
 
     OnThreadExecutor m_dpiUnawareThread;
     OnThreadExecutor m_virtualDesktopTrackerThread;
@@ -291,6 +322,12 @@ FancyZones::Run() noexcept
 
     RegisterHotKey(m_window, 1, m_settings->GetSettings()->editorHotkey.get_modifiers(), m_settings->GetSettings()->editorHotkey.get_code());
 
+    if (GetEnvironmentVariableW(NonLocalizable::ReplayTraceVariable, nullptr, 0) > 0)
+    {
+        m_replayRecorder.Open(PTSettingsHelper::get_module_save_folder_location(L"FancyZones") + NonLocalizable::ReplayTraceFileName);
+    }
+
+    VirtualDesktopUtils::RefreshVirtualDesktopState();
     VirtualDesktopInitialize();
 
     m_dpiUnawareThread.submit(OnThreadExecutor::task_t{ [] {
@@ -300,7 +337,8 @@ FancyZones::Run() noexcept
         .wait();
 
     m_terminateVirtualDesktopTrackerEvent.reset(CreateEvent(nullptr, FALSE, FALSE, nullptr));
-    m_virtualDesktopTrackerThread.submit(OnThreadExecutor::task_t{ [&] { VirtualDesktopUtils::HandleVirtualDesktopUpdates(m_window, WM_PRIV_VD_UPDATE, m_terminateVirtualDesktopTrackerEvent.get()); } });
+    m_virtualDesktopSwitchEvent.reset(CreateEvent(nullptr, FALSE, FALSE, nullptr));
+    m_virtualDesktopTrackerThread.submit(OnThreadExecutor::task_t{ [&] { VirtualDesktopUtils::HandleVirtualDesktopUpdates(m_window, WM_PRIV_VD_UPDATE, WM_PRIV_VD_SWITCH, m_virtualDesktopSwitchEvent.get(), m_terminateVirtualDesktopTrackerEvent.get()); } });
 }
 
 // IFancyZones
@@ -326,8 +364,9 @@ IFACEMETHODIMP_(void)
 FancyZones::VirtualDesktopChanged() noexcept
 {
     // VirtualDesktopChanged is called from a reentrant WinHookProc function, therefore we must postpone the actual logic
-    // until we're in FancyZones::WndProc, which is not reentrant.
-    PostMessage(m_window, WM_PRIV_VD_SWITCH, 0, 0);
+    // until we're in FancyZones::WndProc, which is not reentrant. Virtual desktop tracker refreshes the cached virtual
+    // desktop state first and then posts WM_PRIV_VD_SWITCH.
+    SetEvent(m_virtualDesktopSwitchEvent.get());
 }
 
 // IFancyZonesCallback
@@ -343,7 +382,7 @@ bool FancyZones::ShouldProcessNewWindow(HWND window) noexcept
     // Avoid processing splash screens, already stamped (zoned) windows, or those windows
     // that belong to excluded applications list.
     if (IsSplashScreen(window) ||
-        (reinterpret_cast<size_t>(::GetProp(window, ZonedWindowProperties::PropertyMultipleZoneID)) != 0) ||
+        GetWindowStamp(window).Any() ||
         !IsCandidateForLastKnownZone(window, m_settings->GetSettings()->excludedAppsArray))
     {
         return false;
@@ -384,7 +423,7 @@ std::pair<winrt::com_ptr<IZoneWindow>, std::vector<size_t>> FancyZones::GetAppZo
 std::pair<winrt::com_ptr<IZoneWindow>, std::vector<size_t>> FancyZones::GetAppZoneHistoryInfo(HWND window, HMONITOR monitor, bool isPrimaryMonitor) noexcept
 {
     std::pair<winrt::com_ptr<IZoneWindow>, std::vector<size_t>> appZoneHistoryInfo{ nullptr, {} };
-    auto workAreaMap = m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId);
+    auto workAreaMap = *m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId);
 
     // Search application history on currently active monitor.
     appZoneHistoryInfo = GetAppZoneHistoryInfo(window, monitor, workAreaMap);
@@ -615,8 +654,6 @@ void FancyZones::ToggleEditor() noexcept
 
     winrt::com_ptr<IZoneWindow> zoneWindow;
 
-    std::shared_lock readLock(m_lock);
-
     if (m_settings->GetSettings()->spanZonesAcrossMonitors)
     {
         zoneWindow = m_workAreaHandler.GetWorkArea(m_currentDesktopId, NULL);
@@ -635,19 +672,14 @@ void FancyZones::ToggleEditor() noexcept
 
     if (m_settings->GetSettings()->spanZonesAcrossMonitors)
     {
-        std::vector<std::pair<HMONITOR, RECT>> allMonitors;
-
-        m_dpiUnawareThread.submit(OnThreadExecutor::task_t{ [&] {
-                              allMonitors = FancyZonesUtils::GetAllMonitorRects<&MONITORINFOEX::rcWork>();
-                          } })
-            .wait();
+        const auto& allMonitors = m_monitorTopology.Monitors();
 
         UINT currentDpi = 0;
         for (const auto& monitor : allMonitors)
         {
             UINT dpiX = 0;
             UINT dpiY = 0;
-            if (GetDpiForMonitor(monitor.first, MDT_EFFECTIVE_DPI, &dpiX, &dpiY) == S_OK)
+            if (GetDpiForMonitor(monitor.monitor, MDT_EFFECTIVE_DPI, &dpiX, &dpiY) == S_OK)
             {
                 if (currentDpi == 0)
                 {
@@ -665,8 +697,9 @@ void FancyZones::ToggleEditor() noexcept
             }
         }
 
-        for (auto& [monitor, workArea] : allMonitors)
+        for (const auto& monitor : allMonitors)
         {
+            const auto& workArea = monitor.dpiUnawareWorkAreaRect;
             const auto x = workArea.left;
             const auto y = workArea.top;
             const auto width = workArea.right - workArea.left;
@@ -690,18 +723,28 @@ void FancyZones::ToggleEditor() noexcept
     }
     else
     {
-        MONITORINFOEX mi;
-        mi.cbSize = sizeof(mi);
+        RECT workArea{};
+        if (const auto* info = m_monitorTopology.Find(monitor))
+        {
+            workArea = info->dpiUnawareWorkAreaRect;
+        }
+        else
+        {
+            // Display change not processed yet
+            MONITORINFOEX mi;
+            mi.cbSize = sizeof(mi);
 
-        m_dpiUnawareThread.submit(OnThreadExecutor::task_t{ [&] {
-                              GetMonitorInfo(monitor, &mi);
-                          } })
-            .wait();
+            m_dpiUnawareThread.submit(OnThreadExecutor::task_t{ [&] {
+                                  GetMonitorInfo(monitor, &mi);
+                              } })
+                .wait();
+            workArea = mi.rcWork;
+        }
 
-        const auto x = mi.rcWork.left;
-        const auto y = mi.rcWork.top;
-        const auto width = mi.rcWork.right - mi.rcWork.left;
-        const auto height = mi.rcWork.bottom - mi.rcWork.top;
+        const auto x = workArea.left;
+        const auto y = workArea.top;
+        const auto width = workArea.right - workArea.left;
+        const auto height = workArea.bottom - workArea.top;
         editorLocation =
             std::to_wstring(x) + L"_" +
             std::to_wstring(y) + L"_" +
@@ -711,14 +754,31 @@ void FancyZones::ToggleEditor() noexcept
 
     const auto& fancyZonesData = FancyZonesDataInstance();
 
-    if (!fancyZonesData.SerializeDeviceInfoToTmpFile(zoneWindow->UniqueId()))
+    // Prefer handing the layout data over in shared memory, temp files are the fallback
+    const auto handoffStart = std::chrono::steady_clock::now();
+    const auto snapshot = fancyZonesData.SerializeEditorSnapshot(zoneWindow->UniqueId());
+    if (!snapshot.has_value())
     {
         return;
     }
 
-    const std::wstring params =
+    const std::wstring handoffName = NonLocalizable::EditorHandoffNamePrefix + std::to_wstring(GetCurrentProcessId()) + L"_" + std::to_wstring(++m_editorLaunchCount);
+    const bool sharedMemoryHandoff = m_editorHandoff.Create(handoffName, *snapshot);
+    if (!sharedMemoryHandoff && !fancyZonesData.SerializeDeviceInfoToTmpFile(zoneWindow->UniqueId()))
+    {
+        return;
+    }
+
+    const auto handoffDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - handoffStart);
+    Trace::FancyZones::EditorHandoffPublished(sharedMemoryHandoff, snapshot->size(), handoffDuration.count());
+
+    std::wstring params =
         /*1*/ editorLocation + L" " +
         /*2*/ L"\"" + std::to_wstring(GetCurrentProcessId()) + L"\"";
+    if (sharedMemoryHandoff)
+    {
+        /*3*/ params += L" \"" + handoffName + L"\"";
+    }
 
     SHELLEXECUTEINFO sei{ sizeof(sei) };
     sei.fMask = { SEE_MASK_NOCLOSEPROCESS | SEE_MASK_FLAG_NO_UI };
@@ -826,10 +886,16 @@ LRESULT FancyZones::WndProc(HWND window, UINT message, WPARAM wparam, LPARAM lpa
         }
         else if (message == WM_PRIV_VD_UPDATE)
         {
-            std::vector<GUID> ids{};
-            if (VirtualDesktopUtils::GetVirtualDesktopIds(ids))
+            const auto state = VirtualDesktopUtils::GetVirtualDesktopState();
+            if (!state->ids.empty())
             {
-                RegisterVirtualDesktopUpdates(ids);
+                RegisterVirtualDesktopUpdates(state->ids);
+            }
+
+            // Explorer may persist the current virtual desktop only after the switch was handled
+            if (state->currentId.has_value() && *state->currentId != m_currentDesktopId)
+            {
+                OnDisplayChange(DisplayChangeType::VirtualDesktop);
             }
         }
         else if (message == WM_PRIV_EDITOR)
@@ -844,6 +910,8 @@ LRESULT FancyZones::WndProc(HWND window, UINT message, WPARAM wparam, LPARAM lpa
                 std::unique_lock writeLock(m_lock);
                 m_terminateEditorEvent.release();
             }
+
+            m_editorHandoff.Close();
         }
         else if (message == WM_PRIV_MOVESIZESTART)
         {
@@ -882,6 +950,11 @@ LRESULT FancyZones::WndProc(HWND window, UINT message, WPARAM wparam, LPARAM lpa
 
 void FancyZones::OnDisplayChange(DisplayChangeType changeType) noexcept
 {
+    if (changeType != DisplayChangeType::VirtualDesktop)
+    {
+        UpdateMonitorTopology();
+    }
+
     if (changeType == DisplayChangeType::VirtualDesktop ||
         changeType == DisplayChangeType::Initialization)
     {
@@ -919,8 +992,6 @@ void FancyZones::OnDisplayChange(DisplayChangeType changeType) noexcept
 
 void FancyZones::AddZoneWindow(HMONITOR monitor, const std::wstring& deviceId) noexcept
 {
-    std::unique_lock writeLock(m_lock);
-
     if (m_workAreaHandler.IsNewWorkArea(m_currentDesktopId, monitor))
     {
         wil::unique_cotaskmem_string virtualDesktopId;
@@ -1024,24 +1095,46 @@ void FancyZones::UpdateZoneWindows() noexcept
     }
 }
 
+void FancyZones::UpdateMonitorTopology() noexcept
+{
+    std::vector<MonitorTopology::Monitor> monitors;
+    for (const auto& [monitor, monitorRect] : FancyZonesUtils::GetAllMonitorRects<&MONITORINFOEX::rcMonitor>())
+    {
+        MONITORINFOEX mi;
+        mi.cbSize = sizeof(mi);
+        if (GetMonitorInfo(monitor, &mi))
+        {
+            monitors.push_back({ monitor, monitorRect, mi.rcWork, mi.rcWork });
+        }
+    }
+
+    // The editor is DPI unaware and expects its work areas in virtualized coordinates
+    m_dpiUnawareThread.submit(OnThreadExecutor::task_t{ [&] {
+                          for (auto& monitor : monitors)
+                          {
+                              MONITORINFOEX mi;
+                              mi.cbSize = sizeof(mi);
+                              if (GetMonitorInfo(monitor.monitor, &mi))
+                              {
+                                  monitor.dpiUnawareWorkAreaRect = mi.rcWork;
+                              }
+                          }
+                      } })
+        .wait();
+
+    m_monitorTopology = MonitorTopology(std::move(monitors));
+}
+
 void FancyZones::UpdateWindowsPositions() noexcept
 {
     auto callback = [](HWND window, LPARAM data) -> BOOL {
-        size_t bitmask = reinterpret_cast<size_t>(::GetProp(window, ZonedWindowProperties::PropertyMultipleZoneID));
+        const auto zones = FancyZonesUtils::GetWindowStamp(window);
 
-        if (bitmask != 0)
+        if (zones.Any())
         {
-            std::vector<size_t> indexSet;
-            for (int i = 0; i < std::numeric_limits<size_t>::digits; i++)
-            {
-                if ((1ull << i) & bitmask)
-                {
-                    indexSet.push_back(i);
-                }
-            }
+            const auto indexSet = zones.ToIndexSet();
 
             auto strongThis = reinterpret_cast<FancyZones*>(data);
-            std::unique_lock writeLock(strongThis->m_lock);
             auto zoneWindow = strongThis->m_workAreaHandler.GetWorkArea(window);
             if (zoneWindow)
             {
@@ -1061,8 +1154,6 @@ void FancyZones::CycleActiveZoneSet(DWORD vkCode) noexcept
         const HMONITOR monitor = MonitorFromWindow(window, MONITOR_DEFAULTTONULL);
         if (monitor)
         {
-            std::shared_lock readLock(m_lock);
-
             auto zoneWindow = m_workAreaHandler.GetWorkArea(m_currentDesktopId, monitor);
             if (zoneWindow)
             {
@@ -1086,40 +1177,24 @@ bool FancyZones::OnSnapHotkeyBasedOnZoneNumber(HWND window, DWORD vkCode) noexce
     }
 
     std::vector<HMONITOR> monitorInfo = GetMonitorsSorted();
-    if (current && monitorInfo.size() > 1 && m_settings->GetSettings()->moveWindowAcrossMonitors)
+    if (current && monitorInfo.size() > 1 && m_settings->GetSettings()->moveWindowAcrossMonitors && m_monitorTopology.Find(current))
     {
         // Multi monitor environment.
-        auto currMonitorInfo = std::find(std::begin(monitorInfo), std::end(monitorInfo), current);
+        // Monitors without an active zone set are stepped over, they can't take the window.
+        HMONITOR currMonitor = current;
         do
         {
-            std::unique_lock writeLock(m_lock);
-            if (m_windowMoveHandler.MoveWindowIntoZoneByDirectionAndIndex(window, vkCode, false /* cycle through zones */, m_workAreaHandler.GetWorkArea(m_currentDesktopId, *currMonitorInfo)))
+            if (m_windowMoveHandler.MoveWindowIntoZoneByDirectionAndIndex(window, vkCode, false /* cycle through zones */, m_workAreaHandler.GetWorkArea(m_currentDesktopId, currMonitor)))
             {
                 return true;
             }
             // We iterated through all zones in current monitor zone layout, move on to next one (or previous depending on direction).
-            if (vkCode == VK_RIGHT)
-            {
-                currMonitorInfo = std::next(currMonitorInfo);
-                if (currMonitorInfo == std::end(monitorInfo))
-                {
-                    currMonitorInfo = std::begin(monitorInfo);
-                }
-            }
-            else if (vkCode == VK_LEFT)
-            {
-                if (currMonitorInfo == std::begin(monitorInfo))
-                {
-                    currMonitorInfo = std::end(monitorInfo);
-                }
-                currMonitorInfo = std::prev(currMonitorInfo);
-            }
-        } while (*currMonitorInfo != current);
+            currMonitor = m_monitorTopology.Neighbour(currMonitor, vkCode);
+        } while (currMonitor && currMonitor != current);
     }
     else
     {
         // Single monitor environment, or combined multi-monitor environment.
-        std::unique_lock writeLock(m_lock);
         if (m_settings->GetSettings()->restoreSize)
         {
             bool moved = m_windowMoveHandler.MoveWindowIntoZoneByDirectionAndIndex(window, vkCode, false /* cycle through zones */, m_workAreaHandler.GetWorkArea(m_currentDesktopId, current));
@@ -1152,7 +1227,7 @@ bool FancyZones::OnSnapHotkeyBasedOnPosition(HWND window, DWORD vkCode) noexcept
         current = MonitorFromWindow(window, MONITOR_DEFAULTTONULL);
     }
 
-    auto allMonitors = FancyZonesUtils::GetAllMonitorRects<&MONITORINFOEX::rcWork>();
+    const auto& allMonitors = m_monitorTopology.Monitors();
 
     if (current && allMonitors.size() > 1 && m_settings->GetSettings()->moveWindowAcrossMonitors)
     {
@@ -1169,8 +1244,10 @@ bool FancyZones::OnSnapHotkeyBasedOnPosition(HWND window, DWORD vkCode) noexcept
         std::vector<std::pair<size_t, winrt::com_ptr<IZoneWindow>>> zoneRectsInfo;
         RECT currentMonitorRect{ .top = 0, .bottom = -1 };
 
-        for (const auto& [monitor, monitorRect] : allMonitors)
+        for (const auto& info : allMonitors)
         {
+            const HMONITOR monitor = info.monitor;
+            const RECT& monitorRect = info.workAreaRect;
             if (monitor == current)
             {
                 currentMonitorRect = monitorRect;
@@ -1251,7 +1328,7 @@ bool FancyZones::OnSnapHotkeyBasedOnPosition(HWND window, DWORD vkCode) noexcept
             return false;
         }
 
-        RECT combinedRect = FancyZonesUtils::GetAllMonitorsCombinedRect<&MONITORINFOEX::rcWork>();
+        const RECT& combinedRect = m_monitorTopology.CombinedWorkAreaRect();
         windowRect = FancyZonesUtils::PrepareRectForCycling(windowRect, combinedRect, vkCode);
         chosenIdx = FancyZonesUtils::ChooseNextZoneByPosition(vkCode, windowRect, zoneRects);
         if (chosenIdx < zoneRects.size())
@@ -1279,6 +1356,16 @@ bool FancyZones::OnSnapHotkey(DWORD vkCode) noexcept
     auto window = GetForegroundWindow();
     if (FancyZonesUtils::IsCandidateForZoning(window, m_settings->GetSettings()->excludedAppsArray))
     {
+        if (m_replayRecorder.IsOpen())
+        {
+            POINT ptScreen{};
+            GetCursorPos(&ptScreen);
+            const HMONITOR monitor = m_settings->GetSettings()->spanZonesAcrossMonitors ? NULL : MonitorFromWindow(window, MONITOR_DEFAULTTONULL);
+            RecordReplayLayout();
+            RecordReplayEvent(ReplayTrace::EventKind::SnapHotkey, monitor, ptScreen, vkCode);
+            m_replayRecorder.Flush();
+        }
+
         if (m_settings->GetSettings()->moveWindowsBasedOnPosition)
         {
             return OnSnapHotkeyBasedOnPosition(window, vkCode);
@@ -1304,10 +1391,8 @@ bool FancyZones::ProcessDirectedSnapHotkey(HWND window, DWORD vkCode, bool cycle
     }
 }
 
-void FancyZones::RegisterVirtualDesktopUpdates(std::vector<GUID>& ids) noexcept
+void FancyZones::RegisterVirtualDesktopUpdates(const std::vector<GUID>& ids) noexcept
 {
-    std::unique_lock writeLock(m_lock);
-
     m_workAreaHandler.RegisterUpdates(ids);
     std::vector<std::wstring> active{};
     if (VirtualDesktopUtils::GetVirtualDesktopIds(active))
@@ -1330,7 +1415,13 @@ bool FancyZones::IsSplashScreen(HWND window)
 void FancyZones::OnEditorExitEvent() noexcept
 {
     // Collect information about changes in zone layout after editor exited.
-    FancyZonesDataInstance().ParseDataFromTmpFiles();
+    const auto handoffStart = std::chrono::steady_clock::now();
+    bool journalOverflow = false;
+    const auto journal = m_editorHandoff.ReadJournal(journalOverflow);
+    FancyZonesDataInstance().ParseDataFromEditorJournal(journal);
+
+    const auto handoffDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - handoffStart);
+    Trace::FancyZones::EditorHandoffCollected(m_editorHandoff.IsOpen(), journal.size(), journalOverflow, handoffDuration.count());
 
     for (auto workArea : m_workAreaHandler.GetAllWorkAreas())
     {
@@ -1374,32 +1465,73 @@ bool FancyZones::ShouldProcessSnapHotkey(DWORD vkCode) noexcept
 
 std::vector<HMONITOR> FancyZones::GetMonitorsSorted() noexcept
 {
-    std::shared_lock readLock(m_lock);
-
-    auto monitorInfo = GetRawMonitorData();
-    FancyZonesUtils::OrderMonitors(monitorInfo);
+    // Monitors with an active zone set, in the cached cycling order
     std::vector<HMONITOR> output;
-    std::transform(std::begin(monitorInfo), std::end(monitorInfo), std::back_inserter(output), [](const auto& info) { return info.first; });
+    const auto activeWorkAreaMap = m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId);
+    for (HMONITOR monitor : m_monitorTopology.SortedMonitors())
+    {
+        auto workArea = activeWorkAreaMap->find(monitor);
+        if (workArea != activeWorkAreaMap->end() && workArea->second->ActiveZoneSet() != nullptr)
+        {
+            output.push_back(monitor);
+        }
+    }
     return output;
 }
 
-std::vector<std::pair<HMONITOR, RECT>> FancyZones::GetRawMonitorData() noexcept
+void FancyZones::RecordReplayLayout() noexcept
 {
-    std::shared_lock readLock(m_lock);
+    ReplayTrace::Layout layout;
+    m_replayWorkAreas.clear();
 
-    std::vector<std::pair<HMONITOR, RECT>> monitorInfo;
-    const auto& activeWorkAreaMap = m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId);
-    for (const auto& [monitor, workArea] : activeWorkAreaMap)
+    for (const auto& [monitor, workArea] : *m_workAreaHandler.GetWorkAreasByDesktopId(m_currentDesktopId))
     {
-        if (workArea->ActiveZoneSet() != nullptr)
+        const auto* monitorInfo = m_monitorTopology.Find(monitor);
+        const RECT workAreaRect = monitorInfo ? monitorInfo->workAreaRect : m_monitorTopology.CombinedWorkAreaRect();
+
+        ReplayTrace::WorkArea replayWorkArea{ { workAreaRect.left, workAreaRect.top, workAreaRect.right, workAreaRect.bottom } };
+        if (const auto deviceInfo = FancyZonesDataInstance().FindDeviceInfo(workArea->UniqueId()))
         {
-            MONITORINFOEX mi;
-            mi.cbSize = sizeof(mi);
-            GetMonitorInfo(monitor, &mi);
-            monitorInfo.push_back({ monitor, mi.rcMonitor });
+            replayWorkArea.sensitivityRadius = deviceInfo->sensitivityRadius;
         }
+        if (const auto zoneSet = workArea->ActiveZoneSet())
+        {
+            for (const auto& [id, zone] : zoneSet->GetZones())
+            {
+                const RECT zoneRect = zone->GetZoneRect();
+                replayWorkArea.zones.push_back({ static_cast<uint32_t>(id), { zoneRect.left, zoneRect.top, zoneRect.right, zoneRect.bottom } });
+            }
+        }
+
+        layout.workAreas.push_back(std::move(replayWorkArea));
+        m_replayWorkAreas.push_back(monitor);
+    }
+
+    m_replayRecorder.RecordLayout(layout);
+}
+
+void FancyZones::RecordReplayEvent(ReplayTrace::EventKind kind, HMONITOR monitor, POINT const& ptScreen, DWORD vkCode) noexcept
+{
+    if (!m_replayRecorder.IsOpen())
+    {
+        return;
     }
-    return monitorInfo;
+
+    m_replayMonitor = monitor;
+    const auto it = std::find(std::begin(m_replayWorkAreas), std::end(m_replayWorkAreas), monitor);
+    const uint32_t workArea = it != std::end(m_replayWorkAreas) ? static_cast<uint32_t>(std::distance(std::begin(m_replayWorkAreas), it)) : ReplayTrace::NoWorkArea;
+
+    uint32_t modifiers = 0;
+    if (m_windowMoveHandler.IsDragEnabled())
+    {
+        modifiers |= ReplayTrace::DragEnabled;
+    }
+    if (m_windowMoveHandler.IsSelectManyZonesEnabled())
+    {
+        modifiers |= ReplayTrace::SelectManyZones;
+    }
+
+    m_replayRecorder.RecordEvent(kind, workArea, ptScreen.x, ptScreen.y, modifiers, vkCode);
 }
 
 winrt::com_ptr<IFancyZones> MakeFancyZones(HINSTANCE hinstance,
@@ -4,6 +4,7 @@
 #include "JsonHelpers.h"
 #include "ZoneSet.h"
 #include "Settings.h"
+#include "util.h"
 
 #include <common/common.h>
 #include <common/json.h>
@@ -381,10 +382,10 @@ bool FancyZonesData::RemoveAppLastZone(HWND window, const std::wstring_view& dev
                     }
 
                     // if there is another instance of same application placed in the same zone don't erase history
-                    size_t windowZoneStamp = reinterpret_cast<size_t>(::GetProp(window, ZonedWindowProperties::PropertyMultipleZoneID));
+                    const auto windowZoneStamp = FancyZonesUtils::GetWindowStamp(window);
                     for (auto placedWindow : data->processIdToHandleMap)
                     {
-                        size_t placedWindowZoneStamp = reinterpret_cast<size_t>(::GetProp(placedWindow.second, ZonedWindowProperties::PropertyMultipleZoneID));
+                        const auto placedWindowZoneStamp = FancyZonesUtils::GetWindowStamp(placedWindow.second);
                         if (IsWindow(placedWindow.second) && (windowZoneStamp == placedWindowZoneStamp))
                         {
                             return false;
@@ -500,6 +501,65 @@ void FancyZonesData::ParseDataFromTmpFiles()
     SaveFancyZonesData();
 }
 
+std::optional<std::string> FancyZonesData::SerializeEditorSnapshot(const std::wstring& uniqueId) const
+{
+    std::scoped_lock lock{ dataLock };
+    const auto deviceInfo = FindDeviceInfo(uniqueId);
+    if (!deviceInfo.has_value())
+    {
+        return std::nullopt;
+    }
+
+    JSONHelpers::DeviceInfoJSON deviceInfoJson{ uniqueId, *deviceInfo };
+    return winrt::to_string(JSONHelpers::SerializeEditorSnapshot(deviceInfoJson, customZoneSetsMap).Stringify());
+}
+
+void FancyZonesData::ParseDataFromEditorJournal(const std::vector<EditorHandoff::JournalRecord>& journal)
+{
+    {
+        std::scoped_lock lock{ dataLock };
+        for (const auto& record : journal)
+        {
+            json::JsonObject recordJson;
+            if (!json::JsonObject::TryParse(winrt::to_hstring(record.payload), recordJson))
+            {
+                continue;
+            }
+
+            try
+            {
+                switch (record.kind)
+                {
+                case EditorHandoff::JournalRecordKind::ActiveZoneSet:
+                    if (auto deviceInfo = JSONHelpers::DeviceInfoJSON::FromJson(recordJson); deviceInfo.has_value())
+                    {
+                        deviceInfoMap[deviceInfo->deviceId] = std::move(deviceInfo->data);
+                    }
+                    break;
+                case EditorHandoff::JournalRecordKind::AppliedZoneSet:
+                    if (auto customZoneSet = JSONHelpers::CustomZoneSetJSON::FromJson(recordJson); customZoneSet.has_value())
+                    {
+                        customZoneSetsMap[customZoneSet->uuid] = std::move(customZoneSet->data);
+                    }
+                    break;
+                case EditorHandoff::JournalRecordKind::DeletedCustomZoneSets:
+                    for (const auto& zoneSet : JSONHelpers::ParseDeletedCustomZoneSets(recordJson))
+                    {
+                        customZoneSetsMap.erase(zoneSet);
+                    }
+                    break;
+                }
+            }
+            catch (const json::JsonError&)
+            {
+            }
+        }
+    }
+
+    // Changes which didn't fit in the journal were written to temp files
+    ParseDataFromTmpFiles();
+}
+
 void FancyZonesData::ParseDeviceInfoFromTmpFile(std::wstring_view tmpFilePath)
 {
     std::scoped_lock lock{ dataLock };
@@ -543,8 +603,9 @@ void FancyZonesData::LoadFancyZonesData()
     {
         SaveFancyZonesData();
     }
-    else
+    else if (!JSONHelpers::LoadFancyZonesData(zonesSettingsFileName, appZoneHistoryFileName, appZoneHistoryMap, deviceInfoMap, customZoneSetsMap))
     {
+        // Fall back to the DOM based parser for files the streaming loader can't read
         json::JsonObject fancyZonesDataJSON = GetPersistFancyZonesJSON();
 
         appZoneHistoryMap = JSONHelpers::ParseAppZoneHistory(fancyZonesDataJSON);
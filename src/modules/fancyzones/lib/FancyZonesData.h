@@ -1,5 +1,6 @@
 #pragma once
 
+#include "EditorHandoff.h"
 #include "JsonHelpers.h"
 
 #include <common/settings_helpers.h>
@@ -29,6 +30,11 @@ namespace FancyZonesUnitTests
     class ZoneWindowUnitTests;
     class ZoneWindowCreationUnitTests;
 }
+
+namespace ReplayHarness
+{
+    class Replayer;
+}
 #endif
 
 class FancyZonesData
@@ -74,6 +80,9 @@ public:
     bool SerializeDeviceInfoToTmpFile(const std::wstring& uniqueId) const;
     void ParseDataFromTmpFiles();
 
+    std::optional<std::string> SerializeEditorSnapshot(const std::wstring& uniqueId) const;
+    void ParseDataFromEditorJournal(const std::vector<EditorHandoff::JournalRecord>& journal);
+
     json::JsonObject GetPersistFancyZonesJSON();
 
     void LoadFancyZonesData();
@@ -86,6 +95,7 @@ private:
     friend class FancyZonesUnitTests::ZoneWindowUnitTests;
     friend class FancyZonesUnitTests::ZoneWindowCreationUnitTests;
     friend class FancyZonesUnitTests::ZoneSetCalculateZonesUnitTests;
+    friend class ReplayHarness::Replayer;
 
     inline void SetDeviceInfo(const std::wstring& deviceId, FancyZonesDataTypes::DeviceInfoData data)
     {
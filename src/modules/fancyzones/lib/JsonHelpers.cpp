@@ -3,6 +3,7 @@
 #include "JsonHelpers.h"
 #include "FancyZonesData.h"
 #include "FancyZonesDataTypes.h"
+#include "JsonStreamReader.h"
 #include "trace.h"
 #include "util.h"
 
@@ -62,48 +63,888 @@ namespace
         return arr;
     }
 
-    std::vector<int> JsonArrayToNumVec(const json::JsonArray& arr)
+    // Members of the persisted objects, read by either the DOM based parsers or the streaming parser. Members which
+    // are missing or have another type are left empty. Both parsers pass them to the Make* functions below for
+    // validation, so that they accept exactly the same data.
+    struct ZoneSetDataMembers
     {
+        std::optional<std::wstring> uuid;
+        std::optional<std::wstring> type;
+    };
+
+    struct DeviceInfoMembers
+    {
+        std::optional<std::wstring> deviceId;
+        std::optional<FancyZonesDataTypes::ZoneSetData> activeZoneSet;
+        std::optional<bool> showSpacing;
+        std::optional<double> spacing;
+        std::optional<double> zoneCount;
+        std::optional<double> sensitivityRadius = DefaultValues::SensitivityRadius;
+    };
+
+    // Custom layout info members. Canvas and grid members are validated once the layout type is known.
+    struct LayoutInfoMembers
+    {
+        std::optional<double> rows;
+        std::optional<double> columns;
+        std::optional<std::vector<int>> rowsPercents;
+        std::optional<std::vector<int>> columnsPercents;
+        std::optional<std::vector<std::vector<int>>> cellChildMap;
+        std::optional<double> refWidth;
+        std::optional<double> refHeight;
+        std::optional<std::vector<FancyZonesDataTypes::CanvasLayoutInfo::Rect>> zones;
+    };
+
+    struct CustomZoneSetMembers
+    {
+        std::optional<std::wstring> uuid;
+        std::optional<std::wstring> name;
+        std::optional<std::wstring> type;
+        std::optional<LayoutInfoMembers> info;
+    };
+
+    // App zone history item members. Errors which drop the whole application entry are evaluated only once
+    // the item is used, because members of the previous file format are ignored if history is present.
+    struct AppZoneHistoryItemMembers
+    {
+        bool hasZoneIndexSet = false;
+        bool zoneIndexSetValid = true;
+        std::vector<size_t> zoneIndexSet;
+        bool hasZoneIndex = false;
+        std::optional<double> zoneIndex;
+        std::optional<std::wstring> deviceId;
+        std::optional<std::wstring> zoneSetUuid;
+    };
+
+    std::optional<FancyZonesDataTypes::ZoneSetData> MakeZoneSetData(ZoneSetDataMembers&& members)
+    {
+        if (!members.uuid.has_value() || !members.type.has_value() || !FancyZonesUtils::IsValidGuid(members.uuid.value()))
+        {
+            return std::nullopt;
+        }
+
+        return FancyZonesDataTypes::ZoneSetData{ std::move(members.uuid.value()), FancyZonesDataTypes::TypeFromString(members.type.value()) };
+    }
+
+    std::optional<JSONHelpers::DeviceInfoJSON> MakeDeviceInfo(DeviceInfoMembers&& members)
+    {
+        if (!members.deviceId.has_value() || !members.activeZoneSet.has_value() || !members.showSpacing.has_value() || !members.spacing.has_value() ||
+            !members.zoneCount.has_value() || !members.sensitivityRadius.has_value() || !FancyZonesUtils::IsValidDeviceId(members.deviceId.value()))
+        {
+            return std::nullopt;
+        }
+
+        JSONHelpers::DeviceInfoJSON result;
+        result.deviceId = std::move(members.deviceId.value());
+        result.data.activeZoneSet = std::move(members.activeZoneSet.value());
+        result.data.showSpacing = members.showSpacing.value();
+        result.data.spacing = static_cast<int>(members.spacing.value());
+        result.data.zoneCount = static_cast<int>(members.zoneCount.value());
+        result.data.sensitivityRadius = static_cast<int>(members.sensitivityRadius.value());
+        return result;
+    }
+
+    std::optional<FancyZonesDataTypes::CanvasLayoutInfo> MakeCanvasLayoutInfo(LayoutInfoMembers&& info)
+    {
+        if (!info.refWidth.has_value() || !info.refHeight.has_value() || !info.zones.has_value())
+        {
+            return std::nullopt;
+        }
+
+        FancyZonesDataTypes::CanvasLayoutInfo canvasInfo;
+        canvasInfo.lastWorkAreaWidth = static_cast<int>(info.refWidth.value());
+        canvasInfo.lastWorkAreaHeight = static_cast<int>(info.refHeight.value());
+        canvasInfo.zones = std::move(info.zones.value());
+        return canvasInfo;
+    }
+
+    std::optional<FancyZonesDataTypes::GridLayoutInfo> MakeGridLayoutInfo(LayoutInfoMembers&& info)
+    {
+        if (!info.rows.has_value() || !info.columns.has_value() || !info.rowsPercents.has_value() ||
+            !info.columnsPercents.has_value() || !info.cellChildMap.has_value())
+        {
+            return std::nullopt;
+        }
+
+        FancyZonesDataTypes::GridLayoutInfo gridInfo(FancyZonesDataTypes::GridLayoutInfo::Minimal{});
+        gridInfo.m_rows = static_cast<int>(info.rows.value());
+        gridInfo.m_columns = static_cast<int>(info.columns.value());
+        if (info.rowsPercents->size() != gridInfo.m_rows || info.columnsPercents->size() != gridInfo.m_columns || info.cellChildMap->size() != gridInfo.m_rows)
+        {
+            return std::nullopt;
+        }
+
+        for (const auto& cellsRow : info.cellChildMap.value())
+        {
+            if (cellsRow.size() != gridInfo.m_columns)
+            {
+                return std::nullopt;
+            }
+        }
+
+        gridInfo.m_rowsPercents = std::move(info.rowsPercents.value());
+        gridInfo.m_columnsPercents = std::move(info.columnsPercents.value());
+        gridInfo.m_cellChildMap = std::move(info.cellChildMap.value());
+        return gridInfo;
+    }
+
+    std::optional<JSONHelpers::CustomZoneSetJSON> MakeCustomZoneSet(CustomZoneSetMembers&& members)
+    {
+        if (!members.uuid.has_value() || !members.name.has_value() || !members.type.has_value() || !members.info.has_value() ||
+            !FancyZonesUtils::IsValidGuid(members.uuid.value()))
+        {
+            return std::nullopt;
+        }
+
+        JSONHelpers::CustomZoneSetJSON result;
+        result.uuid = std::move(members.uuid.value());
+        result.data.name = std::move(members.name.value());
+        if (members.type.value() == NonLocalizable::CanvasStr)
+        {
+            auto info = MakeCanvasLayoutInfo(std::move(members.info.value()));
+            if (!info.has_value())
+            {
+                return std::nullopt;
+            }
+
+            result.data.type = FancyZonesDataTypes::CustomLayoutType::Canvas;
+            result.data.info = std::move(info.value());
+        }
+        else if (members.type.value() == NonLocalizable::GridStr)
+        {
+            auto info = MakeGridLayoutInfo(std::move(members.info.value()));
+            if (!info.has_value())
+            {
+                return std::nullopt;
+            }
+
+            result.data.type = FancyZonesDataTypes::CustomLayoutType::Grid;
+            result.data.info = std::move(info.value());
+        }
+        else
+        {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+    // Returns std::nullopt for items rejected by validation. Additionally clears valid for malformed items,
+    // which drop the whole application entry.
+    std::optional<FancyZonesDataTypes::AppZoneHistoryData> MakeAppZoneHistoryData(AppZoneHistoryItemMembers&& item, bool& valid)
+    {
+        FancyZonesDataTypes::AppZoneHistoryData data;
+        if (item.hasZoneIndexSet)
+        {
+            if (!item.zoneIndexSetValid)
+            {
+                valid = false;
+                return std::nullopt;
+            }
+            data.zoneIndexSet = std::move(item.zoneIndexSet);
+        }
+        else if (item.hasZoneIndex)
+        {
+            if (!item.zoneIndex.has_value())
+            {
+                valid = false;
+                return std::nullopt;
+            }
+            data.zoneIndexSet = { static_cast<size_t>(item.zoneIndex.value()) };
+        }
+
+        if (!item.deviceId.has_value() || !item.zoneSetUuid.has_value())
+        {
+            valid = false;
+            return std::nullopt;
+        }
+
+        data.deviceId = std::move(item.deviceId.value());
+        data.zoneSetUuid = std::move(item.zoneSetUuid.value());
+        if (!FancyZonesUtils::IsValidGuid(data.zoneSetUuid) || !FancyZonesUtils::IsValidDeviceId(data.deviceId))
+        {
+            return std::nullopt;
+        }
+
+        return data;
+    }
+
+    std::optional<JSONHelpers::AppZoneHistoryJSON> MakeAppZoneHistory(std::optional<std::wstring>&& appPath, std::vector<FancyZonesDataTypes::AppZoneHistoryData>&& data, bool valid)
+    {
+        if (!appPath.has_value() || !valid || data.empty())
+        {
+            return std::nullopt;
+        }
+
+        JSONHelpers::AppZoneHistoryJSON result;
+        result.appPath = std::move(appPath.value());
+        result.data = std::move(data);
+        return result;
+    }
+
+    // Member accessors of the DOM based parsers, returning std::nullopt instead of throwing
+    std::optional<std::wstring> GetOptionalString(const json::JsonObject& object, std::wstring_view name)
+    {
+        const json::JsonValue* value = object.Find(name);
+        return value && value->ValueType() == json::JsonValueType::String ? std::optional<std::wstring>{ value->GetString() } : std::nullopt;
+    }
+
+    std::optional<double> GetOptionalNumber(const json::JsonObject& object, std::wstring_view name)
+    {
+        const json::JsonValue* value = object.Find(name);
+        return value && value->ValueType() == json::JsonValueType::Number ? std::optional<double>{ value->GetNumber() } : std::nullopt;
+    }
+
+    std::optional<bool> GetOptionalBoolean(const json::JsonObject& object, std::wstring_view name)
+    {
+        const json::JsonValue* value = object.Find(name);
+        return value && value->ValueType() == json::JsonValueType::Boolean ? std::optional<bool>{ value->GetBoolean() } : std::nullopt;
+    }
+
+    std::optional<std::vector<int>> ToNumVec(const json::JsonValue* value)
+    {
+        if (!value || value->ValueType() != json::JsonValueType::Array)
+        {
+            return std::nullopt;
+        }
+
         std::vector<int> vec;
-        for (const auto& val : arr)
+        for (const auto& val : value->GetArray())
         {
+            if (val.ValueType() != json::JsonValueType::Number)
+            {
+                return std::nullopt;
+            }
             vec.emplace_back(static_cast<int>(val.GetNumber()));
         }
 
-        return vec;
-    }
+        return vec;
+    }
+
+    LayoutInfoMembers ReadLayoutInfo(const json::JsonObject& infoJson)
+    {
+        LayoutInfoMembers info;
+        info.rows = GetOptionalNumber(infoJson, NonLocalizable::RowsStr);
+        info.columns = GetOptionalNumber(infoJson, NonLocalizable::ColumnsStr);
+        info.rowsPercents = ToNumVec(infoJson.Find(NonLocalizable::RowsPercentageStr));
+        info.columnsPercents = ToNumVec(infoJson.Find(NonLocalizable::ColumnsPercentageStr));
+        info.refWidth = GetOptionalNumber(infoJson, NonLocalizable::RefWidthStr);
+        info.refHeight = GetOptionalNumber(infoJson, NonLocalizable::RefHeightStr);
+
+        if (json::has(infoJson, NonLocalizable::CellChildMapStr, json::JsonValueType::Array))
+        {
+            bool valid = true;
+            std::vector<std::vector<int>> cellChildMap;
+            for (const auto& cellsRow : infoJson.GetNamedArray(NonLocalizable::CellChildMapStr))
+            {
+                if (auto cells = ToNumVec(&cellsRow); cells.has_value())
+                {
+                    cellChildMap.push_back(std::move(cells.value()));
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+
+            if (valid)
+            {
+                info.cellChildMap = std::move(cellChildMap);
+            }
+        }
+
+        if (json::has(infoJson, NonLocalizable::ZonesStr, json::JsonValueType::Array))
+        {
+            bool valid = true;
+            std::vector<FancyZonesDataTypes::CanvasLayoutInfo::Rect> zones;
+            for (const auto& zone : infoJson.GetNamedArray(NonLocalizable::ZonesStr))
+            {
+                std::optional<double> x, y, width, height;
+                if (zone.ValueType() == json::JsonValueType::Object)
+                {
+                    const json::JsonObject zoneJson = zone.GetObjectW();
+                    x = GetOptionalNumber(zoneJson, NonLocalizable::XStr);
+                    y = GetOptionalNumber(zoneJson, NonLocalizable::YStr);
+                    width = GetOptionalNumber(zoneJson, NonLocalizable::WidthStr);
+                    height = GetOptionalNumber(zoneJson, NonLocalizable::HeightStr);
+                }
+
+                if (x.has_value() && y.has_value() && width.has_value() && height.has_value())
+                {
+                    zones.push_back(FancyZonesDataTypes::CanvasLayoutInfo::Rect{ static_cast<int>(*x), static_cast<int>(*y), static_cast<int>(*width), static_cast<int>(*height) });
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+
+            if (valid)
+            {
+                info.zones = std::move(zones);
+            }
+        }
+
+        return info;
+    }
+
+    AppZoneHistoryItemMembers ReadAppZoneHistoryItem(const json::JsonObject& json)
+    {
+        AppZoneHistoryItemMembers item;
+        if (const json::JsonValue* zoneIndexSet = json.Find(NonLocalizable::ZoneIndexSetStr))
+        {
+            item.hasZoneIndexSet = true;
+            item.zoneIndexSetValid = zoneIndexSet->ValueType() == json::JsonValueType::Array;
+            if (item.zoneIndexSetValid)
+            {
+                for (const auto& value : zoneIndexSet->GetArray())
+                {
+                    if (value.ValueType() == json::JsonValueType::Number)
+                    {
+                        item.zoneIndexSet.push_back(static_cast<size_t>(value.GetNumber()));
+                    }
+                    else
+                    {
+                        item.zoneIndexSetValid = false;
+                    }
+                }
+            }
+        }
+
+        if (json.HasKey(NonLocalizable::ZoneIndexStr))
+        {
+            item.hasZoneIndex = true;
+            item.zoneIndex = GetOptionalNumber(json, NonLocalizable::ZoneIndexStr);
+        }
+
+        item.deviceId = GetOptionalString(json, NonLocalizable::DeviceIdStr);
+        item.zoneSetUuid = GetOptionalString(json, NonLocalizable::ZoneSetUuidStr);
+        return item;
+    }
+
+    inline bool DeleteTmpFile(std::wstring_view tmpFilePath)
+    {
+        return DeleteFileW(tmpFilePath.data());
+    }
+
+    // Streaming counterpart of the DOM based parsers below. Every Parse* function consumes exactly one JSON value and
+    // passes its members to the same Make* function as the matching FromJson function.
+    class FancyZonesDataStreamParser
+    {
+    public:
+        explicit FancyZonesDataStreamParser(std::string_view document) noexcept :
+            m_reader(document)
+        {
+        }
+
+        bool ParseZonesSettings(std::optional<JSONHelpers::TAppZoneHistoryMap>& appZoneHistoryMap,
+                                JSONHelpers::TDeviceInfoMap& deviceInfoMap,
+                                JSONHelpers::TCustomZoneSetsMap& customZoneSetsMap)
+        {
+            if (!m_reader.BeginObject())
+            {
+                return false;
+            }
+
+            while (m_reader.NextMember(m_name))
+            {
+                if (m_name == NonLocalizable::AppZoneHistoryStr)
+                {
+                    appZoneHistoryMap = ParseAppZoneHistory();
+                }
+                else if (m_name == NonLocalizable::DevicesStr)
+                {
+                    deviceInfoMap = ParseDeviceInfos();
+                }
+                else if (m_name == NonLocalizable::CustomZoneSetsStr)
+                {
+                    customZoneSetsMap = ParseCustomZoneSets();
+                }
+                else
+                {
+                    m_reader.SkipValue();
+                }
+            }
+
+            return m_reader.Finish();
+        }
+
+        bool ParseAppZoneHistoryFile(JSONHelpers::TAppZoneHistoryMap& appZoneHistoryMap)
+        {
+            if (!m_reader.BeginObject())
+            {
+                return false;
+            }
+
+            while (m_reader.NextMember(m_name))
+            {
+                if (m_name == NonLocalizable::AppZoneHistoryStr)
+                {
+                    appZoneHistoryMap = ParseAppZoneHistory();
+                }
+                else
+                {
+                    m_reader.SkipValue();
+                }
+            }
+
+            return m_reader.Finish();
+        }
+
+    private:
+        // Calls parseObject for every element of an array of objects. Returns false if the value isn't an array
+        // or any of its elements isn't an object.
+        template<typename Fn>
+        bool ForEachObject(Fn parseObject)
+        {
+            if (!m_reader.BeginArray())
+            {
+                return false;
+            }
+
+            bool result = true;
+            while (m_reader.NextElement())
+            {
+                if (m_reader.BeginObject())
+                {
+                    parseObject();
+                }
+                else
+                {
+                    result = false;
+                }
+            }
+
+            return result && !m_reader.Failed();
+        }
+
+        std::optional<double> ReadNumber()
+        {
+            double value;
+            return m_reader.ReadNumber(value) ? std::optional<double>{ value } : std::nullopt;
+        }
+
+        std::optional<std::wstring> ReadString()
+        {
+            std::wstring value;
+            return m_reader.ReadString(value) ? std::optional<std::wstring>{ std::move(value) } : std::nullopt;
+        }
+
+        std::optional<std::vector<int>> ReadNumberArray()
+        {
+            if (!m_reader.BeginArray())
+            {
+                return std::nullopt;
+            }
+
+            bool valid = true;
+            std::vector<int> values;
+            while (m_reader.NextElement())
+            {
+                double value;
+                if (m_reader.ReadNumber(value))
+                {
+                    values.push_back(static_cast<int>(value));
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+
+            return valid ? std::optional<std::vector<int>>{ std::move(values) } : std::nullopt;
+        }
+
+        JSONHelpers::TAppZoneHistoryMap ParseAppZoneHistory()
+        {
+            JSONHelpers::TAppZoneHistoryMap appZoneHistoryMap{};
+            const bool valid = ForEachObject([&] {
+                if (auto appZoneHistory = ParseAppZoneHistoryEntry(); appZoneHistory.has_value())
+                {
+                    appZoneHistoryMap[appZoneHistory->appPath] = std::move(appZoneHistory->data);
+                }
+            });
+
+            return valid ? std::move(appZoneHistoryMap) : JSONHelpers::TAppZoneHistoryMap{};
+        }
+
+        std::optional<JSONHelpers::AppZoneHistoryJSON> ParseAppZoneHistoryEntry()
+        {
+            std::optional<std::wstring> appPath;
+            std::vector<FancyZonesDataTypes::AppZoneHistoryData> history;
+            bool hasHistory = false;
+            bool historyValid = true;
+            AppZoneHistoryItemMembers previousFormatItem;
+
+            while (m_reader.NextMember(m_name))
+            {
+                if (m_name == NonLocalizable::AppPathStr)
+                {
+                    appPath = ReadString();
+                }
+                else if (m_name == NonLocalizable::HistoryStr)
+                {
+                    hasHistory = true;
+                    history.clear();
+                    bool itemsValid = true;
+                    historyValid = ForEachObject([&] {
+                        AppZoneHistoryItemMembers item;
+                        while (m_reader.NextMember(m_name))
+                        {
+                            ReadAppZoneHistoryItemMember(item);
+                        }
+
+                        if (auto data = MakeAppZoneHistoryData(std::move(item), itemsValid); data.has_value())
+                        {
+                            history.push_back(std::move(data.value()));
+                        }
+                    });
+                    historyValid = historyValid && itemsValid;
+                }
+                else
+                {
+                    ReadAppZoneHistoryItemMember(previousFormatItem);
+                }
+            }
+
+            if (!hasHistory)
+            {
+                // handle previous file format, with single desktop layout information per application
+                if (auto data = MakeAppZoneHistoryData(std::move(previousFormatItem), historyValid); data.has_value())
+                {
+                    history.push_back(std::move(data.value()));
+                }
+            }
+
+            return MakeAppZoneHistory(std::move(appPath), std::move(history), historyValid);
+        }
+
+        void ReadAppZoneHistoryItemMember(AppZoneHistoryItemMembers& item)
+        {
+            if (m_name == NonLocalizable::ZoneIndexSetStr)
+            {
+                item.hasZoneIndexSet = true;
+                item.zoneIndexSet.clear();
+                item.zoneIndexSetValid = m_reader.BeginArray();
+                if (item.zoneIndexSetValid)
+                {
+                    while (m_reader.NextElement())
+                    {
+                        double index;
+                        if (m_reader.ReadNumber(index))
+                        {
+                            item.zoneIndexSet.push_back(static_cast<size_t>(index));
+                        }
+                        else
+                        {
+                            item.zoneIndexSetValid = false;
+                        }
+                    }
+                }
+            }
+            else if (m_name == NonLocalizable::ZoneIndexStr)
+            {
+                item.hasZoneIndex = true;
+                item.zoneIndex = ReadNumber();
+            }
+            else if (m_name == NonLocalizable::DeviceIdStr)
+            {
+                item.deviceId = ReadString();
+            }
+            else if (m_name == NonLocalizable::ZoneSetUuidStr)
+            {
+                item.zoneSetUuid = ReadString();
+            }
+            else
+            {
+                m_reader.SkipValue();
+            }
+        }
+
+        JSONHelpers::TDeviceInfoMap ParseDeviceInfos()
+        {
+            JSONHelpers::TDeviceInfoMap deviceInfoMap{};
+            const bool valid = ForEachObject([&] {
+                if (auto device = ParseDeviceInfo(); device.has_value())
+                {
+                    deviceInfoMap[device->deviceId] = std::move(device->data);
+                }
+            });
+
+            return valid ? std::move(deviceInfoMap) : JSONHelpers::TDeviceInfoMap{};
+        }
+
+        std::optional<JSONHelpers::DeviceInfoJSON> ParseDeviceInfo()
+        {
+            DeviceInfoMembers members;
+            while (m_reader.NextMember(m_name))
+            {
+                if (m_name == NonLocalizable::DeviceIdStr)
+                {
+                    members.deviceId = ReadString();
+                }
+                else if (m_name == NonLocalizable::ActiveZoneSetStr)
+                {
+                    members.activeZoneSet = ParseZoneSetData();
+                }
+                else if (m_name == NonLocalizable::EditorShowSpacingStr)
+                {
+                    bool value;
+                    members.showSpacing = m_reader.ReadBoolean(value) ? std::optional<bool>{ value } : std::nullopt;
+                }
+                else if (m_name == NonLocalizable::EditorSpacingStr)
+                {
+                    members.spacing = ReadNumber();
+                }
+                else if (m_name == NonLocalizable::EditorZoneCountStr)
+                {
+                    members.zoneCount = ReadNumber();
+                }
+                else if (m_name == NonLocalizable::EditorSensitivityRadiusStr)
+                {
+                    members.sensitivityRadius = ReadNumber();
+                }
+                else
+                {
+                    m_reader.SkipValue();
+                }
+            }
+
+            return MakeDeviceInfo(std::move(members));
+        }
+
+        std::optional<FancyZonesDataTypes::ZoneSetData> ParseZoneSetData()
+        {
+            if (!m_reader.BeginObject())
+            {
+                return std::nullopt;
+            }
+
+            ZoneSetDataMembers members;
+            while (m_reader.NextMember(m_name))
+            {
+                if (m_name == NonLocalizable::UuidStr)
+                {
+                    members.uuid = ReadString();
+                }
+                else if (m_name == NonLocalizable::TypeStr)
+                {
+                    members.type = ReadString();
+                }
+                else
+                {
+                    m_reader.SkipValue();
+                }
+            }
+
+            return MakeZoneSetData(std::move(members));
+        }
+
+        JSONHelpers::TCustomZoneSetsMap ParseCustomZoneSets()
+        {
+            JSONHelpers::TCustomZoneSetsMap customZoneSetsMap{};
+            const bool valid = ForEachObject([&] {
+                if (auto zoneSet = ParseCustomZoneSet(); zoneSet.has_value())
+                {
+                    customZoneSetsMap[zoneSet->uuid] = std::move(zoneSet->data);
+                }
+            });
 
-    std::optional<FancyZonesDataTypes::AppZoneHistoryData> ParseSingleAppZoneHistoryItem(const json::JsonObject& json)
-    {
-        FancyZonesDataTypes::AppZoneHistoryData data;
-        if (json.HasKey(NonLocalizable::ZoneIndexSetStr))
+            return valid ? std::move(customZoneSetsMap) : JSONHelpers::TCustomZoneSetsMap{};
+        }
+
+        std::optional<JSONHelpers::CustomZoneSetJSON> ParseCustomZoneSet()
         {
-            data.zoneIndexSet = {};
-            for (auto& value : json.GetNamedArray(NonLocalizable::ZoneIndexSetStr))
+            CustomZoneSetMembers members;
+            while (m_reader.NextMember(m_name))
             {
-                data.zoneIndexSet.push_back(static_cast<size_t>(value.GetNumber()));
+                if (m_name == NonLocalizable::UuidStr)
+                {
+                    members.uuid = ReadString();
+                }
+                else if (m_name == NonLocalizable::NameStr)
+                {
+                    members.name = ReadString();
+                }
+                else if (m_name == NonLocalizable::TypeStr)
+                {
+                    members.type = ReadString();
+                }
+                else if (m_name == NonLocalizable::InfoStr)
+                {
+                    members.info = ParseLayoutInfo();
+                }
+                else
+                {
+                    m_reader.SkipValue();
+                }
             }
+
+            return MakeCustomZoneSet(std::move(members));
         }
-        else if (json.HasKey(NonLocalizable::ZoneIndexStr))
+
+        std::optional<LayoutInfoMembers> ParseLayoutInfo()
         {
-            data.zoneIndexSet = { static_cast<size_t>(json.GetNamedNumber(NonLocalizable::ZoneIndexStr)) };
+            if (!m_reader.BeginObject())
+            {
+                return std::nullopt;
+            }
+
+            LayoutInfoMembers info;
+            while (m_reader.NextMember(m_name))
+            {
+                if (m_name == NonLocalizable::RowsStr)
+                {
+                    info.rows = ReadNumber();
+                }
+                else if (m_name == NonLocalizable::ColumnsStr)
+                {
+                    info.columns = ReadNumber();
+                }
+                else if (m_name == NonLocalizable::RowsPercentageStr)
+                {
+                    info.rowsPercents = ReadNumberArray();
+                }
+                else if (m_name == NonLocalizable::ColumnsPercentageStr)
+                {
+                    info.columnsPercents = ReadNumberArray();
+                }
+                else if (m_name == NonLocalizable::CellChildMapStr)
+                {
+                    info.cellChildMap = ParseCellChildMap();
+                }
+                else if (m_name == NonLocalizable::RefWidthStr)
+                {
+                    info.refWidth = ReadNumber();
+                }
+                else if (m_name == NonLocalizable::RefHeightStr)
+                {
+                    info.refHeight = ReadNumber();
+                }
+                else if (m_name == NonLocalizable::ZonesStr)
+                {
+                    info.zones = ParseCanvasZones();
+                }
+                else
+                {
+                    m_reader.SkipValue();
+                }
+            }
+
+            return info;
         }
 
-        data.deviceId = json.GetNamedString(NonLocalizable::DeviceIdStr);
-        data.zoneSetUuid = json.GetNamedString(NonLocalizable::ZoneSetUuidStr);
+        std::optional<std::vector<std::vector<int>>> ParseCellChildMap()
+        {
+            if (!m_reader.BeginArray())
+            {
+                return std::nullopt;
+            }
 
-        if (!FancyZonesUtils::IsValidGuid(data.zoneSetUuid) || !FancyZonesUtils::IsValidDeviceId(data.deviceId))
+            bool valid = true;
+            std::vector<std::vector<int>> cellChildMap;
+            while (m_reader.NextElement())
+            {
+                if (auto cellsRow = ReadNumberArray(); cellsRow.has_value())
+                {
+                    cellChildMap.push_back(std::move(cellsRow.value()));
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+
+            return valid ? std::optional<std::vector<std::vector<int>>>{ std::move(cellChildMap) } : std::nullopt;
+        }
+
+        std::optional<std::vector<FancyZonesDataTypes::CanvasLayoutInfo::Rect>> ParseCanvasZones()
         {
-            return std::nullopt;
+            bool zonesValid = true;
+            std::vector<FancyZonesDataTypes::CanvasLayoutInfo::Rect> zones;
+            const bool valid = ForEachObject([&] {
+                std::optional<double> x, y, width, height;
+                while (m_reader.NextMember(m_name))
+                {
+                    if (m_name == NonLocalizable::XStr)
+                    {
+                        x = ReadNumber();
+                    }
+                    else if (m_name == NonLocalizable::YStr)
+                    {
+                        y = ReadNumber();
+                    }
+                    else if (m_name == NonLocalizable::WidthStr)
+                    {
+                        width = ReadNumber();
+                    }
+                    else if (m_name == NonLocalizable::HeightStr)
+                    {
+                        height = ReadNumber();
+                    }
+                    else
+                    {
+                        m_reader.SkipValue();
+                    }
+                }
+
+                if (x.has_value() && y.has_value() && width.has_value() && height.has_value())
+                {
+                    zones.push_back(FancyZonesDataTypes::CanvasLayoutInfo::Rect{ static_cast<int>(*x), static_cast<int>(*y), static_cast<int>(*width), static_cast<int>(*height) });
+                }
+                else
+                {
+                    zonesValid = false;
+                }
+            });
+
+            return valid && zonesValid ? std::optional<std::vector<FancyZonesDataTypes::CanvasLayoutInfo::Rect>>{ std::move(zones) } : std::nullopt;
         }
 
-        return data;
-    }
+        JsonStreamReader m_reader;
+        std::wstring m_name; // Shared buffer for member names, compared right after being read
+    };
 
-    inline bool DeleteTmpFile(std::wstring_view tmpFilePath)
+    // Read-only view of a whole file. Files which can't be opened or mapped yield an empty view.
+    class MappedFile
     {
-        return DeleteFileW(tmpFilePath.data());
-    }
+    public:
+        explicit MappedFile(const std::wstring& fileName) noexcept
+        {
+            wil::unique_hfile file{ CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            LARGE_INTEGER size{};
+            if (!file || !GetFileSizeEx(file.get(), &size) || size.QuadPart == 0 || size.QuadPart > MAXDWORD)
+            {
+                return;
+            }
+
+            wil::unique_handle mapping{ CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr) };
+            if (!mapping)
+            {
+                return;
+            }
+
+            m_view.reset(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0));
+            if (m_view)
+            {
+                m_size = static_cast<size_t>(size.QuadPart);
+            }
+        }
+
+        inline bool IsOpen() const noexcept
+        {
+            return m_view != nullptr;
+        }
+
+        inline std::string_view View() const noexcept
+        {
+            return { static_cast<const char*>(m_view.get()), m_size };
+        }
+
+    private:
+        wil::unique_mapview_ptr<void> m_view;
+        size_t m_size = 0;
+    };
 }
 
 namespace JSONHelpers
@@ -131,31 +972,7 @@ namespace JSONHelpers
 
     std::optional<FancyZonesDataTypes::CanvasLayoutInfo> CanvasLayoutInfoJSON::FromJson(const json::JsonObject& infoJson)
     {
-        try
-        {
-            FancyZonesDataTypes::CanvasLayoutInfo info;
-            info.lastWorkAreaWidth = static_cast<int>(infoJson.GetNamedNumber(NonLocalizable::RefWidthStr));
-            info.lastWorkAreaHeight = static_cast<int>(infoJson.GetNamedNumber(NonLocalizable::RefHeightStr));
-
-            json::JsonArray zonesJson = infoJson.GetNamedArray(NonLocalizable::ZonesStr);
-            uint32_t size = zonesJson.Size();
-            info.zones.reserve(size);
-            for (uint32_t i = 0; i < size; ++i)
-            {
-                json::JsonObject zoneJson = zonesJson.GetObjectAt(i);
-                const int x = static_cast<int>(zoneJson.GetNamedNumber(NonLocalizable::XStr));
-                const int y = static_cast<int>(zoneJson.GetNamedNumber(NonLocalizable::YStr));
-                const int width = static_cast<int>(zoneJson.GetNamedNumber(NonLocalizable::WidthStr));
-                const int height = static_cast<int>(zoneJson.GetNamedNumber(NonLocalizable::HeightStr));
-                FancyZonesDataTypes::CanvasLayoutInfo::Rect zone{ x, y, width, height };
-                info.zones.push_back(zone);
-            }
-            return info;
-        }
-        catch (const winrt::hresult_error&)
-        {
-            return std::nullopt;
-        }
+        return MakeCanvasLayoutInfo(ReadLayoutInfo(infoJson));
     }
 
     json::JsonObject GridLayoutInfoJSON::ToJson(const FancyZonesDataTypes::GridLayoutInfo& gridInfo)
@@ -178,40 +995,7 @@ namespace JSONHelpers
 
     std::optional<FancyZonesDataTypes::GridLayoutInfo> GridLayoutInfoJSON::FromJson(const json::JsonObject& infoJson)
     {
-        try
-        {
-            FancyZonesDataTypes::GridLayoutInfo info(FancyZonesDataTypes::GridLayoutInfo::Minimal{});
-
-            info.m_rows = static_cast<int>(infoJson.GetNamedNumber(NonLocalizable::RowsStr));
-            info.m_columns = static_cast<int>(infoJson.GetNamedNumber(NonLocalizable::ColumnsStr));
-
-            json::JsonArray rowsPercentage = infoJson.GetNamedArray(NonLocalizable::RowsPercentageStr);
-            json::JsonArray columnsPercentage = infoJson.GetNamedArray(NonLocalizable::ColumnsPercentageStr);
-            json::JsonArray cellChildMap = infoJson.GetNamedArray(NonLocalizable::CellChildMapStr);
-
-            if (rowsPercentage.Size() != info.m_rows || columnsPercentage.Size() != info.m_columns || cellChildMap.Size() != info.m_rows)
-            {
-                return std::nullopt;
-            }
-
-            info.m_rowsPercents = JsonArrayToNumVec(rowsPercentage);
-            info.m_columnsPercents = JsonArrayToNumVec(columnsPercentage);
-            for (const auto& cellsRow : cellChildMap)
-            {
-                const auto cellsArray = cellsRow.GetArray();
-                if (cellsArray.Size() != info.m_columns)
-                {
-                    return std::nullopt;
-                }
-                info.cellChildMap().push_back(JsonArrayToNumVec(cellsArray));
-            }
-
-            return info;
-        }
-        catch (const winrt::hresult_error&)
-        {
-            return std::nullopt;
-        }
+        return MakeGridLayoutInfo(ReadLayoutInfo(infoJson));
     }
 
     json::JsonObject CustomZoneSetJSON::ToJson(const CustomZoneSetJSON& customZoneSet)
@@ -247,55 +1031,16 @@ namespace JSONHelpers
 
     std::optional<CustomZoneSetJSON> CustomZoneSetJSON::FromJson(const json::JsonObject& customZoneSet)
     {
-        try
-        {
-            CustomZoneSetJSON result;
-
-            result.uuid = customZoneSet.GetNamedString(NonLocalizable::UuidStr);
-            if (!FancyZonesUtils::IsValidGuid(result.uuid))
-            {
-                return std::nullopt;
-            }
-
-            result.data.name = customZoneSet.GetNamedString(NonLocalizable::NameStr);
-
-            json::JsonObject infoJson = customZoneSet.GetNamedObject(NonLocalizable::InfoStr);
-            std::wstring zoneSetType = std::wstring{ customZoneSet.GetNamedString(NonLocalizable::TypeStr) };
-            if (zoneSetType.compare(NonLocalizable::CanvasStr) == 0)
-            {
-                if (auto info = CanvasLayoutInfoJSON::FromJson(infoJson); info.has_value())
-                {
-                    result.data.type = FancyZonesDataTypes::CustomLayoutType::Canvas;
-                    result.data.info = std::move(info.value());
-                }
-                else
-                {
-                    return std::nullopt;
-                }
-            }
-            else if (zoneSetType.compare(NonLocalizable::GridStr) == 0)
-            {
-                if (auto info = GridLayoutInfoJSON::FromJson(infoJson); info.has_value())
-                {
-                    result.data.type = FancyZonesDataTypes::CustomLayoutType::Grid;
-                    result.data.info = std::move(info.value());
-                }
-                else
-                {
-                    return std::nullopt;
-                }
-            }
-            else
-            {
-                return std::nullopt;
-            }
-
-            return result;
-        }
-        catch (const winrt::hresult_error&)
+        CustomZoneSetMembers members;
+        members.uuid = GetOptionalString(customZoneSet, NonLocalizable::UuidStr);
+        members.name = GetOptionalString(customZoneSet, NonLocalizable::NameStr);
+        members.type = GetOptionalString(customZoneSet, NonLocalizable::TypeStr);
+        if (json::has(customZoneSet, NonLocalizable::InfoStr))
         {
-            return std::nullopt;
+            members.info = ReadLayoutInfo(customZoneSet.GetNamedObject(NonLocalizable::InfoStr));
         }
+
+        return MakeCustomZoneSet(std::move(members));
     }
 
     json::JsonObject ZoneSetDataJSON::ToJson(const FancyZonesDataTypes::ZoneSetData& zoneSet)
@@ -310,23 +1055,7 @@ namespace JSONHelpers
 
     std::optional<FancyZonesDataTypes::ZoneSetData> ZoneSetDataJSON::FromJson(const json::JsonObject& zoneSet)
     {
-        try
-        {
-            FancyZonesDataTypes::ZoneSetData zoneSetData;
-            zoneSetData.uuid = zoneSet.GetNamedString(NonLocalizable::UuidStr);
-            zoneSetData.type = FancyZonesDataTypes::TypeFromString(std::wstring{ zoneSet.GetNamedString(NonLocalizable::TypeStr) });
-
-            if (!FancyZonesUtils::IsValidGuid(zoneSetData.uuid))
-            {
-                return std::nullopt;
-            }
-
-            return zoneSetData;
-        }
-        catch (const winrt::hresult_error&)
-        {
-            return std::nullopt;
-        }
+        return MakeZoneSetData({ GetOptionalString(zoneSet, NonLocalizable::UuidStr), GetOptionalString(zoneSet, NonLocalizable::TypeStr) });
     }
 
     json::JsonObject AppZoneHistoryJSON::ToJson(const AppZoneHistoryJSON& appZoneHistory)
@@ -359,42 +1088,36 @@ namespace JSONHelpers
 
     std::optional<AppZoneHistoryJSON> AppZoneHistoryJSON::FromJson(const json::JsonObject& zoneSet)
     {
-        try
+        bool valid = true;
+        std::vector<FancyZonesDataTypes::AppZoneHistoryData> history;
+        if (const json::JsonValue* appHistory = zoneSet.Find(NonLocalizable::HistoryStr))
         {
-            AppZoneHistoryJSON result;
-
-            result.appPath = zoneSet.GetNamedString(NonLocalizable::AppPathStr);
-            if (zoneSet.HasKey(NonLocalizable::HistoryStr))
+            valid = appHistory->ValueType() == json::JsonValueType::Array;
+            if (valid)
             {
-                auto appHistoryArray = zoneSet.GetNamedArray(NonLocalizable::HistoryStr);
-                for (uint32_t i = 0; i < appHistoryArray.Size(); ++i)
+                for (const auto& item : appHistory->GetArray())
                 {
-                    json::JsonObject json = appHistoryArray.GetObjectAt(i);
-                    if (auto data = ParseSingleAppZoneHistoryItem(json); data.has_value())
+                    if (item.ValueType() != json::JsonValueType::Object)
                     {
-                        result.data.push_back(std::move(data.value()));
+                        valid = false;
+                    }
+                    else if (auto data = MakeAppZoneHistoryData(ReadAppZoneHistoryItem(item.GetObjectW()), valid); data.has_value())
+                    {
+                        history.push_back(std::move(data.value()));
                     }
                 }
             }
-            else
-            {
-                // handle previous file format, with single desktop layout information per application
-                if (auto data = ParseSingleAppZoneHistoryItem(zoneSet); data.has_value())
-                {
-                    result.data.push_back(std::move(data.value()));
-                }
-            }
-            if (result.data.empty())
-            {
-                return std::nullopt;
-            }
-
-            return result;
         }
-        catch (const winrt::hresult_error&)
+        else
         {
-            return std::nullopt;
+            // handle previous file format, with single desktop layout information per application
+            if (auto data = MakeAppZoneHistoryData(ReadAppZoneHistoryItem(zoneSet), valid); data.has_value())
+            {
+                history.push_back(std::move(data.value()));
+            }
         }
+
+        return MakeAppZoneHistory(GetOptionalString(zoneSet, NonLocalizable::AppPathStr), std::move(history), valid);
     }
 
     json::JsonObject DeviceInfoJSON::ToJson(const DeviceInfoJSON& device)
@@ -413,36 +1136,22 @@ namespace JSONHelpers
 
     std::optional<DeviceInfoJSON> DeviceInfoJSON::FromJson(const json::JsonObject& device)
     {
-        try
+        DeviceInfoMembers members;
+        members.deviceId = GetOptionalString(device, NonLocalizable::DeviceIdStr);
+        if (json::has(device, NonLocalizable::ActiveZoneSetStr))
         {
-            DeviceInfoJSON result;
-
-            result.deviceId = device.GetNamedString(NonLocalizable::DeviceIdStr);
-            if (!FancyZonesUtils::IsValidDeviceId(result.deviceId))
-            {
-                return std::nullopt;
-            }
-
-            if (auto zoneSet = JSONHelpers::ZoneSetDataJSON::FromJson(device.GetNamedObject(NonLocalizable::ActiveZoneSetStr)); zoneSet.has_value())
-            {
-                result.data.activeZoneSet = std::move(zoneSet.value());
-            }
-            else
-            {
-                return std::nullopt;
-            }
-
-            result.data.showSpacing = device.GetNamedBoolean(NonLocalizable::EditorShowSpacingStr);
-            result.data.spacing = static_cast<int>(device.GetNamedNumber(NonLocalizable::EditorSpacingStr));
-            result.data.zoneCount = static_cast<int>(device.GetNamedNumber(NonLocalizable::EditorZoneCountStr));
-            result.data.sensitivityRadius = static_cast<int>(device.GetNamedNumber(NonLocalizable::EditorSensitivityRadiusStr, DefaultValues::SensitivityRadius));
-
-            return result;
+            members.activeZoneSet = ZoneSetDataJSON::FromJson(device.GetNamedObject(NonLocalizable::ActiveZoneSetStr));
         }
-        catch (const winrt::hresult_error&)
+
+        members.showSpacing = GetOptionalBoolean(device, NonLocalizable::EditorShowSpacingStr);
+        members.spacing = GetOptionalNumber(device, NonLocalizable::EditorSpacingStr);
+        members.zoneCount = GetOptionalNumber(device, NonLocalizable::EditorZoneCountStr);
+        if (device.HasKey(NonLocalizable::EditorSensitivityRadiusStr))
         {
-            return std::nullopt;
+            members.sensitivityRadius = GetOptionalNumber(device, NonLocalizable::EditorSensitivityRadiusStr);
         }
+
+        return MakeDeviceInfo(std::move(members));
     }
 
     json::JsonObject GetPersistFancyZonesJSON(const std::wstring& zonesSettingsFileName, const std::wstring& appZoneHistoryFileName)
@@ -470,6 +1179,54 @@ namespace JSONHelpers
         }
     }
 
+    bool LoadFancyZonesData(const std::wstring& zonesSettingsFileName,
+                            const std::wstring& appZoneHistoryFileName,
+                            TAppZoneHistoryMap& appZoneHistoryMap,
+                            TDeviceInfoMap& deviceInfoMap,
+                            TCustomZoneSetsMap& customZoneSetsMap)
+    {
+        std::optional<TAppZoneHistoryMap> appZoneHistory;
+        TDeviceInfoMap deviceInfos{};
+        TCustomZoneSetsMap customZoneSets{};
+        {
+            MappedFile zonesSettings{ zonesSettingsFileName };
+            if (!zonesSettings.IsOpen() || !ParseZonesSettings(zonesSettings.View(), appZoneHistory, deviceInfos, customZoneSets))
+            {
+                return false;
+            }
+        }
+
+        if (!appZoneHistory.has_value())
+        {
+            MappedFile appZoneHistoryFile{ appZoneHistoryFileName };
+            appZoneHistory = appZoneHistoryFile.IsOpen() ? ParseAppZoneHistory(appZoneHistoryFile.View()) : TAppZoneHistoryMap{};
+        }
+
+        appZoneHistoryMap = std::move(appZoneHistory.value());
+        deviceInfoMap = std::move(deviceInfos);
+        customZoneSetsMap = std::move(customZoneSets);
+        return true;
+    }
+
+    bool ParseZonesSettings(std::string_view zonesSettings,
+                            std::optional<TAppZoneHistoryMap>& appZoneHistoryMap,
+                            TDeviceInfoMap& deviceInfoMap,
+                            TCustomZoneSetsMap& customZoneSetsMap)
+    {
+        return FancyZonesDataStreamParser{ zonesSettings }.ParseZonesSettings(appZoneHistoryMap, deviceInfoMap, customZoneSetsMap);
+    }
+
+    TAppZoneHistoryMap ParseAppZoneHistory(std::string_view appZoneHistory)
+    {
+        TAppZoneHistoryMap appZoneHistoryMap{};
+        if (!FancyZonesDataStreamParser{ appZoneHistory }.ParseAppZoneHistoryFile(appZoneHistoryMap))
+        {
+            return {};
+        }
+
+        return appZoneHistoryMap;
+    }
+
     void SaveFancyZonesData(const std::wstring& zonesSettingsFileName,
                             const std::wstring& appZoneHistoryFileName,
                             const TDeviceInfoMap& deviceInfoMap,
@@ -512,7 +1269,7 @@ namespace JSONHelpers
 
             return std::move(appZoneHistoryMap);
         }
-        catch (const winrt::hresult_error&)
+        catch (const json::JsonError&)
         {
             return {};
         }
@@ -547,7 +1304,7 @@ namespace JSONHelpers
 
             return std::move(deviceInfoMap);
         }
-        catch (const winrt::hresult_error&)
+        catch (const json::JsonError&)
         {
             return {};
         }
@@ -585,7 +1342,7 @@ namespace JSONHelpers
 
             return std::move(customZoneSetsMap);
         }
-        catch (const winrt::hresult_error&)
+        catch (const json::JsonError&)
         {
             return {};
         }
@@ -642,7 +1399,7 @@ namespace JSONHelpers
                     }
                 }
             }
-            catch (const winrt::hresult_error&)
+            catch (const json::JsonError&)
             {
                 result = std::nullopt;
             }
@@ -657,18 +1414,9 @@ namespace JSONHelpers
         std::vector<std::wstring> result{};
         if (std::filesystem::exists(tmpFilePath))
         {
-            auto deletedZoneSetsJson = json::from_file(tmpFilePath);
-            try
-            {
-                auto deletedCustomZoneSets = deletedZoneSetsJson->GetNamedArray(NonLocalizable::DeletedCustomZoneSetsStr);
-                for (auto zoneSet : deletedCustomZoneSets)
-                {
-                    std::wstring uuid = L"{" + std::wstring{ zoneSet.GetString() } + L"}";
-                    result.push_back(uuid);
-                }
-            }
-            catch (const winrt::hresult_error&)
+            if (auto deletedZoneSetsJson = json::from_file(tmpFilePath); deletedZoneSetsJson.has_value())
             {
+                result = ParseDeletedCustomZoneSets(*deletedZoneSetsJson);
             }
 
             DeleteTmpFile(tmpFilePath);
@@ -676,4 +1424,31 @@ namespace JSONHelpers
 
         return result;
     }
+
+    json::JsonObject SerializeEditorSnapshot(const JSONHelpers::DeviceInfoJSON& deviceInfo, const TCustomZoneSetsMap& customZoneSetsMap)
+    {
+        // Same schema as the active zone set temp file, with custom layouts the editor would otherwise read from zones-settings.json
+        json::JsonObject snapshot = JSONHelpers::DeviceInfoJSON::ToJson(deviceInfo);
+        snapshot.SetNamedValue(NonLocalizable::CustomZoneSetsStr, SerializeCustomZoneSets(customZoneSetsMap));
+        return snapshot;
+    }
+
+    std::vector<std::wstring> ParseDeletedCustomZoneSets(const json::JsonObject& deletedZoneSetsJson)
+    {
+        std::vector<std::wstring> result{};
+        try
+        {
+            auto deletedCustomZoneSets = deletedZoneSetsJson.GetNamedArray(NonLocalizable::DeletedCustomZoneSetsStr);
+            for (auto zoneSet : deletedCustomZoneSets)
+            {
+                std::wstring uuid = L"{" + std::wstring{ zoneSet.GetString() } + L"}";
+                result.push_back(uuid);
+            }
+        }
+        catch (const json::JsonError&)
+        {
+        }
+
+        return result;
+    }
 }
@@ -4,7 +4,9 @@
 
 #include <common/json.h>
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
@@ -61,6 +63,14 @@ namespace JSONHelpers
     using TCustomZoneSetsMap = std::unordered_map<std::wstring, FancyZonesDataTypes::CustomZoneSetData>;
 
     json::JsonObject GetPersistFancyZonesJSON(const std::wstring& zonesSettingsFileName, const std::wstring& appZoneHistoryFileName);
+    // Fast start path, streams zones settings and app zone history from memory-mapped files straight into the maps
+    // without building a JSON DOM. Validation is the same as with GetPersistFancyZonesJSON and the Parse* functions.
+    // Returns false and leaves the maps untouched if zones settings can't be read or aren't well-formed JSON.
+    bool LoadFancyZonesData(const std::wstring& zonesSettingsFileName,
+                            const std::wstring& appZoneHistoryFileName,
+                            TAppZoneHistoryMap& appZoneHistoryMap,
+                            TDeviceInfoMap& deviceInfoMap,
+                            TCustomZoneSetsMap& customZoneSetsMap);
     void SaveFancyZonesData(const std::wstring& zonesSettingsFileName,
                             const std::wstring& appZoneHistoryFileName,
                             const TDeviceInfoMap& deviceInfoMap,
@@ -68,6 +78,9 @@ namespace JSONHelpers
                             const TAppZoneHistoryMap& appZoneHistoryMap);
 
     TAppZoneHistoryMap ParseAppZoneHistory(const json::JsonObject& fancyZonesDataJSON);
+    // Streaming parsers over UTF-8 JSON used by LoadFancyZonesData. appZoneHistoryMap is set only if zones settings have app zone history.
+    bool ParseZonesSettings(std::string_view zonesSettings, std::optional<TAppZoneHistoryMap>& appZoneHistoryMap, TDeviceInfoMap& deviceInfoMap, TCustomZoneSetsMap& customZoneSetsMap);
+    TAppZoneHistoryMap ParseAppZoneHistory(std::string_view appZoneHistory);
     json::JsonArray SerializeAppZoneHistory(const TAppZoneHistoryMap& appZoneHistoryMap);
 
     TDeviceInfoMap ParseDeviceInfos(const json::JsonObject& fancyZonesDataJSON);
@@ -80,4 +93,7 @@ namespace JSONHelpers
     std::optional<DeviceInfoJSON> ParseDeviceInfoFromTmpFile(std::wstring_view tmpFilePath);
     std::optional<CustomZoneSetJSON> ParseCustomZoneSetFromTmpFile(std::wstring_view tmpFilePath);
     std::vector<std::wstring> ParseDeletedCustomZoneSetsFromTmpFile(std::wstring_view tmpFilePath);
+
+    json::JsonObject SerializeEditorSnapshot(const JSONHelpers::DeviceInfoJSON& deviceInfo, const TCustomZoneSetsMap& customZoneSetsMap);
+    std::vector<std::wstring> ParseDeletedCustomZoneSets(const json::JsonObject& deletedZoneSetsJson);
 }
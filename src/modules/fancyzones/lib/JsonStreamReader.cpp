@@ -0,0 +1,526 @@
+#include "JsonStreamReader.h"
+
+#include <charconv>
+#include <cstdint>
+
+namespace
+{
+    constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+    inline bool IsDigit(char ch) noexcept
+    {
+        return ch >= '0' && ch <= '9';
+    }
+
+    inline int HexValue(char ch) noexcept
+    {
+        if (ch >= '0' && ch <= '9')
+        {
+            return ch - '0';
+        }
+        if (ch >= 'a' && ch <= 'f')
+        {
+            return ch - 'a' + 10;
+        }
+        if (ch >= 'A' && ch <= 'F')
+        {
+            return ch - 'A' + 10;
+        }
+        return -1;
+    }
+
+    void AppendUtf16(std::wstring& value, char32_t codePoint)
+    {
+        if (codePoint < 0x10000)
+        {
+            value.push_back(static_cast<wchar_t>(codePoint));
+        }
+        else
+        {
+            codePoint -= 0x10000;
+            value.push_back(static_cast<wchar_t>(0xD800 + (codePoint >> 10)));
+            value.push_back(static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF)));
+        }
+    }
+
+    // Decodes one UTF-8 sequence starting at position. Invalid sequences decode to the replacement character,
+    // the same way MultiByteToWideChar treats them.
+    char32_t DecodeUtf8(std::string_view text, size_t& position) noexcept
+    {
+        const auto lead = static_cast<uint8_t>(text[position++]);
+        size_t length = 0;
+        char32_t codePoint = 0;
+        if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            length = 3;
+            codePoint = lead & 0x07;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            length = 2;
+            codePoint = lead & 0x0F;
+        }
+        else if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            length = 1;
+            codePoint = lead & 0x1F;
+        }
+        else
+        {
+            return ReplacementCharacter;
+        }
+
+        for (size_t i = 0; i < length; i++)
+        {
+            if (position >= text.size() || (static_cast<uint8_t>(text[position]) & 0xC0) != 0x80)
+            {
+                return ReplacementCharacter;
+            }
+            codePoint = (codePoint << 6) | (static_cast<uint8_t>(text[position++]) & 0x3F);
+        }
+
+        const bool overlong = (length == 2 && codePoint < 0x800) || (length == 3 && codePoint < 0x10000);
+        if (overlong || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+        {
+            return ReplacementCharacter;
+        }
+
+        return codePoint;
+    }
+}
+
+JsonStreamReader::JsonStreamReader(std::string_view document) noexcept :
+    m_document(document)
+{
+    // Skip UTF-8 byte order mark
+    if (m_document.size() >= 3 && m_document.substr(0, 3) == "\xEF\xBB\xBF")
+    {
+        m_position = 3;
+    }
+}
+
+JsonStreamReader::ValueType JsonStreamReader::PeekType() noexcept
+{
+    if (m_failed)
+    {
+        return ValueType::Invalid;
+    }
+
+    SkipWhitespace();
+    if (m_position >= m_document.size())
+    {
+        return ValueType::Invalid;
+    }
+
+    switch (m_document[m_position])
+    {
+    case '{':
+        return ValueType::Object;
+    case '[':
+        return ValueType::Array;
+    case '"':
+        return ValueType::String;
+    case 't':
+    case 'f':
+        return ValueType::Boolean;
+    case 'n':
+        return ValueType::Null;
+    default:
+        return (m_document[m_position] == '-' || IsDigit(m_document[m_position])) ? ValueType::Number : ValueType::Invalid;
+    }
+}
+
+bool JsonStreamReader::BeginObject() noexcept
+{
+    if (PeekType() != ValueType::Object)
+    {
+        SkipValue();
+        return false;
+    }
+
+    if (m_firstInScope.size() >= MaxDepth)
+    {
+        return Fail();
+    }
+
+    m_position++;
+    m_firstInScope.push_back(true);
+    return true;
+}
+
+bool JsonStreamReader::NextMember(std::wstring& name)
+{
+    if (!NextInScope('}'))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (m_position >= m_document.size() || m_document[m_position] != '"')
+    {
+        return Fail();
+    }
+
+    name.clear();
+    if (!ParseString(&name))
+    {
+        return false;
+    }
+
+    return Expect(':');
+}
+
+bool JsonStreamReader::BeginArray() noexcept
+{
+    if (PeekType() != ValueType::Array)
+    {
+        SkipValue();
+        return false;
+    }
+
+    if (m_firstInScope.size() >= MaxDepth)
+    {
+        return Fail();
+    }
+
+    m_position++;
+    m_firstInScope.push_back(true);
+    return true;
+}
+
+bool JsonStreamReader::NextElement() noexcept
+{
+    return NextInScope(']');
+}
+
+bool JsonStreamReader::ReadString(std::wstring& value)
+{
+    if (PeekType() != ValueType::String)
+    {
+        SkipValue();
+        return false;
+    }
+
+    value.clear();
+    return ParseString(&value);
+}
+
+bool JsonStreamReader::ReadNumber(double& value) noexcept
+{
+    if (PeekType() != ValueType::Number)
+    {
+        SkipValue();
+        return false;
+    }
+
+    return ParseNumber(&value);
+}
+
+bool JsonStreamReader::ReadBoolean(bool& value) noexcept
+{
+    if (PeekType() != ValueType::Boolean)
+    {
+        SkipValue();
+        return false;
+    }
+
+    value = m_document[m_position] == 't';
+    return ParseLiteral(value ? "true" : "false");
+}
+
+void JsonStreamReader::SkipValue() noexcept
+{
+    switch (PeekType())
+    {
+    case ValueType::Object:
+        m_position++;
+        m_firstInScope.push_back(true);
+        if (m_firstInScope.size() > MaxDepth)
+        {
+            Fail();
+            return;
+        }
+        while (NextInScope('}'))
+        {
+            SkipWhitespace();
+            if (m_position >= m_document.size() || m_document[m_position] != '"' || !ParseString(nullptr) || !Expect(':'))
+            {
+                Fail();
+                return;
+            }
+            SkipValue();
+        }
+        break;
+    case ValueType::Array:
+        m_position++;
+        m_firstInScope.push_back(true);
+        if (m_firstInScope.size() > MaxDepth)
+        {
+            Fail();
+            return;
+        }
+        while (NextInScope(']'))
+        {
+            SkipValue();
+        }
+        break;
+    case ValueType::String:
+        ParseString(nullptr);
+        break;
+    case ValueType::Number:
+        ParseNumber(nullptr);
+        break;
+    case ValueType::Boolean:
+        ParseLiteral(m_document[m_position] == 't' ? "true" : "false");
+        break;
+    case ValueType::Null:
+        ParseLiteral("null");
+        break;
+    default:
+        Fail();
+        break;
+    }
+}
+
+bool JsonStreamReader::Finish() noexcept
+{
+    if (m_failed || !m_firstInScope.empty())
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    return m_position == m_document.size();
+}
+
+void JsonStreamReader::SkipWhitespace() noexcept
+{
+    while (m_position < m_document.size())
+    {
+        const char ch = m_document[m_position];
+        if (ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r')
+        {
+            break;
+        }
+        m_position++;
+    }
+}
+
+bool JsonStreamReader::Fail() noexcept
+{
+    m_failed = true;
+    m_position = m_document.size();
+    return false;
+}
+
+bool JsonStreamReader::Expect(char ch) noexcept
+{
+    SkipWhitespace();
+    if (m_position >= m_document.size() || m_document[m_position] != ch)
+    {
+        return Fail();
+    }
+
+    m_position++;
+    return true;
+}
+
+bool JsonStreamReader::NextInScope(char closing) noexcept
+{
+    if (m_failed || m_firstInScope.empty())
+    {
+        return Fail();
+    }
+
+    SkipWhitespace();
+    if (m_position >= m_document.size())
+    {
+        return Fail();
+    }
+
+    if (m_document[m_position] == closing)
+    {
+        m_position++;
+        m_firstInScope.pop_back();
+        return false;
+    }
+
+    if (m_firstInScope.back())
+    {
+        m_firstInScope.back() = false;
+        return true;
+    }
+
+    return Expect(',');
+}
+
+bool JsonStreamReader::ParseString(std::wstring* value)
+{
+    // Opening quote was checked by the caller
+    m_position++;
+    while (m_position < m_document.size())
+    {
+        const char ch = m_document[m_position];
+        if (ch == '"')
+        {
+            m_position++;
+            return true;
+        }
+
+        if (static_cast<uint8_t>(ch) < 0x20)
+        {
+            return Fail();
+        }
+
+        if (ch == '\\')
+        {
+            if (++m_position >= m_document.size())
+            {
+                return Fail();
+            }
+
+            char32_t escaped = 0;
+            switch (m_document[m_position++])
+            {
+            case '"':
+                escaped = '"';
+                break;
+            case '\\':
+                escaped = '\\';
+                break;
+            case '/':
+                escaped = '/';
+                break;
+            case 'b':
+                escaped = '\b';
+                break;
+            case 'f':
+                escaped = '\f';
+                break;
+            case 'n':
+                escaped = '\n';
+                break;
+            case 'r':
+                escaped = '\r';
+                break;
+            case 't':
+                escaped = '\t';
+                break;
+            case 'u':
+                if (m_position + 4 > m_document.size())
+                {
+                    return Fail();
+                }
+                for (size_t i = 0; i < 4; i++)
+                {
+                    const int digit = HexValue(m_document[m_position++]);
+                    if (digit < 0)
+                    {
+                        return Fail();
+                    }
+                    escaped = (escaped << 4) | static_cast<char32_t>(digit);
+                }
+                break;
+            default:
+                return Fail();
+            }
+
+            // \u escapes are UTF-16 code units already, surrogate pairs are passed through as they are
+            if (value)
+            {
+                value->push_back(static_cast<wchar_t>(escaped));
+            }
+        }
+        else if (static_cast<uint8_t>(ch) < 0x80)
+        {
+            if (value)
+            {
+                value->push_back(static_cast<wchar_t>(ch));
+            }
+            m_position++;
+        }
+        else
+        {
+            const char32_t codePoint = DecodeUtf8(m_document, m_position);
+            if (value)
+            {
+                AppendUtf16(*value, codePoint);
+            }
+        }
+    }
+
+    return Fail();
+}
+
+bool JsonStreamReader::ParseNumber(double* value) noexcept
+{
+    const size_t start = m_position;
+    auto digits = [this]() {
+        const size_t first = m_position;
+        while (m_position < m_document.size() && IsDigit(m_document[m_position]))
+        {
+            m_position++;
+        }
+        return m_position - first;
+    };
+
+    if (m_document[m_position] == '-')
+    {
+        m_position++;
+    }
+
+    if (m_position < m_document.size() && m_document[m_position] == '0')
+    {
+        m_position++;
+    }
+    else if (digits() == 0)
+    {
+        return Fail();
+    }
+
+    if (m_position < m_document.size() && m_document[m_position] == '.')
+    {
+        m_position++;
+        if (digits() == 0)
+        {
+            return Fail();
+        }
+    }
+
+    if (m_position < m_document.size() && (m_document[m_position] == 'e' || m_document[m_position] == 'E'))
+    {
+        m_position++;
+        if (m_position < m_document.size() && (m_document[m_position] == '+' || m_document[m_position] == '-'))
+        {
+            m_position++;
+        }
+        if (digits() == 0)
+        {
+            return Fail();
+        }
+    }
+
+    if (value)
+    {
+        const char* begin = m_document.data() + start;
+        const char* end = m_document.data() + m_position;
+        const auto result = std::from_chars(begin, end, *value);
+        if (result.ec == std::errc::result_out_of_range)
+        {
+            return Fail();
+        }
+    }
+
+    return true;
+}
+
+bool JsonStreamReader::ParseLiteral(std::string_view literal) noexcept
+{
+    if (m_document.substr(m_position, literal.size()) != literal)
+    {
+        return Fail();
+    }
+
+    m_position += literal.size();
+    return true;
+}
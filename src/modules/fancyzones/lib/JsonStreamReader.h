@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Forward-only reader over a UTF-8 JSON document. Values are consumed in document order without building a DOM,
+ * which allows callers to fill their own data structures straight from a memory-mapped file.
+ *
+ * Type mismatches are not errors: typed reads skip the unexpected value and return false, leaving it up to the
+ * caller how to treat it. Malformed JSON puts the reader in a failed state in which every read returns false.
+ */
+class JsonStreamReader
+{
+public:
+    enum class ValueType : int
+    {
+        Invalid = 0,
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    // Nesting deeper than this is treated as malformed JSON.
+    static constexpr size_t MaxDepth = 256;
+
+    explicit JsonStreamReader(std::string_view document) noexcept;
+
+    // Type of the next value, without consuming it.
+    ValueType PeekType() noexcept;
+
+    // Enters the object if the next value is an object, otherwise skips the value and returns false.
+    bool BeginObject() noexcept;
+
+    // Reads the name of the next member of the current object. Returns false once the object is exhausted.
+    // Member value has to be consumed before the next call.
+    bool NextMember(std::wstring& name);
+
+    // Enters the array if the next value is an array, otherwise skips the value and returns false.
+    bool BeginArray() noexcept;
+
+    // Returns false once the current array is exhausted. Element value has to be consumed before the next call.
+    bool NextElement() noexcept;
+
+    bool ReadString(std::wstring& value);
+    bool ReadNumber(double& value) noexcept;
+    bool ReadBoolean(bool& value) noexcept;
+    void SkipValue() noexcept;
+
+    // Returns true if the whole document was well-formed and nothing but whitespace follows the root value.
+    bool Finish() noexcept;
+
+    inline bool Failed() const noexcept
+    {
+        return m_failed;
+    }
+
+private:
+    void SkipWhitespace() noexcept;
+    bool Fail() noexcept;
+    bool Expect(char ch) noexcept;
+    bool NextInScope(char closing) noexcept;
+    bool ParseString(std::wstring* value);
+    bool ParseNumber(double* value) noexcept;
+    bool ParseLiteral(std::string_view literal) noexcept;
+
+    std::string_view m_document;
+    size_t m_position = 0;
+    bool m_failed = false;
+
+    // One entry per open container, true until its first element or member was read.
+    std::vector<bool> m_firstInScope;
+};
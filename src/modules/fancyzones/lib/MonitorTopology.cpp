@@ -0,0 +1,73 @@
+#include "pch.h"
+#include "MonitorTopology.h"
+
+#include "util.h"
+
+namespace
+{
+    constexpr size_t PreviousMonitor = 0;
+    constexpr size_t NextMonitor = 1;
+}
+
+MonitorTopology::MonitorTopology(std::vector<Monitor> monitors) :
+    m_monitors(std::move(monitors))
+{
+    std::vector<std::pair<HMONITOR, RECT>> monitorInfo;
+    monitorInfo.reserve(m_monitors.size());
+    for (const auto& monitor : m_monitors)
+    {
+        monitorInfo.push_back({ monitor.monitor, monitor.monitorRect });
+
+        if (m_sortedMonitors.empty())
+        {
+            m_combinedWorkAreaRect = monitor.workAreaRect;
+        }
+        else
+        {
+            m_combinedWorkAreaRect.left = min(m_combinedWorkAreaRect.left, monitor.workAreaRect.left);
+            m_combinedWorkAreaRect.top = min(m_combinedWorkAreaRect.top, monitor.workAreaRect.top);
+            m_combinedWorkAreaRect.right = max(m_combinedWorkAreaRect.right, monitor.workAreaRect.right);
+            m_combinedWorkAreaRect.bottom = max(m_combinedWorkAreaRect.bottom, monitor.workAreaRect.bottom);
+        }
+        m_sortedMonitors.push_back(monitor.monitor);
+    }
+
+    FancyZonesUtils::OrderMonitors(monitorInfo);
+    const size_t count = monitorInfo.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        m_sortedMonitors[i] = monitorInfo[i].first;
+    }
+
+    m_neighbours.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto it = std::find(std::begin(m_sortedMonitors), std::end(m_sortedMonitors), m_monitors[i].monitor);
+        const size_t position = std::distance(std::begin(m_sortedMonitors), it);
+        m_neighbours[i][PreviousMonitor] = m_sortedMonitors[(position + count - 1) % count];
+        m_neighbours[i][NextMonitor] = m_sortedMonitors[(position + 1) % count];
+    }
+}
+
+const MonitorTopology::Monitor* MonitorTopology::Find(HMONITOR monitor) const noexcept
+{
+    auto it = std::find_if(std::begin(m_monitors), std::end(m_monitors), [monitor](const Monitor& item) { return item.monitor == monitor; });
+    return it != std::end(m_monitors) ? &*it : nullptr;
+}
+
+HMONITOR MonitorTopology::Neighbour(HMONITOR monitor, DWORD vkCode) const noexcept
+{
+    if (vkCode != VK_LEFT && vkCode != VK_RIGHT)
+    {
+        return nullptr;
+    }
+
+    const Monitor* item = Find(monitor);
+    if (item == nullptr)
+    {
+        return nullptr;
+    }
+
+    const auto& neighbours = m_neighbours[item - m_monitors.data()];
+    return neighbours[vkCode == VK_RIGHT ? NextMonitor : PreviousMonitor];
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+/**
+ * Snapshot of the monitor layout, built once per display or work area change and queried by the keyboard
+ * snapping paths without enumerating monitors again.
+ */
+class MonitorTopology
+{
+public:
+    struct Monitor
+    {
+        HMONITOR monitor;
+        RECT monitorRect;
+        RECT workAreaRect;
+        // Work area as seen by a DPI unaware process, used for the editor
+        RECT dpiUnawareWorkAreaRect;
+    };
+
+    MonitorTopology() = default;
+
+    /**
+     * @param[in]  monitors Monitors in display enumeration order.
+     */
+    explicit MonitorTopology(std::vector<Monitor> monitors);
+
+    /**
+     * Monitors in display enumeration order.
+     */
+    inline const std::vector<Monitor>& Monitors() const noexcept
+    {
+        return m_monitors;
+    }
+
+    /**
+     * Monitors in the order used for cycling with Win+Left/Right, see FancyZonesUtils::OrderMonitors.
+     */
+    inline const std::vector<HMONITOR>& SortedMonitors() const noexcept
+    {
+        return m_sortedMonitors;
+    }
+
+    /**
+     * @returns    Bounding rectangle of all work areas.
+     */
+    inline const RECT& CombinedWorkAreaRect() const noexcept
+    {
+        return m_combinedWorkAreaRect;
+    }
+
+    /**
+     * @returns    Information about the given monitor, nullptr if it is not part of the topology.
+     */
+    const Monitor* Find(HMONITOR monitor) const noexcept;
+
+    /**
+     * Neighbour of the monitor in the sorted order, wrapping around at both ends.
+     *
+     * @param[in]  monitor Monitor handle.
+     * @param[in]  vkCode  VK_RIGHT for the next monitor, VK_LEFT for the previous one.
+     *
+     * @returns    Neighbouring monitor, nullptr for unknown monitors or other keys.
+     */
+    HMONITOR Neighbour(HMONITOR monitor, DWORD vkCode) const noexcept;
+
+private:
+    std::vector<Monitor> m_monitors;
+    std::vector<HMONITOR> m_sortedMonitors;
+    RECT m_combinedWorkAreaRect{};
+
+    // Per entry of m_monitors: previous and next monitor in the sorted order
+    std::vector<std::array<HMONITOR, 2>> m_neighbours;
+};
@@ -4,10 +4,11 @@
 
 winrt::com_ptr<IZoneWindow> MonitorWorkAreaHandler::GetWorkArea(const GUID& desktopId, HMONITOR monitor)
 {
-    auto desktopIt = workAreaMap.find(desktopId);
-    if (desktopIt != std::end(workAreaMap))
+    const auto snapshot = workAreaMap.Load();
+    auto desktopIt = snapshot->find(desktopId);
+    if (desktopIt != std::end(*snapshot))
     {
-        auto& perDesktopData = desktopIt->second;
+        const auto& perDesktopData = *desktopIt->second;
         auto monitorIt = perDesktopData.find(monitor);
         if (monitorIt != std::end(perDesktopData))
         {
@@ -39,23 +40,25 @@ winrt::com_ptr<IZoneWindow> MonitorWorkAreaHandler::GetWorkArea(HWND window)
     return nullptr;
 }
 
-const std::unordered_map<HMONITOR, winrt::com_ptr<IZoneWindow>>& MonitorWorkAreaHandler::GetWorkAreasByDesktopId(const GUID& desktopId)
+std::shared_ptr<const MonitorWorkAreaHandler::TWorkAreasByMonitor> MonitorWorkAreaHandler::GetWorkAreasByDesktopId(const GUID& desktopId)
 {
-    if (workAreaMap.contains(desktopId))
+    const auto snapshot = workAreaMap.Load();
+    auto desktopIt = snapshot->find(desktopId);
+    if (desktopIt != std::end(*snapshot))
     {
-        return workAreaMap[desktopId];
+        return desktopIt->second;
     }
-    static const std::unordered_map<HMONITOR, winrt::com_ptr<IZoneWindow>> empty;
+    static const auto empty = std::make_shared<const TWorkAreasByMonitor>();
     return empty;
 }
 
 std::vector<winrt::com_ptr<IZoneWindow>> MonitorWorkAreaHandler::GetAllWorkAreas()
 {
     std::vector<winrt::com_ptr<IZoneWindow>> workAreas{};
-    for (const auto& [desktopId, perDesktopData] : workAreaMap)
+    for (const auto& [desktopId, perDesktopData] : *workAreaMap.Load())
     {
-        std::transform(std::begin(perDesktopData),
-                       std::end(perDesktopData),
+        std::transform(std::begin(*perDesktopData),
+                       std::end(*perDesktopData),
                        std::back_inserter(workAreas),
                        [](const auto& item) { return item.second; });
     }
@@ -64,20 +67,20 @@ std::vector<winrt::com_ptr<IZoneWindow>> MonitorWorkAreaHandler::GetAllWorkAreas
 
 void MonitorWorkAreaHandler::AddWorkArea(const GUID& desktopId, HMONITOR monitor, winrt::com_ptr<IZoneWindow>& workArea)
 {
-    if (!workAreaMap.contains(desktopId))
-    {
-        workAreaMap[desktopId] = {};
-    }
-    auto& perDesktopData = workAreaMap[desktopId];
-    perDesktopData[monitor] = std::move(workArea);
+    workAreaMap.Update([&](TWorkAreaMap& map) {
+        auto perDesktopData = map.contains(desktopId) ? std::make_shared<TWorkAreasByMonitor>(*map[desktopId]) : std::make_shared<TWorkAreasByMonitor>();
+        (*perDesktopData)[monitor] = std::move(workArea);
+        map[desktopId] = std::move(perDesktopData);
+    });
 }
 
 bool MonitorWorkAreaHandler::IsNewWorkArea(const GUID& desktopId, HMONITOR monitor)
 {
-    if (workAreaMap.contains(desktopId))
+    const auto snapshot = workAreaMap.Load();
+    auto desktopIt = snapshot->find(desktopId);
+    if (desktopIt != std::end(*snapshot))
     {
-        const auto& perDesktopData = workAreaMap[desktopId];
-        if (perDesktopData.contains(monitor))
+        if (desktopIt->second->contains(monitor))
         {
             return false;
         }
@@ -87,29 +90,31 @@ bool MonitorWorkAreaHandler::IsNewWorkArea(const GUID& desktopId, HMONITOR monit
 
 void MonitorWorkAreaHandler::RegisterUpdates(const std::vector<GUID>& active)
 {
-    std::unordered_set<GUID> activeVirtualDesktops(std::begin(active), std::end(active));
-    for (auto desktopIt = std::begin(workAreaMap); desktopIt != std::end(workAreaMap);)
-    {
-        auto activeIt = activeVirtualDesktops.find(desktopIt->first);
-        if (activeIt == std::end(activeVirtualDesktops))
+    workAreaMap.Update([&](TWorkAreaMap& map) {
+        std::unordered_set<GUID> activeVirtualDesktops(std::begin(active), std::end(active));
+        for (auto desktopIt = std::begin(map); desktopIt != std::end(map);)
         {
-            // virtual desktop deleted, remove entry from the map
-            desktopIt = workAreaMap.erase(desktopIt);
+            auto activeIt = activeVirtualDesktops.find(desktopIt->first);
+            if (activeIt == std::end(activeVirtualDesktops))
+            {
+                // virtual desktop deleted, remove entry from the map
+                desktopIt = map.erase(desktopIt);
+            }
+            else
+            {
+                activeVirtualDesktops.erase(desktopIt->first); // virtual desktop already in map, skip it
+                ++desktopIt;
+            }
         }
-        else
+        // register new virtual desktops, if any
+        for (const auto& id : activeVirtualDesktops)
         {
-            activeVirtualDesktops.erase(desktopIt->first); // virtual desktop already in map, skip it
-            ++desktopIt;
+            map[id] = std::make_shared<const TWorkAreasByMonitor>();
         }
-    }
-    // register new virtual desktops, if any
-    for (const auto& id : activeVirtualDesktops)
-    {
-        workAreaMap[id] = {};
-    }
+    });
 }
 
 void MonitorWorkAreaHandler::Clear()
 {
-    workAreaMap.clear();
+    workAreaMap.Store({});
 }
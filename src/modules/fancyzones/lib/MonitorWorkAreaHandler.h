@@ -1,5 +1,7 @@
 #pragma once
 
+#include "AtomicSnapshot.h"
+
 interface IZoneWindow;
 
 namespace std
@@ -15,9 +17,16 @@ namespace std
     };
 }
 
+/**
+ * Registry of work areas per virtual desktop and monitor.
+ *
+ * Work areas are published as immutable snapshots: lookups never block, and the maps they return stay valid
+ * while display change or virtual desktop handlers register new work areas.
+ */
 class MonitorWorkAreaHandler
 {
 public:
+    using TWorkAreasByMonitor = std::unordered_map<HMONITOR, winrt::com_ptr<IZoneWindow>>;
     /**
      * Get work area based on virtual desktop id and monitor handle.
      *
@@ -45,9 +54,10 @@ public:
      *
      * @param[in]  desktopId Virtual desktop identifier.
      *
-     * @returns    Map containing pairs of monitor and work area for that monitor (within same virtual desktop).
+     * @returns    Snapshot of the map containing pairs of monitor and work area for that monitor (within same
+     *             virtual desktop). Never null, later changes are not reflected in the returned map.
      */
-    const std::unordered_map<HMONITOR, winrt::com_ptr<IZoneWindow>>& GetWorkAreasByDesktopId(const GUID& desktopId);
+    std::shared_ptr<const TWorkAreasByMonitor> GetWorkAreasByDesktopId(const GUID& desktopId);
 
     /**
      * @returns    All registered work areas.
@@ -86,6 +96,9 @@ public:
     void Clear();
 
 private:
-    // Work area is uniquely defined by monitor and virtual desktop id.
-    std::unordered_map<GUID, std::unordered_map<HMONITOR, winrt::com_ptr<IZoneWindow>>> workAreaMap;
+    // Work area is uniquely defined by monitor and virtual desktop id. Per-desktop maps are shared between
+    // snapshots, only the desktop being changed is copied.
+    using TWorkAreaMap = std::unordered_map<GUID, std::shared_ptr<const TWorkAreasByMonitor>>;
+
+    AtomicSnapshot<TWorkAreaMap> workAreaMap;
 };
@@ -0,0 +1,310 @@
+#include "ReplayTrace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    constexpr size_t Align(size_t size) noexcept
+    {
+        return (size + 3) & ~size_t{ 3 };
+    }
+
+    template<typename T>
+    void Put(std::string& buffer, T value)
+    {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        buffer.append(bytes, sizeof(T));
+    }
+
+    void PutRect(std::string& buffer, const ReplayTrace::Rect& rect)
+    {
+        Put(buffer, rect.left);
+        Put(buffer, rect.top);
+        Put(buffer, rect.right);
+        Put(buffer, rect.bottom);
+    }
+
+    // Reads values from a record payload, every read fails once the payload is exhausted.
+    class PayloadReader
+    {
+    public:
+        explicit PayloadReader(std::string_view payload) noexcept :
+            m_payload(payload)
+        {
+        }
+
+        template<typename T>
+        bool Get(T& value) noexcept
+        {
+            if (m_position + sizeof(T) > m_payload.size())
+            {
+                return false;
+            }
+
+            std::memcpy(&value, m_payload.data() + m_position, sizeof(T));
+            m_position += sizeof(T);
+            return true;
+        }
+
+        bool GetRect(ReplayTrace::Rect& rect) noexcept
+        {
+            return Get(rect.left) && Get(rect.top) && Get(rect.right) && Get(rect.bottom);
+        }
+
+        size_t Remaining() const noexcept
+        {
+            return m_payload.size() - m_position;
+        }
+
+    private:
+        std::string_view m_payload;
+        size_t m_position = 0;
+    };
+
+    constexpr size_t ZoneSize = sizeof(uint32_t) + 4 * sizeof(int32_t);
+
+    bool ParseLayout(std::string_view payload, ReplayTrace::Layout& layout)
+    {
+        PayloadReader reader(payload);
+        uint32_t workAreaCount = 0;
+        if (!reader.Get(workAreaCount))
+        {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < workAreaCount; i++)
+        {
+            ReplayTrace::WorkArea workArea;
+            uint32_t zoneCount = 0;
+            if (!reader.GetRect(workArea.rect) || !reader.Get(workArea.sensitivityRadius) || !reader.Get(zoneCount) ||
+                zoneCount > reader.Remaining() / ZoneSize)
+            {
+                return false;
+            }
+
+            workArea.zones.resize(zoneCount);
+            for (auto& zone : workArea.zones)
+            {
+                if (!reader.Get(zone.id) || !reader.GetRect(zone.rect))
+                {
+                    return false;
+                }
+            }
+            layout.workAreas.push_back(std::move(workArea));
+        }
+
+        return true;
+    }
+
+    bool ParseEvent(std::string_view payload, ReplayTrace::Event& event)
+    {
+        PayloadReader reader(payload);
+        uint32_t kind = 0;
+        if (!reader.Get(kind) || !reader.Get(event.workArea) || !reader.Get(event.timestamp) || !reader.Get(event.x) ||
+            !reader.Get(event.y) || !reader.Get(event.modifiers) || !reader.Get(event.vkCode))
+        {
+            return false;
+        }
+
+        event.kind = static_cast<ReplayTrace::EventKind>(kind);
+        return true;
+    }
+}
+
+namespace ReplayTrace
+{
+    Writer::Writer(size_t capacity) :
+        m_capacity(capacity)
+    {
+        Put(m_data, Magic);
+        Put(m_data, Version);
+    }
+
+    bool Writer::Append(const Layout& layout)
+    {
+        std::string payload;
+        Put(payload, static_cast<uint32_t>(layout.workAreas.size()));
+        for (const auto& workArea : layout.workAreas)
+        {
+            PutRect(payload, workArea.rect);
+            Put(payload, workArea.sensitivityRadius);
+            Put(payload, static_cast<uint32_t>(workArea.zones.size()));
+            for (const auto& zone : workArea.zones)
+            {
+                Put(payload, zone.id);
+                PutRect(payload, zone.rect);
+            }
+        }
+
+        return AppendRecord(RecordKind::Layout, payload);
+    }
+
+    bool Writer::Append(const Event& event)
+    {
+        std::string payload;
+        Put(payload, static_cast<uint32_t>(event.kind));
+        Put(payload, event.workArea);
+        Put(payload, event.timestamp);
+        Put(payload, event.x);
+        Put(payload, event.y);
+        Put(payload, event.modifiers);
+        Put(payload, event.vkCode);
+
+        return AppendRecord(RecordKind::Event, payload);
+    }
+
+    bool Writer::AppendRecord(RecordKind kind, const std::string& payload)
+    {
+        const size_t recordSize = sizeof(RecordHeader) + Align(payload.size());
+        if (m_full || m_data.size() + recordSize > m_capacity)
+        {
+            m_full = true;
+            return false;
+        }
+
+        Put(m_data, static_cast<uint32_t>(kind));
+        Put(m_data, static_cast<uint32_t>(payload.size()));
+        m_data += payload;
+        m_data.append(Align(payload.size()) - payload.size(), '\0');
+        return true;
+    }
+
+    bool Read(std::string_view data, std::vector<Record>& records)
+    {
+        Header header{};
+        if (data.size() < sizeof(header))
+        {
+            return false;
+        }
+
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic != Magic || header.version != Version)
+        {
+            return false;
+        }
+
+        size_t offset = sizeof(header);
+        while (offset < data.size())
+        {
+            RecordHeader recordHeader{};
+            if (offset + sizeof(recordHeader) > data.size())
+            {
+                return false;
+            }
+
+            std::memcpy(&recordHeader, data.data() + offset, sizeof(recordHeader));
+            offset += sizeof(recordHeader);
+            if (recordHeader.size > data.size() - offset)
+            {
+                return false;
+            }
+
+            const std::string_view payload = data.substr(offset, recordHeader.size);
+            switch (static_cast<RecordKind>(recordHeader.kind))
+            {
+            case RecordKind::Layout:
+            {
+                Layout layout{};
+                if (!ParseLayout(payload, layout))
+                {
+                    return false;
+                }
+                records.emplace_back(std::move(layout));
+                break;
+            }
+            case RecordKind::Event:
+            {
+                Event event{};
+                if (!ParseEvent(payload, event))
+                {
+                    return false;
+                }
+                records.emplace_back(event);
+                break;
+            }
+            default:
+                // Records from newer recorders are skipped
+                break;
+            }
+
+            offset += (std::min)(Align(recordHeader.size), data.size() - offset);
+        }
+
+        return true;
+    }
+
+    bool ReadFile(const std::filesystem::path& path, std::vector<Record>& records)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        const std::string data{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+        return Read(data, records);
+    }
+
+    bool Recorder::Open(const std::filesystem::path& path)
+    {
+        m_path = path;
+        m_writer = Writer{};
+        m_flushedSize = 0;
+        m_start = std::chrono::steady_clock::now();
+
+        // Replace the trace of a previous run, Flush only appends to it
+        if (!std::ofstream(m_path, std::ios::binary | std::ios::trunc))
+        {
+            m_path.clear();
+            return false;
+        }
+        return Flush();
+    }
+
+    void Recorder::RecordLayout(const Layout& layout)
+    {
+        if (IsOpen())
+        {
+            m_writer.Append(layout);
+        }
+    }
+
+    void Recorder::RecordEvent(EventKind kind, uint32_t workArea, int32_t x, int32_t y, uint32_t modifiers, uint32_t vkCode)
+    {
+        if (!IsOpen())
+        {
+            return;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
+        m_writer.Append(Event{ kind, workArea, static_cast<uint64_t>(elapsed.count()), x, y, modifiers, vkCode });
+    }
+
+    bool Recorder::Flush()
+    {
+        if (!IsOpen())
+        {
+            return false;
+        }
+
+        const std::string& data = m_writer.Data();
+        if (m_flushedSize == data.size())
+        {
+            return true;
+        }
+
+        std::ofstream file(m_path, std::ios::binary | std::ios::app);
+        file.write(data.data() + m_flushedSize, data.size() - m_flushedSize);
+        if (!file.good())
+        {
+            return false;
+        }
+
+        m_flushedSize = data.size();
+        return true;
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+/**
+ * Compact binary trace of drag and snap hotkey sessions, replayed headlessly to reproduce performance issues.
+ *
+ * A trace starts with a header followed by records. Layout records capture the work areas and their zones
+ * as they were when a session started, event records the input that drove the session. Every record starts
+ * with a record header followed by the payload padded to 4 bytes, all values are little endian.
+ */
+namespace ReplayTrace
+{
+    constexpr uint32_t Magic = 0x54525A46; // "FZRT"
+    constexpr uint32_t Version = 1;
+    constexpr size_t DefaultCapacity = 8 * 1024 * 1024;
+    constexpr uint32_t NoWorkArea = UINT32_MAX;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+    };
+
+    enum class RecordKind : uint32_t
+    {
+        Layout = 1,
+        Event = 2,
+    };
+
+    struct RecordHeader
+    {
+        uint32_t kind;
+        uint32_t size;
+    };
+
+    struct Rect
+    {
+        int32_t left;
+        int32_t top;
+        int32_t right;
+        int32_t bottom;
+    };
+
+    struct Zone
+    {
+        uint32_t id;
+        Rect rect; // Relative to the work area
+    };
+
+    struct WorkArea
+    {
+        Rect rect; // Screen coordinates
+        int32_t sensitivityRadius;
+        std::vector<Zone> zones; // Zones of the active zone set
+    };
+
+    struct Layout
+    {
+        std::vector<WorkArea> workAreas;
+    };
+
+    enum class EventKind : uint32_t
+    {
+        MoveSizeStart = 1,
+        MoveSizeUpdate = 2,
+        MoveSizeEnd = 3,
+        SnapHotkey = 4,
+    };
+
+    enum Modifiers : uint32_t
+    {
+        DragEnabled = 1,
+        SelectManyZones = 2,
+    };
+
+    struct Event
+    {
+        EventKind kind;
+        uint32_t workArea; // Index into the work areas of the preceding layout, NoWorkArea if none
+        uint64_t timestamp; // Microseconds since recording started
+        int32_t x; // Cursor position, screen coordinates
+        int32_t y;
+        uint32_t modifiers;
+        uint32_t vkCode; // SnapHotkey only
+    };
+
+    using Record = std::variant<Layout, Event>;
+
+    // Serializes records into an in-memory trace. Records which would exceed the capacity are dropped.
+    class Writer
+    {
+    public:
+        explicit Writer(size_t capacity = DefaultCapacity);
+
+        bool Append(const Layout& layout);
+        bool Append(const Event& event);
+
+        inline const std::string& Data() const noexcept
+        {
+            return m_data;
+        }
+
+        inline bool Full() const noexcept
+        {
+            return m_full;
+        }
+
+    private:
+        bool AppendRecord(RecordKind kind, const std::string& payload);
+
+        std::string m_data;
+        size_t m_capacity;
+        bool m_full = false;
+    };
+
+    // Parses a trace. Returns false for foreign or malformed data, records read up to that point are kept.
+    bool Read(std::string_view data, std::vector<Record>& records);
+
+    // Reads a trace file.
+    bool ReadFile(const std::filesystem::path& path, std::vector<Record>& records);
+
+    // Records events with timestamps relative to Open and appends them to a file on Flush.
+    class Recorder
+    {
+    public:
+        bool Open(const std::filesystem::path& path);
+
+        inline bool IsOpen() const noexcept
+        {
+            return !m_path.empty();
+        }
+
+        void RecordLayout(const Layout& layout);
+        void RecordEvent(EventKind kind, uint32_t workArea, int32_t x, int32_t y, uint32_t modifiers, uint32_t vkCode = 0);
+
+        // Appends the records added since the previous Flush to the trace file, so flushing after every
+        // session costs as much as the session and not the whole trace.
+        bool Flush();
+
+    private:
+        std::filesystem::path m_path;
+        Writer m_writer;
+        size_t m_flushedSize = 0; // Bytes of the trace which are already in the file
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
@@ -6,6 +6,13 @@
 namespace ZonedWindowProperties
 {
     const wchar_t PropertyMultipleZoneID[]  = L"FancyZones_zones";
+    // Zones with index 64 and above are stamped in additional properties, 64 zones per property.
+    const wchar_t PropertyMultipleZone64ID[]  = L"FancyZones_zones_64";
+    const wchar_t PropertyMultipleZone128ID[] = L"FancyZones_zones_128";
+    const wchar_t PropertyMultipleZone192ID[] = L"FancyZones_zones_192";
+    // Zones with index 256 and above continue the same naming, e.g. FancyZones_zones_256. The number of
+    // those properties on the window is stamped in PropertyMultipleZoneOverflowCountID.
+    const wchar_t PropertyMultipleZoneOverflowCountID[] = L"FancyZones_zones_overflow";
     const wchar_t PropertyRestoreSizeID[]   = L"FancyZones_RestoreSize";
     const wchar_t PropertyRestoreOriginID[] = L"FancyZones_RestoreOrigin";
 
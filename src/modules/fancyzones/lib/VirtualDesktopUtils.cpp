@@ -2,6 +2,8 @@
 
 #include "VirtualDesktopUtils.h"
 
+#include <atomic>
+
 // Non-Localizable strings
 namespace NonLocalizable
 {
@@ -10,6 +12,11 @@ namespace NonLocalizable
     const wchar_t RegKeyVirtualDesktops[] = L"Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktops";
 }
 
+namespace
+{
+    std::atomic<std::shared_ptr<const VirtualDesktopState>> virtualDesktopState;
+}
+
 namespace VirtualDesktopUtils
 {
     const CLSID CLSID_ImmersiveShell = { 0xC2F03A33, 0x21F5, 0x47FA, 0xB4, 0xBB, 0x15, 0x63, 0x62, 0xA2, 0xF2, 0x39 };
@@ -44,46 +51,58 @@ namespace VirtualDesktopUtils
 
     bool GetZoneWindowDesktopId(IZoneWindow* zoneWindow, GUID* desktopId)
     {
-        // Format: <device-id>_<resolution>_<virtual-desktop-id>
-        std::wstring uniqueId = zoneWindow->UniqueId();
-        std::wstring virtualDesktopId = uniqueId.substr(uniqueId.rfind('_') + 1);
-        return SUCCEEDED(CLSIDFromString(virtualDesktopId.c_str(), desktopId));
+        *desktopId = zoneWindow->VirtualDesktopId();
+        return *desktopId != GUID_NULL;
     }
 
-    bool GetDesktopIdFromCurrentSession(GUID* desktopId)
+    wil::unique_hkey OpenSessionVirtualDesktopsRegKey()
     {
         DWORD sessionId;
         ProcessIdToSessionId(GetCurrentProcessId(), &sessionId);
 
         wchar_t sessionKeyPath[256]{};
-        RETURN_IF_FAILED(
-            StringCchPrintfW(
+        if (FAILED(StringCchPrintfW(
                 sessionKeyPath,
                 ARRAYSIZE(sessionKeyPath),
                 L"Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\SessionInfo\\%d\\VirtualDesktops",
-                sessionId));
+                sessionId)))
+        {
+            return {};
+        }
 
         wil::unique_hkey key{};
-        GUID value{};
-        if (RegOpenKeyExW(HKEY_CURRENT_USER, sessionKeyPath, 0, KEY_ALL_ACCESS, &key) == ERROR_SUCCESS)
+        if (RegOpenKeyExW(HKEY_CURRENT_USER, sessionKeyPath, 0, KEY_ALL_ACCESS, &key) != ERROR_SUCCESS)
+        {
+            return {};
+        }
+        return key;
+    }
+
+    std::optional<GUID> GetDesktopIdFromCurrentSession()
+    {
+        wil::unique_hkey key = OpenSessionVirtualDesktopsRegKey();
+        if (key)
         {
+            GUID value{};
             DWORD size = sizeof(GUID);
             if (RegQueryValueExW(key.get(), NonLocalizable::RegCurrentVirtualDesktop, 0, nullptr, reinterpret_cast<BYTE*>(&value), &size) == ERROR_SUCCESS)
             {
-                *desktopId = value;
-                return true;
+                return value;
             }
         }
-        return false;
+        return std::nullopt;
     }
 
     bool GetCurrentVirtualDesktopId(GUID* desktopId)
     {
+        const auto state = GetVirtualDesktopState();
+
         // Explorer persists current virtual desktop identifier to registry on a per session basis, but only
         // after first virtual desktop switch happens. If the user hasn't switched virtual desktops in this
         // session, value in registry will be empty.
-        if (GetDesktopIdFromCurrentSession(desktopId))
+        if (state->currentId.has_value())
         {
+            *desktopId = *state->currentId;
             return true;
         }
         // First fallback scenario is to try obtaining virtual desktop id through IVirtualDesktopManager
@@ -97,14 +116,10 @@ namespace VirtualDesktopUtils
         // session. Note that we are taking first element from virtual desktop array, which is primary desktop.
         // If user has more than one virtual desktop, one of previous functions should return correct value,
         // as desktop switch occured in current session.
-        else
+        else if (!state->ids.empty())
         {
-            std::vector<GUID> ids{};
-            if (GetVirtualDesktopIds(ids) && ids.size() > 0)
-            {
-                *desktopId = ids[0];
-                return true;
-            }
+            *desktopId = state->ids[0];
+            return true;
         }
         return false;
     }
@@ -141,25 +156,24 @@ namespace VirtualDesktopUtils
 
     bool GetVirtualDesktopIds(std::vector<GUID>& ids)
     {
-        return GetVirtualDesktopIds(GetVirtualDesktopsRegKey(), ids);
+        const auto state = GetVirtualDesktopState();
+        if (state->ids.empty())
+        {
+            return false;
+        }
+        ids = state->ids;
+        return true;
     }
 
     bool GetVirtualDesktopIds(std::vector<std::wstring>& ids)
     {
-        std::vector<GUID> guids{};
-        if (GetVirtualDesktopIds(guids))
+        const auto state = GetVirtualDesktopState();
+        if (state->ids.empty())
         {
-            for (auto& guid : guids)
-            {
-                wil::unique_cotaskmem_string guidString;
-                if (SUCCEEDED(StringFromCLSID(guid, &guidString)))
-                {
-                    ids.push_back(guidString.get());
-                }
-            }
-            return true;
+            return false;
         }
-        return false;
+        ids.insert(ids.end(), state->idStrings.begin(), state->idStrings.end());
+        return true;
     }
 
     HKEY OpenVirtualDesktopsRegKey()
@@ -178,27 +192,88 @@ namespace VirtualDesktopUtils
         return virtualDesktopsKey.get();
     }
 
-    void HandleVirtualDesktopUpdates(HWND window, UINT message, HANDLE terminateEvent)
+    void RefreshVirtualDesktopState()
     {
-        HKEY virtualDesktopsRegKey = GetVirtualDesktopsRegKey();
-        if (!virtualDesktopsRegKey)
+        auto state = std::make_shared<VirtualDesktopState>();
+        if (GetVirtualDesktopIds(GetVirtualDesktopsRegKey(), state->ids))
         {
-            return;
+            state->idStrings.reserve(state->ids.size());
+            for (const auto& guid : state->ids)
+            {
+                wil::unique_cotaskmem_string guidString;
+                if (SUCCEEDED(StringFromCLSID(guid, &guidString)))
+                {
+                    state->idStrings.push_back(guidString.get());
+                }
+            }
         }
-        HANDLE regKeyEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-        HANDLE events[2] = { regKeyEvent, terminateEvent };
+        state->currentId = GetDesktopIdFromCurrentSession();
+
+        virtualDesktopState.store(std::move(state));
+    }
+
+    std::shared_ptr<const VirtualDesktopState> GetVirtualDesktopState() noexcept
+    {
+        auto state = virtualDesktopState.load();
+        if (!state)
+        {
+            // Nothing published yet, only happens before the tracker thread starts
+            RefreshVirtualDesktopState();
+            state = virtualDesktopState.load();
+        }
+        return state;
+    }
+
+    void HandleVirtualDesktopUpdates(HWND window, UINT updateMessage, UINT switchMessage, HANDLE switchEvent, HANDLE terminateEvent)
+    {
+        // Virtual desktop list is watched for creation and deletion, current session key for switches.
+        // The session key only exists after the first switch, retry opening it on every notification.
+        HKEY virtualDesktopsRegKey = GetVirtualDesktopsRegKey();
+        wil::unique_hkey sessionRegKey = OpenSessionVirtualDesktopsRegKey();
+        wil::unique_event regKeyEvent(wil::EventOptions::None);
+        wil::unique_event sessionRegKeyEvent(wil::EventOptions::None);
+
+        auto watch = [](HKEY key, HANDLE event) {
+            return key && RegNotifyChangeKeyValue(key, TRUE, REG_NOTIFY_CHANGE_LAST_SET, event, TRUE) == ERROR_SUCCESS;
+        };
+
+        watch(virtualDesktopsRegKey, regKeyEvent.get());
+        watch(sessionRegKey.get(), sessionRegKeyEvent.get());
+
+        HANDLE events[4] = { terminateEvent, switchEvent, regKeyEvent.get(), sessionRegKeyEvent.get() };
         while (1)
         {
-            if (RegNotifyChangeKeyValue(virtualDesktopsRegKey, TRUE, REG_NOTIFY_CHANGE_LAST_SET, regKeyEvent, TRUE) != ERROR_SUCCESS)
+            const DWORD result = WaitForMultipleObjects(ARRAYSIZE(events), events, FALSE, INFINITE);
+            if (result == WAIT_OBJECT_0 + 1)
             {
-                return;
+                RefreshVirtualDesktopState();
+                PostMessage(window, switchMessage, 0, 0);
+            }
+            else if (result == WAIT_OBJECT_0 + 2 || result == WAIT_OBJECT_0 + 3)
+            {
+                RefreshVirtualDesktopState();
+                PostMessage(window, updateMessage, 0, 0);
+
+                if (result == WAIT_OBJECT_0 + 2)
+                {
+                    watch(virtualDesktopsRegKey, regKeyEvent.get());
+                }
+
+                if (!sessionRegKey)
+                {
+                    sessionRegKey = OpenSessionVirtualDesktopsRegKey();
+                    watch(sessionRegKey.get(), sessionRegKeyEvent.get());
+                }
+                else if (result == WAIT_OBJECT_0 + 3)
+                {
+                    watch(sessionRegKey.get(), sessionRegKeyEvent.get());
+                }
             }
-            if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != (WAIT_OBJECT_0 + 0))
+            else
             {
                 // if terminateEvent is signalized or WaitForMultipleObjects failed, terminate thread execution
                 return;
             }
-            PostMessage(window, message, 0, 0);
         }
     }
 }
@@ -2,6 +2,20 @@
 
 #include "ZoneWindow.h"
 
+#include <optional>
+
+/**
+ * Virtual desktop information read from registry. Instances are immutable once published.
+ */
+struct VirtualDesktopState
+{
+    // Identifiers of all virtual desktops, first one is the primary desktop. Empty if not available.
+    std::vector<GUID> ids;
+    std::vector<std::wstring> idStrings;
+    // Current virtual desktop persisted by Explorer. Only available after the first desktop switch in the session.
+    std::optional<GUID> currentId;
+};
+
 namespace VirtualDesktopUtils
 {
     bool GetWindowDesktopId(HWND topLevelWindow, GUID* desktopId);
@@ -10,5 +24,20 @@ namespace VirtualDesktopUtils
     bool GetVirtualDesktopIds(std::vector<GUID>& ids);
     bool GetVirtualDesktopIds(std::vector<std::wstring>& ids);
     HKEY GetVirtualDesktopsRegKey();
-    void HandleVirtualDesktopUpdates(HWND window, UINT message, HANDLE terminateEvent);
+
+    /**
+     * Read virtual desktop state from registry and publish it. Called by the virtual desktop tracker
+     * thread whenever registry changes, readers never touch registry themselves.
+     */
+    void RefreshVirtualDesktopState();
+    /**
+     * @returns Most recently published virtual desktop state. Doesn't block on a refresh in progress.
+     */
+    std::shared_ptr<const VirtualDesktopState> GetVirtualDesktopState() noexcept;
+
+    /**
+     * Track virtual desktop changes until terminateEvent is signaled. Published state is refreshed
+     * before updateMessage (registry changed) or switchMessage (switchEvent signaled) is posted to window.
+     */
+    void HandleVirtualDesktopUpdates(HWND window, UINT updateMessage, UINT switchMessage, HANDLE switchEvent, HANDLE terminateEvent);
 }
@@ -256,7 +256,7 @@ void WindowMoveHandler::MoveSizeEnd(HWND window, POINT const& ptScreen, const st
                 }
             }
         }
-        ::RemoveProp(window, ZonedWindowProperties::PropertyMultipleZoneID);
+        FancyZonesUtils::RemoveWindowStamp(window);
     }
 
     m_inMoveSize = false;
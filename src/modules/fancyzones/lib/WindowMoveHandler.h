@@ -33,6 +33,11 @@ public:
         return m_dragEnabled;
     }
 
+    inline bool IsSelectManyZonesEnabled() const noexcept
+    {
+        return m_ctrlKeyState.state();
+    }
+
     inline bool InMoveSize() const noexcept
     {
         return m_inMoveSize;
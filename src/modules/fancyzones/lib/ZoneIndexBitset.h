@@ -0,0 +1,314 @@
+#pragma once
+
+#include "ZoneLayoutEngine.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Set of zone indices. Used to track zones a window is assigned to and to select zone ranges.
+ * Indices below InlineCapacity are kept inline without allocating; larger indices, which only
+ * very large custom layouts have, are kept in words allocated on demand.
+ * Indices at or above MaxCapacity are ignored. They can come from a corrupt app zone history,
+ * and no layout has that many zones, so they must not grow the storage.
+ */
+class ZoneIndexBitset
+{
+public:
+    using Word = uint64_t;
+    static constexpr size_t WordBits = 64;
+    static constexpr size_t InlineWordCount = 4;
+    static constexpr size_t InlineCapacity = WordBits * InlineWordCount;
+    static constexpr size_t MaxWordCount = 64;
+    static constexpr size_t MaxCapacity = WordBits * MaxWordCount;
+
+    ZoneIndexBitset() noexcept = default;
+
+    explicit ZoneIndexBitset(const std::vector<size_t>& indexSet)
+    {
+        for (size_t index : indexSet)
+        {
+            Set(index);
+        }
+    }
+
+    void Set(size_t index)
+    {
+        if (index >= MaxCapacity)
+        {
+            return;
+        }
+
+        const size_t wordIndex = index / WordBits;
+        SetWord(wordIndex, GetWord(wordIndex) | (Word{ 1 } << (index % WordBits)));
+    }
+
+    void Reset(size_t index) noexcept
+    {
+        const size_t wordIndex = index / WordBits;
+        if (wordIndex < WordCount())
+        {
+            SetWord(wordIndex, GetWord(wordIndex) & ~(Word{ 1 } << (index % WordBits)));
+        }
+    }
+
+    void Clear() noexcept
+    {
+        m_words.fill(0);
+        m_overflowWords.clear();
+    }
+
+    bool Test(size_t index) const noexcept
+    {
+        return (GetWord(index / WordBits) & (Word{ 1 } << (index % WordBits))) != 0;
+    }
+
+    bool Any() const noexcept
+    {
+        // Overflow words never end with a zero word, so any overflow word means a set index
+        return !m_overflowWords.empty() || std::any_of(m_words.begin(), m_words.end(), [](Word word) { return word != 0; });
+    }
+
+    bool None() const noexcept
+    {
+        return !Any();
+    }
+
+    size_t Count() const noexcept
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < WordCount(); i++)
+        {
+            count += static_cast<size_t>(std::popcount(GetWord(i)));
+        }
+        return count;
+    }
+
+    // Number of words up to the last one which may be non-zero
+    size_t WordCount() const noexcept
+    {
+        return InlineWordCount + m_overflowWords.size();
+    }
+
+    Word GetWord(size_t wordIndex) const noexcept
+    {
+        if (wordIndex < InlineWordCount)
+        {
+            return m_words[wordIndex];
+        }
+        wordIndex -= InlineWordCount;
+        return wordIndex < m_overflowWords.size() ? m_overflowWords[wordIndex] : 0;
+    }
+
+    void SetWord(size_t wordIndex, Word word)
+    {
+        if (wordIndex < InlineWordCount)
+        {
+            m_words[wordIndex] = word;
+            return;
+        }
+
+        if (wordIndex >= MaxWordCount)
+        {
+            return;
+        }
+
+        wordIndex -= InlineWordCount;
+        if (wordIndex >= m_overflowWords.size())
+        {
+            if (word == 0)
+            {
+                return;
+            }
+            m_overflowWords.resize(wordIndex + 1);
+        }
+        m_overflowWords[wordIndex] = word;
+        TrimOverflow();
+    }
+
+    // Calls fn(index) for every index in the set, in ascending order.
+    template<typename Fn>
+    void ForEach(Fn fn) const
+    {
+        for (size_t wordIndex = 0; wordIndex < WordCount(); wordIndex++)
+        {
+            Word word = GetWord(wordIndex);
+            while (word != 0)
+            {
+                fn(wordIndex * WordBits + std::countr_zero(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    std::vector<size_t> ToIndexSet() const
+    {
+        std::vector<size_t> indexSet;
+        indexSet.reserve(Count());
+        ForEach([&indexSet](size_t index) { indexSet.push_back(index); });
+        return indexSet;
+    }
+
+    ZoneIndexBitset& operator|=(const ZoneIndexBitset& other)
+    {
+        for (size_t i = 0; i < InlineWordCount; i++)
+        {
+            m_words[i] |= other.m_words[i];
+        }
+        if (m_overflowWords.size() < other.m_overflowWords.size())
+        {
+            m_overflowWords.resize(other.m_overflowWords.size());
+        }
+        for (size_t i = 0; i < other.m_overflowWords.size(); i++)
+        {
+            m_overflowWords[i] |= other.m_overflowWords[i];
+        }
+        return *this;
+    }
+
+    ZoneIndexBitset& operator&=(const ZoneIndexBitset& other) noexcept
+    {
+        for (size_t i = 0; i < InlineWordCount; i++)
+        {
+            m_words[i] &= other.m_words[i];
+        }
+        if (m_overflowWords.size() > other.m_overflowWords.size())
+        {
+            m_overflowWords.resize(other.m_overflowWords.size());
+        }
+        for (size_t i = 0; i < m_overflowWords.size(); i++)
+        {
+            m_overflowWords[i] &= other.m_overflowWords[i];
+        }
+        TrimOverflow();
+        return *this;
+    }
+
+    friend ZoneIndexBitset operator|(ZoneIndexBitset lhs, const ZoneIndexBitset& rhs)
+    {
+        return lhs |= rhs;
+    }
+
+    friend ZoneIndexBitset operator&(ZoneIndexBitset lhs, const ZoneIndexBitset& rhs) noexcept
+    {
+        return lhs &= rhs;
+    }
+
+    friend bool operator==(const ZoneIndexBitset& lhs, const ZoneIndexBitset& rhs) noexcept
+    {
+        return lhs.m_words == rhs.m_words && lhs.m_overflowWords == rhs.m_overflowWords;
+    }
+
+    friend bool operator!=(const ZoneIndexBitset& lhs, const ZoneIndexBitset& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    void TrimOverflow() noexcept
+    {
+        while (!m_overflowWords.empty() && m_overflowWords.back() == 0)
+        {
+            m_overflowWords.pop_back();
+        }
+    }
+
+    std::array<Word, InlineWordCount> m_words{};
+    std::vector<Word> m_overflowWords;
+};
+
+/**
+ * Zone rectangles indexed by zone index, precomputed when the zone layout is calculated.
+ * Answers bounding-box queries over zone index sets without touching zone objects.
+ */
+class ZoneBoundsTable
+{
+public:
+    void Clear() noexcept
+    {
+        m_ids.Clear();
+        m_overflowBounds.clear();
+    }
+
+    void Add(size_t id, const ZoneLayoutEngine::ZoneRect& rect)
+    {
+        if (id >= ZoneIndexBitset::MaxCapacity)
+        {
+            return;
+        }
+
+        m_ids.Set(id);
+        if (id < ZoneIndexBitset::InlineCapacity)
+        {
+            m_bounds[id] = rect;
+            return;
+        }
+
+        const size_t overflowIndex = id - ZoneIndexBitset::InlineCapacity;
+        if (overflowIndex >= m_overflowBounds.size())
+        {
+            m_overflowBounds.resize(overflowIndex + 1);
+        }
+        m_overflowBounds[overflowIndex] = rect;
+    }
+
+    const ZoneIndexBitset& Ids() const noexcept
+    {
+        return m_ids;
+    }
+
+    /**
+     * Returns all zones spanned by the minimum bounding rectangle containing the two given zone index sets.
+     */
+    ZoneIndexBitset CombinedRange(const ZoneIndexBitset& initialZones, const ZoneIndexBitset& finalZones) const
+    {
+        ZoneIndexBitset result;
+        const ZoneIndexBitset combinedZones = (initialZones | finalZones) & m_ids;
+        if (combinedZones.None())
+        {
+            return result;
+        }
+
+        bool boundingRectEmpty = true;
+        ZoneLayoutEngine::ZoneRect boundingRect{};
+        combinedZones.ForEach([&](size_t id) {
+            const auto& rect = Bounds(id);
+            if (boundingRectEmpty)
+            {
+                boundingRect = rect;
+                boundingRectEmpty = false;
+            }
+            else
+            {
+                boundingRect.left = (std::min)(boundingRect.left, rect.left);
+                boundingRect.top = (std::min)(boundingRect.top, rect.top);
+                boundingRect.right = (std::max)(boundingRect.right, rect.right);
+                boundingRect.bottom = (std::max)(boundingRect.bottom, rect.bottom);
+            }
+        });
+
+        m_ids.ForEach([&](size_t id) {
+            const auto& rect = Bounds(id);
+            if (boundingRect.left <= rect.left && rect.right <= boundingRect.right &&
+                boundingRect.top <= rect.top && rect.bottom <= boundingRect.bottom)
+            {
+                result.Set(id);
+            }
+        });
+
+        return result;
+    }
+
+private:
+    const ZoneLayoutEngine::ZoneRect& Bounds(size_t id) const noexcept
+    {
+        return id < ZoneIndexBitset::InlineCapacity ? m_bounds[id] : m_overflowBounds[id - ZoneIndexBitset::InlineCapacity];
+    }
+
+    ZoneIndexBitset m_ids;
+    std::array<ZoneLayoutEngine::ZoneRect, ZoneIndexBitset::InlineCapacity> m_bounds{};
+    std::vector<ZoneLayoutEngine::ZoneRect> m_overflowBounds;
+};
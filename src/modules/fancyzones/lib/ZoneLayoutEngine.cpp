@@ -0,0 +1,403 @@
+// This file is intentionally compiled without the precompiled header,
+// so that the layout engine can be built and reused outside of FancyZonesLib.
+#include "ZoneLayoutEngine.h"
+
+namespace
+{
+    using namespace ZoneLayoutEngine;
+
+    // Grids with more rows or columns than this fall back to a heap allocated track table.
+    constexpr int MAX_INLINE_TRACKS = 128;
+
+    struct Track
+    {
+        long start;
+        long end;
+    };
+
+    // PriorityGrid layout is unique for zoneCount <= 11. For zoneCount > 11 PriorityGrid is same as Grid
+    namespace PriorityGrid
+    {
+        constexpr int rows1[] = { 10000 };
+        constexpr int columns1[] = { 10000 };
+        constexpr int cells1[] = { 0 };
+
+        constexpr int rows2[] = { 10000 };
+        constexpr int columns2[] = { 6667, 3333 };
+        constexpr int cells2[] = { 0, 1 };
+
+        constexpr int rows3[] = { 10000 };
+        constexpr int columns3[] = { 2500, 5000, 2500 };
+        constexpr int cells3[] = { 0, 1, 2 };
+
+        constexpr int rows4[] = { 5000, 5000 };
+        constexpr int columns4[] = { 2500, 5000, 2500 };
+        constexpr int cells4[] = { 0, 1, 2,
+                                   0, 1, 3 };
+
+        constexpr int rows5[] = { 5000, 5000 };
+        constexpr int columns5[] = { 2500, 5000, 2500 };
+        constexpr int cells5[] = { 0, 1, 2,
+                                   3, 1, 4 };
+
+        constexpr int rows6[] = { 3333, 3334, 3333 };
+        constexpr int columns6[] = { 2500, 5000, 2500 };
+        constexpr int cells6[] = { 0, 1, 2,
+                                   0, 1, 3,
+                                   4, 1, 5 };
+
+        constexpr int rows7[] = { 3333, 3334, 3333 };
+        constexpr int columns7[] = { 2500, 5000, 2500 };
+        constexpr int cells7[] = { 0, 1, 2,
+                                   3, 1, 4,
+                                   5, 1, 6 };
+
+        constexpr int rows8[] = { 3333, 3334, 3333 };
+        constexpr int columns8[] = { 2500, 2500, 2500, 2500 };
+        constexpr int cells8[] = { 0, 1, 2, 3,
+                                   4, 1, 2, 5,
+                                   6, 1, 2, 7 };
+
+        constexpr int rows9[] = { 3333, 3334, 3333 };
+        constexpr int columns9[] = { 2500, 2500, 2500, 2500 };
+        constexpr int cells9[] = { 0, 1, 2, 3,
+                                   4, 1, 2, 5,
+                                   6, 1, 7, 8 };
+
+        constexpr int rows10[] = { 3333, 3334, 3333 };
+        constexpr int columns10[] = { 2500, 2500, 2500, 2500 };
+        constexpr int cells10[] = { 0, 1, 2, 3,
+                                    4, 1, 5, 6,
+                                    7, 1, 8, 9 };
+
+        constexpr int rows11[] = { 3333, 3334, 3333 };
+        constexpr int columns11[] = { 2500, 2500, 2500, 2500 };
+        constexpr int cells11[] = { 0, 1, 2, 3,
+                                    4, 1, 5, 6,
+                                    7, 8, 9, 10 };
+
+        constexpr GridDescriptor layouts[PRIORITY_GRID_LAYOUTS_COUNT] = {
+            { 1, 1, rows1, columns1, cells1 },
+            { 1, 2, rows2, columns2, cells2 },
+            { 1, 3, rows3, columns3, cells3 },
+            { 2, 3, rows4, columns4, cells4 },
+            { 2, 3, rows5, columns5, cells5 },
+            { 3, 3, rows6, columns6, cells6 },
+            { 3, 3, rows7, columns7, cells7 },
+            { 3, 4, rows8, columns8, cells8 },
+            { 3, 4, rows9, columns9, cells9 },
+            { 3, 4, rows10, columns10, cells10 },
+            { 3, 4, rows11, columns11, cells11 },
+        };
+    }
+
+    // Note: The expressions below are carefully written to
+    // make the sum of all tracks' sizes exactly totalSize
+    template<typename PercentFn>
+    void CalculateTracks(Track* tracks, int count, long totalSize, int spacing, PercentFn percent) noexcept
+    {
+        long totalPercents = 0;
+        for (int i = 0; i < count; i++)
+        {
+            tracks[i].start = totalPercents * totalSize / C_MULTIPLIER + (i + 1) * spacing;
+            totalPercents += percent(i);
+            tracks[i].end = totalPercents * totalSize / C_MULTIPLIER + (i + 1) * spacing;
+        }
+    }
+
+    template<typename RowPercentFn, typename ColumnPercentFn, typename CellFn>
+    bool EmitGridZones(long width, long height, int rows, int columns, RowPercentFn rowPercent, ColumnPercentFn columnPercent, CellFn cell, int spacing, std::vector<Zone>& zones)
+    {
+        if (rows <= 0 || columns <= 0)
+        {
+            return false;
+        }
+
+        Track inlineRows[MAX_INLINE_TRACKS];
+        Track inlineColumns[MAX_INLINE_TRACKS];
+        std::vector<Track> heapRows;
+        std::vector<Track> heapColumns;
+
+        Track* rowInfo = inlineRows;
+        if (rows > MAX_INLINE_TRACKS)
+        {
+            heapRows.resize(rows);
+            rowInfo = heapRows.data();
+        }
+
+        Track* columnInfo = inlineColumns;
+        if (columns > MAX_INLINE_TRACKS)
+        {
+            heapColumns.resize(columns);
+            columnInfo = heapColumns.data();
+        }
+
+        const long totalWidth = width - (spacing * (columns + 1));
+        const long totalHeight = height - (spacing * (rows + 1));
+        CalculateTracks(rowInfo, rows, totalHeight, spacing, rowPercent);
+        CalculateTracks(columnInfo, columns, totalWidth, spacing, columnPercent);
+
+        for (int row = 0; row < rows; row++)
+        {
+            for (int col = 0; col < columns; col++)
+            {
+                const int i = cell(row, col);
+                if (((row == 0) || (cell(row - 1, col) != i)) &&
+                    ((col == 0) || (cell(row, col - 1) != i)))
+                {
+                    int maxRow = row;
+                    while (((maxRow + 1) < rows) && (cell(maxRow + 1, col) == i))
+                    {
+                        maxRow++;
+                    }
+                    int maxCol = col;
+                    while (((maxCol + 1) < columns) && (cell(row, maxCol + 1) == i))
+                    {
+                        maxCol++;
+                    }
+
+                    if (i < 0)
+                    {
+                        zones.clear();
+                        return false;
+                    }
+
+                    zones.push_back(Zone{ static_cast<size_t>(i),
+                                          ZoneRect{ columnInfo[col].start, rowInfo[row].start, columnInfo[maxCol].end, rowInfo[maxRow].end } });
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+namespace ZoneLayoutEngine
+{
+    bool CalculateLayout(const LayoutInput& input, std::vector<Zone>& zones) noexcept
+    {
+        zones.clear();
+
+        //invalid work area
+        if (input.workAreaWidth == 0 || input.workAreaHeight == 0)
+        {
+            return false;
+        }
+
+        const LayoutDescriptor& layout = input.layout;
+        switch (layout.kind)
+        {
+        case LayoutKind::Focus:
+            return CalculateFocusLayout(input.workAreaWidth, input.workAreaHeight, layout.zoneCount, zones);
+        case LayoutKind::Columns:
+        case LayoutKind::Rows:
+            return CalculateColumnsAndRowsLayout(input.workAreaWidth, input.workAreaHeight, layout.kind, layout.zoneCount, input.spacing, zones);
+        case LayoutKind::Grid:
+        case LayoutKind::PriorityGrid:
+            return CalculateGridLayout(input.workAreaWidth, input.workAreaHeight, layout.kind, layout.zoneCount, input.spacing, zones);
+        case LayoutKind::CustomGrid:
+            return CalculateGridZones(input.workAreaWidth, input.workAreaHeight, layout.grid, input.spacing, zones);
+        case LayoutKind::CustomCanvas:
+            return CalculateCanvasLayout(layout.canvas, input.dpi, zones);
+        }
+
+        return false;
+    }
+
+    bool CalculateFocusLayout(long width, long height, int zoneCount, std::vector<Zone>& zones) noexcept
+    {
+        zones.clear();
+
+        //invalid zoneCount
+        if (zoneCount <= 0)
+        {
+            return false;
+        }
+
+        long left{ 100 };
+        long top{ 100 };
+        long right{ left + long(width * 0.4) };
+        long bottom{ top + long(height * 0.4) };
+
+        const long focusRectXIncrement = (zoneCount <= 1) ? 0 : 50;
+        const long focusRectYIncrement = (zoneCount <= 1) ? 0 : 50;
+
+        zones.reserve(zoneCount);
+        for (int i = 0; i < zoneCount; i++)
+        {
+            zones.push_back(Zone{ static_cast<size_t>(i), ZoneRect{ left, top, right, bottom } });
+            left += focusRectXIncrement;
+            right += focusRectXIncrement;
+            bottom += focusRectYIncrement;
+            top += focusRectYIncrement;
+        }
+
+        return true;
+    }
+
+    bool CalculateColumnsAndRowsLayout(long width, long height, LayoutKind kind, int zoneCount, int spacing, std::vector<Zone>& zones) noexcept
+    {
+        zones.clear();
+
+        //invalid zoneCount, may cause division by zero
+        if (zoneCount <= 0)
+        {
+            return false;
+        }
+
+        long totalWidth;
+        long totalHeight;
+
+        if (kind == LayoutKind::Columns)
+        {
+            totalWidth = width - (spacing * (zoneCount + 1));
+            totalHeight = height - (spacing * 2);
+        }
+        else
+        { //Rows
+            totalWidth = width - (spacing * 2);
+            totalHeight = height - (spacing * (zoneCount + 1));
+        }
+
+        long top = spacing;
+        long left = spacing;
+        long bottom;
+        long right;
+
+        zones.reserve(zoneCount);
+
+        // Note: The expressions below are NOT equal to total{Width|Height} / zoneCount and are done
+        // like this to make the sum of all zones' sizes exactly total{Width|Height}.
+        for (int zoneIndex = 0; zoneIndex < zoneCount; ++zoneIndex)
+        {
+            if (kind == LayoutKind::Columns)
+            {
+                right = left + (zoneIndex + 1) * totalWidth / zoneCount - zoneIndex * totalWidth / zoneCount;
+                bottom = totalHeight + spacing;
+            }
+            else
+            { //Rows
+                right = totalWidth + spacing;
+                bottom = top + (zoneIndex + 1) * totalHeight / zoneCount - zoneIndex * totalHeight / zoneCount;
+            }
+
+            zones.push_back(Zone{ static_cast<size_t>(zoneIndex), ZoneRect{ left, top, right, bottom } });
+
+            if (kind == LayoutKind::Columns)
+            {
+                left = right + spacing;
+            }
+            else
+            { //Rows
+                top = bottom + spacing;
+            }
+        }
+
+        return true;
+    }
+
+    bool CalculateGridLayout(long width, long height, LayoutKind kind, int zoneCount, int spacing, std::vector<Zone>& zones) noexcept
+    {
+        zones.clear();
+
+        //invalid zoneCount, may cause division by zero
+        if (zoneCount <= 0)
+        {
+            return false;
+        }
+
+        if (kind == LayoutKind::PriorityGrid && zoneCount < PRIORITY_GRID_LAYOUTS_COUNT)
+        {
+            return CalculateGridZones(width, height, *PriorityGridLayout(zoneCount), spacing, zones);
+        }
+
+        int rows = 1, columns = 1;
+        while (zoneCount / rows >= rows)
+        {
+            rows++;
+        }
+        rows--;
+        columns = zoneCount / rows;
+        if (zoneCount % rows != 0)
+        {
+            columns++;
+        }
+
+        zones.reserve(zoneCount);
+
+        // Note: The expressions below are NOT equal to C_MULTIPLIER / {rows|columns} and are done
+        // like this to make the sum of all percents exactly C_MULTIPLIER.
+        // Cells are numbered row by row, the last zone spans all remaining cells.
+        return EmitGridZones(
+            width,
+            height,
+            rows,
+            columns,
+            [rows](int row) { return C_MULTIPLIER * (row + 1) / rows - C_MULTIPLIER * row / rows; },
+            [columns](int col) { return C_MULTIPLIER * (col + 1) / columns - C_MULTIPLIER * col / columns; },
+            [columns, zoneCount](int row, int col) {
+                const int index = row * columns + col;
+                return index < zoneCount ? index : zoneCount - 1;
+            },
+            spacing,
+            zones);
+    }
+
+    bool CalculateGridZones(long width, long height, const GridDescriptor& grid, int spacing, std::vector<Zone>& zones) noexcept
+    {
+        zones.clear();
+
+        if (!grid.rowsPercents || !grid.columnsPercents || !grid.cellChildMap)
+        {
+            return false;
+        }
+
+        return EmitGridZones(
+            width,
+            height,
+            grid.rows,
+            grid.columns,
+            [&grid](int row) { return grid.rowsPercents[row]; },
+            [&grid](int col) { return grid.columnsPercents[col]; },
+            [&grid](int row, int col) { return grid.cellChildMap[row * grid.columns + col]; },
+            spacing,
+            zones);
+    }
+
+    bool CalculateCanvasLayout(const CanvasDescriptor& canvas, unsigned int dpi, std::vector<Zone>& zones) noexcept
+    {
+        zones.clear();
+
+        if (canvas.count > 0 && !canvas.zones)
+        {
+            return false;
+        }
+
+        const int scale = static_cast<int>(dpi != 0 ? dpi : DEFAULT_DPI);
+        const int defaultDpi = static_cast<int>(DEFAULT_DPI);
+
+        zones.reserve(canvas.count);
+        for (size_t i = 0; i < canvas.count; i++)
+        {
+            const CanvasZone& zone = canvas.zones[i];
+            const long x = zone.x * scale / defaultDpi;
+            const long y = zone.y * scale / defaultDpi;
+            const long width = zone.width * scale / defaultDpi;
+            const long height = zone.height * scale / defaultDpi;
+
+            zones.push_back(Zone{ i, ZoneRect{ x, y, x + width, y + height } });
+        }
+
+        return true;
+    }
+
+    const GridDescriptor* PriorityGridLayout(int zoneCount) noexcept
+    {
+        if (zoneCount <= 0 || zoneCount > PRIORITY_GRID_LAYOUTS_COUNT)
+        {
+            return nullptr;
+        }
+
+        return &PriorityGrid::layouts[zoneCount - 1];
+    }
+}
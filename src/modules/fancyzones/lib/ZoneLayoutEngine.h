@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Platform independent zone layout geometry. Given the size of a work area, a layout descriptor, spacing and DPI,
+ * produces a flat array of zone rectangles. The engine does not depend on Windows headers, COM objects or
+ * FancyZones data, which allows it to be fuzzed, benchmarked and reused by the test tools.
+ */
+namespace ZoneLayoutEngine
+{
+    // Grid and priority grid row/column sizes are expressed in units of 1/C_MULTIPLIER of the available space.
+    constexpr int C_MULTIPLIER = 10000;
+    constexpr unsigned int DEFAULT_DPI = 96;
+
+    // Number of zone counts (starting with 1) for which priority grid has its own predefined layout.
+    constexpr int PRIORITY_GRID_LAYOUTS_COUNT = 11;
+
+    enum class LayoutKind : int
+    {
+        Focus = 0,
+        Columns,
+        Rows,
+        Grid,
+        PriorityGrid,
+        CustomGrid,
+        CustomCanvas
+    };
+
+    struct ZoneRect
+    {
+        long left;
+        long top;
+        long right;
+        long bottom;
+    };
+
+    struct Zone
+    {
+        size_t id;
+        ZoneRect rect;
+    };
+
+    /**
+     * Grid description, referencing memory owned by the caller.
+     * cellChildMap is stored row-major and has rows * columns elements.
+     */
+    struct GridDescriptor
+    {
+        int rows;
+        int columns;
+        const int* rowsPercents;
+        const int* columnsPercents;
+        const int* cellChildMap;
+    };
+
+    struct CanvasZone
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    /**
+     * Canvas description, referencing memory owned by the caller. Zone coordinates are in 96 DPI units.
+     */
+    struct CanvasDescriptor
+    {
+        const CanvasZone* zones;
+        size_t count;
+    };
+
+    struct LayoutDescriptor
+    {
+        LayoutKind kind;
+        // Used by predefined layouts (focus, columns, rows, grid and priority grid).
+        int zoneCount;
+        // Used by custom grid layouts.
+        GridDescriptor grid;
+        // Used by custom canvas layouts.
+        CanvasDescriptor canvas;
+    };
+
+    struct LayoutInput
+    {
+        long workAreaWidth;
+        long workAreaHeight;
+        LayoutDescriptor layout;
+        int spacing;
+        unsigned int dpi;
+    };
+
+    /**
+     * Calculate zone rectangles for the given layout. Zones are relative to the top-left corner of the work area.
+     *
+     * @param   input Work area size, layout descriptor, spacing and DPI.
+     * @param   zones Output array. It is cleared first, its capacity is reused between calls.
+     *
+     * @returns Boolean indicating if calculation was successful. On failure, zones is empty.
+     */
+    bool CalculateLayout(const LayoutInput& input, std::vector<Zone>& zones) noexcept;
+
+    bool CalculateFocusLayout(long width, long height, int zoneCount, std::vector<Zone>& zones) noexcept;
+    bool CalculateColumnsAndRowsLayout(long width, long height, LayoutKind kind, int zoneCount, int spacing, std::vector<Zone>& zones) noexcept;
+    bool CalculateGridLayout(long width, long height, LayoutKind kind, int zoneCount, int spacing, std::vector<Zone>& zones) noexcept;
+    bool CalculateGridZones(long width, long height, const GridDescriptor& grid, int spacing, std::vector<Zone>& zones) noexcept;
+    bool CalculateCanvasLayout(const CanvasDescriptor& canvas, unsigned int dpi, std::vector<Zone>& zones) noexcept;
+
+    /**
+     * @returns Predefined priority grid layout for the given zone count, or nullptr if there is none.
+     */
+    const GridDescriptor* PriorityGridLayout(int zoneCount) noexcept;
+}
@@ -2,15 +2,16 @@
 
 #include "ZoneSet.h"
 
+#include "AtomicSnapshot.h"
 #include "FancyZonesData.h"
 #include "FancyZonesDataTypes.h"
 #include "Settings.h"
 #include "Zone.h"
+#include "ZoneLayoutEngine.h"
 #include "util.h"
 
 #include <common/dpi_aware.h>
 
-#include <limits>
 #include <map>
 #include <utility>
 
@@ -18,92 +19,38 @@ using namespace FancyZonesUtils;
 
 namespace
 {
-    constexpr int C_MULTIPLIER = 10000;
-
-    // PriorityGrid layout is unique for zoneCount <= 11. For zoneCount > 11 PriorityGrid is same as Grid
-    FancyZonesDataTypes::GridLayoutInfo predefinedPriorityGridLayouts[11] = {
-        /* 1 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 1,
-            .columns = 1,
-            .rowsPercents = { 10000 },
-            .columnsPercents = { 10000 },
-            .cellChildMap = { { 0 } } }),
-        /* 2 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 1,
-            .columns = 2,
-            .rowsPercents = { 10000 },
-            .columnsPercents = { 6667, 3333 },
-            .cellChildMap = { { 0, 1 } } }),
-        /* 3 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 1,
-            .columns = 3,
-            .rowsPercents = { 10000 },
-            .columnsPercents = { 2500, 5000, 2500 },
-            .cellChildMap = { { 0, 1, 2 } } }),
-        /* 4 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 2,
-            .columns = 3,
-            .rowsPercents = { 5000, 5000 },
-            .columnsPercents = { 2500, 5000, 2500 },
-            .cellChildMap = { { 0, 1, 2 }, { 0, 1, 3 } } }),
-        /* 5 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 2,
-            .columns = 3,
-            .rowsPercents = { 5000, 5000 },
-            .columnsPercents = { 2500, 5000, 2500 },
-            .cellChildMap = { { 0, 1, 2 }, { 3, 1, 4 } } }),
-        /* 6 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 3,
-            .columns = 3,
-            .rowsPercents = { 3333, 3334, 3333 },
-            .columnsPercents = { 2500, 5000, 2500 },
-            .cellChildMap = { { 0, 1, 2 }, { 0, 1, 3 }, { 4, 1, 5 } } }),
-        /* 7 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 3,
-            .columns = 3,
-            .rowsPercents = { 3333, 3334, 3333 },
-            .columnsPercents = { 2500, 5000, 2500 },
-            .cellChildMap = { { 0, 1, 2 }, { 3, 1, 4 }, { 5, 1, 6 } } }),
-        /* 8 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 3,
-            .columns = 4,
-            .rowsPercents = { 3333, 3334, 3333 },
-            .columnsPercents = { 2500, 2500, 2500, 2500 },
-            .cellChildMap = { { 0, 1, 2, 3 }, { 4, 1, 2, 5 }, { 6, 1, 2, 7 } } }),
-        /* 9 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 3,
-            .columns = 4,
-            .rowsPercents = { 3333, 3334, 3333 },
-            .columnsPercents = { 2500, 2500, 2500, 2500 },
-            .cellChildMap = { { 0, 1, 2, 3 }, { 4, 1, 2, 5 }, { 6, 1, 7, 8 } } }),
-        /* 10 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 3,
-            .columns = 4,
-            .rowsPercents = { 3333, 3334, 3333 },
-            .columnsPercents = { 2500, 2500, 2500, 2500 },
-            .cellChildMap = { { 0, 1, 2, 3 }, { 4, 1, 5, 6 }, { 7, 1, 8, 9 } } }),
-        /* 11 */
-        FancyZonesDataTypes::GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
-            .rows = 3,
-            .columns = 4,
-            .rowsPercents = { 3333, 3334, 3333 },
-            .columnsPercents = { 2500, 2500, 2500, 2500 },
-            .cellChildMap = { { 0, 1, 2, 3 }, { 4, 1, 5, 6 }, { 7, 8, 9, 10 } } }),
-    };
+    ZoneLayoutEngine::LayoutKind ToLayoutKind(FancyZonesDataTypes::ZoneSetLayoutType type) noexcept
+    {
+        switch (type)
+        {
+        case FancyZonesDataTypes::ZoneSetLayoutType::Focus:
+            return ZoneLayoutEngine::LayoutKind::Focus;
+        case FancyZonesDataTypes::ZoneSetLayoutType::Columns:
+            return ZoneLayoutEngine::LayoutKind::Columns;
+        case FancyZonesDataTypes::ZoneSetLayoutType::Rows:
+            return ZoneLayoutEngine::LayoutKind::Rows;
+        case FancyZonesDataTypes::ZoneSetLayoutType::PriorityGrid:
+            return ZoneLayoutEngine::LayoutKind::PriorityGrid;
+        default:
+            return ZoneLayoutEngine::LayoutKind::Grid;
+        }
+    }
 
-    inline void StampWindow(HWND window, size_t bitmask) noexcept
+    UINT GetMonitorDpi(HMONITOR monitor) noexcept
     {
-        SetProp(window, ZonedWindowProperties::PropertyMultipleZoneID, reinterpret_cast<HANDLE>(bitmask));
+        if (monitor == nullptr)
+        {
+            const POINT ptZero = { 0, 0 };
+            monitor = MonitorFromPoint(ptZero, MONITOR_DEFAULTTOPRIMARY);
+        }
+
+        UINT dpiX, dpiY;
+        if (GetDpiForMonitor(monitor, MDT_EFFECTIVE_DPI, &dpiX, &dpiY) == S_OK)
+        {
+            return dpiX;
+        }
+
+        return DPIAware::DEFAULT_DPI;
     }
 }
 
@@ -119,6 +66,7 @@ public:
         m_config(config),
         m_zones(zones)
     {
+        PublishGeometry();
     }
 
     IFACEMETHODIMP_(GUID)
@@ -148,22 +96,28 @@ public:
     CalculateZones(RECT workArea, int zoneCount, int spacing) noexcept;
     IFACEMETHODIMP_(bool)
     IsZoneEmpty(int zoneIndex) const noexcept;
-    IFACEMETHODIMP_(std::vector<size_t>)
-    GetCombinedZoneRange(const std::vector<size_t>& initialZones, const std::vector<size_t>& finalZones) const noexcept;
+    IFACEMETHODIMP_(ZoneIndexBitset)
+    GetCombinedZoneRange(const ZoneIndexBitset& initialZones, const ZoneIndexBitset& finalZones) const noexcept;
 
 private:
-    bool CalculateFocusLayout(Rect workArea, int zoneCount) noexcept;
-    bool CalculateColumnsAndRowsLayout(Rect workArea, FancyZonesDataTypes::ZoneSetLayoutType type, int zoneCount, int spacing) noexcept;
-    bool CalculateGridLayout(Rect workArea, FancyZonesDataTypes::ZoneSetLayoutType type, int zoneCount, int spacing) noexcept;
-    bool CalculateUniquePriorityGridLayout(Rect workArea, int zoneCount, int spacing) noexcept;
-    bool CalculateCustomLayout(Rect workArea, int spacing) noexcept;
-    bool CalculateGridZones(Rect workArea, FancyZonesDataTypes::GridLayoutInfo gridLayoutInfo, int spacing);
+    bool CalculateCustomLayout(Rect workArea, int spacing, std::vector<ZoneLayoutEngine::Zone>& zones) noexcept;
+    bool AddCalculatedZones(const std::vector<ZoneLayoutEngine::Zone>& zones) noexcept;
+    void PublishGeometry() noexcept;
+
+    // Zone rectangles as of the last layout change, read by ZonesFromPoint and GetCombinedZoneRange without
+    // touching the zone objects. Replaced as a whole, so a drag in progress never sees a partially calculated layout.
+    struct ZoneGeometry
+    {
+        std::vector<std::pair<size_t, RECT>> rects; // Ordered by zone id
+        ZoneBoundsTable bounds;
+    };
 
     ZonesMap m_zones;
+    AtomicSnapshot<ZoneGeometry> m_geometry;
     std::map<HWND, std::vector<size_t>> m_windowIndexSet;
 
     // Needed for ExtendWindowByDirectionAndPosition
-    std::map<HWND, std::vector<size_t>> m_windowInitialIndexSet;
+    std::map<HWND, ZoneIndexBitset> m_windowInitialIndexSet;
     std::map<HWND, size_t> m_windowFinalIndex;
     bool m_inExtendWindow = false;
 
@@ -178,6 +132,7 @@ IFACEMETHODIMP ZoneSet::AddZone(winrt::com_ptr<IZone> zone) noexcept
         return S_FALSE;
     }
     m_zones[zoneId] = zone;
+    PublishGeometry();
 
     return S_OK;
 }
@@ -185,27 +140,30 @@ IFACEMETHODIMP ZoneSet::AddZone(winrt::com_ptr<IZone> zone) noexcept
 IFACEMETHODIMP_(std::vector<size_t>)
 ZoneSet::ZonesFromPoint(POINT pt) const noexcept
 {
+    const auto geometry = m_geometry.Load();
+
     std::vector<size_t> capturedZones;
-    std::vector<size_t> strictlyCapturedZones;
-    for (const auto& [zoneId, zone] : m_zones)
+    std::vector<RECT> capturedRects;
+    size_t strictlyCapturedZones = 0;
+    for (const auto& [zoneId, zoneRect] : geometry->rects)
     {
-        const RECT& zoneRect = zone->GetZoneRect();
         if (zoneRect.left - m_config.SensitivityRadius <= pt.x && pt.x <= zoneRect.right + m_config.SensitivityRadius &&
             zoneRect.top - m_config.SensitivityRadius <= pt.y && pt.y <= zoneRect.bottom + m_config.SensitivityRadius)
         {
             capturedZones.emplace_back(zoneId);
+            capturedRects.emplace_back(zoneRect);
         }
             
         if (zoneRect.left <= pt.x && pt.x < zoneRect.right &&
             zoneRect.top <= pt.y && pt.y < zoneRect.bottom)
         {
-            strictlyCapturedZones.emplace_back(zoneId);
+            strictlyCapturedZones++;
         }
     }
 
     // If only one zone is captured, but it's not strictly captured
     // don't consider it as captured
-    if (capturedZones.size() == 1 && strictlyCapturedZones.size() == 0)
+    if (capturedZones.size() == 1 && strictlyCapturedZones == 0)
     {
         return {};
     }
@@ -213,22 +171,12 @@ ZoneSet::ZonesFromPoint(POINT pt) const noexcept
     // If captured zones do not overlap, return all of them
     // Otherwise, return the smallest one
     bool overlap = false;
-    for (size_t i = 0; i < capturedZones.size(); ++i)
+    for (size_t i = 0; i < capturedRects.size(); ++i)
     {
-        for (size_t j = i + 1; j < capturedZones.size(); ++j)
+        for (size_t j = i + 1; j < capturedRects.size(); ++j)
         {
-            RECT rectI;
-            RECT rectJ;
-            try
-            {
-                rectI = m_zones.at(capturedZones[i])->GetZoneRect();
-                rectJ = m_zones.at(capturedZones[j])->GetZoneRect();
-            }
-            catch (std::out_of_range)
-            {
-                return {};
-            }
-
+            const RECT& rectI = capturedRects[i];
+            const RECT& rectJ = capturedRects[j];
             if (max(rectI.top, rectJ.top) + m_config.SensitivityRadius < min(rectI.bottom, rectJ.bottom) &&
                 max(rectI.left, rectJ.left) + m_config.SensitivityRadius < min(rectI.right, rectJ.right))
             {
@@ -245,19 +193,10 @@ ZoneSet::ZonesFromPoint(POINT pt) const noexcept
     if (overlap)
     {
         size_t smallestIdx = 0;
-        for (size_t i = 1; i < capturedZones.size(); ++i)
+        for (size_t i = 1; i < capturedRects.size(); ++i)
         {
-            RECT rectS;
-            RECT rectI;
-            try
-            {
-                rectS = m_zones.at(capturedZones[smallestIdx])->GetZoneRect();
-                rectI = m_zones.at(capturedZones[i])->GetZoneRect();
-            }
-            catch (std::out_of_range)
-            {
-                return {};
-            }
+            const RECT& rectS = capturedRects[smallestIdx];
+            const RECT& rectI = capturedRects[i];
             int smallestSize = (rectS.bottom - rectS.top) * (rectS.right - rectS.left);
             int iSize = (rectI.bottom - rectI.top) * (rectI.right - rectI.left);
 
@@ -309,7 +248,7 @@ ZoneSet::MoveWindowIntoZoneByIndexSet(HWND window, HWND workAreaWindow, const st
 
     RECT size;
     bool sizeEmpty = true;
-    size_t bitmask = 0;
+    ZoneIndexBitset stamp;
 
     m_windowIndexSet[window] = {};
 
@@ -333,11 +272,9 @@ ZoneSet::MoveWindowIntoZoneByIndexSet(HWND window, HWND workAreaWindow, const st
             }
 
             m_windowIndexSet[window].push_back(id);
-        }
 
-        if (id < std::numeric_limits<size_t>::digits)
-        {
-            bitmask |= 1ull << id;
+            // Indices which are not zones of this layout, e.g. from a corrupt app zone history, are not stamped
+            stamp.Set(id);
         }
     }
 
@@ -345,7 +282,7 @@ ZoneSet::MoveWindowIntoZoneByIndexSet(HWND window, HWND workAreaWindow, const st
     {
         SaveWindowSizeAndOrigin(window);
         SizeWindowToRect(window, size);
-        StampWindow(window, bitmask);
+        StampWindow(window, stamp);
     }
 }
 
@@ -404,20 +341,16 @@ ZoneSet::MoveWindowIntoZoneByDirectionAndPosition(HWND window, HWND workAreaWind
         return false;
     }
 
-    std::vector<bool> usedZoneIndices(m_zones.size(), false);
-    for (size_t id : GetZoneIndexSetFromWindow(window))
-    {
-        usedZoneIndices[id] = true;
-    }
+    const ZoneIndexBitset usedZoneIndices(GetZoneIndexSetFromWindow(window));
 
     std::vector<RECT> zoneRects;
     std::vector<size_t> freeZoneIndices;
 
     for (const auto& [zoneId, zone] : m_zones)
     {
-        if (!usedZoneIndices[zoneId])
+        if (!usedZoneIndices.Test(zoneId))
         {
-            zoneRects.emplace_back(m_zones[zoneId]->GetZoneRect());
+            zoneRects.emplace_back(zone->GetZoneRect());
             freeZoneIndices.emplace_back(zoneId);
         }
     }
@@ -468,8 +401,8 @@ ZoneSet::ExtendWindowByDirectionAndPosition(HWND window, HWND workAreaWindow, DW
     RECT windowRect, windowZoneRect;
     if (GetWindowRect(window, &windowRect) && GetWindowRect(workAreaWindow, &windowZoneRect))
     {
-        auto oldZones = GetZoneIndexSetFromWindow(window);
-        std::vector<bool> usedZoneIndices(m_zones.size(), false);
+        const ZoneIndexBitset oldZones(GetZoneIndexSetFromWindow(window));
+        ZoneIndexBitset usedZoneIndices;
         std::vector<RECT> zoneRects;
         std::vector<size_t> freeZoneIndices;
 
@@ -478,15 +411,12 @@ ZoneSet::ExtendWindowByDirectionAndPosition(HWND window, HWND workAreaWindow, DW
         auto finalIndexIt = m_windowFinalIndex.find(window);
         if (finalIndexIt != m_windowFinalIndex.end())
         {
-            usedZoneIndices[finalIndexIt->second] = true;
+            usedZoneIndices.Set(finalIndexIt->second);
             windowRect = m_zones[finalIndexIt->second]->GetZoneRect();
         }
         else
         {
-            for (size_t idx : oldZones)
-            {
-                usedZoneIndices[idx] = true;
-            }
+            usedZoneIndices = oldZones;
             // Move to coordinates relative to windowZone
             windowRect.top -= windowZoneRect.top;
             windowRect.bottom -= windowZoneRect.top;
@@ -494,12 +424,12 @@ ZoneSet::ExtendWindowByDirectionAndPosition(HWND window, HWND workAreaWindow, DW
             windowRect.right -= windowZoneRect.left;
         }
 
-        for (size_t i = 0; i < m_zones.size(); i++)
+        for (const auto& [zoneId, zone] : m_zones)
         {
-            if (!usedZoneIndices[i])
+            if (!usedZoneIndices.Test(zoneId))
             {
-                zoneRects.emplace_back(m_zones[i]->GetZoneRect());
-                freeZoneIndices.emplace_back(i);
+                zoneRects.emplace_back(zone->GetZoneRect());
+                freeZoneIndices.emplace_back(zoneId);
             }
         }
 
@@ -507,34 +437,35 @@ ZoneSet::ExtendWindowByDirectionAndPosition(HWND window, HWND workAreaWindow, DW
         if (result < zoneRects.size())
         {
             size_t targetZone = freeZoneIndices[result];
-            std::vector<size_t> resultIndexSet;
+            ZoneIndexBitset targetZoneSet;
+            targetZoneSet.Set(targetZone);
+            ZoneIndexBitset resultIndexSet;
 
             // First time with selectManyZones = true for this window?
             if (finalIndexIt == m_windowFinalIndex.end())
             {
                 // Already zoned?
-                if (oldZones.size())
+                if (oldZones.Any())
                 {
                     m_windowInitialIndexSet[window] = oldZones;
                     m_windowFinalIndex[window] = targetZone;
-                    resultIndexSet = GetCombinedZoneRange(oldZones, { targetZone });
+                    resultIndexSet = GetCombinedZoneRange(oldZones, targetZoneSet);
                 }
                 else
                 {
-                    m_windowInitialIndexSet[window] = { targetZone };
+                    m_windowInitialIndexSet[window] = targetZoneSet;
                     m_windowFinalIndex[window] = targetZone;
-                    resultIndexSet = { targetZone };
+                    resultIndexSet = targetZoneSet;
                 }
             }
             else
             {
-                auto deletethis = m_windowInitialIndexSet[window];
                 m_windowFinalIndex[window] = targetZone;
-                resultIndexSet = GetCombinedZoneRange(m_windowInitialIndexSet[window], { targetZone });
+                resultIndexSet = GetCombinedZoneRange(m_windowInitialIndexSet[window], targetZoneSet);
             }
 
             m_inExtendWindow = true;
-            MoveWindowIntoZoneByIndexSet(window, workAreaWindow, resultIndexSet);
+            MoveWindowIntoZoneByIndexSet(window, workAreaWindow, resultIndexSet.ToIndexSet());
             m_inExtendWindow = false;
             return true;
         }
@@ -566,26 +497,25 @@ ZoneSet::CalculateZones(RECT workAreaRect, int zoneCount, int spacing) noexcept
         return false;
     }
 
-    bool success = true;
-    switch (m_config.LayoutType)
+    std::vector<ZoneLayoutEngine::Zone> zones;
+    bool success = false;
+    if (m_config.LayoutType == FancyZonesDataTypes::ZoneSetLayoutType::Custom)
+    {
+        success = CalculateCustomLayout(workArea, spacing, zones);
+    }
+    else
     {
-    case FancyZonesDataTypes::ZoneSetLayoutType::Focus:
-        success = CalculateFocusLayout(workArea, zoneCount);
-        break;
-    case FancyZonesDataTypes::ZoneSetLayoutType::Columns:
-    case FancyZonesDataTypes::ZoneSetLayoutType::Rows:
-        success = CalculateColumnsAndRowsLayout(workArea, m_config.LayoutType, zoneCount, spacing);
-        break;
-    case FancyZonesDataTypes::ZoneSetLayoutType::Grid:
-    case FancyZonesDataTypes::ZoneSetLayoutType::PriorityGrid:
-        success = CalculateGridLayout(workArea, m_config.LayoutType, zoneCount, spacing);
-        break;
-    case FancyZonesDataTypes::ZoneSetLayoutType::Custom:
-        success = CalculateCustomLayout(workArea, spacing);
-        break;
+        ZoneLayoutEngine::LayoutInput input{};
+        input.workAreaWidth = workArea.width();
+        input.workAreaHeight = workArea.height();
+        input.layout.kind = ToLayoutKind(m_config.LayoutType);
+        input.layout.zoneCount = zoneCount;
+        input.spacing = spacing;
+        input.dpi = DPIAware::DEFAULT_DPI;
+        success = ZoneLayoutEngine::CalculateLayout(input, zones);
     }
 
-    return success;
+    return success && AddCalculatedZones(zones);
 }
 
 bool ZoneSet::IsZoneEmpty(int zoneIndex) const noexcept
@@ -601,170 +531,7 @@ bool ZoneSet::IsZoneEmpty(int zoneIndex) const noexcept
     return true;
 }
 
-bool ZoneSet::CalculateFocusLayout(Rect workArea, int zoneCount) noexcept
-{
-    long left{ 100 };
-    long top{ 100 };
-    long right{ left + long(workArea.width() * 0.4) };
-    long bottom{ top + long(workArea.height() * 0.4) };
-
-    RECT focusZoneRect{ left, top, right, bottom };
-
-    long focusRectXIncrement = (zoneCount <= 1) ? 0 : 50;
-    long focusRectYIncrement = (zoneCount <= 1) ? 0 : 50;
-
-    for (int i = 0; i < zoneCount; i++)
-    {
-        auto zone = MakeZone(focusZoneRect, m_zones.size());
-        if (zone)
-        {
-            AddZone(zone);
-        }
-        else
-        {
-            // All zones within zone set should be valid in order to use its functionality.
-            m_zones.clear();
-            return false;
-        }
-        focusZoneRect.left += focusRectXIncrement;
-        focusZoneRect.right += focusRectXIncrement;
-        focusZoneRect.bottom += focusRectYIncrement;
-        focusZoneRect.top += focusRectYIncrement;
-    }
-
-    return true;
-}
-
-bool ZoneSet::CalculateColumnsAndRowsLayout(Rect workArea, FancyZonesDataTypes::ZoneSetLayoutType type, int zoneCount, int spacing) noexcept
-{
-    long totalWidth;
-    long totalHeight;
-
-    if (type == FancyZonesDataTypes::ZoneSetLayoutType::Columns)
-    {
-        totalWidth = workArea.width() - (spacing * (zoneCount + 1));
-        totalHeight = workArea.height() - (spacing * 2);
-    }
-    else
-    { //Rows
-        totalWidth = workArea.width() - (spacing * 2);
-        totalHeight = workArea.height() - (spacing * (zoneCount + 1));
-    }
-
-    long top = spacing;
-    long left = spacing;
-    long bottom;
-    long right;
-
-    // Note: The expressions below are NOT equal to total{Width|Height} / zoneCount and are done
-    // like this to make the sum of all zones' sizes exactly total{Width|Height}.
-    for (int zoneIndex = 0; zoneIndex < zoneCount; ++zoneIndex)
-    {
-        if (type == FancyZonesDataTypes::ZoneSetLayoutType::Columns)
-        {
-            right = left + (zoneIndex + 1) * totalWidth / zoneCount - zoneIndex * totalWidth / zoneCount;
-            bottom = totalHeight + spacing;
-        }
-        else
-        { //Rows
-            right = totalWidth + spacing;
-            bottom = top + (zoneIndex + 1) * totalHeight / zoneCount - zoneIndex * totalHeight / zoneCount;
-        }
-
-
-        auto zone = MakeZone(RECT{ left, top, right, bottom }, m_zones.size());
-        if (zone)
-        {
-            AddZone(zone);
-        }
-        else
-        {
-            // All zones within zone set should be valid in order to use its functionality.
-            m_zones.clear();
-            return false;
-        }
-
-        if (type == FancyZonesDataTypes::ZoneSetLayoutType::Columns)
-        {
-            left = right + spacing;
-        }
-        else
-        { //Rows
-            top = bottom + spacing;
-        }
-    }
-
-    return true;
-}
-
-bool ZoneSet::CalculateGridLayout(Rect workArea, FancyZonesDataTypes::ZoneSetLayoutType type, int zoneCount, int spacing) noexcept
-{
-    const auto count = sizeof(predefinedPriorityGridLayouts) / sizeof(FancyZonesDataTypes::GridLayoutInfo);
-    if (type == FancyZonesDataTypes::ZoneSetLayoutType::PriorityGrid && zoneCount < count)
-    {
-        return CalculateUniquePriorityGridLayout(workArea, zoneCount, spacing);
-    }
-
-    int rows = 1, columns = 1;
-    while (zoneCount / rows >= rows)
-    {
-        rows++;
-    }
-    rows--;
-    columns = zoneCount / rows;
-    if (zoneCount % rows == 0)
-    {
-        // even grid
-    }
-    else
-    {
-        columns++;
-    }
-
-    FancyZonesDataTypes::GridLayoutInfo gridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Minimal{ .rows = rows, .columns = columns });
-
-    // Note: The expressions below are NOT equal to C_MULTIPLIER / {rows|columns} and are done
-    // like this to make the sum of all percents exactly C_MULTIPLIER
-    for (int row = 0; row < rows; row++)
-    {
-        gridLayoutInfo.rowsPercents()[row] = C_MULTIPLIER * (row + 1) / rows - C_MULTIPLIER * row / rows;
-    }
-    for (int col = 0; col < columns; col++)
-    {
-        gridLayoutInfo.columnsPercents()[col] = C_MULTIPLIER * (col + 1) / columns - C_MULTIPLIER * col / columns;
-    }
-
-    for (int i = 0; i < rows; ++i)
-    {
-        gridLayoutInfo.cellChildMap()[i] = std::vector<int>(columns);
-    }
-
-    int index = 0;
-    for (int row = 0; row < rows; row++)
-    {
-        for (int col = 0; col < columns; col++)
-        {
-            gridLayoutInfo.cellChildMap()[row][col] = index++;
-            if (index == zoneCount)
-            {
-                index--;
-            }
-        }
-    }
-    return CalculateGridZones(workArea, gridLayoutInfo, spacing);
-}
-
-bool ZoneSet::CalculateUniquePriorityGridLayout(Rect workArea, int zoneCount, int spacing) noexcept
-{
-    if (zoneCount <= 0 || zoneCount >= sizeof(predefinedPriorityGridLayouts))
-    {
-        return false;
-    }
-
-    return CalculateGridZones(workArea, predefinedPriorityGridLayouts[zoneCount - 1], spacing);
-}
-
-bool ZoneSet::CalculateCustomLayout(Rect workArea, int spacing) noexcept
+bool ZoneSet::CalculateCustomLayout(Rect workArea, int spacing, std::vector<ZoneLayoutEngine::Zone>& zones) noexcept
 {
     wil::unique_cotaskmem_string guidStr;
     if (SUCCEEDED(StringFromCLSID(m_config.Id, &guidStr)))
@@ -778,163 +545,99 @@ bool ZoneSet::CalculateCustomLayout(Rect workArea, int spacing) noexcept
             return false;
         }
 
+        ZoneLayoutEngine::LayoutInput input{};
+        input.workAreaWidth = workArea.width();
+        input.workAreaHeight = workArea.height();
+        input.spacing = spacing;
+        input.dpi = GetMonitorDpi(m_config.Monitor);
+
         const auto& zoneSet = *zoneSetSearchResult;
         if (zoneSet.type == FancyZonesDataTypes::CustomLayoutType::Canvas && std::holds_alternative<FancyZonesDataTypes::CanvasLayoutInfo>(zoneSet.info))
         {
             const auto& zoneSetInfo = std::get<FancyZonesDataTypes::CanvasLayoutInfo>(zoneSet.info);
+
+            std::vector<ZoneLayoutEngine::CanvasZone> canvasZones;
+            canvasZones.reserve(zoneSetInfo.zones.size());
             for (const auto& zone : zoneSetInfo.zones)
             {
-                int x = zone.x;
-                int y = zone.y;
-                int width = zone.width;
-                int height = zone.height;
+                canvasZones.push_back({ zone.x, zone.y, zone.width, zone.height });
+            }
 
-                DPIAware::Convert(m_config.Monitor, x, y);
-                DPIAware::Convert(m_config.Monitor, width, height);
+            input.layout.kind = ZoneLayoutEngine::LayoutKind::CustomCanvas;
+            input.layout.canvas = { canvasZones.data(), canvasZones.size() };
+            return ZoneLayoutEngine::CalculateLayout(input, zones);
+        }
+        else if (zoneSet.type == FancyZonesDataTypes::CustomLayoutType::Grid && std::holds_alternative<FancyZonesDataTypes::GridLayoutInfo>(zoneSet.info))
+        {
+            const auto& info = std::get<FancyZonesDataTypes::GridLayoutInfo>(zoneSet.info);
+            const size_t rows = static_cast<size_t>(info.rows());
+            const size_t columns = static_cast<size_t>(info.columns());
+            if (info.rowsPercents().size() < rows || info.columnsPercents().size() < columns || info.cellChildMap().size() < rows)
+            {
+                return false;
+            }
 
-                auto zone = MakeZone(RECT{ x, y, x + width, y + height }, m_zones.size());
-                if (zone)
-                {
-                    AddZone(zone);
-                }
-                else
+            std::vector<int> cellChildMap;
+            cellChildMap.reserve(rows * columns);
+            for (size_t row = 0; row < rows; row++)
+            {
+                const auto& cells = info.cellChildMap()[row];
+                if (cells.size() < columns)
                 {
-                    // All zones within zone set should be valid in order to use its functionality.
-                    m_zones.clear();
                     return false;
                 }
+                cellChildMap.insert(cellChildMap.end(), cells.begin(), cells.begin() + columns);
             }
 
-            return true;
-        }
-        else if (zoneSet.type == FancyZonesDataTypes::CustomLayoutType::Grid && std::holds_alternative<FancyZonesDataTypes::GridLayoutInfo>(zoneSet.info))
-        {
-            const auto& info = std::get<FancyZonesDataTypes::GridLayoutInfo>(zoneSet.info);
-            return CalculateGridZones(workArea, info, spacing);
+            input.layout.kind = ZoneLayoutEngine::LayoutKind::CustomGrid;
+            input.layout.grid = { info.rows(), info.columns(), info.rowsPercents().data(), info.columnsPercents().data(), cellChildMap.data() };
+            return ZoneLayoutEngine::CalculateLayout(input, zones);
         }
     }
 
     return false;
 }
 
-bool ZoneSet::CalculateGridZones(Rect workArea, FancyZonesDataTypes::GridLayoutInfo gridLayoutInfo, int spacing)
+bool ZoneSet::AddCalculatedZones(const std::vector<ZoneLayoutEngine::Zone>& zones) noexcept
 {
-    long totalWidth = workArea.width() - (spacing * (gridLayoutInfo.columns() + 1));
-    long totalHeight = workArea.height() - (spacing * (gridLayoutInfo.rows() + 1));
-    struct Info
-    {
-        long Extent;
-        long Start;
-        long End;
-    };
-    std::vector<Info> rowInfo(gridLayoutInfo.rows());
-    std::vector<Info> columnInfo(gridLayoutInfo.columns());
-
-    // Note: The expressions below are carefully written to 
-    // make the sum of all zones' sizes exactly total{Width|Height}
-    int totalPercents = 0;
-    for (int row = 0; row < gridLayoutInfo.rows(); row++)
-    {
-        rowInfo[row].Start = totalPercents * totalHeight / C_MULTIPLIER + (row + 1) * spacing;
-        totalPercents += gridLayoutInfo.rowsPercents()[row];
-        rowInfo[row].End = totalPercents * totalHeight / C_MULTIPLIER + (row + 1) * spacing;
-        rowInfo[row].Extent = rowInfo[row].End - rowInfo[row].Start;
-    }
-
-    totalPercents = 0;
-    for (int col = 0; col < gridLayoutInfo.columns(); col++)
-    {
-        columnInfo[col].Start = totalPercents * totalWidth / C_MULTIPLIER + (col + 1) * spacing;
-        totalPercents += gridLayoutInfo.columnsPercents()[col];
-        columnInfo[col].End = totalPercents * totalWidth / C_MULTIPLIER + (col + 1) * spacing;
-        columnInfo[col].Extent = columnInfo[col].End - columnInfo[col].Start;
-    }
-
-    for (int row = 0; row < gridLayoutInfo.rows(); row++)
+    for (const auto& [id, rect] : zones)
     {
-        for (int col = 0; col < gridLayoutInfo.columns(); col++)
+        auto zone = MakeZone(RECT{ rect.left, rect.top, rect.right, rect.bottom }, id);
+        if (zone)
         {
-            int i = gridLayoutInfo.cellChildMap()[row][col];
-            if (((row == 0) || (gridLayoutInfo.cellChildMap()[row - 1][col] != i)) &&
-                ((col == 0) || (gridLayoutInfo.cellChildMap()[row][col - 1] != i)))
-            {
-                long left = columnInfo[col].Start;
-                long top = rowInfo[row].Start;
-
-                int maxRow = row;
-                while (((maxRow + 1) < gridLayoutInfo.rows()) && (gridLayoutInfo.cellChildMap()[maxRow + 1][col] == i))
-                {
-                    maxRow++;
-                }
-                int maxCol = col;
-                while (((maxCol + 1) < gridLayoutInfo.columns()) && (gridLayoutInfo.cellChildMap()[row][maxCol + 1] == i))
-                {
-                    maxCol++;
-                }
-
-                long right = columnInfo[maxCol].End;
-                long bottom = rowInfo[maxRow].End;
-
-                auto zone = MakeZone(RECT{ left, top, right, bottom }, i);
-                if (zone)
-                {
-                    AddZone(zone);
-                }
-                else
-                {
-                    // All zones within zone set should be valid in order to use its functionality.
-                    m_zones.clear();
-                    return false;
-                }
-            }
+            m_zones.try_emplace(zone->Id(), zone);
+        }
+        else
+        {
+            // All zones within zone set should be valid in order to use its functionality.
+            m_zones.clear();
+            PublishGeometry();
+            return false;
         }
     }
 
+    // Publish the whole layout at once instead of one snapshot per zone
+    PublishGeometry();
     return true;
 }
 
-std::vector<size_t> ZoneSet::GetCombinedZoneRange(const std::vector<size_t>& initialZones, const std::vector<size_t>& finalZones) const noexcept
+void ZoneSet::PublishGeometry() noexcept
 {
-    std::vector<size_t> combinedZones, result;
-    std::set_union(begin(initialZones), end(initialZones), begin(finalZones), end(finalZones), std::back_inserter(combinedZones));
-
-    RECT boundingRect;
-    bool boundingRectEmpty = true;
-
-    for (size_t zoneId : combinedZones)
+    ZoneGeometry geometry;
+    geometry.rects.reserve(m_zones.size());
+    for (const auto& [zoneId, zone] : m_zones)
     {
-        if (m_zones.contains(zoneId))
-        {
-            const RECT rect = m_zones.at(zoneId)->GetZoneRect();
-            if (boundingRectEmpty)
-            {
-                boundingRect = rect;
-                boundingRectEmpty = false;
-            }
-            else
-            {
-                boundingRect.left = min(boundingRect.left, rect.left);
-                boundingRect.top = min(boundingRect.top, rect.top);
-                boundingRect.right = max(boundingRect.right, rect.right);
-                boundingRect.bottom = max(boundingRect.bottom, rect.bottom);
-            }
-        }
+        const RECT& rect = zone->GetZoneRect();
+        geometry.rects.emplace_back(zoneId, rect);
+        geometry.bounds.Add(zoneId, ZoneLayoutEngine::ZoneRect{ rect.left, rect.top, rect.right, rect.bottom });
     }
 
-    if (!boundingRectEmpty)
-    {
-        for (const auto& [zoneId, zone] : m_zones)
-        {
-            const RECT rect = zone->GetZoneRect();
-            if (boundingRect.left <= rect.left && rect.right <= boundingRect.right &&
-                boundingRect.top <= rect.top && rect.bottom <= boundingRect.bottom)
-            {
-                result.push_back(zoneId);
-            }
-        }
-    }
+    m_geometry.Store(std::move(geometry));
+}
 
-    return result;
+ZoneIndexBitset ZoneSet::GetCombinedZoneRange(const ZoneIndexBitset& initialZones, const ZoneIndexBitset& finalZones) const noexcept
+{
+    return m_geometry.Load()->bounds.CombinedRange(initialZones, finalZones);
 }
 
 winrt::com_ptr<IZoneSet> MakeZoneSet(ZoneSetConfig const& config) noexcept
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Zone.h"
+#include "ZoneIndexBitset.h"
 
 namespace FancyZonesDataTypes
 {
@@ -146,9 +147,9 @@ interface __declspec(uuid("{E4839EB7-669D-49CF-84A9-71A2DFD851A3}")) IZoneSet :
      * @param   initialZones   The indices of the first chosen zone (the anchor).
      * @param   finalZones     The indices of the last chosen zone (the current window position).
      *
-     * @returns A vector indicating describing the chosen zone index set.
+     * @returns The chosen zone index set.
      */
-    IFACEMETHOD_(std::vector<size_t>, GetCombinedZoneRange)(const std::vector<size_t>& initialZones, const std::vector<size_t>& finalZones) const = 0;
+    IFACEMETHOD_(ZoneIndexBitset, GetCombinedZoneRange)(const ZoneIndexBitset& initialZones, const ZoneIndexBitset& finalZones) const = 0;
 };
 
 struct ZoneSetConfig
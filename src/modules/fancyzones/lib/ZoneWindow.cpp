@@ -88,6 +88,8 @@ public:
     CycleActiveZoneSet(DWORD vkCode) noexcept;
     IFACEMETHODIMP_(std::wstring)
     UniqueId() noexcept { return { m_uniqueId }; }
+    IFACEMETHODIMP_(GUID)
+    VirtualDesktopId() noexcept { return m_virtualDesktopId; }
     IFACEMETHODIMP_(void)
     SaveWindowProcessToZoneIndex(HWND window) noexcept;
     IFACEMETHODIMP_(IZoneSet*)
@@ -116,11 +118,12 @@ private:
     winrt::com_ptr<IZoneWindowHost> m_host;
     HMONITOR m_monitor{};
     std::wstring m_uniqueId; // Parsed deviceId + resolution + virtualDesktopId
+    GUID m_virtualDesktopId{}; // Parsed from m_uniqueId once, so it's not parsed on every lookup
     wil::unique_hwnd m_window{}; // Hidden tool window used to represent current monitor desktop work area.
     HWND m_windowMoveSize{};
     winrt::com_ptr<IZoneSet> m_activeZoneSet;
     std::vector<winrt::com_ptr<IZoneSet>> m_zoneSets;
-    std::vector<size_t> m_initialHighlightZone;
+    ZoneIndexBitset m_initialHighlightZone;
     std::vector<size_t> m_highlightZone;
     WPARAM m_keyLast{};
     size_t m_keyCycle{};
@@ -167,6 +170,11 @@ bool ZoneWindow::Init(IZoneWindowHost* host, HINSTANCE hinstance, HMONITOR monit
     }
 
     m_uniqueId = uniqueId;
+    // Format: <device-id>_<resolution>_<virtual-desktop-id>
+    if (FAILED(CLSIDFromString(m_uniqueId.substr(m_uniqueId.rfind('_') + 1).c_str(), &m_virtualDesktopId)))
+    {
+        m_virtualDesktopId = GUID_NULL;
+    }
     InitializeZoneSets(parentUniqueId);
 
     m_window = wil::unique_hwnd{
@@ -206,14 +214,14 @@ IFACEMETHODIMP ZoneWindow::MoveSizeUpdate(POINT const& ptScreen, bool dragEnable
 
         if (selectManyZones)
         {
-            if (m_initialHighlightZone.empty())
+            if (m_initialHighlightZone.None())
             {
                 // first time
-                m_initialHighlightZone = highlightZone;
+                m_initialHighlightZone = ZoneIndexBitset(highlightZone);
             }
             else
             {
-                highlightZone = m_activeZoneSet->GetCombinedZoneRange(m_initialHighlightZone, highlightZone);
+                highlightZone = m_activeZoneSet->GetCombinedZoneRange(m_initialHighlightZone, ZoneIndexBitset(highlightZone)).ToIndexSet();
             }
         }
         else
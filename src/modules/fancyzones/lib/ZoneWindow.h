@@ -110,6 +110,10 @@ interface __declspec(uuid("{7F017528-8110-4FB3-BE41-F472969C2560}")) IZoneWindow
      * @returns Unique work area identifier. Format: <device-id>_<resolution>_<virtual-desktop-id>
      */
     IFACEMETHOD_(std::wstring, UniqueId)() = 0;
+    /**
+     * @returns Virtual desktop identifier parsed from the unique work area identifier, GUID_NULL if it's not valid.
+     */
+    IFACEMETHOD_(GUID, VirtualDesktopId)() = 0;
     /**
      * @returns Active zone layout for this work area.
      */
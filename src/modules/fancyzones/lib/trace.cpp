@@ -12,6 +12,8 @@
 #define EventKeyDownKey "FancyZones_OnKeyDown"
 #define EventZoneSettingsChangedKey "FancyZones_ZoneSettingsChanged"
 #define EventEditorLaunchKey "FancyZones_EditorLaunch"
+#define EventEditorHandoffPublishedKey "FancyZones_EditorHandoffPublished"
+#define EventEditorHandoffCollectedKey "FancyZones_EditorHandoffCollected"
 #define EventSettingsChangedKey "FancyZones_SettingsChanged"
 #define EventDesktopChangedKey "FancyZones_VirtualDesktopChanged"
 #define EventZoneWindowKeyUpKey "FancyZones_ZoneWindowKeyUp"
@@ -29,6 +31,11 @@
 #define ActiveZoneSetsCountKey "ActiveZoneSetsCount"
 #define ActiveZoneSetsListKey "ActiveZoneSetsList"
 #define EditorLaunchValueKey "Value"
+#define SharedMemoryKey "SharedMemory"
+#define SnapshotSizeKey "SnapshotSize"
+#define JournalRecordsKey "JournalRecords"
+#define JournalOverflowKey "JournalOverflow"
+#define DurationMicrosecondsKey "DurationMicroseconds"
 #define ShiftDragKey "ShiftDrag"
 #define MouseSwitchKey "MouseSwitch"
 #define MoveWindowsOnDisplayChangeKey "MoveWindowsOnDisplayChange"
@@ -213,6 +220,33 @@ void Trace::FancyZones::EditorLaunched(int value) noexcept
         TraceLoggingInt32(value, EditorLaunchValueKey));
 }
 
+// Log how long it took to hand the edited layout data over to the editor
+void Trace::FancyZones::EditorHandoffPublished(bool sharedMemory, size_t snapshotSize, int64_t durationMicroseconds) noexcept
+{
+    TraceLoggingWrite(
+        g_hProvider,
+        EventEditorHandoffPublishedKey,
+        ProjectTelemetryPrivacyDataTag(ProjectTelemetryTag_ProductAndServicePerformance),
+        TraceLoggingKeyword(PROJECT_KEYWORD_MEASURE),
+        TraceLoggingBoolean(sharedMemory, SharedMemoryKey),
+        TraceLoggingValue(snapshotSize, SnapshotSizeKey),
+        TraceLoggingInt64(durationMicroseconds, DurationMicrosecondsKey));
+}
+
+// Log how long it took to apply the changes made in the editor
+void Trace::FancyZones::EditorHandoffCollected(bool sharedMemory, size_t journalRecords, bool journalOverflow, int64_t durationMicroseconds) noexcept
+{
+    TraceLoggingWrite(
+        g_hProvider,
+        EventEditorHandoffCollectedKey,
+        ProjectTelemetryPrivacyDataTag(ProjectTelemetryTag_ProductAndServicePerformance),
+        TraceLoggingKeyword(PROJECT_KEYWORD_MEASURE),
+        TraceLoggingBoolean(sharedMemory, SharedMemoryKey),
+        TraceLoggingValue(journalRecords, JournalRecordsKey),
+        TraceLoggingBoolean(journalOverflow, JournalOverflowKey),
+        TraceLoggingInt64(durationMicroseconds, DurationMicrosecondsKey));
+}
+
 // Log if an error occurs in FZ
 void Trace::FancyZones::Error(const DWORD errorCode, std::wstring errorMessage, std::wstring methodName) noexcept
 {
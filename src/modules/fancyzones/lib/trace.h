@@ -16,6 +16,8 @@ public:
         static void OnKeyDown(DWORD vkCode, bool win, bool control, bool inMoveSize) noexcept;
         static void DataChanged() noexcept;
         static void EditorLaunched(int value) noexcept;
+        static void EditorHandoffPublished(bool sharedMemory, size_t snapshotSize, int64_t durationMicroseconds) noexcept;
+        static void EditorHandoffCollected(bool sharedMemory, size_t journalRecords, bool journalOverflow, int64_t durationMicroseconds) noexcept;
         static void Error(const DWORD errorCode, std::wstring errorMessage, std::wstring methodName) noexcept;
     };
 
@@ -18,6 +18,38 @@ namespace NonLocalizable
 
 namespace
 {
+    const wchar_t* const ZoneStampProperties[] = {
+        ZonedWindowProperties::PropertyMultipleZoneID,
+        ZonedWindowProperties::PropertyMultipleZone64ID,
+        ZonedWindowProperties::PropertyMultipleZone128ID,
+        ZonedWindowProperties::PropertyMultipleZone192ID,
+    };
+    static_assert(std::size(ZoneStampProperties) == ZoneIndexBitset::InlineWordCount);
+
+    // Name of the property of an overflow word, formatted into a fixed buffer so that stamping doesn't allocate
+    std::array<wchar_t, 64> ZoneStampOverflowProperty(size_t wordIndex) noexcept
+    {
+        std::array<wchar_t, 64> name{};
+        swprintf_s(name.data(), name.size(), L"%s_%zu", ZonedWindowProperties::PropertyMultipleZoneID, wordIndex * ZoneIndexBitset::WordBits);
+        return name;
+    }
+
+    // Any window can carry the property, so the count is capped to the words a zone index set can have
+    size_t GetZoneStampOverflowCount(HWND window) noexcept
+    {
+        const size_t count = reinterpret_cast<size_t>(::GetProp(window, ZonedWindowProperties::PropertyMultipleZoneOverflowCountID));
+        return (std::min)(count, ZoneIndexBitset::MaxWordCount - ZoneIndexBitset::InlineWordCount);
+    }
+
+    void RemoveZoneStampOverflow(HWND window, size_t fromWordIndex) noexcept
+    {
+        const size_t wordCount = ZoneIndexBitset::InlineWordCount + GetZoneStampOverflowCount(window);
+        for (size_t i = (std::max)(fromWordIndex, ZoneIndexBitset::InlineWordCount); i < wordCount; i++)
+        {
+            ::RemoveProp(window, ZoneStampOverflowProperty(i).data());
+        }
+    }
+
     bool IsZonableByProcessPath(const std::wstring& processPath, const std::vector<std::wstring>& excludedApps)
     {
         // Filter out user specified apps
@@ -379,6 +411,81 @@ namespace FancyZonesUtils
         }
     }
 
+    void StampWindow(HWND window, const ZoneIndexBitset& zones) noexcept
+    {
+        for (size_t i = 0; i < ZoneIndexBitset::InlineWordCount; i++)
+        {
+            const auto word = static_cast<size_t>(zones.GetWord(i));
+            if (word != 0)
+            {
+                ::SetProp(window, ZoneStampProperties[i], reinterpret_cast<HANDLE>(word));
+            }
+            else
+            {
+                ::RemoveProp(window, ZoneStampProperties[i]);
+            }
+        }
+
+        // Zones of very large custom layouts
+        RemoveZoneStampOverflow(window, zones.WordCount());
+        for (size_t i = ZoneIndexBitset::InlineWordCount; i < zones.WordCount(); i++)
+        {
+            const auto word = static_cast<size_t>(zones.GetWord(i));
+            if (word != 0)
+            {
+                ::SetProp(window, ZoneStampOverflowProperty(i).data(), reinterpret_cast<HANDLE>(word));
+            }
+            else
+            {
+                ::RemoveProp(window, ZoneStampOverflowProperty(i).data());
+            }
+        }
+
+        const size_t overflowCount = zones.WordCount() - ZoneIndexBitset::InlineWordCount;
+        if (overflowCount != 0)
+        {
+            ::SetProp(window, ZonedWindowProperties::PropertyMultipleZoneOverflowCountID, reinterpret_cast<HANDLE>(overflowCount));
+        }
+        else
+        {
+            ::RemoveProp(window, ZonedWindowProperties::PropertyMultipleZoneOverflowCountID);
+        }
+    }
+
+    ZoneIndexBitset GetWindowStamp(HWND window) noexcept
+    {
+        ZoneIndexBitset zones;
+        for (size_t i = 0; i < ZoneIndexBitset::InlineWordCount; i++)
+        {
+            zones.SetWord(i, reinterpret_cast<size_t>(::GetProp(window, ZoneStampProperties[i])));
+        }
+
+        // Overflow words are allocated, so the stamp is treated as empty if that fails
+        try
+        {
+            const size_t wordCount = ZoneIndexBitset::InlineWordCount + GetZoneStampOverflowCount(window);
+            for (size_t i = ZoneIndexBitset::InlineWordCount; i < wordCount; i++)
+            {
+                zones.SetWord(i, reinterpret_cast<size_t>(::GetProp(window, ZoneStampOverflowProperty(i).data())));
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+            return {};
+        }
+        return zones;
+    }
+
+    void RemoveWindowStamp(HWND window) noexcept
+    {
+        for (const auto& property : ZoneStampProperties)
+        {
+            ::RemoveProp(window, property);
+        }
+        RemoveZoneStampOverflow(window, ZoneIndexBitset::InlineWordCount);
+        ::RemoveProp(window, ZonedWindowProperties::PropertyMultipleZoneOverflowCountID);
+    }
+
     bool IsValidGuid(const std::wstring& str)
     {
         GUID id;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gdiplus.h"
+#include "ZoneIndexBitset.h"
 #include <common/string_utils.h>
 
 namespace FancyZonesUtils
@@ -173,6 +174,10 @@ namespace FancyZonesUtils
     void RestoreWindowSize(HWND window) noexcept;
     void RestoreWindowOrigin(HWND window) noexcept;
 
+    void StampWindow(HWND window, const ZoneIndexBitset& zones) noexcept;
+    ZoneIndexBitset GetWindowStamp(HWND window) noexcept;
+    void RemoveWindowStamp(HWND window) noexcept;
+
     bool IsValidGuid(const std::wstring& str);
     bool IsValidDeviceId(const std::wstring& str);
 
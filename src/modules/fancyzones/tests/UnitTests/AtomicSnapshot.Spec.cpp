@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "lib\AtomicSnapshot.h"
+
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace FancyZonesUnitTests
+{
+    TEST_CLASS (AtomicSnapshotUnitTests)
+    {
+        TEST_METHOD (DefaultConstructed)
+        {
+            AtomicSnapshot<std::vector<int>> snapshot;
+            Assert::IsNotNull(snapshot.Load().get());
+            Assert::IsTrue(snapshot.Load()->empty());
+        }
+
+        TEST_METHOD (Store)
+        {
+            AtomicSnapshot<std::vector<int>> snapshot{ { 1, 2 } };
+            snapshot.Store({ 3 });
+
+            const std::vector<int> expected{ 3 };
+            Assert::IsTrue(expected == *snapshot.Load());
+        }
+
+        TEST_METHOD (UpdateCopiesCurrentValue)
+        {
+            AtomicSnapshot<std::vector<int>> snapshot{ { 1, 2 } };
+            const size_t size = snapshot.Update([](std::vector<int>& value) {
+                value.push_back(3);
+                return value.size();
+            });
+
+            const std::vector<int> expected{ 1, 2, 3 };
+            Assert::AreEqual(size_t{ 3 }, size);
+            Assert::IsTrue(expected == *snapshot.Load());
+        }
+
+        TEST_METHOD (ReaderKeepsItsSnapshot)
+        {
+            AtomicSnapshot<std::vector<int>> snapshot{ { 1, 2 } };
+            const auto before = snapshot.Load();
+
+            snapshot.Update([](std::vector<int>& value) { value.clear(); });
+            snapshot.Store({ 5 });
+
+            const std::vector<int> expected{ 1, 2 };
+            Assert::IsTrue(expected == *before);
+            Assert::AreEqual(5, snapshot.Load()->front());
+        }
+
+        TEST_METHOD (ConcurrentUpdatesAreNotLost)
+        {
+            constexpr int writers = 4;
+            constexpr int updatesPerWriter = 1000;
+            AtomicSnapshot<std::vector<int>> snapshot;
+            std::atomic<bool> done = false;
+            std::atomic<size_t> inconsistentReads = 0;
+
+            // Readers must always see a consistent value: element i equals i
+            std::thread reader([&] {
+                while (!done)
+                {
+                    const auto value = snapshot.Load();
+                    for (size_t i = 0; i < value->size(); i++)
+                    {
+                        if ((*value)[i] != static_cast<int>(i))
+                        {
+                            inconsistentReads++;
+                        }
+                    }
+                }
+            });
+
+            std::vector<std::thread> threads;
+            for (int writer = 0; writer < writers; writer++)
+            {
+                threads.emplace_back([&] {
+                    for (int i = 0; i < updatesPerWriter; i++)
+                    {
+                        snapshot.Update([](std::vector<int>& value) { value.push_back(static_cast<int>(value.size())); });
+                    }
+                });
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            done = true;
+            reader.join();
+
+            Assert::AreEqual(size_t{ 0 }, inconsistentReads.load());
+            Assert::AreEqual(static_cast<size_t>(writers * updatesPerWriter), snapshot.Load()->size());
+        }
+    };
+}
@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "lib\EditorHandoff.h"
+
+#include "Util.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace EditorHandoff;
+
+namespace FancyZonesUnitTests
+{
+    TEST_CLASS (EditorHandoffUnitTests)
+    {
+        std::vector<uint8_t> makeBuffer(std::string_view snapshot, size_t journalCapacity = DefaultJournalCapacity)
+        {
+            std::vector<uint8_t> buffer(RequiredSize(snapshot.size(), journalCapacity));
+            Assert::IsTrue(WriteSnapshot(buffer.data(), buffer.size(), snapshot, journalCapacity));
+            return buffer;
+        }
+
+        TEST_METHOD (WriteSnapshotLayout)
+        {
+            const std::string snapshot = "{\"device-id\": \"id\"}";
+            auto buffer = makeBuffer(snapshot);
+
+            const auto header = reinterpret_cast<const Header*>(buffer.data());
+            Assert::AreEqual(Magic, header->magic);
+            Assert::AreEqual(Version, header->version);
+            Assert::AreEqual(buffer.size(), static_cast<size_t>(header->totalSize));
+            Assert::AreEqual(snapshot.size(), static_cast<size_t>(header->snapshotSize));
+            Assert::AreEqual(0u, header->journalOffset % 4);
+            Assert::AreEqual(0u, header->journalSize);
+            Assert::AreEqual(snapshot, std::string(reinterpret_cast<const char*>(buffer.data() + header->snapshotOffset), header->snapshotSize));
+        }
+
+        TEST_METHOD (WriteSnapshotBufferTooSmall)
+        {
+            std::vector<uint8_t> buffer(RequiredSize(16) - 1);
+            Assert::IsFalse(WriteSnapshot(buffer.data(), buffer.size(), std::string(16, 'x')));
+        }
+
+        TEST_METHOD (EmptyJournal)
+        {
+            auto buffer = makeBuffer("{}");
+
+            bool overflow = true;
+            Assert::IsTrue(ReadJournal(buffer.data(), buffer.size(), overflow).empty());
+            Assert::IsFalse(overflow);
+        }
+
+        TEST_METHOD (JournalRoundTrip)
+        {
+            auto buffer = makeBuffer("{}");
+            Assert::IsTrue(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::DeletedCustomZoneSets, "{\"deleted-custom-zone-sets\": []}"));
+            Assert::IsTrue(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::AppliedZoneSet, "{\"uuid\": \"a\"}"));
+            Assert::IsTrue(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::ActiveZoneSet, ""));
+
+            bool overflow = true;
+            const auto journal = ReadJournal(buffer.data(), buffer.size(), overflow);
+            Assert::IsFalse(overflow);
+            Assert::AreEqual(size_t{ 3 }, journal.size());
+            Assert::IsTrue(JournalRecordKind::DeletedCustomZoneSets == journal[0].kind);
+            Assert::AreEqual(std::string("{\"deleted-custom-zone-sets\": []}"), journal[0].payload);
+            Assert::IsTrue(JournalRecordKind::AppliedZoneSet == journal[1].kind);
+            Assert::AreEqual(std::string("{\"uuid\": \"a\"}"), journal[1].payload);
+            Assert::IsTrue(JournalRecordKind::ActiveZoneSet == journal[2].kind);
+            Assert::IsTrue(journal[2].payload.empty());
+        }
+
+        TEST_METHOD (JournalOverflow)
+        {
+            auto buffer = makeBuffer("{}", 32);
+            Assert::IsTrue(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::AppliedZoneSet, "0123456789"));
+            Assert::IsFalse(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::AppliedZoneSet, "0123456789"));
+            // Would fit, but has to follow the overflowed record to the temp files
+            Assert::IsFalse(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::ActiveZoneSet, ""));
+
+            bool overflow = false;
+            const auto journal = ReadJournal(buffer.data(), buffer.size(), overflow);
+            Assert::IsTrue(overflow);
+            Assert::AreEqual(size_t{ 1 }, journal.size());
+        }
+
+        TEST_METHOD (InvalidBuffer)
+        {
+            auto buffer = makeBuffer("{}");
+            Assert::IsTrue(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::AppliedZoneSet, "{}"));
+            reinterpret_cast<Header*>(buffer.data())->magic = 0;
+
+            bool overflow = false;
+            Assert::IsTrue(ReadJournal(buffer.data(), buffer.size(), overflow).empty());
+            Assert::IsTrue(ReadJournal(nullptr, 0, overflow).empty());
+            Assert::IsFalse(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::AppliedZoneSet, "{}"));
+        }
+
+        TEST_METHOD (TruncatedRecordIsIgnored)
+        {
+            auto buffer = makeBuffer("{}");
+            Assert::IsTrue(AppendJournalRecord(buffer.data(), buffer.size(), JournalRecordKind::AppliedZoneSet, "{}"));
+
+            auto header = reinterpret_cast<Header*>(buffer.data());
+            auto record = reinterpret_cast<JournalRecordHeader*>(buffer.data() + header->journalOffset);
+            record->size = header->journalCapacity;
+
+            bool overflow = false;
+            Assert::IsTrue(ReadJournal(buffer.data(), buffer.size(), overflow).empty());
+        }
+
+        TEST_METHOD (SharedMemorySnapshot)
+        {
+            const std::wstring name = L"Local\\FancyZonesUnitTests_EditorHandoff_" + std::to_wstring(GetCurrentProcessId());
+            SharedMemory sharedMemory;
+            Assert::IsTrue(sharedMemory.Create(name, "{}"));
+            Assert::IsTrue(sharedMemory.IsOpen());
+            Assert::AreEqual(name.c_str(), sharedMemory.Name().c_str());
+
+            // Editor side
+            wil::unique_handle mapping{ OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, name.c_str()) };
+            Assert::IsTrue(static_cast<bool>(mapping));
+            wil::unique_mapview_ptr<void> view{ MapViewOfFile(mapping.get(), FILE_MAP_ALL_ACCESS, 0, 0, 0) };
+            Assert::IsTrue(static_cast<bool>(view));
+            Assert::IsTrue(AppendJournalRecord(view.get(), RequiredSize(2), JournalRecordKind::AppliedZoneSet, "{}"));
+
+            bool overflow = false;
+            Assert::AreEqual(size_t{ 1 }, sharedMemory.ReadJournal(overflow).size());
+
+            sharedMemory.Close();
+            Assert::IsFalse(sharedMemory.IsOpen());
+            Assert::IsTrue(sharedMemory.ReadJournal(overflow).empty());
+        }
+    };
+}
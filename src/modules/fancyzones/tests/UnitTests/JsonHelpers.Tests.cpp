@@ -1577,6 +1577,56 @@ namespace FancyZonesUnitTests
                 Assert::AreEqual((size_t)0, devices.size());
             }
 
+            TEST_METHOD (EditorJournalApply)
+            {
+                FancyZonesData data;
+                data.SetSettingsModulePath(m_moduleName);
+
+                const std::wstring deletedUuid = L"{33A2B101-06E0-437B-A61E-CDBECF502902}";
+                const std::wstring appliedUuid = L"{33A2B101-06E0-437B-A61E-CDBECF502906}";
+                const CustomZoneSetJSON applied{ appliedUuid, CustomZoneSetData{ L"applied", CustomLayoutType::Canvas, CanvasLayoutInfo{ 1920, 1080 } } };
+
+                data.customZoneSetsMap[deletedUuid] = CustomZoneSetData{ L"deleted", CustomLayoutType::Canvas, CanvasLayoutInfo{ 1, 2 } };
+
+                std::vector<EditorHandoff::JournalRecord> journal{
+                    { EditorHandoff::JournalRecordKind::AppliedZoneSet, winrt::to_string(CustomZoneSetJSON::ToJson(applied).Stringify()) },
+                    { EditorHandoff::JournalRecordKind::DeletedCustomZoneSets, "{\"deleted-custom-zone-sets\": [\"33A2B101-06E0-437B-A61E-CDBECF502902\"]}" },
+                    { EditorHandoff::JournalRecordKind::ActiveZoneSet, winrt::to_string(m_defaultCustomDeviceStr) },
+                    { EditorHandoff::JournalRecordKind::AppliedZoneSet, "malformed" },
+                };
+                data.ParseDataFromEditorJournal(journal);
+
+                const auto& customZoneSetsMap = data.GetCustomZoneSetsMap();
+                Assert::AreEqual((size_t)1, customZoneSetsMap.size());
+                Assert::AreEqual(L"applied", customZoneSetsMap.at(appliedUuid).name.c_str());
+
+                const auto& deviceInfoMap = data.GetDeviceInfoMap();
+                Assert::AreEqual((size_t)1, deviceInfoMap.size());
+                Assert::AreEqual(L"{33A2B101-06E0-437B-A61E-CDBECF502906}", deviceInfoMap.at(m_defaultDeviceId).activeZoneSet.uuid.c_str());
+            }
+
+            TEST_METHOD (EditorSnapshot)
+            {
+                FancyZonesData data;
+                data.SetSettingsModulePath(m_moduleName);
+
+                json::JsonArray devices;
+                devices.Append(m_defaultCustomDeviceValue);
+                json::JsonObject json;
+                json.SetNamedValue(L"devices", devices);
+                data.ParseDeviceInfos(json);
+                data.customZoneSetsMap[L"{33A2B101-06E0-437B-A61E-CDBECF502902}"] = CustomZoneSetData{ L"name", CustomLayoutType::Canvas, CanvasLayoutInfo{ 1, 2 } };
+
+                Assert::IsFalse(data.SerializeEditorSnapshot(L"unknown device").has_value());
+
+                const auto snapshot = data.SerializeEditorSnapshot(m_defaultDeviceId);
+                Assert::IsTrue(snapshot.has_value());
+
+                const auto snapshotJson = json::JsonObject::Parse(winrt::to_hstring(*snapshot));
+                Assert::AreEqual(m_defaultDeviceId.c_str(), snapshotJson.GetNamedString(L"device-id").c_str());
+                Assert::AreEqual(1u, snapshotJson.GetNamedArray(L"custom-zone-sets").Size());
+            }
+
             TEST_METHOD (SetActiveZoneSet)
             {
                 FancyZonesData data;
@@ -1747,6 +1797,121 @@ namespace FancyZonesUnitTests
                 Assert::IsFalse(data.GetDeviceInfoMap().empty());
             }
 
+            TEST_METHOD (StreamingParserMatchesDomParser)
+            {
+                const GridLayoutInfo grid(GridLayoutInfo(FancyZonesDataTypes::GridLayoutInfo::Full{
+                    .rows = 1,
+                    .columns = 3,
+                    .rowsPercents = { 10000 },
+                    .columnsPercents = { 2500, 5000, 2500 },
+                    .cellChildMap = { { 0, 1, 2 } } }));
+                const CanvasLayoutInfo canvas{ 1920, 1080, { { 0, 0, 960, 1080 }, { 960, 0, 960, 1080 } } };
+                AppZoneHistoryData history{
+                    .zoneSetUuid = L"{33A2B101-06E0-437B-A61E-CDBECF502906}", .deviceId = m_defaultDeviceId, .zoneIndexSet = { 1, 2 }
+                };
+
+                json::JsonArray devices, customZoneSets, appZoneHistory;
+                devices.Append(m_defaultCustomDeviceValue);
+                devices.Append(json::JsonObject::Parse(L"{\"device-id\": \"device_id\"}"));
+                customZoneSets.Append(CustomZoneSetJSON::ToJson(CustomZoneSetJSON{ L"{33A2B101-06E0-437B-A61E-CDBECF502906}", CustomZoneSetData{ L"grid", CustomLayoutType::Grid, grid } }));
+                customZoneSets.Append(CustomZoneSetJSON::ToJson(CustomZoneSetJSON{ L"{33A2B101-06E0-437B-A61E-CDBECF502907}", CustomZoneSetData{ L"canvas", CustomLayoutType::Canvas, canvas } }));
+                customZoneSets.Append(json::JsonObject::Parse(L"{\"uuid\": \"{33A2B101-06E0-437B-A61E-CDBECF502908}\", \"name\": \"invalid\", \"type\": \"grid\", \"info\": {\"rows\": 2}}"));
+                appZoneHistory.Append(AppZoneHistoryJSON::ToJson(AppZoneHistoryJSON{ L"app", { history } }));
+                appZoneHistory.Append(json::JsonObject::Parse(L"{\"app-path\": \"previous-format\", \"zone-index\": 3, \"device-id\": \"" + m_defaultDeviceId + L"\", \"zoneset-uuid\": \"{33A2B101-06E0-437B-A61E-CDBECF502906}\"}"));
+                appZoneHistory.Append(json::JsonObject::Parse(L"{\"app-path\": \"invalid\", \"history\": [{\"zone-index-set\": [\"1\"], \"device-id\": \"" + m_defaultDeviceId + L"\", \"zoneset-uuid\": \"{33A2B101-06E0-437B-A61E-CDBECF502906}\"}]}"));
+
+                json::JsonObject json;
+                json.SetNamedValue(L"devices", devices);
+                json.SetNamedValue(L"custom-zone-sets", customZoneSets);
+                json.SetNamedValue(L"app-zone-history", appZoneHistory);
+
+                std::optional<TAppZoneHistoryMap> appZoneHistoryMap;
+                TDeviceInfoMap deviceInfoMap;
+                TCustomZoneSetsMap customZoneSetsMap;
+                Assert::IsTrue(ParseZonesSettings(winrt::to_string(json.Stringify()), appZoneHistoryMap, deviceInfoMap, customZoneSetsMap));
+
+                const auto expectedAppZoneHistoryMap = ParseAppZoneHistory(json);
+                const auto expectedDeviceInfoMap = ParseDeviceInfos(json);
+                const auto expectedCustomZoneSetsMap = ParseCustomZoneSets(json);
+
+                Assert::IsTrue(appZoneHistoryMap.has_value());
+                Assert::AreEqual(expectedAppZoneHistoryMap.size(), appZoneHistoryMap->size());
+                for (const auto& [appPath, expectedData] : expectedAppZoneHistoryMap)
+                {
+                    const auto& actualData = appZoneHistoryMap->at(appPath);
+                    Assert::AreEqual(expectedData.size(), actualData.size());
+                    for (size_t i = 0; i < expectedData.size(); i++)
+                    {
+                        Assert::AreEqual(expectedData[i].deviceId.c_str(), actualData[i].deviceId.c_str());
+                        Assert::AreEqual(expectedData[i].zoneSetUuid.c_str(), actualData[i].zoneSetUuid.c_str());
+                        Assert::IsTrue(expectedData[i].zoneIndexSet == actualData[i].zoneIndexSet);
+                    }
+                }
+
+                Assert::AreEqual(expectedDeviceInfoMap.size(), deviceInfoMap.size());
+                compareJsonArrays(SerializeDeviceInfos(expectedDeviceInfoMap), SerializeDeviceInfos(deviceInfoMap));
+
+                Assert::AreEqual(expectedCustomZoneSetsMap.size(), customZoneSetsMap.size());
+                for (const auto& [uuid, expectedData] : expectedCustomZoneSetsMap)
+                {
+                    compareJsonObjects(CustomZoneSetJSON::ToJson(CustomZoneSetJSON{ uuid, expectedData }), CustomZoneSetJSON::ToJson(CustomZoneSetJSON{ uuid, customZoneSetsMap.at(uuid) }));
+                }
+            }
+
+            TEST_METHOD (StreamingParserInvalidTypes)
+            {
+                const std::string json = "{ \"app-zone-history\": null, \"devices\": [{\"device-id\":\"AOC2460#4&fe3a015&0&UID65793_1920_1200_{39B25DD2-130D-4B5D-8851-4791D66B1539}\",\"active-zoneset\":{\"uuid\":\"{568EBC3A-C09C-483E-A64D-6F1F2AF4E48D}\",\"type\":\"columns\"},\"editor-show-spacing\":true,\"editor-spacing\":16,\"editor-zone-count\":3}], \"custom-zone-sets\": [1]}";
+
+                std::optional<TAppZoneHistoryMap> appZoneHistoryMap;
+                TDeviceInfoMap deviceInfoMap;
+                TCustomZoneSetsMap customZoneSetsMap;
+                Assert::IsTrue(ParseZonesSettings(json, appZoneHistoryMap, deviceInfoMap, customZoneSetsMap));
+
+                Assert::IsTrue(appZoneHistoryMap.has_value());
+                Assert::IsTrue(appZoneHistoryMap->empty());
+                Assert::AreEqual((size_t)1, deviceInfoMap.size());
+                Assert::IsTrue(customZoneSetsMap.empty());
+            }
+
+            TEST_METHOD (StreamingParserCroppedJson)
+            {
+                std::optional<TAppZoneHistoryMap> appZoneHistoryMap;
+                TDeviceInfoMap deviceInfoMap;
+                TCustomZoneSetsMap customZoneSetsMap;
+                Assert::IsFalse(ParseZonesSettings("{ \"app-zone-history\": [], \"devices\": [{\"device-id\": \"", appZoneHistoryMap, deviceInfoMap, customZoneSetsMap));
+                Assert::IsTrue(ParseAppZoneHistory(std::string_view{ "{ \"app-zone-history\": [" }).empty());
+            }
+
+            TEST_METHOD (LoadFancyZonesDataFromSeparateAppZoneHistoryFile)
+            {
+                FancyZonesData data;
+                data.SetSettingsModulePath(m_moduleName);
+
+                AppZoneHistoryData history{
+                    .zoneSetUuid = L"{33A2B101-06E0-437B-A61E-CDBECF502906}", .deviceId = m_defaultDeviceId, .zoneIndexSet = { 1 }
+                };
+                json::JsonArray devices, appZoneHistory;
+                devices.Append(m_defaultCustomDeviceValue);
+                appZoneHistory.Append(AppZoneHistoryJSON::ToJson(AppZoneHistoryJSON{ L"app", { history } }));
+
+                json::JsonObject zonesSettings, appZoneHistoryRoot;
+                zonesSettings.SetNamedValue(L"devices", devices);
+                zonesSettings.SetNamedValue(L"custom-zone-sets", json::JsonArray{});
+                appZoneHistoryRoot.SetNamedValue(L"app-zone-history", appZoneHistory);
+                json::to_file(data.zonesSettingsFileName, zonesSettings);
+                json::to_file(data.appZoneHistoryFileName, appZoneHistoryRoot);
+
+                TAppZoneHistoryMap appZoneHistoryMap;
+                TDeviceInfoMap deviceInfoMap;
+                TCustomZoneSetsMap customZoneSetsMap;
+                Assert::IsTrue(JSONHelpers::LoadFancyZonesData(data.zonesSettingsFileName, data.appZoneHistoryFileName, appZoneHistoryMap, deviceInfoMap, customZoneSetsMap));
+
+                Assert::AreEqual((size_t)1, appZoneHistoryMap.size());
+                Assert::IsTrue(std::vector<size_t>{ 1 } == appZoneHistoryMap.at(L"app")[0].zoneIndexSet);
+                Assert::AreEqual((size_t)1, deviceInfoMap.size());
+                Assert::IsTrue(customZoneSetsMap.empty());
+            }
+
             TEST_METHOD (LoadFancyZonesDataFromRegistry)
             {
                 FancyZonesData data;
@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "lib\JsonStreamReader.h"
+
+#include "Util.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace FancyZonesUnitTests
+{
+    TEST_CLASS (JsonStreamReaderUnitTests)
+    {
+        TEST_METHOD (ReadObject)
+        {
+            JsonStreamReader reader{ R"({ "string": "value", "number": -12.5e1, "boolean": true, "null": null })" };
+            std::wstring name, stringValue;
+            double numberValue = 0;
+            bool booleanValue = false;
+
+            Assert::IsTrue(reader.BeginObject());
+            Assert::IsTrue(reader.NextMember(name));
+            Assert::AreEqual(L"string", name.c_str());
+            Assert::IsTrue(reader.ReadString(stringValue));
+            Assert::AreEqual(L"value", stringValue.c_str());
+            Assert::IsTrue(reader.NextMember(name));
+            Assert::AreEqual(L"number", name.c_str());
+            Assert::IsTrue(reader.ReadNumber(numberValue));
+            Assert::AreEqual(-125.0, numberValue);
+            Assert::IsTrue(reader.NextMember(name));
+            Assert::AreEqual(L"boolean", name.c_str());
+            Assert::IsTrue(reader.ReadBoolean(booleanValue));
+            Assert::IsTrue(booleanValue);
+            Assert::IsTrue(reader.NextMember(name));
+            Assert::AreEqual(L"null", name.c_str());
+            Assert::IsTrue(JsonStreamReader::ValueType::Null == reader.PeekType());
+            reader.SkipValue();
+            Assert::IsFalse(reader.NextMember(name));
+            Assert::IsTrue(reader.Finish());
+        }
+
+        TEST_METHOD (ReadArray)
+        {
+            JsonStreamReader reader{ "[1, 2, 3]" };
+            double value = 0, sum = 0;
+            Assert::IsTrue(reader.BeginArray());
+            while (reader.NextElement())
+            {
+                Assert::IsTrue(reader.ReadNumber(value));
+                sum += value;
+            }
+            Assert::AreEqual(6.0, sum);
+            Assert::IsTrue(reader.Finish());
+        }
+
+        TEST_METHOD (TypeMismatchSkipsValue)
+        {
+            JsonStreamReader reader{ R"([{"nested": [1, {"a": "b"}]}, "text"])" };
+            double number = 0;
+            std::wstring text;
+            Assert::IsTrue(reader.BeginArray());
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsFalse(reader.ReadNumber(number));
+            Assert::IsFalse(reader.Failed());
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(text));
+            Assert::AreEqual(L"text", text.c_str());
+            Assert::IsFalse(reader.NextElement());
+            Assert::IsTrue(reader.Finish());
+        }
+
+        TEST_METHOD (ReadEscapedAndUnicodeStrings)
+        {
+            JsonStreamReader reader{ "[\"a\\\"b\\\\c\\/\\n\", \"\\u043a\\u0438\", \"\xD0\xBA\xD0\xB8\", \"\\ud83d\\ude00\", \"\xF0\x9F\x98\x80\"]" };
+            std::wstring value;
+            Assert::IsTrue(reader.BeginArray());
+
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(value));
+            Assert::AreEqual(L"a\"b\\c/\n", value.c_str());
+
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(value));
+            Assert::AreEqual(L"\u043a\u0438", value.c_str());
+
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(value));
+            Assert::AreEqual(L"\u043a\u0438", value.c_str());
+
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(value));
+            Assert::AreEqual(L"\U0001F600", value.c_str());
+
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(value));
+            Assert::AreEqual(L"\U0001F600", value.c_str());
+
+            Assert::IsFalse(reader.NextElement());
+            Assert::IsTrue(reader.Finish());
+        }
+
+        TEST_METHOD (ReadInvalidUtf8Strings)
+        {
+            // Lead bytes above 0xF4, overlong forms and encoded surrogates decode to U+FFFD instead of a code point
+            JsonStreamReader reader{ "[\"\xF8\x88\x80\x80\", \"\xC0\x80\", \"\xED\xA0\x80\"]" };
+            std::wstring value;
+            Assert::IsTrue(reader.BeginArray());
+
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(value));
+            Assert::AreEqual(L"\uFFFD\uFFFD\uFFFD\uFFFD", value.c_str());
+
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(value));
+            Assert::AreEqual(L"\uFFFD\uFFFD", value.c_str());
+
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadString(value));
+            Assert::AreEqual(L"\uFFFD", value.c_str());
+
+            Assert::IsFalse(reader.NextElement());
+            Assert::IsTrue(reader.Finish());
+        }
+
+        TEST_METHOD (SkipByteOrderMark)
+        {
+            JsonStreamReader reader{ "\xEF\xBB\xBF{}" };
+            std::wstring name;
+            Assert::IsTrue(reader.BeginObject());
+            Assert::IsFalse(reader.NextMember(name));
+            Assert::IsTrue(reader.Finish());
+        }
+
+        TEST_METHOD (MalformedDocuments)
+        {
+            const char* documents[] = {
+                "",
+                "{",
+                "{\"a\":1,}",
+                "{,\"a\":1}",
+                "{\"a\" 1}",
+                "[1,]",
+                "[1 2]",
+                "[01]",
+                "[1.]",
+                "[-]",
+                "[\"abc",
+                "[\"\\x\"]",
+                "tru",
+                "[1] 2",
+            };
+
+            for (const char* document : documents)
+            {
+                JsonStreamReader reader{ document };
+                reader.SkipValue();
+                Assert::IsFalse(reader.Finish());
+            }
+        }
+
+        TEST_METHOD (MaxDepth)
+        {
+            const std::string tooDeep = std::string(JsonStreamReader::MaxDepth + 1, '[') + std::string(JsonStreamReader::MaxDepth + 1, ']');
+            JsonStreamReader tooDeepReader{ tooDeep };
+            tooDeepReader.SkipValue();
+            Assert::IsFalse(tooDeepReader.Finish());
+
+            const std::string deep = std::string(JsonStreamReader::MaxDepth, '[') + std::string(JsonStreamReader::MaxDepth, ']');
+            JsonStreamReader deepReader{ deep };
+            deepReader.SkipValue();
+            Assert::IsTrue(deepReader.Finish());
+        }
+
+        TEST_METHOD (FailedReaderStopsReading)
+        {
+            JsonStreamReader reader{ "[1, x]" };
+            double value = 0;
+            Assert::IsTrue(reader.BeginArray());
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsTrue(reader.ReadNumber(value));
+            Assert::IsTrue(reader.NextElement());
+            Assert::IsFalse(reader.ReadNumber(value));
+            Assert::IsTrue(reader.Failed());
+            Assert::IsFalse(reader.NextElement());
+            Assert::IsFalse(reader.Finish());
+        }
+    };
+}
@@ -0,0 +1,97 @@
+#include "pch.h"
+#include "lib\MonitorTopology.h"
+
+#include "Util.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace FancyZonesUnitTests
+{
+    TEST_CLASS (MonitorTopologyUnitTests)
+    {
+        // Enumerated right to left, with a taskbar at the bottom of every monitor
+        MonitorTopology::Monitor m_right{ Mocks::Monitor(), RECT{ 1920, 0, 3840, 1080 }, RECT{ 1920, 0, 3840, 1040 }, RECT{ 1280, 0, 2560, 693 } };
+        MonitorTopology::Monitor m_middle{ Mocks::Monitor(), RECT{ 0, 0, 1920, 1080 }, RECT{ 0, 0, 1920, 1040 }, RECT{ 0, 0, 1280, 693 } };
+        MonitorTopology::Monitor m_left{ Mocks::Monitor(), RECT{ -1920, 100, 0, 1180 }, RECT{ -1920, 100, 0, 1140 }, RECT{ -1280, 67, 0, 760 } };
+
+        TEST_METHOD (Empty)
+        {
+            MonitorTopology topology;
+            Assert::IsTrue(topology.Monitors().empty());
+            Assert::IsTrue(topology.SortedMonitors().empty());
+            Assert::IsNull(topology.Find(m_left.monitor));
+            Assert::IsNull(topology.Neighbour(m_left.monitor, VK_RIGHT));
+        }
+
+        TEST_METHOD (KeepsEnumerationOrder)
+        {
+            MonitorTopology topology({ m_right, m_middle, m_left });
+
+            Assert::AreEqual(size_t{ 3 }, topology.Monitors().size());
+            Assert::IsTrue(m_right.monitor == topology.Monitors()[0].monitor);
+            Assert::IsTrue(m_left.monitor == topology.Monitors()[2].monitor);
+        }
+
+        TEST_METHOD (SortsMonitors)
+        {
+            MonitorTopology topology({ m_right, m_middle, m_left });
+
+            const std::vector<HMONITOR> expected{ m_left.monitor, m_middle.monitor, m_right.monitor };
+            Assert::IsTrue(expected == topology.SortedMonitors());
+        }
+
+        TEST_METHOD (CombinedWorkAreaRect)
+        {
+            MonitorTopology topology({ m_right, m_middle, m_left });
+
+            const RECT& actual = topology.CombinedWorkAreaRect();
+            Assert::AreEqual(-1920l, actual.left);
+            Assert::AreEqual(0l, actual.top);
+            Assert::AreEqual(3840l, actual.right);
+            Assert::AreEqual(1140l, actual.bottom);
+        }
+
+        TEST_METHOD (Find)
+        {
+            MonitorTopology topology({ m_right, m_middle, m_left });
+
+            const auto* actual = topology.Find(m_middle.monitor);
+            Assert::IsNotNull(actual);
+            Assert::AreEqual(693l, actual->dpiUnawareWorkAreaRect.bottom);
+            Assert::IsNull(topology.Find(Mocks::Monitor()));
+        }
+
+        TEST_METHOD (NeighboursFollowSortedOrder)
+        {
+            MonitorTopology topology({ m_right, m_middle, m_left });
+
+            Assert::IsTrue(m_middle.monitor == topology.Neighbour(m_left.monitor, VK_RIGHT));
+            Assert::IsTrue(m_right.monitor == topology.Neighbour(m_middle.monitor, VK_RIGHT));
+            Assert::IsTrue(m_left.monitor == topology.Neighbour(m_middle.monitor, VK_LEFT));
+        }
+
+        TEST_METHOD (NeighboursWrapAround)
+        {
+            MonitorTopology topology({ m_right, m_middle, m_left });
+
+            Assert::IsTrue(m_left.monitor == topology.Neighbour(m_right.monitor, VK_RIGHT));
+            Assert::IsTrue(m_right.monitor == topology.Neighbour(m_left.monitor, VK_LEFT));
+        }
+
+        TEST_METHOD (NeighbourOtherKeys)
+        {
+            MonitorTopology topology({ m_right, m_middle, m_left });
+
+            Assert::IsNull(topology.Neighbour(m_middle.monitor, VK_UP));
+            Assert::IsNull(topology.Neighbour(m_middle.monitor, VK_DOWN));
+        }
+
+        TEST_METHOD (SingleMonitorIsItsOwnNeighbour)
+        {
+            MonitorTopology topology({ m_middle });
+
+            Assert::IsTrue(m_middle.monitor == topology.Neighbour(m_middle.monitor, VK_RIGHT));
+            Assert::IsTrue(m_middle.monitor == topology.Neighbour(m_middle.monitor, VK_LEFT));
+        }
+    };
+}
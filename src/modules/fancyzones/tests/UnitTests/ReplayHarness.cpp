@@ -0,0 +1,311 @@
+#include "pch.h"
+#include "ReplayHarness.h"
+
+#include "lib/FancyZones.h"
+#include "lib/FancyZonesData.h"
+#include "lib/FancyZonesDataTypes.h"
+#include "lib/ZoneSet.h"
+#include "lib/ZoneWindow.h"
+
+#include "Util.h"
+
+#include <common/dpi_aware.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    const std::wstring ReplayDeviceId = L"\\\\?\\DISPLAY#DELA026#5&10a58c63&0&UID16777488#{e6f07b5f-ee97-4a90-b076-33f57bf4eaa7}";
+
+    struct ReplayZoneWindowHost : public winrt::implements<ReplayZoneWindowHost, IZoneWindowHost>
+    {
+        IFACEMETHODIMP_(void)
+        MoveWindowsOnActiveZoneSetChange() noexcept {}
+        IFACEMETHODIMP_(COLORREF)
+        GetZoneColor() noexcept
+        {
+            return RGB(0xFF, 0xFF, 0xFF);
+        }
+        IFACEMETHODIMP_(COLORREF)
+        GetZoneBorderColor() noexcept
+        {
+            return RGB(0xFF, 0xFF, 0xFF);
+        }
+        IFACEMETHODIMP_(COLORREF)
+        GetZoneHighlightColor() noexcept
+        {
+            return RGB(0xFF, 0xFF, 0xFF);
+        }
+        IFACEMETHODIMP_(int)
+        GetZoneHighlightOpacity() noexcept
+        {
+            return 100;
+        }
+        IFACEMETHODIMP_(bool)
+        isMakeDraggedWindowTransparentActive() noexcept
+        {
+            return false;
+        }
+        IFACEMETHODIMP_(bool)
+        InMoveSize() noexcept
+        {
+            return true;
+        }
+    };
+
+    // Same DPI as ZoneSet scales canvas zones with
+    UINT GetMonitorDpi(HMONITOR monitor) noexcept
+    {
+        UINT dpiX, dpiY;
+        if (GetDpiForMonitor(monitor, MDT_EFFECTIVE_DPI, &dpiX, &dpiY) == S_OK)
+        {
+            return dpiX;
+        }
+
+        return DPIAware::DEFAULT_DPI;
+    }
+}
+
+namespace ReplayHarness
+{
+    // Feeds the events to zone windows like WindowMoveHandler does, one zone window per recorded work area.
+    // All zone windows are on the primary monitor. Recorded zones become custom canvas layouts, so cursor
+    // positions are moved into the zone window's work area and scaled by the monitor DPI like canvas zones are.
+    class Replayer
+    {
+    public:
+        Replayer() :
+            m_host(winrt::make_self<ReplayZoneWindowHost>()),
+            m_monitor(MonitorFromPoint(POINT{ 0, 0 }, MONITOR_DEFAULTTOPRIMARY)),
+            m_dpi(GetMonitorDpi(m_monitor))
+        {
+            MONITORINFO monitorInfo{};
+            monitorInfo.cbSize = sizeof(monitorInfo);
+            if (GetMonitorInfoW(m_monitor, &monitorInfo))
+            {
+                m_origin = POINT{ monitorInfo.rcWork.left, monitorInfo.rcWork.top };
+            }
+        }
+
+        ~Replayer()
+        {
+            Clear();
+        }
+
+        void Apply(const ReplayTrace::Layout& layout)
+        {
+            Clear();
+
+            auto& fancyZonesData = FancyZonesDataInstance();
+            for (const auto& workArea : layout.workAreas)
+            {
+                // Canvas zones are numbered in order, which matches the recorded ids as long as those are contiguous
+                auto zones = workArea.zones;
+                std::sort(zones.begin(), zones.end(), [](const ReplayTrace::Zone& lhs, const ReplayTrace::Zone& rhs) { return lhs.id < rhs.id; });
+
+                FancyZonesDataTypes::CanvasLayoutInfo info{ workArea.rect.right - workArea.rect.left, workArea.rect.bottom - workArea.rect.top };
+                for (const auto& zone : zones)
+                {
+                    info.zones.push_back({ zone.rect.left, zone.rect.top, zone.rect.right - zone.rect.left, zone.rect.bottom - zone.rect.top });
+                }
+
+                const std::wstring zoneSetId = Helpers::CreateGuidString();
+                const std::wstring uniqueId = ZoneWindowUtils::GenerateUniqueId(m_monitor, ReplayDeviceId, Helpers::CreateGuidString());
+                fancyZonesData.customZoneSetsMap[zoneSetId] = FancyZonesDataTypes::CustomZoneSetData{ L"Replay", FancyZonesDataTypes::CustomLayoutType::Canvas, std::move(info) };
+                fancyZonesData.SetDeviceInfo(uniqueId, FancyZonesDataTypes::DeviceInfoData{ FancyZonesDataTypes::ZoneSetData{ zoneSetId, FancyZonesDataTypes::ZoneSetLayoutType::Custom }, false, 0, static_cast<int>(zones.size()), workArea.sensitivityRadius });
+
+                m_workAreas.push_back({ workArea.rect, MakeZoneWindow(m_host.get(), GetModuleHandleW(nullptr), m_monitor, uniqueId, {}), zoneSetId, uniqueId });
+            }
+        }
+
+        // Returns false if the event refers to an unknown work area
+        bool Apply(const ReplayTrace::Event& event)
+        {
+            if (event.workArea != ReplayTrace::NoWorkArea && event.workArea >= m_workAreas.size())
+            {
+                return false;
+            }
+
+            const bool dragEnabled = (event.modifiers & ReplayTrace::DragEnabled) != 0;
+            switch (event.kind)
+            {
+            case ReplayTrace::EventKind::MoveSizeStart:
+                m_window = Mocks::Window();
+                m_current = nullptr;
+                if (dragEnabled)
+                {
+                    Enter(event.workArea);
+                }
+                break;
+            case ReplayTrace::EventKind::MoveSizeUpdate:
+                if (!dragEnabled)
+                {
+                    Leave();
+                }
+                else
+                {
+                    if (ZoneWindowAt(event.workArea) != m_current)
+                    {
+                        Leave();
+                        Enter(event.workArea);
+                    }
+
+                    if (m_current)
+                    {
+                        m_current->MoveSizeUpdate(ToScreen(event), true, (event.modifiers & ReplayTrace::SelectManyZones) != 0);
+                    }
+                }
+                break;
+            case ReplayTrace::EventKind::MoveSizeEnd:
+                m_droppedZones = {};
+                if (m_current)
+                {
+                    m_current->MoveSizeEnd(m_window, ToScreen(event));
+                    if (auto zoneSet = m_current->ActiveZoneSet())
+                    {
+                        m_droppedZones = zoneSet->GetZoneIndexSetFromWindow(m_window);
+                    }
+                    m_current = nullptr;
+                }
+                break;
+            case ReplayTrace::EventKind::SnapHotkey:
+                if (auto zoneWindow = ZoneWindowAt(event.workArea))
+                {
+                    zoneWindow->MoveWindowIntoZoneByDirectionAndIndex(Mocks::Window(), event.vkCode, true);
+                }
+                break;
+            }
+            return true;
+        }
+
+        inline const std::vector<size_t>& DroppedZones() const noexcept
+        {
+            return m_droppedZones;
+        }
+
+    private:
+        struct WorkArea
+        {
+            ReplayTrace::Rect rect;
+            winrt::com_ptr<IZoneWindow> zoneWindow;
+            std::wstring zoneSetId;
+            std::wstring uniqueId;
+        };
+
+        IZoneWindow* ZoneWindowAt(uint32_t workArea) const noexcept
+        {
+            return workArea != ReplayTrace::NoWorkArea ? m_workAreas[workArea].zoneWindow.get() : nullptr;
+        }
+
+        void Enter(uint32_t workArea) noexcept
+        {
+            m_current = ZoneWindowAt(workArea);
+            m_currentRect = m_current ? m_workAreas[workArea].rect : ReplayTrace::Rect{};
+            if (m_current)
+            {
+                m_current->MoveSizeEnter(m_window);
+            }
+        }
+
+        void Leave() noexcept
+        {
+            if (m_current)
+            {
+                m_current->ClearSelectedZones();
+                m_current->HideZoneWindow();
+                m_current = nullptr;
+            }
+        }
+
+        POINT ToScreen(const ReplayTrace::Event& event) const noexcept
+        {
+            const int scale = static_cast<int>(m_dpi);
+            const int defaultDpi = static_cast<int>(DPIAware::DEFAULT_DPI);
+            return POINT{ m_origin.x + (event.x - m_currentRect.left) * scale / defaultDpi, m_origin.y + (event.y - m_currentRect.top) * scale / defaultDpi };
+        }
+
+        void Clear()
+        {
+            Leave();
+
+            auto& fancyZonesData = FancyZonesDataInstance();
+            for (const auto& workArea : m_workAreas)
+            {
+                fancyZonesData.customZoneSetsMap.erase(workArea.zoneSetId);
+                fancyZonesData.deviceInfoMap.erase(workArea.uniqueId);
+            }
+            m_workAreas.clear();
+        }
+
+        winrt::com_ptr<ReplayZoneWindowHost> m_host;
+        HMONITOR m_monitor{};
+        UINT m_dpi{};
+        POINT m_origin{};
+        std::vector<WorkArea> m_workAreas;
+        IZoneWindow* m_current{};
+        ReplayTrace::Rect m_currentRect{};
+        HWND m_window{};
+        std::vector<size_t> m_droppedZones;
+    };
+
+    Result Replay(const std::vector<ReplayTrace::Record>& records)
+    {
+        Result result;
+        Replayer replayer;
+        std::map<ReplayTrace::EventKind, std::vector<double>> samples;
+
+        for (const auto& record : records)
+        {
+            if (const auto* layout = std::get_if<ReplayTrace::Layout>(&record))
+            {
+                replayer.Apply(*layout);
+                continue;
+            }
+
+            const auto& event = std::get<ReplayTrace::Event>(record);
+            const auto start = std::chrono::high_resolution_clock::now();
+            const bool applied = replayer.Apply(event);
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            if (applied)
+            {
+                samples[event.kind].push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            }
+            else
+            {
+                result.skippedEvents++;
+            }
+        }
+
+        for (auto& [kind, kindSamples] : samples)
+        {
+            result.latencies[kind] = Summarize(std::move(kindSamples));
+        }
+        result.droppedZones = replayer.DroppedZones();
+        return result;
+    }
+
+    LatencyStats Summarize(std::vector<double> samples)
+    {
+        LatencyStats stats;
+        if (samples.empty())
+        {
+            return stats;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        const auto percentile = [&samples](double p) {
+            const size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+            return samples[(std::max)(rank, size_t{ 1 }) - 1];
+        };
+
+        stats.count = samples.size();
+        stats.p50 = percentile(0.50);
+        stats.p90 = percentile(0.90);
+        stats.p99 = percentile(0.99);
+        stats.max = samples.back();
+        return stats;
+    }
+}
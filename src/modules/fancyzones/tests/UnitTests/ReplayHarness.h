@@ -0,0 +1,37 @@
+#pragma once
+
+#include "lib/ReplayTrace.h"
+
+#include <map>
+#include <vector>
+
+/**
+ * Replays recorded drag and snap hotkey sessions through zone windows showing the recorded layouts as custom
+ * canvas layouts. The zone windows are real, the dragged and snapped windows are mocked.
+ */
+namespace ReplayHarness
+{
+    // Latencies in microseconds
+    struct LatencyStats
+    {
+        size_t count = 0;
+        double p50 = 0;
+        double p90 = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    struct Result
+    {
+        std::map<ReplayTrace::EventKind, LatencyStats> latencies;
+        // Zones the window was dropped into at the end of the last drag
+        std::vector<size_t> droppedZones;
+        // Events referring to a work area which is not part of the preceding layout
+        size_t skippedEvents = 0;
+    };
+
+    Result Replay(const std::vector<ReplayTrace::Record>& records);
+
+    // Nearest-rank percentiles of the given samples
+    LatencyStats Summarize(std::vector<double> samples);
+}
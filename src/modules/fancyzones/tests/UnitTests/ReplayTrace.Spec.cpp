@@ -0,0 +1,228 @@
+#include "pch.h"
+#include "lib\ReplayTrace.h"
+
+#include "ReplayHarness.h"
+#include "Util.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace FancyZonesUnitTests
+{
+    namespace
+    {
+        // Two monitors side by side, the left one split into three columns
+        ReplayTrace::Layout TwoMonitorLayout()
+        {
+            ReplayTrace::WorkArea left{ { 0, 0, 1920, 1040 }, 20, { { 0, { 0, 0, 640, 1040 } }, { 1, { 640, 0, 1280, 1040 } }, { 2, { 1280, 0, 1920, 1040 } } } };
+            ReplayTrace::WorkArea right{ { 1920, 0, 3840, 1040 }, 20, { { 0, { 0, 0, 1920, 1040 } } } };
+            return ReplayTrace::Layout{ { left, right } };
+        }
+
+        ReplayTrace::Event Drag(ReplayTrace::EventKind kind, uint32_t workArea, int32_t x, uint32_t modifiers = ReplayTrace::DragEnabled)
+        {
+            return ReplayTrace::Event{ kind, workArea, 0, x, 500, modifiers, 0 };
+        }
+    }
+
+    TEST_CLASS (ReplayTraceUnitTests)
+    {
+        TEST_METHOD (RoundTrip)
+        {
+            ReplayTrace::Writer writer;
+            Assert::IsTrue(writer.Append(TwoMonitorLayout()));
+            Assert::IsTrue(writer.Append(ReplayTrace::Event{ ReplayTrace::EventKind::SnapHotkey, 1, 123456789, -20, 30, ReplayTrace::SelectManyZones, VK_RIGHT }));
+
+            std::vector<ReplayTrace::Record> records;
+            Assert::IsTrue(ReplayTrace::Read(writer.Data(), records));
+            Assert::AreEqual(size_t{ 2 }, records.size());
+
+            const auto& layout = std::get<ReplayTrace::Layout>(records[0]);
+            Assert::AreEqual(size_t{ 2 }, layout.workAreas.size());
+            Assert::AreEqual(20, layout.workAreas[0].sensitivityRadius);
+            Assert::AreEqual(size_t{ 3 }, layout.workAreas[0].zones.size());
+            Assert::AreEqual(2u, layout.workAreas[0].zones[2].id);
+            Assert::AreEqual(1280, layout.workAreas[0].zones[2].rect.left);
+            Assert::AreEqual(3840, layout.workAreas[1].rect.right);
+
+            const auto& event = std::get<ReplayTrace::Event>(records[1]);
+            Assert::IsTrue(ReplayTrace::EventKind::SnapHotkey == event.kind);
+            Assert::AreEqual(1u, event.workArea);
+            Assert::AreEqual(uint64_t{ 123456789 }, event.timestamp);
+            Assert::AreEqual(-20, event.x);
+            Assert::AreEqual(30, event.y);
+            Assert::AreEqual(static_cast<uint32_t>(ReplayTrace::SelectManyZones), event.modifiers);
+            Assert::AreEqual(static_cast<uint32_t>(VK_RIGHT), event.vkCode);
+        }
+
+        TEST_METHOD (TruncatedTrace)
+        {
+            ReplayTrace::Writer writer;
+            writer.Append(TwoMonitorLayout());
+            const std::string& data = writer.Data();
+
+            for (size_t size = sizeof(ReplayTrace::Header) + 1; size < data.size(); size++)
+            {
+                std::vector<ReplayTrace::Record> records;
+                Assert::IsFalse(ReplayTrace::Read(std::string_view(data).substr(0, size), records));
+                Assert::IsTrue(records.empty());
+            }
+        }
+
+        TEST_METHOD (ForeignData)
+        {
+            std::vector<ReplayTrace::Record> records;
+            Assert::IsFalse(ReplayTrace::Read("", records));
+            Assert::IsFalse(ReplayTrace::Read("{ \"devices\": [] }", records));
+            Assert::IsTrue(records.empty());
+        }
+
+        TEST_METHOD (SkipsUnknownRecords)
+        {
+            ReplayTrace::Writer writer;
+            std::string data = writer.Data();
+            const uint32_t unknownRecord[] = { 42, 3, 0 };
+            data.append(reinterpret_cast<const char*>(unknownRecord), sizeof(unknownRecord));
+
+            writer.Append(Drag(ReplayTrace::EventKind::MoveSizeStart, 0, 10));
+            data += writer.Data().substr(sizeof(ReplayTrace::Header));
+
+            std::vector<ReplayTrace::Record> records;
+            Assert::IsTrue(ReplayTrace::Read(data, records));
+            Assert::AreEqual(size_t{ 1 }, records.size());
+            Assert::IsTrue(std::holds_alternative<ReplayTrace::Event>(records[0]));
+        }
+
+        TEST_METHOD (CapacityLimit)
+        {
+            ReplayTrace::Writer writer(64);
+            const auto event = Drag(ReplayTrace::EventKind::MoveSizeUpdate, 0, 10);
+            Assert::IsTrue(writer.Append(event));
+            Assert::IsFalse(writer.Append(event));
+            Assert::IsTrue(writer.Full());
+            Assert::IsTrue(writer.Data().size() <= 64);
+
+            std::vector<ReplayTrace::Record> records;
+            Assert::IsTrue(ReplayTrace::Read(writer.Data(), records));
+            Assert::AreEqual(size_t{ 1 }, records.size());
+        }
+
+        TEST_METHOD (RecorderAppendsOnFlush)
+        {
+            const auto path = std::filesystem::temp_directory_path() / L"fancyzones-replay-trace-test.fzrt";
+            ReplayTrace::Recorder recorder;
+            Assert::IsTrue(recorder.Open(path));
+
+            recorder.RecordLayout(TwoMonitorLayout());
+            recorder.RecordEvent(ReplayTrace::EventKind::MoveSizeStart, 0, 10, 500, ReplayTrace::DragEnabled);
+            Assert::IsTrue(recorder.Flush());
+
+            recorder.RecordEvent(ReplayTrace::EventKind::MoveSizeEnd, 0, 20, 500, ReplayTrace::DragEnabled);
+            Assert::IsTrue(recorder.Flush());
+            Assert::IsTrue(recorder.Flush());
+
+            std::vector<ReplayTrace::Record> records;
+            Assert::IsTrue(ReplayTrace::ReadFile(path, records));
+            std::filesystem::remove(path);
+
+            Assert::AreEqual(size_t{ 3 }, records.size());
+            Assert::IsTrue(std::holds_alternative<ReplayTrace::Layout>(records[0]));
+            Assert::IsTrue(ReplayTrace::EventKind::MoveSizeEnd == std::get<ReplayTrace::Event>(records[2]).kind);
+        }
+    };
+
+    TEST_CLASS (ReplayHarnessUnitTests)
+    {
+        void LogLatencies(const ReplayHarness::Result& result)
+        {
+            for (const auto& [kind, stats] : result.latencies)
+            {
+                Logger::WriteMessage((L"event " + std::to_wstring(static_cast<uint32_t>(kind)) + L": " + std::to_wstring(stats.count) +
+                                      L" events, p50 " + std::to_wstring(stats.p50) + L" us, p90 " + std::to_wstring(stats.p90) +
+                                      L" us, p99 " + std::to_wstring(stats.p99) + L" us, max " + std::to_wstring(stats.max) + L" us\n")
+                                         .c_str());
+            }
+        }
+
+        TEST_METHOD (DragAcrossMonitors)
+        {
+            std::vector<ReplayTrace::Record> records{ TwoMonitorLayout(), Drag(ReplayTrace::EventKind::MoveSizeStart, 1, 2500, 0) };
+            for (int32_t x = 2500; x > 300; x -= 50)
+            {
+                records.push_back(Drag(ReplayTrace::EventKind::MoveSizeUpdate, x >= 1920 ? 1 : 0, x));
+            }
+            records.push_back(Drag(ReplayTrace::EventKind::MoveSizeEnd, 0, 300));
+
+            const auto result = ReplayHarness::Replay(records);
+            LogLatencies(result);
+
+            Assert::AreEqual(size_t{ 0 }, result.skippedEvents);
+            Assert::AreEqual(size_t{ 44 }, result.latencies.at(ReplayTrace::EventKind::MoveSizeUpdate).count);
+            Assert::AreEqual(size_t{ 1 }, result.droppedZones.size());
+            Assert::AreEqual(size_t{ 0 }, result.droppedZones[0]);
+        }
+
+        TEST_METHOD (DragSelectingManyZones)
+        {
+            const uint32_t selectMany = ReplayTrace::DragEnabled | ReplayTrace::SelectManyZones;
+            const std::vector<ReplayTrace::Record> records{
+                TwoMonitorLayout(),
+                Drag(ReplayTrace::EventKind::MoveSizeStart, 0, 100),
+                Drag(ReplayTrace::EventKind::MoveSizeUpdate, 0, 100, selectMany),
+                Drag(ReplayTrace::EventKind::MoveSizeUpdate, 0, 1000, selectMany),
+                Drag(ReplayTrace::EventKind::MoveSizeEnd, 0, 1000, selectMany),
+            };
+
+            const auto result = ReplayHarness::Replay(records);
+
+            Assert::AreEqual(size_t{ 2 }, result.droppedZones.size());
+            Assert::AreEqual(size_t{ 0 }, result.droppedZones[0]);
+            Assert::AreEqual(size_t{ 1 }, result.droppedZones[1]);
+        }
+
+        TEST_METHOD (DragWithoutZones)
+        {
+            const std::vector<ReplayTrace::Record> records{
+                TwoMonitorLayout(),
+                Drag(ReplayTrace::EventKind::MoveSizeStart, 0, 100, 0),
+                Drag(ReplayTrace::EventKind::MoveSizeUpdate, 0, 100, 0),
+                Drag(ReplayTrace::EventKind::MoveSizeEnd, 0, 100, 0),
+            };
+
+            const auto result = ReplayHarness::Replay(records);
+
+            Assert::IsTrue(result.droppedZones.empty());
+        }
+
+        TEST_METHOD (SkipsEventsOutsideLayout)
+        {
+            const std::vector<ReplayTrace::Record> records{
+                Drag(ReplayTrace::EventKind::MoveSizeStart, 0, 100),
+                TwoMonitorLayout(),
+                Drag(ReplayTrace::EventKind::MoveSizeUpdate, 5, 100),
+                ReplayTrace::Event{ ReplayTrace::EventKind::SnapHotkey, 1, 0, 0, 0, 0, VK_LEFT },
+            };
+
+            const auto result = ReplayHarness::Replay(records);
+
+            Assert::AreEqual(size_t{ 2 }, result.skippedEvents);
+            Assert::AreEqual(size_t{ 1 }, result.latencies.at(ReplayTrace::EventKind::SnapHotkey).count);
+        }
+
+        TEST_METHOD (Percentiles)
+        {
+            std::vector<double> samples;
+            for (int i = 100; i >= 1; i--)
+            {
+                samples.push_back(i);
+            }
+
+            const auto stats = ReplayHarness::Summarize(samples);
+
+            Assert::AreEqual(size_t{ 100 }, stats.count);
+            Assert::AreEqual(50.0, stats.p50);
+            Assert::AreEqual(90.0, stats.p90);
+            Assert::AreEqual(99.0, stats.p99);
+            Assert::AreEqual(100.0, stats.max);
+        }
+    };
+}
@@ -0,0 +1,196 @@
+#include "pch.h"
+#include "lib\ZoneIndexBitset.h"
+
+#include "Util.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace FancyZonesUnitTests
+{
+    TEST_CLASS (ZoneIndexBitsetUnitTests)
+    {
+        TEST_METHOD (Empty)
+        {
+            ZoneIndexBitset bitset;
+            Assert::IsTrue(bitset.None());
+            Assert::IsFalse(bitset.Any());
+            Assert::AreEqual(size_t{ 0 }, bitset.Count());
+            Assert::IsTrue(bitset.ToIndexSet().empty());
+        }
+
+        TEST_METHOD (SetAndTestAcrossWords)
+        {
+            ZoneIndexBitset bitset;
+            for (size_t index : { 0, 63, 64, 127, 128, 255 })
+            {
+                bitset.Set(index);
+            }
+
+            Assert::AreEqual(size_t{ 6 }, bitset.Count());
+            Assert::IsTrue(bitset.Test(63));
+            Assert::IsTrue(bitset.Test(64));
+            Assert::IsTrue(bitset.Test(255));
+            Assert::IsFalse(bitset.Test(1));
+            Assert::IsFalse(bitset.Test(65));
+        }
+
+        TEST_METHOD (SetBeyondInlineCapacity)
+        {
+            ZoneIndexBitset bitset;
+            bitset.Set(ZoneIndexBitset::InlineCapacity);
+            bitset.Set(1000);
+
+            Assert::IsTrue(bitset.Test(ZoneIndexBitset::InlineCapacity));
+            Assert::IsTrue(bitset.Test(1000));
+            Assert::IsFalse(bitset.Test(999));
+            Assert::AreEqual(size_t{ 2 }, bitset.Count());
+            std::vector<size_t> expected{ ZoneIndexBitset::InlineCapacity, 1000 };
+            Assert::IsTrue(expected == bitset.ToIndexSet());
+        }
+
+        TEST_METHOD (SetIgnoresIndicesBeyondMaxCapacity)
+        {
+            ZoneIndexBitset bitset;
+            bitset.Set(ZoneIndexBitset::MaxCapacity - 1);
+            bitset.Set(ZoneIndexBitset::MaxCapacity);
+            bitset.Set(size_t{ 1 } << 40);
+            bitset.SetWord(ZoneIndexBitset::MaxWordCount, 1);
+
+            Assert::AreEqual(size_t{ 1 }, bitset.Count());
+            Assert::IsTrue(bitset.Test(ZoneIndexBitset::MaxCapacity - 1));
+            Assert::AreEqual(ZoneIndexBitset::MaxWordCount, bitset.WordCount());
+        }
+
+        TEST_METHOD (ResetBeyondInlineCapacity)
+        {
+            ZoneIndexBitset bitset({ 1000 });
+            bitset.Reset(1000);
+            Assert::IsTrue(bitset.None());
+            Assert::IsTrue(ZoneIndexBitset() == bitset);
+        }
+
+        TEST_METHOD (Reset)
+        {
+            ZoneIndexBitset bitset({ 3, 100 });
+            bitset.Reset(100);
+            Assert::IsTrue(bitset.Test(3));
+            Assert::IsFalse(bitset.Test(100));
+            Assert::AreEqual(size_t{ 1 }, bitset.Count());
+        }
+
+        TEST_METHOD (ToIndexSetIsSorted)
+        {
+            ZoneIndexBitset bitset({ 200, 5, 70, 1 });
+            std::vector<size_t> expected{ 1, 5, 70, 200 };
+            Assert::IsTrue(expected == bitset.ToIndexSet());
+        }
+
+        TEST_METHOD (WordRoundTrip)
+        {
+            ZoneIndexBitset bitset({ 2, 66, 130, 250, 700 });
+            ZoneIndexBitset copy;
+            for (size_t i = 0; i < bitset.WordCount(); i++)
+            {
+                copy.SetWord(i, bitset.GetWord(i));
+            }
+
+            Assert::IsTrue(bitset == copy);
+        }
+
+        TEST_METHOD (UnionAndIntersection)
+        {
+            ZoneIndexBitset first({ 1, 64, 200 });
+            ZoneIndexBitset second({ 64, 150 });
+
+            Assert::IsTrue(ZoneIndexBitset({ 1, 64, 150, 200 }) == (first | second));
+            Assert::IsTrue(ZoneIndexBitset({ 64 }) == (first & second));
+
+            ZoneIndexBitset large({ 64, 300, 900 });
+            Assert::IsTrue(ZoneIndexBitset({ 1, 64, 200, 300, 900 }) == (first | large));
+            Assert::IsTrue(ZoneIndexBitset({ 64 }) == (first & large));
+            Assert::IsTrue(ZoneIndexBitset({ 300 }) == (large & ZoneIndexBitset({ 300 })));
+        }
+    };
+
+    TEST_CLASS (ZoneBoundsTableUnitTests)
+    {
+        // Zones of a size x size grid of 10x10 rectangles, indexed row by row
+        ZoneBoundsTable makeGrid(size_t size)
+        {
+            ZoneBoundsTable table;
+            for (size_t i = 0; i < size * size; i++)
+            {
+                long left = static_cast<long>(i % size) * 10;
+                long top = static_cast<long>(i / size) * 10;
+                table.Add(i, { left, top, left + 10, top + 10 });
+            }
+            return table;
+        }
+
+        TEST_METHOD (CombinedRangeEmpty)
+        {
+            ZoneBoundsTable table = makeGrid(4);
+            Assert::IsTrue(table.CombinedRange({}, {}).None());
+        }
+
+        TEST_METHOD (CombinedRangeSingleZone)
+        {
+            ZoneBoundsTable table = makeGrid(4);
+            Assert::IsTrue(ZoneIndexBitset({ 5 }) == table.CombinedRange(ZoneIndexBitset({ 5 }), ZoneIndexBitset({ 5 })));
+        }
+
+        TEST_METHOD (CombinedRangeRectangle)
+        {
+            ZoneBoundsTable table = makeGrid(4);
+            // From zone (1, 0) to zone (2, 2)
+            ZoneIndexBitset expected({ 1, 2, 5, 6, 9, 10 });
+            Assert::IsTrue(expected == table.CombinedRange(ZoneIndexBitset({ 1 }), ZoneIndexBitset({ 10 })));
+        }
+
+        TEST_METHOD (CombinedRangeBeyond64Zones)
+        {
+            ZoneBoundsTable table = makeGrid(16);
+            // From zone (15, 3) to zone (14, 15)
+            ZoneIndexBitset expected;
+            for (size_t row = 3; row < 16; row++)
+            {
+                expected.Set(row * 16 + 14);
+                expected.Set(row * 16 + 15);
+            }
+
+            auto actual = table.CombinedRange(ZoneIndexBitset({ 63 }), ZoneIndexBitset({ 254 }));
+            Assert::AreEqual(size_t{ 26 }, actual.Count());
+            Assert::IsTrue(expected == actual);
+        }
+
+        TEST_METHOD (CombinedRangeBeyondInlineCapacity)
+        {
+            ZoneBoundsTable table = makeGrid(20);
+            // From zone (0, 12) to zone (1, 19), zones 240 to 381
+            ZoneIndexBitset expected;
+            for (size_t row = 12; row < 20; row++)
+            {
+                expected.Set(row * 20);
+                expected.Set(row * 20 + 1);
+            }
+
+            auto actual = table.CombinedRange(ZoneIndexBitset({ 240 }), ZoneIndexBitset({ 381 }));
+            Assert::AreEqual(size_t{ 16 }, actual.Count());
+            Assert::IsTrue(expected == actual);
+        }
+
+        TEST_METHOD (CombinedRangeIgnoresUnknownZones)
+        {
+            ZoneBoundsTable table = makeGrid(2);
+            Assert::IsTrue(table.CombinedRange(ZoneIndexBitset({ 42 }), {}).None());
+        }
+
+        TEST_METHOD (Clear)
+        {
+            ZoneBoundsTable table = makeGrid(2);
+            table.Clear();
+            Assert::IsTrue(table.Ids().None());
+            Assert::IsTrue(table.CombinedRange(ZoneIndexBitset({ 0 }), ZoneIndexBitset({ 3 })).None());
+        }
+    };
+}
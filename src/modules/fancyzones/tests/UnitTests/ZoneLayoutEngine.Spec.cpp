@@ -0,0 +1,248 @@
+#include "pch.h"
+#include "lib\ZoneLayoutEngine.h"
+
+#include "Util.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace ZoneLayoutEngine;
+
+namespace FancyZonesUnitTests
+{
+    TEST_CLASS (ZoneLayoutEngineUnitTests)
+    {
+        static constexpr long m_width = 1920;
+        static constexpr long m_height = 1080;
+
+        void compareZone(const Zone& zone, size_t id, const ZoneRect& expected)
+        {
+            Assert::AreEqual(id, zone.id);
+            Assert::AreEqual(expected.left, zone.rect.left);
+            Assert::AreEqual(expected.top, zone.rect.top);
+            Assert::AreEqual(expected.right, zone.rect.right);
+            Assert::AreEqual(expected.bottom, zone.rect.bottom);
+        }
+
+        void checkZonesInsideWorkArea(const std::vector<Zone>& zones, int spacing)
+        {
+            for (const auto& zone : zones)
+            {
+                Assert::IsTrue(zone.rect.left >= spacing);
+                Assert::IsTrue(zone.rect.top >= spacing);
+                Assert::IsTrue(zone.rect.right <= m_width - spacing);
+                Assert::IsTrue(zone.rect.bottom <= m_height - spacing);
+                Assert::IsTrue(zone.rect.left <= zone.rect.right);
+                Assert::IsTrue(zone.rect.top <= zone.rect.bottom);
+            }
+        }
+
+        LayoutInput makeInput(LayoutKind kind, int zoneCount, int spacing)
+        {
+            LayoutInput input{};
+            input.workAreaWidth = m_width;
+            input.workAreaHeight = m_height;
+            input.layout.kind = kind;
+            input.layout.zoneCount = zoneCount;
+            input.spacing = spacing;
+            input.dpi = DEFAULT_DPI;
+            return input;
+        }
+
+    public:
+        TEST_METHOD (InvalidWorkArea)
+        {
+            std::vector<Zone> zones;
+            LayoutInput input = makeInput(LayoutKind::Columns, 3, 0);
+            input.workAreaWidth = 0;
+            Assert::IsFalse(CalculateLayout(input, zones));
+            Assert::IsTrue(zones.empty());
+        }
+
+        TEST_METHOD (InvalidZoneCount)
+        {
+            for (auto kind : { LayoutKind::Focus, LayoutKind::Columns, LayoutKind::Rows, LayoutKind::Grid, LayoutKind::PriorityGrid })
+            {
+                std::vector<Zone> zones;
+                Assert::IsFalse(CalculateLayout(makeInput(kind, 0, 0), zones));
+                Assert::IsFalse(CalculateLayout(makeInput(kind, -1, 0), zones));
+                Assert::IsTrue(zones.empty());
+            }
+        }
+
+        TEST_METHOD (FocusLayout)
+        {
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(makeInput(LayoutKind::Focus, 3, 16), zones));
+            Assert::AreEqual(size_t(3), zones.size());
+            compareZone(zones[0], 0, { 100, 100, 868, 532 });
+            compareZone(zones[1], 1, { 150, 150, 918, 582 });
+            compareZone(zones[2], 2, { 200, 200, 968, 632 });
+        }
+
+        TEST_METHOD (ColumnsLayout)
+        {
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(makeInput(LayoutKind::Columns, 3, 10), zones));
+            Assert::AreEqual(size_t(3), zones.size());
+            compareZone(zones[0], 0, { 10, 10, 636, 1070 });
+            compareZone(zones[1], 1, { 646, 10, 1273, 1070 });
+            compareZone(zones[2], 2, { 1283, 10, 1910, 1070 });
+        }
+
+        TEST_METHOD (RowsLayout)
+        {
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(makeInput(LayoutKind::Rows, 2, 0), zones));
+            Assert::AreEqual(size_t(2), zones.size());
+            compareZone(zones[0], 0, { 0, 0, 1920, 540 });
+            compareZone(zones[1], 1, { 0, 540, 1920, 1080 });
+        }
+
+        TEST_METHOD (GridLayout)
+        {
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(makeInput(LayoutKind::Grid, 4, 0), zones));
+            Assert::AreEqual(size_t(4), zones.size());
+            compareZone(zones[0], 0, { 0, 0, 960, 540 });
+            compareZone(zones[1], 1, { 960, 0, 1920, 540 });
+            compareZone(zones[2], 2, { 0, 540, 960, 1080 });
+            compareZone(zones[3], 3, { 960, 540, 1920, 1080 });
+        }
+
+        TEST_METHOD (GridLayoutLastZoneSpansRemainingCells)
+        {
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(makeInput(LayoutKind::Grid, 5, 0), zones));
+            Assert::AreEqual(size_t(5), zones.size());
+            compareZone(zones[0], 0, { 0, 0, 639, 540 });
+            compareZone(zones[1], 1, { 639, 0, 1279, 540 });
+            compareZone(zones[2], 2, { 1279, 0, 1920, 540 });
+            compareZone(zones[3], 3, { 0, 540, 639, 1080 });
+            compareZone(zones[4], 4, { 639, 540, 1920, 1080 });
+        }
+
+        TEST_METHOD (PriorityGridLayout)
+        {
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(makeInput(LayoutKind::PriorityGrid, 3, 0), zones));
+            Assert::AreEqual(size_t(3), zones.size());
+            compareZone(zones[0], 0, { 0, 0, 480, 1080 });
+            compareZone(zones[1], 1, { 480, 0, 1440, 1080 });
+            compareZone(zones[2], 2, { 1440, 0, 1920, 1080 });
+        }
+
+        TEST_METHOD (PriorityGridLayoutsAreValid)
+        {
+            Assert::IsNull(PriorityGridLayout(0));
+            Assert::IsNull(PriorityGridLayout(PRIORITY_GRID_LAYOUTS_COUNT + 1));
+
+            for (int zoneCount = 1; zoneCount <= PRIORITY_GRID_LAYOUTS_COUNT; zoneCount++)
+            {
+                const GridDescriptor* grid = PriorityGridLayout(zoneCount);
+                Assert::IsNotNull(grid);
+
+                int rowsTotal = 0;
+                for (int row = 0; row < grid->rows; row++)
+                {
+                    rowsTotal += grid->rowsPercents[row];
+                }
+                int columnsTotal = 0;
+                for (int col = 0; col < grid->columns; col++)
+                {
+                    columnsTotal += grid->columnsPercents[col];
+                }
+                Assert::AreEqual(C_MULTIPLIER, rowsTotal);
+                Assert::AreEqual(C_MULTIPLIER, columnsTotal);
+
+                std::vector<Zone> zones;
+                Assert::IsTrue(CalculateGridZones(m_width, m_height, *grid, 0, zones));
+                Assert::AreEqual(static_cast<size_t>(zoneCount), zones.size());
+            }
+        }
+
+        TEST_METHOD (PredefinedLayoutsStayInsideWorkArea)
+        {
+            for (auto kind : { LayoutKind::Columns, LayoutKind::Rows, LayoutKind::Grid, LayoutKind::PriorityGrid })
+            {
+                for (int zoneCount = 1; zoneCount <= 40; zoneCount++)
+                {
+                    for (int spacing : { 0, 16 })
+                    {
+                        std::vector<Zone> zones;
+                        Assert::IsTrue(CalculateLayout(makeInput(kind, zoneCount, spacing), zones));
+                        Assert::AreEqual(static_cast<size_t>(zoneCount), zones.size());
+                        checkZonesInsideWorkArea(zones, spacing);
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD (CustomGridLayout)
+        {
+            const int rowsPercents[] = { 5000, 5000 };
+            const int columnsPercents[] = { 3333, 6667 };
+            const int cellChildMap[] = { 0, 1,
+                                         0, 2 };
+
+            LayoutInput input = makeInput(LayoutKind::CustomGrid, 0, 0);
+            input.layout.grid = { 2, 2, rowsPercents, columnsPercents, cellChildMap };
+
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(input, zones));
+            Assert::AreEqual(size_t(3), zones.size());
+            compareZone(zones[0], 0, { 0, 0, 639, 1080 });
+            compareZone(zones[1], 1, { 639, 0, 1920, 540 });
+            compareZone(zones[2], 2, { 639, 540, 1920, 1080 });
+        }
+
+        TEST_METHOD (CustomGridLayoutMissingData)
+        {
+            LayoutInput input = makeInput(LayoutKind::CustomGrid, 0, 0);
+            input.layout.grid = { 2, 2, nullptr, nullptr, nullptr };
+
+            std::vector<Zone> zones;
+            Assert::IsFalse(CalculateLayout(input, zones));
+            Assert::IsTrue(zones.empty());
+        }
+
+        TEST_METHOD (CanvasLayout)
+        {
+            const CanvasZone canvasZones[] = { { 0, 0, 100, 200 }, { 100, 50, 300, 150 } };
+
+            LayoutInput input = makeInput(LayoutKind::CustomCanvas, 0, 0);
+            input.layout.canvas = { canvasZones, 2 };
+
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(input, zones));
+            Assert::AreEqual(size_t(2), zones.size());
+            compareZone(zones[0], 0, { 0, 0, 100, 200 });
+            compareZone(zones[1], 1, { 100, 50, 400, 200 });
+        }
+
+        TEST_METHOD (CanvasLayoutScaledByDpi)
+        {
+            const CanvasZone canvasZones[] = { { 10, 20, 100, 200 } };
+
+            LayoutInput input = makeInput(LayoutKind::CustomCanvas, 0, 0);
+            input.layout.canvas = { canvasZones, 1 };
+            input.dpi = DEFAULT_DPI * 2;
+
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(input, zones));
+            Assert::AreEqual(size_t(1), zones.size());
+            compareZone(zones[0], 0, { 20, 40, 220, 440 });
+        }
+
+        TEST_METHOD (OutputIsReused)
+        {
+            std::vector<Zone> zones;
+            Assert::IsTrue(CalculateLayout(makeInput(LayoutKind::Grid, 30, 0), zones));
+            const auto capacity = zones.capacity();
+            const auto data = zones.data();
+
+            Assert::IsTrue(CalculateLayout(makeInput(LayoutKind::Columns, 5, 0), zones));
+            Assert::AreEqual(size_t(5), zones.size());
+            Assert::AreEqual(capacity, zones.capacity());
+            Assert::IsTrue(data == zones.data());
+        }
+    };
+}
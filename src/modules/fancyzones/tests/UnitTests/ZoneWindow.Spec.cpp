@@ -185,6 +185,25 @@ namespace FancyZonesUnitTests
             Assert::AreEqual(activeZoneSet->GetZones().size(), static_cast<size_t>(3));
         }
 
+        TEST_METHOD(CreateZoneWindowVirtualDesktopId)
+        {
+            auto zoneWindow = MakeZoneWindow(winrt::make_self<MockZoneWindowHost>().get(), m_hInst, m_monitor, m_uniqueId.str(), {});
+
+            GUID expected;
+            Assert::AreEqual(S_OK, CLSIDFromString(L"{39B25DD2-130D-4B5D-8851-4791D66B1539}", &expected));
+            Assert::IsNotNull(zoneWindow.get());
+            Assert::IsTrue(expected == zoneWindow->VirtualDesktopId());
+        }
+
+        TEST_METHOD(CreateZoneWindowInvalidVirtualDesktopId)
+        {
+            std::wstring uniqueId = ZoneWindowUtils::GenerateUniqueId(m_monitor, m_deviceId, m_virtualDesktopId);
+            auto zoneWindow = MakeZoneWindow(winrt::make_self<MockZoneWindowHost>().get(), m_hInst, m_monitor, uniqueId, {});
+
+            Assert::IsNotNull(zoneWindow.get());
+            Assert::IsTrue(GUID_NULL == zoneWindow->VirtualDesktopId());
+        }
+
         TEST_METHOD(CreateZoneWindowWithActiveZoneTmpFile)
         {
             using namespace FancyZonesDataTypes;
@@ -3,6 +3,7 @@
 
 #include <common/json.h>
 #include <common/settings_helpers.h>
+#include <common/shell_extension_settings.h>
 #include <filesystem>
 #include <commctrl.h>
 #include <imageresizer\dll\ImageResizerConstants.h>
@@ -56,12 +57,27 @@ void CSettings::Save()
 
     jsonData.SetNamedValue(c_enabled, json::value(settings.enabled));
 
-    json::to_file(jsonFilePath, jsonData);
+    // Other processes are only told to reload the settings once they were saved
+    if (!json::to_file(jsonFilePath, jsonData))
+    {
+        return;
+    }
+
     GetSystemTimeAsFileTime(&lastLoadedTime);
+    if (const uint64_t generation = ShellExtensionSettings::publish(ShellExtensionSettings::Module::ImageResizer, GetSharedFlags()))
+    {
+        loadedGeneration = generation;
+    }
 }
 
 void CSettings::Load()
 {
+    // Read the generation before the file, so settings saved in the meantime are loaded again on the next check.
+    if (const auto sharedState = ShellExtensionSettings::read(ShellExtensionSettings::Module::ImageResizer))
+    {
+        loadedGeneration = sharedState->generation;
+    }
+
     if (!std::filesystem::exists(jsonFilePath))
     {
         MigrateFromRegistry();
@@ -76,6 +92,17 @@ void CSettings::Load()
 
 void CSettings::Reload()
 {
+    // Every save publishes a new generation, so the file only has to be parsed again when the generation changed.
+    if (const auto sharedState = ShellExtensionSettings::read(ShellExtensionSettings::Module::ImageResizer))
+    {
+        if (sharedState->generation != loadedGeneration)
+        {
+            Load();
+        }
+        settings.enabled = sharedState->flags & ShellExtensionSettings::Enabled;
+        return;
+    }
+
     // Load json settings from data file if it is modified in the meantime.
     FILETIME lastModifiedTime{};
     if (LastModifiedTime(jsonFilePath, &lastModifiedTime) &&
@@ -103,11 +130,20 @@ void CSettings::ParseJson()
                 settings.enabled = jsonSettings.GetNamedBoolean(c_enabled);
             }
         }
-        catch (const winrt::hresult_error&)
+        catch (const json::JsonError&)
         {
         }
     }
     GetSystemTimeAsFileTime(&lastLoadedTime);
+    if (const uint64_t generation = ShellExtensionSettings::publish_loaded(ShellExtensionSettings::Module::ImageResizer, GetSharedFlags()))
+    {
+        loadedGeneration = generation;
+    }
+}
+
+uint8_t CSettings::GetSharedFlags() const
+{
+    return static_cast<uint8_t>(settings.enabled ? ShellExtensionSettings::Enabled : 0);
 }
 
 CSettings& CSettingsInstance()
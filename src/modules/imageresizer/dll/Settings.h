@@ -30,9 +30,12 @@ private:
     void MigrateFromRegistry();
     void ParseJson();
 
+    uint8_t GetSharedFlags() const;
+
     Settings settings;
     std::wstring jsonFilePath;
     FILETIME lastLoadedTime;
+    uint64_t loadedGeneration{ 0 };
 };
 
 CSettings& CSettingsInstance();
\ No newline at end of file
@@ -22,6 +22,7 @@
     - disable()/enable()/is_enabled() to change or get the PowerToy's enabled state,
     - get_config() to get the available configuration settings,
     - set_config() to set various settings,
+    - set_config_changes() instead of set_config() when only some settings changed,
     - call_custom_action() when the user selects clicks a custom action in settings,
     - get_hotkeys() when the settings change, to make sure the hotkey(s) are up to date.
     - on_hotkey() when the corresponding hotkey is pressed.
@@ -48,6 +49,16 @@ public:
         std::strong_ordering operator<=>(const Hotkey&) const = default;
     };
 
+    /* Describes a setting which changed since the configuration previously sent to the PowerToy.
+     * 'path' is a JSON Pointer to the value in the configuration, e.g. "/properties/press_time/value",
+     * and 'value' is the new value serialized as JSON, or nullptr if the value was removed.
+     */
+    struct ConfigChange
+    {
+        const wchar_t* path = nullptr;
+        const wchar_t* value = nullptr;
+    };
+
     /* Returns the localized name of the PowerToy*/
     virtual const wchar_t* get_name() = 0;
     /* Returns non localized name of the PowerToy, this will be cached by the runner. */
@@ -82,6 +93,16 @@ public:
      * if the key press is to be swallowed.
      */
     virtual bool on_hotkey(size_t hotkeyId) { return false; }
+
+    /* Applies the settings which changed since the previous call to set_config() or set_config_changes(),
+     * so the PowerToy doesn't have to parse and apply the whole configuration again.
+     * Should return false without applying anything if the changes can't be applied on their own, in which
+     * case set_config() is called with the whole configuration. Modules do not need to override this method.
+     * The runner doesn't call either method if no setting changed.
+     * The runner calls this method on every module, so modules have to be built against the same version of this
+     * interface as the runner. PowerToys always ships the runner and the modules together.
+     */
+    virtual bool set_config_changes(const ConfigChange* changes, size_t count) { return false; }
 };
 
 /*
@@ -0,0 +1,87 @@
+#include "pch.h"
+#include "HookLatencyStats.h"
+#include <algorithm>
+
+namespace
+{
+    // Function to get the upper bound of a bucket in microseconds
+    double BucketUpperBound(int bucket, double ticksPerMicrosecond)
+    {
+        return static_cast<double>(uint64_t{ 1 } << bucket) / ticksPerMicrosecond;
+    }
+}
+
+// Function to get the current counters and the percentiles of each stage
+HookLatencyStats::Snapshot HookLatencyStats::GetSnapshot() const
+{
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    const double ticksPerMicrosecond = static_cast<double>(frequency.QuadPart) / 1000000.0;
+
+    Snapshot snapshot;
+    for (int stage = 0; stage < StageCount; stage++)
+    {
+        const auto& histogram = stages[stage];
+        std::array<uint64_t, BucketCount> buckets;
+        uint64_t count = 0;
+        for (int bucket = 0; bucket < BucketCount; bucket++)
+        {
+            buckets[bucket] = histogram.buckets[bucket].load(std::memory_order_relaxed);
+            count += buckets[bucket];
+        }
+
+        StageSnapshot& result = snapshot.stages[stage];
+        result.count = count;
+        result.max = static_cast<double>(histogram.max.load(std::memory_order_relaxed)) / ticksPerMicrosecond;
+        if (count == 0)
+        {
+            continue;
+        }
+
+        // Nearest-rank percentiles, i.e. the bucket which contains the ceil(p * count)-th sample
+        const uint64_t p50Rank = (count + 1) / 2;
+        const uint64_t p99Rank = (count * 99 + 99) / 100;
+        uint64_t seen = 0;
+        bool p50Found = false;
+        for (int bucket = 0; bucket < BucketCount; bucket++)
+        {
+            seen += buckets[bucket];
+            if (!p50Found && seen >= p50Rank)
+            {
+                result.p50 = BucketUpperBound(bucket, ticksPerMicrosecond);
+                p50Found = true;
+            }
+            if (seen >= p99Rank)
+            {
+                result.p99 = BucketUpperBound(bucket, ticksPerMicrosecond);
+                break;
+            }
+        }
+
+        // The percentiles can not be larger than the largest sample
+        result.p50 = (std::min)(result.p50, result.max);
+        result.p99 = (std::min)(result.p99, result.max);
+    }
+
+    snapshot.suppressedEvents = suppressedEvents.load(std::memory_order_relaxed);
+    snapshot.passedEvents = passedEvents.load(std::memory_order_relaxed);
+    snapshot.injectedEvents = injectedEvents.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+// Function to clear all histograms and counters. Must not be called while the hook is recording
+void HookLatencyStats::Reset()
+{
+    for (auto& histogram : stages)
+    {
+        for (auto& bucket : histogram.buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        histogram.max.store(0, std::memory_order_relaxed);
+    }
+
+    suppressedEvents.store(0, std::memory_order_relaxed);
+    passedEvents.store(0, std::memory_order_relaxed);
+    injectedEvents.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <intrin.h>
+
+// Stages of the keyboard hook which are timed
+enum class HookStage
+{
+    // Detect key and detect shortcut windows of the UI
+    UIDetection,
+    SingleKeyRemap,
+    AppSpecificShortcutRemap,
+    OSLevelShortcutRemap,
+    // SendInput calls made by the remaps. This time is also part of the stage which sent the input
+    SendInput,
+    Count
+};
+
+// Latency histograms and event counters for the keyboard hook. Each stage has a histogram with power of two buckets of QueryPerformanceCounter ticks.
+// Recording is lock-free and assumes a single writer (the hook thread), so that it only needs relaxed loads and stores. Snapshots can be taken from any thread
+class HookLatencyStats
+{
+public:
+    static const int StageCount = static_cast<int>(HookStage::Count);
+
+    // Bucket i counts the samples which took less than 2^i ticks and at least 2^(i-1) ticks
+    static const int BucketCount = 32;
+
+    // Latencies of a stage in microseconds. Percentiles are the upper bound of the bucket which contains them
+    struct StageSnapshot
+    {
+        uint64_t count = 0;
+        double p50 = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    struct Snapshot
+    {
+        std::array<StageSnapshot, StageCount> stages = {};
+
+        // Key events suppressed and passed on by the hook
+        uint64_t suppressedEvents = 0;
+        uint64_t passedEvents = 0;
+
+        // Key events sent by the remaps
+        uint64_t injectedEvents = 0;
+    };
+
+    // Class to time a stage from its construction to its destruction, excluding the time while it is paused. The stage is recorded once, on destruction
+    class StageTimer
+    {
+    private:
+        HookLatencyStats& stats;
+        HookStage stage;
+        int64_t start;
+        int64_t elapsed = 0;
+        bool running = true;
+
+    public:
+        StageTimer(HookLatencyStats& latencyStats, HookStage hookStage) :
+            stats(latencyStats), stage(hookStage), start(Now())
+        {
+        }
+
+        ~StageTimer()
+        {
+            Pause();
+            stats.RecordStage(stage, elapsed);
+        }
+
+        // Function to stop timing the stage while other stages run
+        void Pause()
+        {
+            if (running)
+            {
+                elapsed += Now() - start;
+                running = false;
+            }
+        }
+
+        // Function to continue timing the stage after it was paused
+        void Resume()
+        {
+            if (!running)
+            {
+                start = Now();
+                running = true;
+            }
+        }
+
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+    };
+
+    // Function to get the current time in QueryPerformanceCounter ticks
+    static inline int64_t Now()
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+    }
+
+    // Function to record the duration of a stage in ticks
+    inline void RecordStage(HookStage stage, int64_t ticks)
+    {
+        auto& histogram = stages[static_cast<int>(stage)];
+        const uint64_t value = ticks > 0 ? static_cast<uint64_t>(ticks) : 0;
+        Increment(histogram.buckets[BucketIndex(value)]);
+        if (value > histogram.max.load(std::memory_order_relaxed))
+        {
+            histogram.max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // Function to record the decision of the hook for a key event
+    inline void RecordHookDecision(bool suppressed)
+    {
+        Increment(suppressed ? suppressedEvents : passedEvents);
+    }
+
+    // Function to record a SendInput call which took the given number of ticks to send the given number of key events
+    inline void RecordSendInput(int64_t ticks, UINT keyEventCount)
+    {
+        RecordStage(HookStage::SendInput, ticks);
+        injectedEvents.store(injectedEvents.load(std::memory_order_relaxed) + keyEventCount, std::memory_order_relaxed);
+    }
+
+    // Function to get the current counters and the percentiles of each stage
+    Snapshot GetSnapshot() const;
+
+    // Function to clear all histograms and counters. Must not be called while the hook is recording
+    void Reset();
+
+private:
+    struct Histogram
+    {
+        std::array<std::atomic<uint64_t>, BucketCount> buckets = {};
+        std::atomic<uint64_t> max = 0;
+    };
+
+    std::array<Histogram, StageCount> stages;
+    std::atomic<uint64_t> suppressedEvents = 0;
+    std::atomic<uint64_t> passedEvents = 0;
+    std::atomic<uint64_t> injectedEvents = 0;
+
+    // Function to increment a counter which is only written by the hook thread
+    static inline void Increment(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Function to get the bucket of a number of ticks, i.e. its bit width clamped to the last bucket
+    static inline int BucketIndex(uint64_t ticks)
+    {
+        unsigned long highestBit;
+        if (!_BitScanReverse64(&highestBit, ticks))
+        {
+            return 0;
+        }
+
+        const int bitWidth = static_cast<int>(highestBit) + 1;
+        return bitWidth < BucketCount ? bitWidth : BucketCount - 1;
+    }
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <functional>
+#include "KeyboardStateBitmap.h"
 
 // Interface used to wrap keyboard input library methods
 class InputInterface
@@ -10,6 +12,12 @@ public:
     // Function to get the state of a particular key
     virtual bool GetVirtualKeyState(int key) = 0;
 
+    // Function to get the bitmap of the pressed keys, which is maintained from the key events seen by the hook instead of polling every key
+    virtual const KeyboardStateBitmap& GetKeyboardStateBitmap() = 0;
+
     // Function to get the foreground process name
     virtual void GetForegroundProcess(_Out_ std::wstring& foregroundProcess) = 0;
+
+    // Function to set the callback which receives the foreground process name whenever the foreground window changes. The callback is invoked once with the current foreground process when it is set, passing nullptr stops the notifications
+    virtual void SetForegroundProcessChangedCallback(std::function<void(const std::wstring&)> callback) = 0;
 };
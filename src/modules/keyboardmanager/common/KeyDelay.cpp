@@ -1,28 +1,20 @@
 #include "pch.h"
 #include "KeyDelay.h"
 
-// NOTE: The destructor should never be called on the DelayThread, i.e. from any of shortPress, longPress or longPressReleased, as it will re-enter the mutex. Even if the mutex is removed it will deadlock because of the join statement
-KeyDelay::~KeyDelay()
+void KeyDelay::KeyEvent(const KeyTimedEvent& ev)
 {
-    std::unique_lock<std::mutex> l(_queueMutex);
-    _quit = true;
-    _cv.notify_all();
-    l.unlock();
-    _delayThread.join();
-}
-
-void KeyDelay::KeyEvent(LowlevelKeyboardEvent* ev)
-{
-    std::lock_guard guard(_queueMutex);
-    _queue.push({ ev->lParam->time, ev->wParam });
-    _cv.notify_all();
-}
-
-KeyTimedEvent KeyDelay::NextEvent()
-{
-    auto ev = _queue.front();
-    _queue.pop();
-    return ev;
+    switch (_state)
+    {
+    case KeyDelayState::RELEASED:
+        HandleRelease(ev);
+        break;
+    case KeyDelayState::ON_HOLD:
+        HandleOnHold(ev);
+        break;
+    case KeyDelayState::ON_HOLD_TIMEOUT:
+        HandleOnHoldTimeout(ev);
+        break;
+    }
 }
 
 bool KeyDelay::CheckIfMillisHaveElapsed(DWORD64 first, DWORD64 last, DWORD64 duration)
@@ -39,68 +31,74 @@ bool KeyDelay::CheckIfMillisHaveElapsed(DWORD64 first, DWORD64 last, DWORD64 dur
     }
 }
 
-bool KeyDelay::HasNextEvent()
+void KeyDelay::HandleRelease(const KeyTimedEvent& ev)
 {
-    return !_queue.empty();
+    switch (ev.message)
+    {
+    case WM_KEYDOWN:
+    case WM_SYSKEYDOWN:
+        _state = KeyDelayState::ON_HOLD;
+        _initialHoldKeyDown = ev.time;
+        break;
+    case WM_KEYUP:
+    case WM_SYSKEYUP:
+        break;
+    }
 }
 
-bool KeyDelay::HandleRelease()
+void KeyDelay::HandleOnHold(const KeyTimedEvent& ev)
 {
-    while (HasNextEvent())
+    switch (ev.message)
     {
-        auto ev = NextEvent();
-        switch (ev.message)
+    case WM_KEYDOWN:
+    case WM_SYSKEYDOWN:
+        break;
+    case WM_KEYUP:
+    case WM_SYSKEYUP:
+        if (CheckIfMillisHaveElapsed(_initialHoldKeyDown, ev.time, LONG_PRESS_DELAY_MILLIS))
         {
-        case WM_KEYDOWN:
-        case WM_SYSKEYDOWN:
-            _state = KeyDelayState::ON_HOLD;
-            _initialHoldKeyDown = ev.time;
-            return false;
-        case WM_KEYUP:
-        case WM_SYSKEYUP:
-            break;
+            if (_onLongPressDetected != nullptr)
+            {
+                _onLongPressDetected(_key);
+            }
+            if (_onLongPressReleased != nullptr)
+            {
+                _onLongPressReleased(_key);
+            }
         }
+        else
+        {
+            if (_onShortPress != nullptr)
+            {
+                _onShortPress(_key);
+            }
+        }
+        _state = KeyDelayState::RELEASED;
+        break;
     }
-
-    return true;
 }
 
-bool KeyDelay::HandleOnHold(std::unique_lock<std::mutex>& cvLock)
+void KeyDelay::HandleOnHoldTimeout(const KeyTimedEvent& ev)
 {
-    while (HasNextEvent())
+    switch (ev.message)
     {
-        auto ev = NextEvent();
-        switch (ev.message)
+    case WM_KEYDOWN:
+    case WM_SYSKEYDOWN:
+        break;
+    case WM_KEYUP:
+    case WM_SYSKEYUP:
+        if (_onLongPressReleased != nullptr)
         {
-        case WM_KEYDOWN:
-        case WM_SYSKEYDOWN:
-            break;
-        case WM_KEYUP:
-        case WM_SYSKEYUP:
-            if (CheckIfMillisHaveElapsed(_initialHoldKeyDown, ev.time, LONG_PRESS_DELAY_MILLIS))
-            {
-                if (_onLongPressDetected != nullptr)
-                {
-                    _onLongPressDetected(_key);
-                }
-                if (_onLongPressReleased != nullptr)
-                {
-                    _onLongPressReleased(_key);
-                }
-            }
-            else
-            {
-                if (_onShortPress != nullptr)
-                {
-                    _onShortPress(_key);
-                }
-            }
-            _state = KeyDelayState::RELEASED;
-            return false;
+            _onLongPressReleased(_key);
         }
+        _state = KeyDelayState::RELEASED;
+        break;
     }
+}
 
-    if (CheckIfMillisHaveElapsed(_initialHoldKeyDown, GetTickCount64(), LONG_PRESS_DELAY_MILLIS))
+void KeyDelay::CheckHoldTimeout(DWORD64 now)
+{
+    if (_state == KeyDelayState::ON_HOLD && CheckIfMillisHaveElapsed(_initialHoldKeyDown, now, LONG_PRESS_DELAY_MILLIS))
     {
         if (_onLongPressDetected != nullptr)
         {
@@ -108,59 +106,159 @@ bool KeyDelay::HandleOnHold(std::unique_lock<std::mutex>& cvLock)
         }
         _state = KeyDelayState::ON_HOLD_TIMEOUT;
     }
-    else
+}
+
+DWORD KeyDelay::GetMillisUntilHoldTimeout(DWORD64 now) const
+{
+    if (_state != KeyDelayState::ON_HOLD)
     {
-        _cv.wait_for(cvLock, std::chrono::milliseconds(ON_HOLD_WAIT_TIMEOUT_MILLIS));
+        return INFINITE;
     }
-    return false;
+
+    // The timeout fires once more than LONG_PRESS_DELAY_MILLIS have elapsed. Fall back to polling if the event time is ahead of the clock or has wrapped around
+    const DWORD64 deadline = _initialHoldKeyDown + LONG_PRESS_DELAY_MILLIS + 1;
+    if (now < _initialHoldKeyDown || now >= deadline)
+    {
+        return static_cast<DWORD>(ON_HOLD_WAIT_TIMEOUT_MILLIS);
+    }
+
+    return static_cast<DWORD>(deadline - now);
 }
 
-bool KeyDelay::HandleOnHoldTimeout()
+KeyDelayTimer::KeyDelayTimer() :
+    _registeredKeys{}, _queue{}, _queueHead(0), _queueTail(0), _quit(false)
 {
-    while (HasNextEvent())
+    _wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+}
+
+// NOTE: The destructor should never be called on the timer thread, i.e. from any of the callbacks, as it will deadlock on the join statement
+KeyDelayTimer::~KeyDelayTimer()
+{
+    _quit = true;
+    if (_timerThread.joinable())
     {
-        auto ev = NextEvent();
-        switch (ev.message)
-        {
-        case WM_KEYDOWN:
-        case WM_SYSKEYDOWN:
-            break;
-        case WM_KEYUP:
-        case WM_SYSKEYUP:
-            if (_onLongPressReleased != nullptr)
-            {
-                _onLongPressReleased(_key);
-            }
-            _state = KeyDelayState::RELEASED;
-            return false;
-        }
+        SetEvent(_wakeEvent);
+        _timerThread.join();
     }
 
+    if (_wakeEvent)
+    {
+        CloseHandle(_wakeEvent);
+    }
+}
+
+bool KeyDelayTimer::Register(std::unique_ptr<KeyDelay> keyDelay, DWORD key)
+{
+    std::lock_guard l(_delaysMutex);
+
+    if (_delays.find(key) != _delays.end())
+    {
+        return false;
+    }
+
+    _delays[key] = std::move(keyDelay);
+    if (key < 256)
+    {
+        _registeredKeys[key >> 6].fetch_or(uint64_t{ 1 } << (key & 63));
+    }
+
+    if (!_timerThread.joinable())
+    {
+        _timerThread = std::thread(&KeyDelayTimer::TimerThread, this);
+    }
+
+    return true;
+}
+
+bool KeyDelayTimer::Unregister(DWORD key)
+{
+    std::lock_guard l(_delaysMutex);
+
+    if (key < 256)
+    {
+        _registeredKeys[key >> 6].fetch_and(~(uint64_t{ 1 } << (key & 63)));
+    }
+
+    return _delays.erase(key) != 0;
+}
+
+// Function to remove all the registered KeyDelay state machines
+void KeyDelayTimer::Clear()
+{
+    std::lock_guard l(_delaysMutex);
+
+    for (auto& keys : _registeredKeys)
+    {
+        keys = 0;
+    }
+
+    _delays.clear();
+}
+
+bool KeyDelayTimer::IsRegistered(DWORD key) const
+{
+    return key < 256 && (_registeredKeys[key >> 6].load(std::memory_order_acquire) >> (key & 63)) & 1;
+}
+
+bool KeyDelayTimer::KeyEvent(LowlevelKeyboardEvent* ev)
+{
+    if (!IsRegistered(ev->lParam->vkCode))
+    {
+        return false;
+    }
+
+    // If the timer thread has fallen behind by a full queue the event is dropped, it is still suppressed as the key is registered
+    const size_t tail = _queueTail.load(std::memory_order_relaxed);
+    if (tail - _queueHead.load(std::memory_order_acquire) < QueueCapacity)
+    {
+        _queue[tail % QueueCapacity] = { ev->lParam->vkCode, ev->lParam->time, ev->wParam };
+        _queueTail.store(tail + 1, std::memory_order_release);
+        SetEvent(_wakeEvent);
+    }
+
+    return true;
+}
+
+bool KeyDelayTimer::NextEvent(KeyTimedEvent& ev)
+{
+    const size_t head = _queueHead.load(std::memory_order_relaxed);
+    if (head == _queueTail.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    ev = _queue[head % QueueCapacity];
+    _queueHead.store(head + 1, std::memory_order_release);
     return true;
 }
 
-void KeyDelay::DelayThread()
+void KeyDelayTimer::TimerThread()
 {
-    std::unique_lock<std::mutex> qLock(_queueMutex);
-    bool shouldWait = true;
     while (!_quit)
     {
-        if (shouldWait)
+        DWORD timeout = INFINITE;
         {
-            _cv.wait(qLock);
-        }
+            std::lock_guard l(_delaysMutex);
 
-        switch (_state)
-        {
-        case KeyDelayState::RELEASED:
-            shouldWait = HandleRelease();
-            break;
-        case KeyDelayState::ON_HOLD:
-            shouldWait = HandleOnHold(qLock);
-            break;
-        case KeyDelayState::ON_HOLD_TIMEOUT:
-            shouldWait = HandleOnHoldTimeout();
-            break;
+            // Events for keys which were unregistered after being queued are dropped
+            KeyTimedEvent ev;
+            while (NextEvent(ev))
+            {
+                auto it = _delays.find(ev.key);
+                if (it != _delays.end())
+                {
+                    it->second->KeyEvent(ev);
+                }
+            }
+
+            const DWORD64 now = GetTickCount64();
+            for (auto& [key, keyDelay] : _delays)
+            {
+                keyDelay->CheckHoldTimeout(now);
+                timeout = (std::min)(timeout, keyDelay->GetMillisUntilHoldTimeout(now));
+            }
         }
+
+        WaitForSingleObject(_wakeEvent, timeout);
     }
-}
\ No newline at end of file
+}
@@ -1,8 +1,11 @@
 #pragma once
 #include <functional>
 #include <thread>
-#include <queue>
 #include <mutex>
+#include <map>
+#include <memory>
+#include <array>
+#include <atomic>
 
 #include <LowlevelKeyboardEvent.h>
 // Available states for the KeyDelay state machine.
@@ -16,13 +19,13 @@ enum class KeyDelayState
 // Virtual key + timestamp (in millis since Windows startup)
 struct KeyTimedEvent
 {
+    DWORD key;
     DWORD64 time;
     WPARAM message;
 };
 
 // Handles delayed key inputs.
-// Implemented as a state machine running on its own thread.
-// Thread stops on destruction.
+// Implemented as a state machine which is driven by the KeyDelayTimer thread.
 class KeyDelay
 {
 public:
@@ -31,39 +34,39 @@ public:
         std::function<void(DWORD)> onShortPress,
         std::function<void(DWORD)> onLongPressDetected,
         std::function<void(DWORD)> onLongPressReleased) :
-        _quit(false),
         _state(KeyDelayState::RELEASED),
         _initialHoldKeyDown(0),
         _key(key),
         _onShortPress(onShortPress),
         _onLongPressDetected(onLongPressDetected),
-        _onLongPressReleased(onLongPressReleased),
-        _delayThread(&KeyDelay::DelayThread, this){};
+        _onLongPressReleased(onLongPressReleased){};
 
-    // Enque new KeyTimedEvent and notify the condition variable.
-    void KeyEvent(LowlevelKeyboardEvent* ev);
-    ~KeyDelay();
+    // Manage state transitions and trigger callbacks on a key event.
+    void KeyEvent(const KeyTimedEvent& ev);
 
-private:
-    // Runs the state machine, waits if there is no events to process.
-    // Checks for _quit condition.
-    void DelayThread();
+    // Trigger the long press callback if the key has been held down for long enough at <now> milliseconds.
+    void CheckHoldTimeout(DWORD64 now);
 
-    // Manage state transitions and trigger callbacks on certain events.
-    // Returns whether or not the thread should wait on new events.
-    bool HandleRelease();
-    bool HandleOnHold(std::unique_lock<std::mutex>& cvLock);
-    bool HandleOnHoldTimeout();
+    // Returns the number of milliseconds after which CheckHoldTimeout should be called again, INFINITE if the key is not held down.
+    DWORD GetMillisUntilHoldTimeout(DWORD64 now) const;
 
-    // Get next key event in queue.
-    KeyTimedEvent NextEvent();
-    bool HasNextEvent();
+    KeyDelayState GetState() const
+    {
+        return _state;
+    }
+
+    static const DWORD64 LONG_PRESS_DELAY_MILLIS = 900;
+
+private:
+    // Manage state transitions and trigger callbacks on certain events.
+    void HandleRelease(const KeyTimedEvent& ev);
+    void HandleOnHold(const KeyTimedEvent& ev);
+    void HandleOnHoldTimeout(const KeyTimedEvent& ev);
 
     // Check if <duration> milliseconds passed since <first> millisecond.
     // Also checks for overflow conditions.
-    bool CheckIfMillisHaveElapsed(DWORD64 first, DWORD64 last, DWORD64 duration);
+    static bool CheckIfMillisHaveElapsed(DWORD64 first, DWORD64 last, DWORD64 duration);
 
-    bool _quit;
     KeyDelayState _state;
 
     // Callback functions, the key provided in the constructor is passed as an argument.
@@ -71,23 +74,66 @@ private:
     std::function<void(DWORD)> _onLongPressReleased;
     std::function<void(DWORD)> _onShortPress;
 
-    // Queue holding key events that are not processed yet. Should be kept synchronized
-    // using _queueMutex
-    std::queue<KeyTimedEvent> _queue;
-    std::mutex _queueMutex;
-
-    // DelayThread waits on this condition variable when there is no events to process.
-    std::condition_variable _cv;
-
     // Keeps track of the time at which the initial KEY_DOWN event happened.
     DWORD64 _initialHoldKeyDown;
 
     // Virtual Key provided in the constructor. Passed to callback functions.
     DWORD _key;
 
-    // Declare _delayThread after all other members so that it is the last to be initialized by the constructor
-    std::thread _delayThread;
-
-    static const DWORD64 LONG_PRESS_DELAY_MILLIS = 900;
+    // Interval at which the hold timeout is polled when the deadline cannot be computed from the event time.
     static const DWORD64 ON_HOLD_WAIT_TIMEOUT_MILLIS = 50;
 };
+
+// Runs all the registered KeyDelay state machines on a single thread.
+// Key events are passed from the hook through a lock-free single producer single consumer queue, so the hook never blocks on the timer thread.
+// Thread is started on the first registration and stops on destruction.
+class KeyDelayTimer
+{
+public:
+    KeyDelayTimer();
+    ~KeyDelayTimer();
+
+    // Add a KeyDelay state machine for the given virtual key. Returns false if the key is already registered.
+    bool Register(std::unique_ptr<KeyDelay> keyDelay, DWORD key);
+
+    // Remove the KeyDelay state machine for the given virtual key. Returns false if the key is not registered.
+    // Once this returns, no callbacks of the removed state machine are running or will run.
+    bool Unregister(DWORD key);
+
+    // Remove all the registered KeyDelay state machines
+    void Clear();
+
+    // Returns true if a KeyDelay is registered for the virtual key
+    bool IsRegistered(DWORD key) const;
+
+    // Enqueue a key event for the timer thread. Returns false if no KeyDelay is registered for the key.
+    // NOTE: must only be called from a single thread, i.e. the hook thread.
+    bool KeyEvent(LowlevelKeyboardEvent* ev);
+
+    static const size_t QueueCapacity = 256;
+
+private:
+    // Processes queued events and hold timeouts, waits until the next hold timeout or key event.
+    void TimerThread();
+
+    // Get next key event in queue.
+    bool NextEvent(KeyTimedEvent& ev);
+
+    // Registered state machines, the timer thread holds _delaysMutex while running them.
+    // NOTE: Register, Unregister and Clear should never be called from the callbacks, as it will re-enter the mutex.
+    std::map<DWORD, std::unique_ptr<KeyDelay>> _delays;
+    std::mutex _delaysMutex;
+
+    // Bitmap of the registered keys, read by the hook without taking _delaysMutex.
+    std::array<std::atomic<uint64_t>, 4> _registeredKeys;
+
+    // Ring buffer of key events which are not processed yet. _queueTail is only written by the hook and _queueHead by the timer thread.
+    std::array<KeyTimedEvent, QueueCapacity> _queue;
+    std::atomic<size_t> _queueHead;
+    std::atomic<size_t> _queueTail;
+
+    // Auto-reset event signalled on new key events and on quit.
+    HANDLE _wakeEvent;
+    std::atomic<bool> _quit;
+    std::thread _timerThread;
+};
@@ -0,0 +1,72 @@
+#include "pch.h"
+#include "KeyEventBatch.h"
+#include "Helpers.h"
+#include "InputInterface.h"
+#include "KeyboardManagerConstants.h"
+
+// Function to add a key event. Events beyond the capacity are dropped
+void KeyEventBatch::AddKeyEvent(WORD keyCode, DWORD flags, ULONG_PTR extraInfo)
+{
+    if (size < Capacity)
+    {
+        KeyboardManagerHelper::SetKeyEvent(inputs.data(), size, INPUT_KEYBOARD, keyCode, flags, extraInfo);
+        size++;
+    }
+}
+
+// Function to add a key down event
+void KeyEventBatch::PressKey(WORD keyCode, ULONG_PTR extraInfo)
+{
+    AddKeyEvent(keyCode, 0, extraInfo);
+}
+
+// Function to add a key up event
+void KeyEventBatch::ReleaseKey(WORD keyCode, ULONG_PTR extraInfo)
+{
+    AddKeyEvent(keyCode, KEYEVENTF_KEYUP, extraInfo);
+}
+
+// Function to add a key down and a key up event
+void KeyEventBatch::TapKey(WORD keyCode, ULONG_PTR extraInfo)
+{
+    PressKey(keyCode, extraInfo);
+    ReleaseKey(keyCode, extraInfo);
+}
+
+// Function to add the dummy key events used for remapping shortcuts, see KeyboardManagerHelper::SetDummyKeyEvent
+void KeyEventBatch::AddDummyKeyEvent(ULONG_PTR extraInfo)
+{
+    TapKey((WORD)KeyboardManagerConstants::DUMMY_KEY, extraInfo);
+}
+
+// Function to add key down events for the modifiers of a shortcut in the order Win, Ctrl, Alt, Shift
+void KeyEventBatch::PressModifiers(const Shortcut& shortcutToBeSent, const ModifierKey& winKeyInvoked, ULONG_PTR extraInfoFlag, const Shortcut& shortcutToCompare, const DWORD& keyToBeReleased)
+{
+    if (size + MaxModifierKeyEvents <= Capacity)
+    {
+        KeyboardManagerHelper::SetModifierKeyEvents(shortcutToBeSent, winKeyInvoked, inputs.data(), size, true, extraInfoFlag, shortcutToCompare, keyToBeReleased);
+    }
+}
+
+// Function to add key up events for the modifiers of a shortcut in the reverse order, i.e. Shift, Alt, Ctrl, Win
+void KeyEventBatch::ReleaseModifiers(const Shortcut& shortcutToBeSent, const ModifierKey& winKeyInvoked, ULONG_PTR extraInfoFlag, const Shortcut& shortcutToCompare, const DWORD& keyToBeReleased)
+{
+    if (size + MaxModifierKeyEvents <= Capacity)
+    {
+        KeyboardManagerHelper::SetModifierKeyEvents(shortcutToBeSent, winKeyInvoked, inputs.data(), size, false, extraInfoFlag, shortcutToCompare, keyToBeReleased);
+    }
+}
+
+// Function to send the key events and clear the batch. Returns the result of SendVirtualInput
+UINT KeyEventBatch::Send(InputInterface& ii)
+{
+    UINT result = 0;
+    if (size > 0)
+    {
+        result = ii.SendVirtualInput((UINT)size, inputs.data(), sizeof(INPUT));
+    }
+
+    inputs = {};
+    size = 0;
+    return result;
+}
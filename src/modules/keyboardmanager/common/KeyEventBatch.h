@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include "Shortcut.h"
+
+class InputInterface;
+
+// Fixed capacity list of key events which is built on the stack, so that the hook can send input without heap allocations
+class KeyEventBatch
+{
+public:
+    // Maximum number of key events in a batch. A remap sends at most a dummy key event, the modifiers of two shortcuts and two action key events
+    static const int Capacity = 16;
+
+    // Function to add a key event. Events beyond the capacity are dropped
+    void AddKeyEvent(WORD keyCode, DWORD flags, ULONG_PTR extraInfo);
+
+    // Function to add a key down event
+    void PressKey(WORD keyCode, ULONG_PTR extraInfo);
+
+    // Function to add a key up event
+    void ReleaseKey(WORD keyCode, ULONG_PTR extraInfo);
+
+    // Function to add a key down and a key up event
+    void TapKey(WORD keyCode, ULONG_PTR extraInfo);
+
+    // Function to add the dummy key events used for remapping shortcuts, see KeyboardManagerHelper::SetDummyKeyEvent
+    void AddDummyKeyEvent(ULONG_PTR extraInfo);
+
+    // Function to add key down events for the modifiers of a shortcut in the order Win, Ctrl, Alt, Shift. See KeyboardManagerHelper::SetModifierKeyEvents for shortcutToCompare and keyToBeReleased
+    void PressModifiers(const Shortcut& shortcutToBeSent, const ModifierKey& winKeyInvoked, ULONG_PTR extraInfoFlag, const Shortcut& shortcutToCompare = Shortcut(), const DWORD& keyToBeReleased = NULL);
+
+    // Function to add key up events for the modifiers of a shortcut in the reverse order, i.e. Shift, Alt, Ctrl, Win
+    void ReleaseModifiers(const Shortcut& shortcutToBeSent, const ModifierKey& winKeyInvoked, ULONG_PTR extraInfoFlag, const Shortcut& shortcutToCompare = Shortcut(), const DWORD& keyToBeReleased = NULL);
+
+    // Function to send the key events and clear the batch. Returns the result of SendVirtualInput
+    UINT Send(InputInterface& ii);
+
+    // Function to get the number of key events in the batch
+    inline int Size() const
+    {
+        return size;
+    }
+
+    // Function to get the key events in the batch
+    inline const INPUT* Data() const
+    {
+        return inputs.data();
+    }
+
+private:
+    std::array<INPUT, Capacity> inputs = {};
+    int size = 0;
+
+    // Number of key events added by SetModifierKeyEvents at most
+    static const int MaxModifierKeyEvents = 4;
+};
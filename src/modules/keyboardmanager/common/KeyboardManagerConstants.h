@@ -103,6 +103,9 @@ namespace KeyboardManagerConstants
     // Number of key messages required while sending a dummy key event
     inline const size_t DUMMY_KEY_EVENT_SIZE = 2;
 
+    // Interval in milliseconds after which the pressed keys tracked from the hook are reconciled with the OS key state, to recover from key events the hook did not see (for example on the secure desktop)
+    inline const ULONGLONG KeyboardStateSyncInterval = 1000;
+
     // String constant for the default app name in Remap shortcuts
     inline const std::wstring DefaultAppName = GET_RESOURCE_STRING(IDS_EDITSHORTCUTS_ALLAPPS);
 
@@ -5,10 +5,11 @@
 #include <../common/settings_helpers.h>
 #include "KeyDelay.h"
 #include "Helpers.h"
+#include <thread>
 
 // Constructor
 KeyboardManagerState::KeyboardManagerState() :
-    uiState(KeyboardManagerUIState::Deactivated), currentUIWindow(nullptr), currentShortcutUI1(nullptr), currentShortcutUI2(nullptr), currentSingleKeyUI(nullptr), detectedRemapKey(NULL), remappingsEnabled(true)
+    uiState(KeyboardManagerUIState::Deactivated), currentUIWindow(nullptr), currentShortcutUI1(nullptr), currentShortcutUI2(nullptr), currentSingleKeyUI(nullptr), detectedRemapKey(NULL), keyDelayTimer(std::make_unique<KeyDelayTimer>()), foregroundApp(nullptr), remapTables(new RemapTables()), remapTablesUpdateDepth(0), hookEventEpoch(0), hookRemapTables(nullptr), hookEventDepth(0)
 {
     configFile_mutex = CreateMutex(
         NULL, // default security descriptor
@@ -23,6 +24,8 @@ KeyboardManagerState::~KeyboardManagerState()
     {
         CloseHandle(configFile_mutex);
     }
+
+    delete remapTables.load();
 }
 
 // Function to check the if the UI state matches the argument state. For states with detect windows it also checks if the window is in focus.
@@ -106,12 +109,14 @@ void KeyboardManagerState::ClearOSLevelShortcuts()
 {
     osLevelShortcutReMap.clear();
     osLevelShortcutReMapSortedKeys.clear();
+    RemapsChanged();
 }
 
 // Function to clear the Keys remapping table.
 void KeyboardManagerState::ClearSingleKeyRemaps()
 {
     singleKeyReMap.clear();
+    RemapsChanged();
 }
 
 // Function to clear the App specific shortcut remapping table
@@ -119,6 +124,7 @@ void KeyboardManagerState::ClearAppSpecificShortcuts()
 {
     appSpecificShortcutReMap.clear();
     appSpecificShortcutReMapSortedKeys.clear();
+    RemapsChanged();
 }
 
 // Function to add a new OS level shortcut remapping
@@ -134,6 +140,7 @@ bool KeyboardManagerState::AddOSLevelShortcut(const Shortcut& originalSC, const
     osLevelShortcutReMap[originalSC] = RemapShortcut(newSC);
     osLevelShortcutReMapSortedKeys.push_back(originalSC);
     KeyboardManagerHelper::SortShortcutVectorBasedOnSize(osLevelShortcutReMapSortedKeys);
+    RemapsChanged();
 
     return true;
 }
@@ -149,6 +156,7 @@ bool KeyboardManagerState::AddSingleKeyRemap(const DWORD& originalKey, const Key
     }
 
     singleKeyReMap[originalKey] = newRemapKey;
+    RemapsChanged();
     return true;
 }
 
@@ -179,25 +187,20 @@ bool KeyboardManagerState::AddAppSpecificShortcut(const std::wstring& app, const
     appSpecificShortcutReMap[process_name][originalSC] = RemapShortcut(newSC);
     appSpecificShortcutReMapSortedKeys[process_name].push_back(originalSC);
     KeyboardManagerHelper::SortShortcutVectorBasedOnSize(appSpecificShortcutReMapSortedKeys[process_name]);
+    RemapsChanged();
     return true;
 }
 
-// Function to get the iterator of a single key remap given the source key. Returns nullopt if it isn't remapped
-std::optional<SingleKeyRemapTable::iterator> KeyboardManagerState::GetSingleKeyRemap(const DWORD& originalKey)
+// Function to get the single key remap table compiled for the hook
+const SingleKeyRemapLookup& KeyboardManagerState::GetSingleKeyRemapLookup()
 {
-    auto it = singleKeyReMap.find(originalKey);
-    if (it != singleKeyReMap.end())
-    {
-        return it;
-    }
-
-    return std::nullopt;
+    return GetRemapTables().singleKeyRemapLookup;
 }
 
 bool KeyboardManagerState::CheckShortcutRemapInvoked(const std::optional<std::wstring>& appName)
 {
     // Assumes appName exists in the app-specific remap table
-    ShortcutRemapTable& currentRemapTable = appName ? appSpecificShortcutReMap[*appName] : osLevelShortcutReMap;
+    ShortcutRemapTable& currentRemapTable = GetShortcutRemapTable(appName);
     for (auto& it : currentRemapTable)
     {
         if (it.second.isShortcutInvoked)
@@ -209,25 +212,49 @@ bool KeyboardManagerState::CheckShortcutRemapInvoked(const std::optional<std::ws
     return false;
 }
 
+// Function to check if the given app has app-specific shortcut remaps in the remap tables of the hook
+bool KeyboardManagerState::HasAppSpecificShortcutRemaps(const std::wstring& appName)
+{
+    auto& table = GetRemapTables().appSpecificShortcutReMap;
+    return table.find(appName) != table.end();
+}
+
 std::vector<Shortcut>& KeyboardManagerState::GetSortedShortcutRemapVector(const std::optional<std::wstring>& appName)
 {
     // Assumes appName exists in the app-specific remap table
     return appName ? appSpecificShortcutReMapSortedKeys[*appName] : osLevelShortcutReMapSortedKeys;
 }
 
-// Function to get the source and target of a shortcut remap given the source shortcut. Returns nullopt if it isn't remapped
+// Function to get the shortcut remap table of the hook for the OS level or the given app
 ShortcutRemapTable& KeyboardManagerState::GetShortcutRemapTable(const std::optional<std::wstring>& appName)
 {
+    RemapTables& tables = GetRemapTables();
     if (appName)
     {
-        auto itTable = appSpecificShortcutReMap.find(*appName);
-        if (itTable != appSpecificShortcutReMap.end())
+        auto itTable = tables.appSpecificShortcutReMap.find(*appName);
+        if (itTable != tables.appSpecificShortcutReMap.end())
         {
             return itTable->second;
         }
     }
 
-    return osLevelShortcutReMap;
+    return tables.osLevelShortcutReMap;
+}
+
+// Function to get the compiled shortcut remap table for the OS level or the given app
+const ShortcutMatcher& KeyboardManagerState::GetShortcutMatcher(const std::optional<std::wstring>& appName)
+{
+    RemapTables& tables = GetRemapTables();
+    if (appName)
+    {
+        auto itMatcher = tables.appSpecificShortcutMatchers.find(*appName);
+        if (itMatcher != tables.appSpecificShortcutMatchers.end())
+        {
+            return itMatcher->second;
+        }
+    }
+
+    return tables.osLevelShortcutMatcher;
 }
 
 // Function to set the textblock of the detect shortcut UI so that it can be accessed by the hook
@@ -451,22 +478,15 @@ void KeyboardManagerState::RegisterKeyDelay(
     std::function<void(DWORD)> onLongPressDetected,
     std::function<void(DWORD)> onLongPressReleased)
 {
-    std::lock_guard l(keyDelays_mutex);
-
-    if (keyDelays.find(key) != keyDelays.end())
+    if (!keyDelayTimer->Register(std::make_unique<KeyDelay>(key, onShortPress, onLongPressDetected, onLongPressReleased), key))
     {
         throw std::invalid_argument("This key was already registered.");
     }
-
-    keyDelays[key] = std::make_unique<KeyDelay>(key, onShortPress, onLongPressDetected, onLongPressReleased);
 }
 
 void KeyboardManagerState::UnregisterKeyDelay(DWORD key)
 {
-    std::lock_guard l(keyDelays_mutex);
-
-    auto deleted = keyDelays.erase(key);
-    if (deleted == 0)
+    if (!keyDelayTimer->Unregister(key))
     {
         throw std::invalid_argument("The key was not previously registered.");
     }
@@ -475,8 +495,7 @@ void KeyboardManagerState::UnregisterKeyDelay(DWORD key)
 // Function to clear all the registered key delays
 void KeyboardManagerState::ClearRegisteredKeyDelays()
 {
-    std::lock_guard l(keyDelays_mutex);
-    keyDelays.clear();
+    keyDelayTimer->Clear();
 }
 
 bool KeyboardManagerState::HandleKeyDelayEvent(LowlevelKeyboardEvent* ev)
@@ -486,15 +505,8 @@ bool KeyboardManagerState::HandleKeyDelayEvent(LowlevelKeyboardEvent* ev)
         return false;
     }
 
-    std::lock_guard l(keyDelays_mutex);
-
-    if (keyDelays.find(ev->lParam->vkCode) == keyDelays.end())
-    {
-        return false;
-    }
-
-    keyDelays[ev->lParam->vkCode]->KeyEvent(ev);
-    return true;
+    // The event is queued for the key delay timer thread, so the hook does not wait on the registered callbacks
+    return keyDelayTimer->KeyEvent(ev);
 }
 
 // Save the updated configuration.
@@ -588,7 +600,7 @@ bool KeyboardManagerState::SaveConfigToFile()
     {
         try
         {
-            json::to_file((PTSettingsHelper::get_module_save_folder_location(KeyboardManagerConstants::ModuleName) + L"\\" + GetCurrentConfigName() + L".json"), configJson);
+            result = json::to_file((PTSettingsHelper::get_module_save_folder_location(KeyboardManagerConstants::ModuleName) + L"\\" + GetCurrentConfigName() + L".json"), configJson);
         }
         catch (...)
         {
@@ -630,19 +642,169 @@ std::wstring KeyboardManagerState::GetActivatedApp()
     return activatedAppSpecificShortcutTarget;
 }
 
-bool KeyboardManagerState::AreRemappingsEnabled()
+// Sets the foreground process name. Called whenever the foreground window changes
+void KeyboardManagerState::SetForegroundProcess(const std::wstring& processName)
+{
+    std::lock_guard<std::mutex> lock(foregroundApps_mutex);
+
+    // Remove elements after null character and convert process name to lower case
+    foregroundProcess = processName.substr(0, processName.find(L'\0'));
+    std::transform(foregroundProcess.begin(), foregroundProcess.end(), foregroundProcess.begin(), towlower);
+    UpdateForegroundApp();
+}
+
+// Gets the application currently in the foreground, nullptr if there is none. Also nullptr if the remaps were published while the hook handles a key event, since the app was then resolved against other tables than the ones the hook uses
+const ForegroundApp* KeyboardManagerState::GetForegroundApp()
+{
+    const ForegroundApp* app = foregroundApp.load(std::memory_order_acquire);
+    if (app == nullptr || app->tables != &GetRemapTables())
+    {
+        return nullptr;
+    }
+
+    return app;
+}
+
+// Function to publish the interned entry of the current foreground process. foregroundApps_mutex has to be held
+void KeyboardManagerState::UpdateForegroundApp()
+{
+    if (foregroundProcess.empty())
+    {
+        foregroundApp.store(nullptr, std::memory_order_release);
+        return;
+    }
+
+    auto& entry = foregroundApps[foregroundProcess];
+    if (!entry)
+    {
+        RemapTables* tables = remapTables.load();
+        entry = std::make_unique<ForegroundApp>(ForegroundApp{ foregroundProcess, nullptr, tables });
+
+        // Search the published remaps for the process name, and then for the process name without it's file extension
+        auto& appSpecificRemaps = tables->appSpecificShortcutReMap;
+        auto it = appSpecificRemaps.find(foregroundProcess);
+        if (it == appSpecificRemaps.end())
+        {
+            it = appSpecificRemaps.find(foregroundProcess.substr(0, foregroundProcess.find_last_of(L".")));
+        }
+
+        if (it != appSpecificRemaps.end())
+        {
+            entry->name = it->first;
+            entry->remapTable = &it->second;
+        }
+    }
+
+    foregroundApp.store(entry.get(), std::memory_order_release);
+}
+
+// Function to build the remap tables from the edited remaps and publish them for the hook. Unless the remaps are being updated with UpdateRemapTables, this is done after every change
+void KeyboardManagerState::PublishRemapTables()
 {
-    return remappingsEnabled;
+    auto tables = std::make_unique<RemapTables>();
+    tables->singleKeyReMap = singleKeyReMap;
+    tables->singleKeyRemapLookup = SingleKeyRemapLookup(tables->singleKeyReMap);
+    tables->osLevelShortcutReMap = osLevelShortcutReMap;
+    tables->appSpecificShortcutReMap = appSpecificShortcutReMap;
+    tables->osLevelShortcutMatcher = ShortcutMatcher(tables->osLevelShortcutReMap, osLevelShortcutReMapSortedKeys);
+    for (auto& it : tables->appSpecificShortcutReMap)
+    {
+        tables->appSpecificShortcutMatchers[it.first] = ShortcutMatcher(it.second, appSpecificShortcutReMapSortedKeys[it.first]);
+    }
+
+    std::unique_ptr<RemapTables> previousTables;
+    std::map<std::wstring, std::unique_ptr<ForegroundApp>> previousForegroundApps;
+    {
+        std::lock_guard<std::mutex> lock(foregroundApps_mutex);
+        previousTables.reset(remapTables.exchange(tables.release()));
+
+        // The interned foreground apps point into the previous tables, so they are resolved again
+        previousForegroundApps = std::move(foregroundApps);
+        foregroundApps.clear();
+        UpdateForegroundApp();
+    }
+
+    // The previous tables and foreground apps are released once the hook can no longer be using them
+    WaitForHookEvent();
 }
 
-void KeyboardManagerState::RemappingsDisabledWrapper(std::function<void()> method)
+// Function to publish the remap tables after a change, unless the remaps are being updated with UpdateRemapTables
+void KeyboardManagerState::RemapsChanged()
 {
-    // Disable keyboard remappings
-    remappingsEnabled = false;
+    if (remapTablesUpdateDepth == 0)
+    {
+        PublishRemapTables();
+    }
+}
 
-    // Run the method which requires the remappings to be disabled
-    method();
+// Function to wait until the hook finished the key event which it is handling, if any. After that the hook no longer uses previously published remap tables and foreground apps
+void KeyboardManagerState::WaitForHookEvent()
+{
+    // Pairs with the fence in BeginHookEvent: either the hook started the key event after the tables were published and uses the new ones, or its epoch is seen here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t epoch = hookEventEpoch.load(std::memory_order_acquire);
+    if (epoch % 2 == 1)
+    {
+        while (hookEventEpoch.load(std::memory_order_acquire) == epoch)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
 
-    // Re-enable the keyboard remappings
-    remappingsEnabled = true;
+// Function to get the remap tables to be used by the hook
+RemapTables& KeyboardManagerState::GetRemapTables()
+{
+    return hookRemapTables != nullptr ? *hookRemapTables : *remapTables.load(std::memory_order_acquire);
+}
+
+// Function to run a method which changes the remaps. The changes are published to the hook as a whole after the method returns, until then the hook keeps using the previous remaps
+void KeyboardManagerState::UpdateRemapTables(std::function<void()> method)
+{
+    remapTablesUpdateDepth++;
+    std::exception_ptr exception;
+    try
+    {
+        method();
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    // Publish whatever was changed, so that the hook stays in sync with the edited remaps
+    remapTablesUpdateDepth--;
+    RemapsChanged();
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+// Function called by the hook when it starts handling a key event
+void KeyboardManagerState::BeginHookEvent()
+{
+    if (hookEventDepth++ == 0)
+    {
+        hookEventEpoch.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        hookRemapTables = remapTables.load(std::memory_order_acquire);
+    }
+}
+
+// Function called by the hook when it finishes handling a key event
+void KeyboardManagerState::EndHookEvent()
+{
+    if (--hookEventDepth == 0)
+    {
+        hookRemapTables = nullptr;
+        hookEventEpoch.fetch_add(1, std::memory_order_release);
+    }
+}
+
+// Function to get the latency histograms and event counters of the hook
+HookLatencyStats& KeyboardManagerState::GetHookLatencyStats()
+{
+    return hookLatencyStats;
 }
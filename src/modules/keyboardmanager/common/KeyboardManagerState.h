@@ -7,8 +7,11 @@
 #include <variant>
 #include "Shortcut.h"
 #include "RemapShortcut.h"
+#include "ShortcutMatcher.h"
+#include "SingleKeyRemapLookup.h"
+#include "HookLatencyStats.h"
 
-class KeyDelay;
+class KeyDelayTimer;
 
 namespace KeyboardManagerHelper
 {
@@ -20,8 +23,6 @@ namespace winrt::Windows::UI::Xaml::Controls
     struct StackPanel;
 }
 
-using SingleKeyRemapTable = std::unordered_map<DWORD, KeyShortcutUnion>;
-using ShortcutRemapTable = std::map<Shortcut, RemapShortcut>;
 using AppSpecificShortcutRemapTable = std::map<std::wstring, ShortcutRemapTable>;
 
 // Enum type to store different states of the UI
@@ -41,6 +42,34 @@ enum class KeyboardManagerUIState
     EditShortcutsWindowActivated
 };
 
+struct RemapTables;
+
+// Application in the foreground, resolved against the app-specific remap table when the foreground window changes
+struct ForegroundApp
+{
+    // Key of the app in the app-specific remap table, or the lower case process name if the app has no remaps
+    std::wstring name;
+
+    // App-specific remaps of the app, nullptr if it has none
+    ShortcutRemapTable* remapTable;
+
+    // Remap tables the app was resolved against. The hook ignores the app while it uses other tables
+    const RemapTables* tables;
+};
+
+// Remap tables read by the hook. They are built from the edited remaps and published as a whole, so the hook never sees a table which is being updated. Once published, only the invocation state of the shortcut remaps is modified, by the hook
+struct RemapTables
+{
+    SingleKeyRemapTable singleKeyReMap;
+    ShortcutRemapTable osLevelShortcutReMap;
+    AppSpecificShortcutRemapTable appSpecificShortcutReMap;
+
+    // Remap tables compiled for the hook
+    SingleKeyRemapLookup singleKeyRemapLookup;
+    ShortcutMatcher osLevelShortcutMatcher;
+    std::map<std::wstring, ShortcutMatcher> appSpecificShortcutMatchers;
+};
+
 // Class to store the shared state of the keyboard manager between the UI and the hook
 class KeyboardManagerState
 {
@@ -81,21 +110,56 @@ private:
     // Handle of named mutex used for configuration file.
     HANDLE configFile_mutex;
 
-    // Registered KeyDelay objects, used to notify delayed key events.
-    std::map<DWORD, std::unique_ptr<KeyDelay>> keyDelays;
-    std::mutex keyDelays_mutex;
+    // Runs the registered KeyDelay state machines, used to notify delayed key events.
+    std::unique_ptr<KeyDelayTimer> keyDelayTimer;
 
     // Stores the activated target application in app-specfic shortcut
     std::wstring activatedAppSpecificShortcutTarget;
 
-    // Thread safe boolean value to check if remappings are currently enabled. This is used to disable remappings while the remap tables are being updated by the UI thread
-    std::atomic_bool remappingsEnabled;
+    // Foreground applications interned by lower case process name. Entries are resolved once and dropped whenever the app-specific remaps change
+    std::map<std::wstring, std::unique_ptr<ForegroundApp>> foregroundApps;
+    std::wstring foregroundProcess;
+    std::mutex foregroundApps_mutex;
+
+    // Interned entry of the current foreground process, read by the hook. nullptr if there is no foreground process
+    std::atomic<const ForegroundApp*> foregroundApp;
+
+    // Function to publish the interned entry of the current foreground process. foregroundApps_mutex has to be held
+    void UpdateForegroundApp();
+
+    // Remap tables published for the hook
+    std::atomic<RemapTables*> remapTables;
+
+    // Nesting depth of UpdateRemapTables. Changes to the remaps are published when the outermost call returns. Atomic since the remaps can be edited from several UI threads
+    std::atomic<int> remapTablesUpdateDepth;
+
+    // Incremented when the hook starts and finishes handling a key event, so it is odd while the hook may read the remap tables and the foreground app
+    std::atomic<uint64_t> hookEventEpoch;
+
+    // Remap tables used for the key event which the hook is handling, and the nesting depth of key events sent from within the hook. Only accessed by the hook thread
+    RemapTables* hookRemapTables;
+    int hookEventDepth;
+
+    // Function to build the remap tables from the edited remaps and publish them for the hook. Unless the remaps are being updated with UpdateRemapTables, this is done after every change
+    void PublishRemapTables();
+
+    // Function to publish the remap tables after a change, unless the remaps are being updated with UpdateRemapTables
+    void RemapsChanged();
+
+    // Function to wait until the hook finished the key event which it is handling, if any. After that the hook no longer uses previously published remap tables and foreground apps
+    void WaitForHookEvent();
+
+    // Function to get the remap tables to be used by the hook
+    RemapTables& GetRemapTables();
+
+    // Latency histograms and event counters recorded by the hook
+    HookLatencyStats hookLatencyStats;
 
     // Display a key by appending a border Control as a child of the panel.
     void AddKeyToLayout(const winrt::Windows::UI::Xaml::Controls::StackPanel& panel, const winrt::hstring& key);
 
 public:
-    // The map members and their mutexes are left as public since the maps are used extensively in dllmain.cpp.
+    // The map members and their mutexes are left as public since the maps are used extensively in dllmain.cpp. They are the edited remaps, the hook reads the tables published by PublishRemapTables.
     // Maps which store the remappings for each of the features. The bool fields should be initialized to false. They are used to check the current state of the shortcut (i.e is that particular shortcut currently pressed down or not).
     // Stores single key remappings
     std::unordered_map<DWORD, KeyShortcutUnion> singleKeyReMap;
@@ -153,16 +217,22 @@ public:
     // Function to add a new App specific level shortcut remapping
     bool AddAppSpecificShortcut(const std::wstring& app, const Shortcut& originalSC, const KeyShortcutUnion& newSC);
 
-    // Function to get the iterator of a single key remap given the source key. Returns nullopt if it isn't remapped
-    std::optional<SingleKeyRemapTable::iterator> GetSingleKeyRemap(const DWORD& originalKey);
+    // Function to get the single key remap table compiled for the hook
+    const SingleKeyRemapLookup& GetSingleKeyRemapLookup();
 
     bool CheckShortcutRemapInvoked(const std::optional<std::wstring>& appName);
 
+    // Function to check if the given app has app-specific shortcut remaps in the remap tables of the hook
+    bool HasAppSpecificShortcutRemaps(const std::wstring& appName);
+
     std::vector<Shortcut>& GetSortedShortcutRemapVector(const std::optional<std::wstring>& appName);
 
-    // Function to get the source and target of a shortcut remap given the source shortcut. Returns nullopt if it isn't remapped
+    // Function to get the shortcut remap table of the hook for the OS level or the given app
     ShortcutRemapTable& GetShortcutRemapTable(const std::optional<std::wstring>& appName);
 
+    // Function to get the compiled shortcut remap table for the OS level or the given app
+    const ShortcutMatcher& GetShortcutMatcher(const std::optional<std::wstring>& appName);
+
     // Function to set the textblock of the detect shortcut UI so that it can be accessed by the hook
     void ConfigureDetectShortcutUI(const winrt::Windows::UI::Xaml::Controls::StackPanel& textBlock1, const winrt::Windows::UI::Xaml::Controls::StackPanel& textBlock2);
 
@@ -231,7 +301,41 @@ public:
     // Gets the activated target application in app-specfic shortcut
     std::wstring GetActivatedApp();
 
-    bool AreRemappingsEnabled();
+    // Sets the foreground process name. Called whenever the foreground window changes
+    void SetForegroundProcess(const std::wstring& processName);
+
+    // Gets the application currently in the foreground, nullptr if there is none or if it was resolved against other remap tables than the ones the hook uses
+    const ForegroundApp* GetForegroundApp();
+
+    // Function to run a method which changes the remaps. The changes are published to the hook as a whole after the method returns, until then the hook keeps using the previous remaps
+    void UpdateRemapTables(std::function<void()> method);
+
+    // Functions called by the hook when it starts and finishes handling a key event. Key events use the remap tables which were published when the hook started handling them
+    void BeginHookEvent();
+    void EndHookEvent();
+
+    // Class to mark the key event handled by the hook in the current scope
+    class HookEventScope
+    {
+    private:
+        KeyboardManagerState& state;
+
+    public:
+        HookEventScope(KeyboardManagerState& keyboardManagerState) :
+            state(keyboardManagerState)
+        {
+            state.BeginHookEvent();
+        }
+
+        ~HookEventScope()
+        {
+            state.EndHookEvent();
+        }
+
+        HookEventScope(const HookEventScope&) = delete;
+        HookEventScope& operator=(const HookEventScope&) = delete;
+    };
 
-    void RemappingsDisabledWrapper(std::function<void()> method);
+    // Function to get the latency histograms and event counters of the hook
+    HookLatencyStats& GetHookLatencyStats();
 };
@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Bitmap of the pressed virtual keys, one bit per key code
+class KeyboardStateBitmap
+{
+private:
+    std::array<uint64_t, 4> bits = {};
+
+public:
+    // Function to get the state of a particular key
+    inline bool GetKeyState(DWORD key) const
+    {
+        return key < 256 && (bits[key >> 6] >> (key & 63)) & 1;
+    }
+
+    // Function to set the state of a particular key
+    inline void SetKeyState(DWORD key, bool isDown)
+    {
+        if (key >= 256)
+        {
+            return;
+        }
+
+        const uint64_t bit = uint64_t{ 1 } << (key & 63);
+        if (isDown)
+        {
+            bits[key >> 6] |= bit;
+        }
+        else
+        {
+            bits[key >> 6] &= ~bit;
+        }
+    }
+
+    // Function to set all the keys to key up
+    inline void Clear()
+    {
+        bits.fill(0);
+    }
+
+    // Function to check if no keys are pressed apart from those set in the mask
+    inline bool IsClearExcept(const KeyboardStateBitmap& mask) const
+    {
+        return ((bits[0] & ~mask.bits[0]) | (bits[1] & ~mask.bits[1]) | (bits[2] & ~mask.bits[2]) | (bits[3] & ~mask.bits[3])) == 0;
+    }
+};
@@ -668,154 +668,47 @@ bool IgnoreKeyCode(DWORD key)
     }
 }
 
+// Function to get the keys which are ignored while checking the keyboard state
+const KeyboardStateBitmap& GetIgnoredKeys()
+{
+    static const KeyboardStateBitmap ignoredKeys = [] {
+        KeyboardStateBitmap keys;
+        for (DWORD keyVal = 1; keyVal < 0xFF; keyVal++)
+        {
+            keys.SetKeyState(keyVal, IgnoreKeyCode(keyVal));
+        }
+
+        // Key code 0 is not a key and 0xFF is set to key down because of the Num Lock
+        keys.SetKeyState(0, true);
+        keys.SetKeyState(0xFF, true);
+        return keys;
+    }();
+
+    return ignoredKeys;
+}
+
 // Function to check if any keys are pressed down except those in the shortcut
 bool Shortcut::IsKeyboardStateClearExceptShortcut(InputInterface& ii) const
 {
-    // Iterate through all the virtual key codes - 0xFF is set to key down because of the Num Lock
-    for (int keyVal = 1; keyVal < 0xFF; keyVal++)
+    // Mask out the ignored keys and the keys of the shortcut, any other pressed key means the keyboard state is not clear
+    KeyboardStateBitmap mask = GetIgnoredKeys();
+    mask.SetKeyState(VK_LWIN, winKey == ModifierKey::Left || winKey == ModifierKey::Both);
+    mask.SetKeyState(VK_RWIN, winKey == ModifierKey::Right || winKey == ModifierKey::Both);
+    mask.SetKeyState(VK_LCONTROL, ctrlKey == ModifierKey::Left || ctrlKey == ModifierKey::Both);
+    mask.SetKeyState(VK_RCONTROL, ctrlKey == ModifierKey::Right || ctrlKey == ModifierKey::Both);
+    mask.SetKeyState(VK_CONTROL, ctrlKey != ModifierKey::Disabled);
+    mask.SetKeyState(VK_LMENU, altKey == ModifierKey::Left || altKey == ModifierKey::Both);
+    mask.SetKeyState(VK_RMENU, altKey == ModifierKey::Right || altKey == ModifierKey::Both);
+    mask.SetKeyState(VK_MENU, altKey != ModifierKey::Disabled);
+    mask.SetKeyState(VK_LSHIFT, shiftKey == ModifierKey::Left || shiftKey == ModifierKey::Both);
+    mask.SetKeyState(VK_RSHIFT, shiftKey == ModifierKey::Right || shiftKey == ModifierKey::Both);
+    mask.SetKeyState(VK_SHIFT, shiftKey != ModifierKey::Disabled);
+    if (actionKey != NULL)
     {
-        // Ignore problematic key codes
-        if (IgnoreKeyCode(keyVal))
-        {
-            continue;
-        }
-        // Check state of the key. If the key is pressed down but it is not part of the shortcut then the keyboard state is not clear
-        if (ii.GetVirtualKeyState(keyVal))
-        {
-            // If one of the win keys is pressed check if it is part of the shortcut
-            if (keyVal == VK_LWIN)
-            {
-                if (winKey != ModifierKey::Left && winKey != ModifierKey::Both)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            else if (keyVal == VK_RWIN)
-            {
-                if (winKey != ModifierKey::Right && winKey != ModifierKey::Both)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            // If one of the ctrl keys is pressed check if it is part of the shortcut
-            else if (keyVal == VK_LCONTROL)
-            {
-                if (ctrlKey != ModifierKey::Left && ctrlKey != ModifierKey::Both)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            else if (keyVal == VK_RCONTROL)
-            {
-                if (ctrlKey != ModifierKey::Right && ctrlKey != ModifierKey::Both)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            else if (keyVal == VK_CONTROL)
-            {
-                if (ctrlKey == ModifierKey::Disabled)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            // If one of the alt keys is pressed check if it is part of the shortcut
-            else if (keyVal == VK_LMENU)
-            {
-                if (altKey != ModifierKey::Left && altKey != ModifierKey::Both)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            else if (keyVal == VK_RMENU)
-            {
-                if (altKey != ModifierKey::Right && altKey != ModifierKey::Both)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            else if (keyVal == VK_MENU)
-            {
-                if (altKey == ModifierKey::Disabled)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            // If one of the shift keys is pressed check if it is part of the shortcut
-            else if (keyVal == VK_LSHIFT)
-            {
-                if (shiftKey != ModifierKey::Left && shiftKey != ModifierKey::Both)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            else if (keyVal == VK_RSHIFT)
-            {
-                if (shiftKey != ModifierKey::Right && shiftKey != ModifierKey::Both)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            else if (keyVal == VK_SHIFT)
-            {
-                if (shiftKey == ModifierKey::Disabled)
-                {
-                    return false;
-                }
-                else
-                {
-                    continue;
-                }
-            }
-            // If any other key is pressed check if it is the action key
-            else if (keyVal != actionKey)
-            {
-                return false;
-            }
-        }
+        mask.SetKeyState(actionKey, true);
     }
 
-    return true;
+    return ii.GetKeyboardStateBitmap().IsClearExcept(mask);
 }
 
 // Function to get the number of modifiers that are common between the current shortcut and the shortcut in the argument
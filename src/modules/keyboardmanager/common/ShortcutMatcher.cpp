@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "ShortcutMatcher.h"
+#include "InputInterface.h"
+
+namespace
+{
+    // Modifier keys in the order of their ModifierBit
+    constexpr std::array<int, 11> modifierKeys = { VK_LWIN, VK_RWIN, VK_LCONTROL, VK_RCONTROL, VK_CONTROL, VK_LMENU, VK_RMENU, VK_MENU, VK_LSHIFT, VK_RSHIFT, VK_SHIFT };
+
+    // Function to return the ModifierBit of a modifier key code, 0 if it is not a modifier
+    ModifierState GetModifierBit(DWORD key)
+    {
+        for (size_t i = 0; i < modifierKeys.size(); i++)
+        {
+            if (modifierKeys[i] == (int)key)
+            {
+                return (ModifierState)(1 << i);
+            }
+        }
+
+        return 0;
+    }
+}
+
+ShortcutMatcher::ShortcutMatcher()
+{
+    actionKeyOffsets.fill(0);
+}
+
+// Compile the remaps of the table. The sorted keys define the priority of the remaps, see KeyboardManagerHelper::SortShortcutVectorBasedOnSize
+ShortcutMatcher::ShortcutMatcher(ShortcutRemapTable& table, const std::vector<Shortcut>& sortedKeys)
+{
+    entries.reserve(sortedKeys.size());
+    std::array<uint32_t, 256> counts = {};
+    for (const auto& shortcut : sortedKeys)
+    {
+        auto it = table.find(shortcut);
+        if (it == table.end())
+        {
+            continue;
+        }
+
+        entries.push_back(Compile(shortcut, it));
+        if (shortcut.GetActionKey() < counts.size())
+        {
+            counts[shortcut.GetActionKey()]++;
+        }
+    }
+
+    // Group the entries by action key with a counting sort, which keeps the priority order within each group
+    actionKeyOffsets[0] = 0;
+    for (size_t key = 0; key < counts.size(); key++)
+    {
+        actionKeyOffsets[key + 1] = actionKeyOffsets[key] + counts[key];
+    }
+
+    entriesByActionKey.resize(actionKeyOffsets[256]);
+    std::array<uint32_t, 256> next = {};
+    std::copy(actionKeyOffsets.begin(), actionKeyOffsets.end() - 1, next.begin());
+    for (const auto& entry : entries)
+    {
+        DWORD actionKey = entry.remap->first.GetActionKey();
+        if (actionKey < next.size())
+        {
+            entriesByActionKey[next[actionKey]++] = entry;
+        }
+    }
+}
+
+// Function to return all the remaps in priority order
+ShortcutMatcher::EntryRange ShortcutMatcher::GetEntries() const
+{
+    return { entries.data(), entries.data() + entries.size() };
+}
+
+// Function to return the remaps with the given action key in priority order
+ShortcutMatcher::EntryRange ShortcutMatcher::GetEntries(DWORD actionKey) const
+{
+    if (actionKey >= 256)
+    {
+        return { nullptr, nullptr };
+    }
+
+    const Entry* groups = entriesByActionKey.data();
+    return { groups + actionKeyOffsets[actionKey], groups + actionKeyOffsets[actionKey + 1] };
+}
+
+// Function to take a snapshot of the modifier keys state
+ModifierState ShortcutMatcher::GetModifierState(InputInterface& ii)
+{
+    ModifierState state = 0;
+    for (size_t i = 0; i < modifierKeys.size(); i++)
+    {
+        if (ii.GetVirtualKeyState(modifierKeys[i]))
+        {
+            state |= (ModifierState)(1 << i);
+        }
+    }
+
+    return state;
+}
+
+// Function to compile the modifiers of a shortcut into an entry
+ShortcutMatcher::Entry ShortcutMatcher::Compile(const Shortcut& shortcut, ShortcutRemapTable::iterator remap)
+{
+    Entry entry{ 0, 0, remap };
+
+    // Win key is set to both if it matches either side
+    if (shortcut.CheckWinKey(VK_LWIN) && shortcut.CheckWinKey(VK_RWIN))
+    {
+        entry.requiredAny = ModifierBit::LWin | ModifierBit::RWin;
+    }
+    else if (shortcut.CheckWinKey(VK_LWIN) || shortcut.CheckWinKey(VK_RWIN))
+    {
+        entry.required |= GetModifierBit(shortcut.GetWinKey(ModifierKey::Disabled));
+    }
+
+    // Ctrl, Alt and Shift set to both are checked with their generic key codes
+    entry.required |= GetModifierBit(shortcut.GetCtrlKey());
+    entry.required |= GetModifierBit(shortcut.GetAltKey());
+    entry.required |= GetModifierBit(shortcut.GetShiftKey());
+    return entry;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "Shortcut.h"
+#include "RemapShortcut.h"
+#include <array>
+#include <map>
+#include <vector>
+
+class InputInterface;
+
+using ShortcutRemapTable = std::map<Shortcut, RemapShortcut>;
+
+// Bits of the modifier keys in a ModifierState
+namespace ModifierBit
+{
+    enum : uint16_t
+    {
+        LWin = 1 << 0,
+        RWin = 1 << 1,
+        LCtrl = 1 << 2,
+        RCtrl = 1 << 3,
+        Ctrl = 1 << 4,
+        LAlt = 1 << 5,
+        RAlt = 1 << 6,
+        Alt = 1 << 7,
+        LShift = 1 << 8,
+        RShift = 1 << 9,
+        Shift = 1 << 10
+    };
+}
+
+// Snapshot of the pressed modifier keys, one ModifierBit per key
+using ModifierState = uint16_t;
+
+// Shortcut remap table compiled for the hook. Remaps are indexed by action key and their modifiers are packed into bitmasks, so a key down only checks the remaps for that key against a single snapshot of the modifier state
+class ShortcutMatcher
+{
+public:
+    struct Entry
+    {
+        // Modifier keys which all have to be pressed
+        ModifierState required;
+
+        // Modifier keys of which at least one has to be pressed, used for the win key since VK_WIN does not exist
+        ModifierState requiredAny;
+
+        ShortcutRemapTable::iterator remap;
+
+        // Function to check if the modifiers of the shortcut are pressed in the given state, equivalent to Shortcut::CheckModifiersKeyboardState
+        inline bool CheckModifiers(ModifierState state) const
+        {
+            return (state & required) == required && (requiredAny == 0 || (state & requiredAny) != 0);
+        }
+    };
+
+    // Range of entries in priority order
+    struct EntryRange
+    {
+        const Entry* first;
+        const Entry* last;
+
+        inline const Entry* begin() const { return first; }
+        inline const Entry* end() const { return last; }
+        inline bool empty() const { return first == last; }
+    };
+
+    ShortcutMatcher();
+
+    // Compile the remaps of the table. The sorted keys define the priority of the remaps, see KeyboardManagerHelper::SortShortcutVectorBasedOnSize
+    ShortcutMatcher(ShortcutRemapTable& table, const std::vector<Shortcut>& sortedKeys);
+
+    // Function to return all the remaps in priority order
+    EntryRange GetEntries() const;
+
+    // Function to return the remaps with the given action key in priority order
+    EntryRange GetEntries(DWORD actionKey) const;
+
+    // Function to take a snapshot of the modifier keys state
+    static ModifierState GetModifierState(InputInterface& ii);
+
+    // Function to compile the modifiers of a shortcut into an entry
+    static Entry Compile(const Shortcut& shortcut, ShortcutRemapTable::iterator remap);
+
+private:
+    // Remaps in priority order
+    std::vector<Entry> entries;
+
+    // Remaps grouped by action key, keeping the priority order within each group
+    std::vector<Entry> entriesByActionKey;
+
+    // Offsets of each action key group in entriesByActionKey, the group of key k spans [actionKeyOffsets[k], actionKeyOffsets[k + 1])
+    std::array<uint32_t, 257> actionKeyOffsets;
+};
@@ -0,0 +1,41 @@
+#include "pch.h"
+#include "SingleKeyRemapLookup.h"
+#include "Helpers.h"
+#include "../common/shared_constants.h"
+
+SingleKeyRemapLookup::SingleKeyRemapLookup()
+{
+    entries.fill({ TargetType::None, 0 });
+}
+
+// Compile the remaps of the table
+SingleKeyRemapLookup::SingleKeyRemapLookup(const SingleKeyRemapTable& table) :
+    SingleKeyRemapLookup()
+{
+    for (const auto& it : table)
+    {
+        if (it.first == 0 || it.first >= entries.size())
+        {
+            continue;
+        }
+
+        Entry& entry = entries[it.first];
+        if (it.second.index() == 0)
+        {
+            DWORD target = std::get<DWORD>(it.second);
+            if (target == CommonSharedConstants::VK_DISABLED)
+            {
+                entry = { TargetType::Disabled, 0 };
+            }
+            else
+            {
+                entry = { TargetType::Key, (uint16_t)KeyboardManagerHelper::FilterArtificialKeys(target) };
+            }
+        }
+        else
+        {
+            entry = { TargetType::Shortcut, (uint16_t)shortcuts.size() };
+            shortcuts.push_back(std::get<Shortcut>(it.second));
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Shortcut.h"
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+using SingleKeyRemapTable = std::unordered_map<DWORD, KeyShortcutUnion>;
+
+// Single key remap table compiled for the hook. Remaps are stored in a flat table indexed by the source key, so checking a key which is not remapped is a single read of a small entry. Shortcut targets are stored out of line
+class SingleKeyRemapLookup
+{
+public:
+    enum class TargetType : uint8_t
+    {
+        None,
+        Key,
+        Disabled,
+        Shortcut
+    };
+
+    struct Entry
+    {
+        TargetType type;
+
+        // Target key code with the artificial keys filtered for Key, index of the target in the shortcut targets for Shortcut
+        uint16_t target;
+
+        inline bool IsRemapped() const { return type != TargetType::None; }
+    };
+
+    SingleKeyRemapLookup();
+
+    // Compile the remaps of the table
+    explicit SingleKeyRemapLookup(const SingleKeyRemapTable& table);
+
+    // Function to return the remap of a source key, an entry of type None if it isn't remapped
+    inline const Entry& GetEntry(DWORD originalKey) const
+    {
+        return originalKey < entries.size() ? entries[originalKey] : entries[0];
+    }
+
+    // Function to return the target of a remap of type Shortcut
+    inline const Shortcut& GetShortcut(const Entry& entry) const
+    {
+        return shortcuts[entry.target];
+    }
+
+private:
+    // Remaps indexed by source key. Key code 0 is never remapped, so its entry is also used for keys out of range
+    std::array<Entry, 256> entries;
+
+    // Shortcut targets of the remaps
+    std::vector<Shortcut> shortcuts;
+};
@@ -132,6 +132,35 @@ void Trace::ShortcutRemapInvoked(bool isShortcutToShortcut, bool isAppSpecific)
     }
 }
 
+// Log the latencies of each hook stage and the key event counters of the hook
+void Trace::HookLatency(const HookLatencyStats::Snapshot& snapshot) noexcept
+{
+    static const char* const stageNames[HookLatencyStats::StageCount] = { "UIDetection", "SingleKeyRemap", "AppSpecificShortcutRemap", "OSLevelShortcutRemap", "SendInput" };
+    for (int stage = 0; stage < HookLatencyStats::StageCount; stage++)
+    {
+        const auto& stageSnapshot = snapshot.stages[stage];
+        TraceLoggingWrite(
+            g_hProvider,
+            "KeyboardManager_HookStageLatency",
+            ProjectTelemetryPrivacyDataTag(ProjectTelemetryTag_ProductAndServicePerformance),
+            TraceLoggingKeyword(PROJECT_KEYWORD_MEASURE),
+            TraceLoggingValue(stageNames[stage], "Stage"),
+            TraceLoggingValue(stageSnapshot.count, "Count"),
+            TraceLoggingValue(stageSnapshot.p50, "P50Microseconds"),
+            TraceLoggingValue(stageSnapshot.p99, "P99Microseconds"),
+            TraceLoggingValue(stageSnapshot.max, "MaxMicroseconds"));
+    }
+
+    TraceLoggingWrite(
+        g_hProvider,
+        "KeyboardManager_HookEventCount",
+        ProjectTelemetryPrivacyDataTag(ProjectTelemetryTag_ProductAndServicePerformance),
+        TraceLoggingKeyword(PROJECT_KEYWORD_MEASURE),
+        TraceLoggingValue(snapshot.suppressedEvents, "SuppressedEventCount"),
+        TraceLoggingValue(snapshot.passedEvents, "PassedEventCount"),
+        TraceLoggingValue(snapshot.injectedEvents, "InjectedEventCount"));
+}
+
 // Log if an error occurs in KBM
 void Trace::Error(const DWORD errorCode, std::wstring errorMessage, std::wstring methodName) noexcept
 {
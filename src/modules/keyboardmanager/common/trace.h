@@ -1,4 +1,5 @@
 #pragma once
+#include "HookLatencyStats.h"
 
 class Trace
 {
@@ -24,6 +25,9 @@ public:
     // Log if a shortcut remap has been invoked
     static void ShortcutRemapInvoked(bool isShortcutToShortcut, bool isAppSpecific) noexcept;
     
+    // Log the latencies of each hook stage and the key event counters of the hook
+    static void HookLatency(const HookLatencyStats::Snapshot& snapshot) noexcept;
+
     // Log if an error occurs in KBM
     static void Error(const DWORD errorCode, std::wstring errorMessage, std::wstring methodName) noexcept;
 };
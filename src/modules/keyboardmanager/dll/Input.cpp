@@ -1,11 +1,21 @@
 #include "pch.h"
 #include "Input.h"
 #include <keyboardmanager/common/Helpers.h>
+#include <keyboardmanager/common/KeyboardManagerConstants.h>
+#include <keyboardmanager/common/HookLatencyStats.h>
 
 // Function to simulate input
 UINT Input::SendVirtualInput(UINT cInputs, LPINPUT pInputs, int cbSize)
 {
-    return SendInput(cInputs, pInputs, cbSize);
+    if (hookLatencyStats == nullptr)
+    {
+        return SendInput(cInputs, pInputs, cbSize);
+    }
+
+    int64_t start = HookLatencyStats::Now();
+    UINT result = SendInput(cInputs, pInputs, cbSize);
+    hookLatencyStats->RecordSendInput(HookLatencyStats::Now() - start, result);
+    return result;
 }
 
 // Function to get the state of a particular key
@@ -14,8 +24,98 @@ bool Input::GetVirtualKeyState(int key)
     return (GetAsyncKeyState(key) & 0x8000);
 }
 
+// Function to get the bitmap of the pressed keys. It is reconciled with the OS key state if it has not been for KeyboardStateSyncInterval
+const KeyboardStateBitmap& Input::GetKeyboardStateBitmap()
+{
+    ULONGLONG currentTime = GetTickCount64();
+    if (currentTime - keyboardStateSyncTime >= KeyboardManagerConstants::KeyboardStateSyncInterval)
+    {
+        for (int keyVal = 1; keyVal < 0xFF; keyVal++)
+        {
+            keyboardState.SetKeyState(keyVal, GetVirtualKeyState(keyVal));
+        }
+
+        keyboardStateSyncTime = currentTime;
+    }
+
+    return keyboardState;
+}
+
+// Function to update the bitmap of the pressed keys with a key event which was not suppressed by the hook
+void Input::UpdateKeyboardStateBitmap(LowlevelKeyboardEvent* data)
+{
+    DWORD key = data->lParam->vkCode;
+    bool isDown = (data->wParam == WM_KEYDOWN || data->wParam == WM_SYSKEYDOWN);
+    keyboardState.SetKeyState(key, isDown);
+
+    // The generic modifier key codes are pressed while either side is pressed
+    switch (key)
+    {
+    case VK_LCONTROL:
+    case VK_RCONTROL:
+        keyboardState.SetKeyState(VK_CONTROL, keyboardState.GetKeyState(VK_LCONTROL) || keyboardState.GetKeyState(VK_RCONTROL));
+        break;
+    case VK_LMENU:
+    case VK_RMENU:
+        keyboardState.SetKeyState(VK_MENU, keyboardState.GetKeyState(VK_LMENU) || keyboardState.GetKeyState(VK_RMENU));
+        break;
+    case VK_LSHIFT:
+    case VK_RSHIFT:
+        keyboardState.SetKeyState(VK_SHIFT, keyboardState.GetKeyState(VK_LSHIFT) || keyboardState.GetKeyState(VK_RSHIFT));
+        break;
+    }
+}
+
 // Function to get the foreground process name
 void Input::GetForegroundProcess(_Out_ std::wstring& foregroundProcess)
 {
     foregroundProcess = KeyboardManagerHelper::GetCurrentApplication(false);
 }
+
+Input* Input::foregroundTracker = nullptr;
+
+// Destructor
+Input::~Input()
+{
+    SetForegroundProcessChangedCallback(nullptr);
+}
+
+// Function to set the callback which receives the foreground process name whenever the foreground window changes
+void Input::SetForegroundProcessChangedCallback(std::function<void(const std::wstring&)> callback)
+{
+    if (foregroundEventHook)
+    {
+        UnhookWinEvent(foregroundEventHook);
+        foregroundEventHook = nullptr;
+        foregroundTracker = nullptr;
+    }
+
+    foregroundProcessChangedCallback = std::move(callback);
+    if (foregroundProcessChangedCallback)
+    {
+        // The events are delivered on the calling thread, which is the thread running the low level keyboard hook
+        foregroundTracker = this;
+        foregroundEventHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, ForegroundEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+
+        std::wstring foregroundProcess;
+        GetForegroundProcess(foregroundProcess);
+        foregroundProcessChangedCallback(foregroundProcess);
+    }
+}
+
+// Window event procedure for EVENT_SYSTEM_FOREGROUND
+void CALLBACK Input::ForegroundEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject, LONG idChild, DWORD idEventThread, DWORD dwmsEventTime)
+{
+    if (foregroundTracker && foregroundTracker->foregroundProcessChangedCallback)
+    {
+        std::wstring foregroundProcess;
+        foregroundTracker->GetForegroundProcess(foregroundProcess);
+        foregroundTracker->foregroundProcessChangedCallback(foregroundProcess);
+    }
+}
+
+// Function to set the statistics which record the SendInput calls
+void Input::SetHookLatencyStats(HookLatencyStats* stats)
+{
+    hookLatencyStats = stats;
+}
@@ -1,17 +1,54 @@
 #pragma once
 #include <keyboardmanager/common/InputInterface.h>
+#include <common/LowlevelKeyboardEvent.h>
+
+class HookLatencyStats;
 
 // Class used to wrap keyboard input library methods
 class Input :
     public InputInterface
 {
+private:
+    // Pressed keys as seen by the hook, and the time they were last reconciled with the OS key state
+    KeyboardStateBitmap keyboardState;
+    ULONGLONG keyboardStateSyncTime = 0;
+
+    // Window event hook used to track foreground window changes
+    HWINEVENTHOOK foregroundEventHook = nullptr;
+
+    std::function<void(const std::wstring&)> foregroundProcessChangedCallback;
+
+    // Statistics which record the SendInput calls, nullptr if they are not recorded
+    HookLatencyStats* hookLatencyStats = nullptr;
+
+    // Static pointer to the object tracking the foreground window, required for accessing the callback in the window event procedure
+    static Input* foregroundTracker;
+
+    // Window event procedure for EVENT_SYSTEM_FOREGROUND
+    static void CALLBACK ForegroundEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject, LONG idChild, DWORD idEventThread, DWORD dwmsEventTime);
+
 public:
+    // Destructor
+    ~Input();
+
     // Function to simulate input
     UINT SendVirtualInput(UINT cInputs, LPINPUT pInputs, int cbSize);
 
     // Function to get the state of a particular key
     bool GetVirtualKeyState(int key);
 
+    // Function to get the bitmap of the pressed keys. It is reconciled with the OS key state if it has not been for KeyboardStateSyncInterval
+    const KeyboardStateBitmap& GetKeyboardStateBitmap();
+
+    // Function to update the bitmap of the pressed keys with a key event which was not suppressed by the hook
+    void UpdateKeyboardStateBitmap(LowlevelKeyboardEvent* data);
+
     // Function to get the foreground process name
     void GetForegroundProcess(_Out_ std::wstring& foregroundProcess);
+
+    // Function to set the callback which receives the foreground process name whenever the foreground window changes
+    void SetForegroundProcessChangedCallback(std::function<void(const std::wstring&)> callback);
+
+    // Function to set the statistics which record the SendInput calls
+    void SetHookLatencyStats(HookLatencyStats* stats);
 };
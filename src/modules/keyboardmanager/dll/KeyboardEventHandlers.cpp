@@ -2,6 +2,7 @@
 #include "KeyboardEventHandlers.h"
 #include "keyboardmanager/common/Shortcut.h"
 #include "keyboardmanager/common/RemapShortcut.h"
+#include "keyboardmanager/common/KeyEventBatch.h"
 #include "../common/shared_constants.h"
 #include <keyboardmanager/common/KeyboardManagerState.h>
 #include <keyboardmanager/common/InputInterface.h>
@@ -16,85 +17,69 @@ namespace KeyboardEventHandlers
         // Check if the key event was generated by KeyboardManager to avoid remapping events generated by us.
         if (!(data->lParam->dwExtraInfo & CommonSharedConstants::KEYBOARDMANAGER_INJECTED_FLAG))
         {
-            auto& remapping = keyboardManagerState.GetSingleKeyRemap(data->lParam->vkCode);
-            if (remapping)
+            const auto& lookup = keyboardManagerState.GetSingleKeyRemapLookup();
+            const auto& remapping = lookup.GetEntry(data->lParam->vkCode);
+            if (remapping.IsRemapped())
             {
-                auto it = remapping.value();
-
-                // Check if the remap is to a key or a shortcut
-                bool remapToKey = (it->second.index() == 0);
+                const DWORD originalKey = data->lParam->vkCode;
 
                 // If mapped to VK_DISABLED then the key is disabled
-                if (remapToKey)
+                if (remapping.type == SingleKeyRemapLookup::TargetType::Disabled)
                 {
-                    if (std::get<DWORD>(it->second) == CommonSharedConstants::VK_DISABLED)
-                    {
-                        return 1;
-                    }
+                    return 1;
                 }
 
-                int key_count;
-                if (remapToKey)
-                {
-                    key_count = 1;
-                }
-                else
-                {
-                    key_count = std::get<Shortcut>(it->second).Size();
-                }
-                LPINPUT keyEventList = new INPUT[size_t(key_count)]();
-                memset(keyEventList, 0, sizeof(keyEventList));
+                // Check if the remap is to a key or a shortcut
+                bool remapToKey = (remapping.type == SingleKeyRemapLookup::TargetType::Key);
+
+                KeyEventBatch keyEvents;
 
-                // Handle remaps to VK_WIN_BOTH
+                // Remaps to VK_WIN_BOTH are already filtered in the lookup table
                 DWORD target;
                 if (remapToKey)
                 {
-                    target = KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second));
+                    target = remapping.target;
                 }
                 else
                 {
-                    target = KeyboardManagerHelper::FilterArtificialKeys(std::get<Shortcut>(it->second).GetActionKey());
+                    target = KeyboardManagerHelper::FilterArtificialKeys(lookup.GetShortcut(remapping).GetActionKey());
                 }
 
                 // If Ctrl/Alt/Shift is being remapped to Caps Lock, then reset the modifier key state to fix issues in certain IME keyboards where the IME shortcut gets invoked since it detects that the modifier and Caps Lock is pressed even though it is suppressed by the hook - More information at the GitHub issue https://github.com/microsoft/PowerToys/issues/3397
                 if (data->wParam == WM_KEYDOWN || data->wParam == WM_SYSKEYDOWN)
                 {
-                    ResetIfModifierKeyForLowerLevelKeyHandlers(ii, it->first, target);
+                    ResetIfModifierKeyForLowerLevelKeyHandlers(ii, originalKey, target);
                 }
 
                 if (remapToKey)
                 {
                     if (data->wParam == WM_KEYUP || data->wParam == WM_SYSKEYUP)
                     {
-                        KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, (WORD)target, KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
+                        keyEvents.ReleaseKey((WORD)target, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
                     }
                     else
                     {
-                        KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, (WORD)target, 0, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
+                        keyEvents.PressKey((WORD)target, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
                     }
                 }
                 else
                 {
-                    int i = 0;
-                    Shortcut targetShortcut = std::get<Shortcut>(it->second);
+                    const Shortcut& targetShortcut = lookup.GetShortcut(remapping);
                     if (data->wParam == WM_KEYUP || data->wParam == WM_SYSKEYUP)
                     {
-                        KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)targetShortcut.GetActionKey(), KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
-                        i++;
-                        KeyboardManagerHelper::SetModifierKeyEvents(targetShortcut, ModifierKey::Disabled, keyEventList, i, false, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
-                        // Dummy key is not required here since SetModifierKeyEvents will only add key-up events for the modifiers here, and the action key key-up is already sent before it
+                        keyEvents.ReleaseKey((WORD)targetShortcut.GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
+                        keyEvents.ReleaseModifiers(targetShortcut, ModifierKey::Disabled, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
+                        // Dummy key is not required here since ReleaseModifiers will only add key-up events for the modifiers here, and the action key key-up is already sent before it
                     }
                     else
                     {
-                        // Dummy key is not required here since SetModifierKeyEvents will only add key-down events for the modifiers here, and the action key key-down is already sent after it
-                        KeyboardManagerHelper::SetModifierKeyEvents(targetShortcut, ModifierKey::Disabled, keyEventList, i, true, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
-                        KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)targetShortcut.GetActionKey(), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
-                        i++;
+                        // Dummy key is not required here since PressModifiers will only add key-down events for the modifiers here, and the action key key-down is already sent after it
+                        keyEvents.PressModifiers(targetShortcut, ModifierKey::Disabled, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
+                        keyEvents.PressKey((WORD)targetShortcut.GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
                     }
                 }
 
-                UINT res = ii.SendVirtualInput(key_count, keyEventList, sizeof(INPUT));
-                delete[] keyEventList;
+                UINT res = keyEvents.Send(ii);
 
                 if (data->wParam == WM_KEYDOWN || data->wParam == WM_SYSKEYDOWN)
                 {
@@ -104,14 +89,15 @@ namespace KeyboardEventHandlers
                     // If Caps Lock is being remapped to Ctrl/Alt/Shift, then reset the modifier key state to fix issues in certain IME keyboards where the IME shortcut gets invoked since it detects that the modifier and Caps Lock is pressed even though it is suppressed by the hook - More information at the GitHub issue https://github.com/microsoft/PowerToys/issues/3397
                     if (remapToKey)
                     {
-                        ResetIfModifierKeyForLowerLevelKeyHandlers(ii, target, it->first);
+                        ResetIfModifierKeyForLowerLevelKeyHandlers(ii, target, originalKey);
                     }
                     else
                     {
-                        std::vector<DWORD> shortcutKeys = std::get<Shortcut>(it->second).GetKeyCodes();
-                        for (auto& itSk : shortcutKeys)
+                        // Win keys are never reset, so only the Ctrl/Alt/Shift and action keys of the shortcut are checked
+                        const Shortcut& targetShortcut = lookup.GetShortcut(remapping);
+                        for (DWORD key : { targetShortcut.GetCtrlKey(), targetShortcut.GetAltKey(), targetShortcut.GetShiftKey(), targetShortcut.GetActionKey() })
                         {
-                            ResetIfModifierKeyForLowerLevelKeyHandlers(ii, itSk, it->first);
+                            ResetIfModifierKeyForLowerLevelKeyHandlers(ii, key, originalKey);
                         }
                     }
                 }
@@ -149,15 +135,12 @@ namespace KeyboardEventHandlers
                         return 1;
                     }
                 }
-                int key_count = 2;
-                LPINPUT keyEventList = new INPUT[size_t(key_count)]();
-                memset(keyEventList, 0, sizeof(keyEventList));
-                KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, (WORD)data->lParam->vkCode, 0, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
-                KeyboardManagerHelper::SetKeyEvent(keyEventList, 1, INPUT_KEYBOARD, (WORD)data->lParam->vkCode, KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
+                KeyEventBatch keyEvents;
+                keyEvents.PressKey((WORD)data->lParam->vkCode, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
+                keyEvents.ReleaseKey((WORD)data->lParam->vkCode, KeyboardManagerConstants::KEYBOARDMANAGER_SINGLEKEY_FLAG);
 
                 lock.unlock();
-                UINT res = ii.SendVirtualInput(key_count, keyEventList, sizeof(INPUT));
-                delete[] keyEventList;
+                UINT res = keyEvents.Send(ii);
 
                 // Reset the long press flag when the key has been lifted.
                 if (data->wParam == WM_KEYUP || data->wParam == WM_SYSKEYUP)
@@ -181,13 +164,17 @@ namespace KeyboardEventHandlers
         // Check if any shortcut is currently in the invoked state
         bool isShortcutInvoked = keyboardManagerState.CheckShortcutRemapInvoked(activatedApp);
 
-        // Get shortcut table for given activatedApp
-        ShortcutRemapTable& reMap = keyboardManagerState.GetShortcutRemapTable(activatedApp);
+        // Get compiled shortcut table for given activatedApp
+        const ShortcutMatcher& matcher = keyboardManagerState.GetShortcutMatcher(activatedApp);
+
+        // If no shortcut is invoked, only the remaps for the current action key can be pressed. Their modifiers are checked against a single snapshot of the modifier keys
+        ShortcutMatcher::EntryRange entries = isShortcutInvoked ? matcher.GetEntries() : matcher.GetEntries(data->lParam->vkCode);
+        ModifierState modifierState = (isShortcutInvoked || entries.empty()) ? 0 : ShortcutMatcher::GetModifierState(ii);
 
         // Iterate through the shortcut remaps and apply whichever has been pressed
-        for (auto& itShortcut : keyboardManagerState.GetSortedShortcutRemapVector(activatedApp))
+        for (const auto& entry : entries)
         {
-            auto& it = reMap.find(itShortcut);
+            auto it = entry.remap;
 
             // If a shortcut is currently in the invoked state then skip till the shortcut that is currently invoked
             if (isShortcutInvoked && !it->second.isShortcutInvoked)
@@ -201,7 +188,7 @@ namespace KeyboardEventHandlers
             const size_t dest_size = remapToShortcut ? std::get<Shortcut>(it->second.targetShortcut).Size() : 1;
 
             // If the shortcut has been pressed down
-            if (!it->second.isShortcutInvoked && it->first.CheckModifiersKeyboardState(ii))
+            if (!it->second.isShortcutInvoked && entry.CheckModifiers(modifierState))
             {
                 if (data->lParam->vkCode == it->first.GetActionKey() && (data->wParam == WM_KEYDOWN || data->wParam == WM_SYSKEYDOWN))
                 {
@@ -211,8 +198,7 @@ namespace KeyboardEventHandlers
                         continue;
                     }
 
-                    size_t key_count;
-                    LPINPUT keyEventList;
+                    KeyEventBatch keyEvents;
 
                     // Remember which win key was pressed initially
                     if (ii.GetVirtualKeyState(VK_RWIN))
@@ -233,71 +219,54 @@ namespace KeyboardEventHandlers
                         if (commonKeys == src_size - 1)
                         {
                             // key down for all new shortcut keys except the common modifiers
-                            key_count = dest_size - commonKeys;
-                            keyEventList = new INPUT[key_count]();
-                            memset(keyEventList, 0, sizeof(keyEventList));
-                            int i = 0;
-                            KeyboardManagerHelper::SetModifierKeyEvents(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, keyEventList, i, true, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first);
-                            KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                            i++;
+                            keyEvents.PressModifiers(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first);
+                            keyEvents.PressKey((WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                         }
                         else
                         {
                             // Dummy key, key up for all the original shortcut modifier keys and key down for all the new shortcut keys but common keys in each are not repeated
-                            key_count = KeyboardManagerConstants::DUMMY_KEY_EVENT_SIZE + (src_size - 1) + (dest_size) - (2 * (size_t)commonKeys);
-                            keyEventList = new INPUT[key_count]();
-                            memset(keyEventList, 0, sizeof(keyEventList));
-
                             // Send a dummy key event to prevent modifier press+release from being triggered. Example: Win+A->Ctrl+V, press Win+A, since Win will be released here we need to send a dummy event before it
-                            int i = 0;
-                            KeyboardManagerHelper::SetDummyKeyEvent(keyEventList, i, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                            keyEvents.AddDummyKeyEvent(KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
 
                             // Release original shortcut state (release in reverse order of shortcut to be accurate)
-                            KeyboardManagerHelper::SetModifierKeyEvents(it->first, it->second.winKeyInvoked, keyEventList, i, false, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, std::get<Shortcut>(it->second.targetShortcut));
+                            keyEvents.ReleaseModifiers(it->first, it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, std::get<Shortcut>(it->second.targetShortcut));
 
                             // Set new shortcut key down state
-                            KeyboardManagerHelper::SetModifierKeyEvents(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, keyEventList, i, true, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first);
-                            KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                            i++;
+                            keyEvents.PressModifiers(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first);
+                            keyEvents.PressKey((WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                         }
 
                         // Modifier state reset might be required for this key depending on the shortcut's action and target modifiers - ex: Win+Caps -> Ctrl+A
                         if (it->first.GetCtrlKey() == NULL && it->first.GetAltKey() == NULL && it->first.GetShiftKey() == NULL)
                         {
-                            Shortcut temp = std::get<Shortcut>(it->second.targetShortcut);
-                            for (auto keys : temp.GetKeyCodes())
+                            // Win keys are never reset, so only the Ctrl/Alt/Shift and action keys of the shortcut are checked
+                            const Shortcut& targetShortcut = std::get<Shortcut>(it->second.targetShortcut);
+                            for (DWORD key : { targetShortcut.GetCtrlKey(), targetShortcut.GetAltKey(), targetShortcut.GetShiftKey(), targetShortcut.GetActionKey() })
                             {
-                                ResetIfModifierKeyForLowerLevelKeyHandlers(ii, keys, data->lParam->vkCode);
+                                ResetIfModifierKeyForLowerLevelKeyHandlers(ii, key, data->lParam->vkCode);
                             }
                         }
                     }
                     else
                     {
                         // Dummy key, key up for all the original shortcut modifier keys and key down for remapped key
-                        key_count = KeyboardManagerConstants::DUMMY_KEY_EVENT_SIZE + (src_size - 1) + dest_size;
                         // Do not send Disable key
                         if (std::get<DWORD>(it->second.targetShortcut) == CommonSharedConstants::VK_DISABLED)
                         {
-                            key_count--;
                             // Since the original shortcut's action key is pressed, set it to true
                             it->second.isOriginalActionKeyPressed = true;
                         }
 
-                        keyEventList = new INPUT[key_count]();
-                        memset(keyEventList, 0, sizeof(keyEventList));
-
                         // Send a dummy key event to prevent modifier press+release from being triggered. Example: Win+A->V, press Win+A, since Win will be released here we need to send a dummy event before it
-                        int i = 0;
-                        KeyboardManagerHelper::SetDummyKeyEvent(keyEventList, i, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                        keyEvents.AddDummyKeyEvent(KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
 
                         // Release original shortcut state (release in reverse order of shortcut to be accurate)
-                        KeyboardManagerHelper::SetModifierKeyEvents(it->first, it->second.winKeyInvoked, keyEventList, i, false, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                        keyEvents.ReleaseModifiers(it->first, it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
 
                         // Set target key down state
                         if (std::get<DWORD>(it->second.targetShortcut) != CommonSharedConstants::VK_DISABLED)
                         {
-                            KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                            i++;
+                            keyEvents.PressKey((WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                         }
 
                         // Modifier state reset might be required for this key depending on the shortcut's action and target modifier - ex: Win+Caps -> Ctrl
@@ -314,8 +283,7 @@ namespace KeyboardEventHandlers
                         keyboardManagerState.SetActivatedApp(*activatedApp);
                     }
 
-                    UINT res = ii.SendVirtualInput((UINT)key_count, keyEventList, sizeof(INPUT));
-                    delete[] keyEventList;
+                    UINT res = keyEvents.Send(ii);
 
                     // Log telemetry event when shortcut remap is invoked
                     Trace::ShortcutRemapInvoked(remapToShortcut, activatedApp.has_value());
@@ -340,85 +308,51 @@ namespace KeyboardEventHandlers
                 if ((it->first.CheckWinKey(data->lParam->vkCode) || it->first.CheckCtrlKey(data->lParam->vkCode) || it->first.CheckAltKey(data->lParam->vkCode) || it->first.CheckShiftKey(data->lParam->vkCode)) && (data->wParam == WM_KEYUP || data->wParam == WM_SYSKEYUP))
                 {
                     // Release new shortcut, and set original shortcut keys except the one released
-                    size_t key_count;
-                    LPINPUT keyEventList;
+                    KeyEventBatch keyEvents;
                     if (remapToShortcut)
                     {
-                        // if the released key is present in both shortcuts' modifiers (i.e part of the common modifiers)
-                        if (std::get<Shortcut>(it->second.targetShortcut).CheckWinKey(data->lParam->vkCode) || std::get<Shortcut>(it->second.targetShortcut).CheckCtrlKey(data->lParam->vkCode) || std::get<Shortcut>(it->second.targetShortcut).CheckAltKey(data->lParam->vkCode) || std::get<Shortcut>(it->second.targetShortcut).CheckShiftKey(data->lParam->vkCode))
-                        {
-                            // release all new shortcut keys and the common released modifier except the other common modifiers, and add all original shortcut modifiers except the common ones, and dummy key
-                            key_count = (dest_size - commonKeys) + (src_size - 1 - commonKeys) + KeyboardManagerConstants::DUMMY_KEY_EVENT_SIZE;
-                        }
-                        else
-                        {
-                            // release all new shortcut keys except the common modifiers and add all original shortcut modifiers except the common ones, and dummy key
-                            key_count = (dest_size - 1) + (src_size - 2) - (2 * (size_t)commonKeys) + KeyboardManagerConstants::DUMMY_KEY_EVENT_SIZE;
-                        }
+                        // Release all new shortcut keys except the common modifiers (unless it is the released modifier), add all original shortcut modifiers except the common ones, and dummy key
 
                         // If the target shortcut's action key is pressed, then it should be released
                         bool isActionKeyPressed = false;
                         if (ii.GetVirtualKeyState((std::get<Shortcut>(it->second.targetShortcut).GetActionKey())))
                         {
                             isActionKeyPressed = true;
-                            key_count += 1;
                         }
 
-                        keyEventList = new INPUT[key_count]();
-                        memset(keyEventList, 0, sizeof(keyEventList));
-
                         // Release new shortcut state (release in reverse order of shortcut to be accurate)
-                        int i = 0;
                         if (isActionKeyPressed)
                         {
-                            KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                            i++;
+                            keyEvents.ReleaseKey((WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                         }
-                        KeyboardManagerHelper::SetModifierKeyEvents(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, keyEventList, i, false, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first, data->lParam->vkCode);
+                        keyEvents.ReleaseModifiers(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first, data->lParam->vkCode);
 
                         // Set original shortcut key down state except the action key and the released modifier since the original action key may or may not be held down. If it is held down it will generate it's own key message
-                        KeyboardManagerHelper::SetModifierKeyEvents(it->first, it->second.winKeyInvoked, keyEventList, i, true, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, std::get<Shortcut>(it->second.targetShortcut), data->lParam->vkCode);
+                        keyEvents.PressModifiers(it->first, it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, std::get<Shortcut>(it->second.targetShortcut), data->lParam->vkCode);
 
                         // Send a dummy key event to prevent modifier press+release from being triggered. Example: Win+Ctrl+A->Ctrl+V, press Win+Ctrl+A and release A then Ctrl, since Win will be pressed here we need to send a dummy event after it
-                        KeyboardManagerHelper::SetDummyKeyEvent(keyEventList, i, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                        keyEvents.AddDummyKeyEvent(KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                     }
                     else
                     {
-                        // 1 for releasing new key and original shortcut modifiers except the one released and dummy key
-                        key_count = dest_size + src_size - 2 + KeyboardManagerConstants::DUMMY_KEY_EVENT_SIZE;
+                        // Release new key, set original shortcut modifiers except the one released, and dummy key. Do not send Disable key up
                         bool isTargetKeyPressed = false;
-
-                        // Do not send Disable key up
-                        if (std::get<DWORD>(it->second.targetShortcut) == CommonSharedConstants::VK_DISABLED)
-                        {
-                            key_count--;
-                        }
-                        else if (ii.GetVirtualKeyState(KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut))))
+                        if (std::get<DWORD>(it->second.targetShortcut) != CommonSharedConstants::VK_DISABLED && ii.GetVirtualKeyState(KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut))))
                         {
                             isTargetKeyPressed = true;
                         }
-                        else
-                        {
-                            isTargetKeyPressed = false;
-                            key_count--;
-                        }
-
-                        keyEventList = new INPUT[key_count]();
-                        memset(keyEventList, 0, sizeof(keyEventList));
 
                         // Release new key state
-                        int i = 0;
                         if (std::get<DWORD>(it->second.targetShortcut) != CommonSharedConstants::VK_DISABLED && isTargetKeyPressed)
                         {
-                            KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                            i++;
+                            keyEvents.ReleaseKey((WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                         }
 
                         // Set original shortcut key down state except the action key and the released modifier since the original action key may or may not be held down. If it is held down it will generate it's own key message
-                        KeyboardManagerHelper::SetModifierKeyEvents(it->first, it->second.winKeyInvoked, keyEventList, i, true, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, Shortcut(), data->lParam->vkCode);
+                        keyEvents.PressModifiers(it->first, it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, Shortcut(), data->lParam->vkCode);
 
                         // Send a dummy key event to prevent modifier press+release from being triggered. Example: Win+Ctrl+A->V, press Win+Ctrl+A and release A then Ctrl, since Win will be pressed here we need to send a dummy event after it
-                        KeyboardManagerHelper::SetDummyKeyEvent(keyEventList, i, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                        keyEvents.AddDummyKeyEvent(KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                     }
 
                     // Reset the remap state
@@ -431,12 +365,8 @@ namespace KeyboardEventHandlers
                         keyboardManagerState.SetActivatedApp(KeyboardManagerConstants::NoActivatedApp);
                     }
 
-                    // key count can be 0 if both shortcuts have same modifiers and the action key is not held down. delete will throw an error if keyEventList is empty
-                    if (key_count > 0)
-                    {
-                        UINT res = ii.SendVirtualInput((UINT)key_count, keyEventList, sizeof(INPUT));
-                        delete[] keyEventList;
-                    }
+                    // The batch can be empty if both shortcuts have same modifiers and the action key is not held down, in which case nothing is sent
+                    UINT res = keyEvents.Send(ii);
                     return 1;
                 }
 
@@ -454,33 +384,27 @@ namespace KeyboardEventHandlers
                             return 1;
                         }
 
-                        size_t key_count = 1;
-                        LPINPUT keyEventList = new INPUT[key_count]();
-                        memset(keyEventList, 0, sizeof(keyEventList));
+                        KeyEventBatch keyEvents;
                         if (remapToShortcut)
                         {
-                            KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, (WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                            keyEvents.PressKey((WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                         }
                         else
                         {
-                            KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, (WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                            keyEvents.PressKey((WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                         }
 
-                        UINT res = ii.SendVirtualInput((UINT)key_count, keyEventList, sizeof(INPUT));
-                        delete[] keyEventList;
+                        UINT res = keyEvents.Send(ii);
                         return 1;
                     }
 
                     // Case 3: If the action key is released from the original shortcut, keep modifiers of the new shortcut until some other key event which doesn't apply to the original shortcut
                     if (data->lParam->vkCode == it->first.GetActionKey() && (data->wParam == WM_KEYUP || data->wParam == WM_SYSKEYUP))
                     {
-                        size_t key_count = 1;
-                        LPINPUT keyEventList;
+                        KeyEventBatch keyEvents;
                         if (remapToShortcut)
                         {
-                            keyEventList = new INPUT[key_count]();
-                            memset(keyEventList, 0, sizeof(keyEventList));
-                            KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, (WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                            keyEvents.ReleaseKey((WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                         }
                         // If remapped to disable, do nothing and suppress the key event
                         else if (std::get<DWORD>(it->second.targetShortcut) == CommonSharedConstants::VK_DISABLED)
@@ -492,33 +416,25 @@ namespace KeyboardEventHandlers
                         else
                         {
                             // Check if the keyboard state is clear apart from the target remap key (by creating a temp Shortcut object with the target key)
-                            bool isKeyboardStateClear = Shortcut(std::vector<int32_t>({ KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)) })).IsKeyboardStateClearExceptShortcut(ii);
+                            Shortcut targetKeyShortcut;
+                            targetKeyShortcut.SetKey(KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)));
+                            bool isKeyboardStateClear = targetKeyShortcut.IsKeyboardStateClearExceptShortcut(ii);
                             // If the keyboard state is clear, we release the target key but do not reset the remap state
                             if (isKeyboardStateClear)
                             {
-                                keyEventList = new INPUT[key_count]();
-                                memset(keyEventList, 0, sizeof(keyEventList));
-                                KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, (WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                                keyEvents.ReleaseKey((WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                             }
                             // If any other key is pressed, then the keyboard state must be reverted back to the physical keys. This is to take cases like Ctrl+A->D remap and user presses B+Ctrl+A and releases A, or Ctrl+A+B and releases A
                             else
                             {
-                                // 1 for releasing new key and original shortcut modifiers, and dummy key
-                                key_count = dest_size + (src_size - 1) + KeyboardManagerConstants::DUMMY_KEY_EVENT_SIZE;
-
-                                keyEventList = new INPUT[key_count]();
-                                memset(keyEventList, 0, sizeof(keyEventList));
-
                                 // Release new key state
-                                int i = 0;
-                                KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                                i++;
+                                keyEvents.ReleaseKey((WORD)KeyboardManagerHelper::FilterArtificialKeys(std::get<DWORD>(it->second.targetShortcut)), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
 
                                 // Set original shortcut key down state except the action key
-                                KeyboardManagerHelper::SetModifierKeyEvents(it->first, it->second.winKeyInvoked, keyEventList, i, true, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                                keyEvents.PressModifiers(it->first, it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
 
                                 // Send a dummy key event to prevent modifier press+release from being triggered. Example: Win+A->V, press Shift+Win+A and release A, since Win will be pressed here we need to send a dummy event after it
-                                KeyboardManagerHelper::SetDummyKeyEvent(keyEventList, i, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                                keyEvents.AddDummyKeyEvent(KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
 
                                 // Reset the remap state
                                 it->second.isShortcutInvoked = false;
@@ -532,8 +448,7 @@ namespace KeyboardEventHandlers
                             }
                         }
 
-                        UINT res = ii.SendVirtualInput((UINT)key_count, keyEventList, sizeof(INPUT));
-                        delete[] keyEventList;
+                        UINT res = keyEvents.Send(ii);
                         return 1;
                     }
 
@@ -570,84 +485,63 @@ namespace KeyboardEventHandlers
                                 ResetIfModifierKeyForLowerLevelKeyHandlers(ii, data->lParam->vkCode, std::get<Shortcut>(it->second.targetShortcut).GetActionKey());
                             }
 
-                            size_t key_count;
-                            LPINPUT keyEventList;
+                            KeyEventBatch keyEvents;
 
                             // If the original shortcut is a subset of the new shortcut
                             if (commonKeys == src_size - 1)
                             {
-                                key_count = dest_size - commonKeys;
-
                                 // If the target shortcut's action key is pressed, then it should be released and original shortcut's action key should be set
                                 bool isActionKeyPressed = false;
                                 if (ii.GetVirtualKeyState((std::get<Shortcut>(it->second.targetShortcut).GetActionKey())))
                                 {
                                     isActionKeyPressed = true;
-                                    key_count += 2;
                                 }
 
-                                keyEventList = new INPUT[key_count]();
-                                memset(keyEventList, 0, sizeof(keyEventList));
-
-                                int i = 0;
                                 if (isActionKeyPressed)
                                 {
-                                    KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                                    i++;
+                                    keyEvents.ReleaseKey((WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                                 }
-                                KeyboardManagerHelper::SetModifierKeyEvents(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, keyEventList, i, false, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first);
+                                keyEvents.ReleaseModifiers(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first);
 
                                 // key down for original shortcut action key with shortcut flag so that we don't invoke the same shortcut remap again
                                 if (isActionKeyPressed)
                                 {
-                                    KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)it->first.GetActionKey(), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                                    i++;
+                                    keyEvents.PressKey((WORD)it->first.GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                                 }
 
                                 // Send current key pressed without shortcut flag so that it can be reprocessed in case the physical keys pressed are a different remapped shortcut
-                                KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)data->lParam->vkCode, 0, 0);
-                                i++;
+                                keyEvents.PressKey((WORD)data->lParam->vkCode, 0);
 
                                 // Do not send a dummy key as we want the current key press to behave as normal i.e. it can do press+release functionality if required. Required to allow a shortcut to Win key remap invoked directly after shortcut to shortcut is released to open start menu
                             }
                             else
                             {
                                 // Key up for all new shortcut keys, key down for original shortcut modifiers and current key press but common keys aren't repeated
-                                key_count = (dest_size) + (src_size - 1) - (2 * (size_t)commonKeys);
-
                                 // If the target shortcut's action key is pressed, then it should be released and original shortcut's action key should be set
                                 bool isActionKeyPressed = false;
                                 if (ii.GetVirtualKeyState((std::get<Shortcut>(it->second.targetShortcut).GetActionKey())))
                                 {
                                     isActionKeyPressed = true;
-                                    key_count += 2;
                                 }
 
-                                keyEventList = new INPUT[key_count]();
-                                memset(keyEventList, 0, sizeof(keyEventList));
-
                                 // Release new shortcut state (release in reverse order of shortcut to be accurate)
-                                int i = 0;
                                 if (isActionKeyPressed)
                                 {
-                                    KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                                    i++;
+                                    keyEvents.ReleaseKey((WORD)std::get<Shortcut>(it->second.targetShortcut).GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                                 }
-                                KeyboardManagerHelper::SetModifierKeyEvents(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, keyEventList, i, false, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first);
+                                keyEvents.ReleaseModifiers(std::get<Shortcut>(it->second.targetShortcut), it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, it->first);
 
                                 // Set old shortcut key down state
-                                KeyboardManagerHelper::SetModifierKeyEvents(it->first, it->second.winKeyInvoked, keyEventList, i, true, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, std::get<Shortcut>(it->second.targetShortcut));
+                                keyEvents.PressModifiers(it->first, it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG, std::get<Shortcut>(it->second.targetShortcut));
 
                                 // key down for original shortcut action key with shortcut flag so that we don't invoke the same shortcut remap again
                                 if (isActionKeyPressed)
                                 {
-                                    KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)it->first.GetActionKey(), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                                    i++;
+                                    keyEvents.PressKey((WORD)it->first.GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                                 }
 
                                 // Send current key pressed without shortcut flag so that it can be reprocessed in case the physical keys pressed are a different remapped shortcut
-                                KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)data->lParam->vkCode, 0, 0);
-                                i++;
+                                keyEvents.PressKey((WORD)data->lParam->vkCode, 0);
 
                                 // Do not send a dummy key as we want the current key press to behave as normal i.e. it can do press+release functionality if required. Required to allow a shortcut to Win key remap invoked directly after shortcut to shortcut is released to open start menu
                             }
@@ -662,8 +556,7 @@ namespace KeyboardEventHandlers
                                 keyboardManagerState.SetActivatedApp(KeyboardManagerConstants::NoActivatedApp);
                             }
 
-                            UINT res = ii.SendVirtualInput((UINT)key_count, keyEventList, sizeof(INPUT));
-                            delete[] keyEventList;
+                            UINT res = keyEvents.Send(ii);
                             return 1;
                         }
                         // For remap to key, if the original action key is not currently pressed, we should revert the keyboard state to the physical keys. If it is pressed we should not suppress the event so that shortcut to key remaps can be pressed with other keys. Example use-case: Alt+D->Win, allows Alt+D+A to perform Win+A
@@ -692,30 +585,20 @@ namespace KeyboardEventHandlers
                             if (isRemapToDisable || !isOriginalActionKeyPressed)
                             {
                                 // Key down for original shortcut modifiers and action key, and current key press
-                                size_t key_count = src_size + 1;
-
-                                LPINPUT keyEventList = new INPUT[key_count]();
-                                memset(keyEventList, 0, sizeof(keyEventList));
+                                KeyEventBatch keyEvents;
 
                                 // Set original shortcut key down state
-                                int i = 0;
-                                KeyboardManagerHelper::SetModifierKeyEvents(it->first, it->second.winKeyInvoked, keyEventList, i, true, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                                keyEvents.PressModifiers(it->first, it->second.winKeyInvoked, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
 
                                 // Send the original action key only if it is physically pressed. For remappings to keys other than disabled we already check earlier that it is not pressed in this scenario. For remap to disable
                                 if (isRemapToDisable && isOriginalActionKeyPressed)
                                 {
                                     // Set original action key
-                                    KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)it->first.GetActionKey(), 0, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
-                                    i++;
-                                }
-                                else
-                                {
-                                    key_count--;
+                                    keyEvents.PressKey((WORD)it->first.GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
                                 }
 
                                 // Send current key pressed without shortcut flag so that it can be reprocessed in case the physical keys pressed are a different remapped shortcut
-                                KeyboardManagerHelper::SetKeyEvent(keyEventList, i, INPUT_KEYBOARD, (WORD)data->lParam->vkCode, 0, 0);
-                                i++;
+                                keyEvents.PressKey((WORD)data->lParam->vkCode, 0);
 
                                 // Do not send a dummy key as we want the current key press to behave as normal i.e. it can do press+release functionality if required. Required to allow a shortcut to Win key remap invoked directly after another shortcut to key remap is released to open start menu
 
@@ -729,8 +612,7 @@ namespace KeyboardEventHandlers
                                     keyboardManagerState.SetActivatedApp(KeyboardManagerConstants::NoActivatedApp);
                                 }
 
-                                UINT res = ii.SendVirtualInput((UINT)key_count, keyEventList, sizeof(INPUT));
-                                delete[] keyEventList;
+                                UINT res = keyEvents.Send(ii);
                                 return 1;
                             }
                             else
@@ -766,55 +648,131 @@ namespace KeyboardEventHandlers
         // Check if the key event was generated by KeyboardManager to avoid remapping events generated by us.
         if (data->lParam->dwExtraInfo != KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG)
         {
-            std::wstring process_name;
+            // The foreground app is resolved against the remap table whenever the foreground window changes
+            const ForegroundApp* foregroundApp = keyboardManagerState.GetForegroundApp();
+            if (foregroundApp == nullptr)
+            {
+                return 0;
+            }
 
-            // Allocate MAX_PATH amount of memory
-            process_name.resize(MAX_PATH);
-            ii.GetForegroundProcess(process_name);
+            // Check if an app-specific shortcut is already activated
+            std::wstring activatedApp = keyboardManagerState.GetActivatedApp();
+            if (activatedApp == KeyboardManagerConstants::NoActivatedApp)
+            {
+                if (foregroundApp->remapTable != nullptr)
+                {
+                    bool result = HandleShortcutRemapEvent(ii, data, keyboardManagerState, foregroundApp->name);
+                    return result;
+                }
+            }
+            else if (keyboardManagerState.HasAppSpecificShortcutRemaps(activatedApp))
+            {
+                bool result = HandleShortcutRemapEvent(ii, data, keyboardManagerState, activatedApp);
+                return result;
+            }
+        }
 
-            // Remove elements after null character
-            process_name.erase(std::find(process_name.begin(), process_name.end(), L'\0'), process_name.end());
+        return 0;
+    }
 
-            if (process_name.empty())
+    // Function to run the UI detection and remapping stages of the hook for a key event, timing each stage
+    static intptr_t HandleKeyboardHookStages(InputInterface& ii, LowlevelKeyboardEvent* data, KeyboardManagerState& keyboardManagerState, HookLatencyStats& latencyStats) noexcept
+    {
+        // The detect windows of Remap Keys are checked before the single key remaps and the detect window of Remap Shortcuts after them, so the UI detection timer is paused in between and recorded once per event
+        HookLatencyStats::StageTimer uiDetectionTimer(latencyStats, HookStage::UIDetection);
+        {
+            // If the Detect Key Window is currently activated, then suppress the keyboard event
+            KeyboardManagerHelper::KeyboardHookDecision singleKeyRemapUIDetected = keyboardManagerState.DetectSingleRemapKeyUIBackend(data);
+            if (singleKeyRemapUIDetected == KeyboardManagerHelper::KeyboardHookDecision::Suppress)
+            {
+                return 1;
+            }
+            else if (singleKeyRemapUIDetected == KeyboardManagerHelper::KeyboardHookDecision::SkipHook)
             {
                 return 0;
             }
 
-            // Convert process name to lower case
-            std::transform(process_name.begin(), process_name.end(), process_name.begin(), towlower);
+            // If the Detect Shortcut Window from Remap Keys is currently activated, then suppress the keyboard event
+            KeyboardManagerHelper::KeyboardHookDecision remapKeyShortcutUIDetected = keyboardManagerState.DetectShortcutUIBackend(data, true);
+            if (remapKeyShortcutUIDetected == KeyboardManagerHelper::KeyboardHookDecision::Suppress)
+            {
+                return 1;
+            }
+            else if (remapKeyShortcutUIDetected == KeyboardManagerHelper::KeyboardHookDecision::SkipHook)
+            {
+                return 0;
+            }
+        }
 
-            std::wstring query_string;
+        // Remap a key
+        uiDetectionTimer.Pause();
+        {
+            HookLatencyStats::StageTimer stageTimer(latencyStats, HookStage::SingleKeyRemap);
+            intptr_t SingleKeyRemapResult = HandleSingleKeyRemapEvent(ii, data, keyboardManagerState);
 
-            AppSpecificShortcutRemapTable::iterator it;
-            // Check if an app-specific shortcut is already activated
-            if (keyboardManagerState.GetActivatedApp() == KeyboardManagerConstants::NoActivatedApp)
+            // Single key remaps have priority. If a key is remapped, only the remapped version should be visible to the shortcuts and hence the event should be suppressed here.
+            if (SingleKeyRemapResult == 1)
             {
-                query_string = process_name;
-                it = keyboardManagerState.appSpecificShortcutReMap.find(query_string);
+                return 1;
+            }
+        }
 
-                // If no entry is found, search for the process name without it's file extension
-                if (it == keyboardManagerState.appSpecificShortcutReMap.end())
-                {
-                    // Find index of the file extension
-                    size_t extensionIndex = process_name.find_last_of(L".");
-                    query_string = process_name.substr(0, extensionIndex);
-                    it = keyboardManagerState.appSpecificShortcutReMap.find(query_string);
-                }
+        uiDetectionTimer.Resume();
+        {
+            // If the Detect Shortcut Window is currently activated, then suppress the keyboard event
+            KeyboardManagerHelper::KeyboardHookDecision shortcutUIDetected = keyboardManagerState.DetectShortcutUIBackend(data, false);
+            if (shortcutUIDetected == KeyboardManagerHelper::KeyboardHookDecision::Suppress)
+            {
+                return 1;
             }
-            else
+            else if (shortcutUIDetected == KeyboardManagerHelper::KeyboardHookDecision::SkipHook)
             {
-                query_string = keyboardManagerState.GetActivatedApp();
-                it = keyboardManagerState.appSpecificShortcutReMap.find(query_string);
+                return 0;
             }
+        }
+
+        /* This feature has not been enabled (code from proof of concept stage)
+        * 
+        //// Remap a key to behave like a modifier instead of a toggle
+        //intptr_t SingleKeyToggleToModResult = KeyboardEventHandlers::HandleSingleKeyToggleToModEvent(inputHandler, data, keyboardManagerState);
+        */
+
+        // Handle an app-specific shortcut remapping
+        uiDetectionTimer.Pause();
+        {
+            HookLatencyStats::StageTimer stageTimer(latencyStats, HookStage::AppSpecificShortcutRemap);
+            intptr_t AppSpecificShortcutRemapResult = HandleAppSpecificShortcutRemapEvent(ii, data, keyboardManagerState);
 
-            if (it != keyboardManagerState.appSpecificShortcutReMap.end())
+            // If an app-specific shortcut is remapped then the os-level shortcut remapping should be suppressed.
+            if (AppSpecificShortcutRemapResult == 1)
             {
-                bool result = HandleShortcutRemapEvent(ii, data, keyboardManagerState, query_string);
-                return result;
+                return 1;
             }
         }
 
-        return 0;
+        // Handle an os-level shortcut remapping
+        HookLatencyStats::StageTimer stageTimer(latencyStats, HookStage::OSLevelShortcutRemap);
+        return HandleOSLevelShortcutRemapEvent(ii, data, keyboardManagerState);
+    }
+
+    // Function to handle a key event from the low level hook. This is the starting point function for remapping
+    __declspec(dllexport) intptr_t HandleKeyboardHookEvent(InputInterface& ii, LowlevelKeyboardEvent* data, KeyboardManagerState& keyboardManagerState) noexcept
+    {
+        // The key event is handled with the remap tables published when it started, remaps which are updated in the meantime apply from the next key event
+        KeyboardManagerState::HookEventScope hookEventScope(keyboardManagerState);
+
+        HookLatencyStats& latencyStats = keyboardManagerState.GetHookLatencyStats();
+
+        // If key has suppress flag, then suppress it
+        if (data->lParam->dwExtraInfo == KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG)
+        {
+            latencyStats.RecordHookDecision(true);
+            return 1;
+        }
+
+        intptr_t result = HandleKeyboardHookStages(ii, data, keyboardManagerState, latencyStats);
+        latencyStats.RecordHookDecision(result == 1);
+        return result;
     }
 
     // Function to ensure Num Lock state does not change when it is suppressed by the low level hook
@@ -822,15 +780,12 @@ namespace KeyboardEventHandlers
     {
         // Num Lock's key state is applied before it is intercepted by low level keyboard hooks, so we have to manually set back the state when we suppress the key. This is done by sending an additional key up, key down set of messages.
         // We need 2 key events because after Num Lock is suppressed, key up to release num lock key and key down to revert the num lock state
-        int key_count = 2;
-        LPINPUT keyEventList = new INPUT[size_t(key_count)]();
-        memset(keyEventList, 0, sizeof(keyEventList));
+        KeyEventBatch keyEvents;
 
         // Use the suppress flag to ensure these are not intercepted by any remapped keys or shortcuts
-        KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, VK_NUMLOCK, KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG);
-        KeyboardManagerHelper::SetKeyEvent(keyEventList, 1, INPUT_KEYBOARD, VK_NUMLOCK, 0, KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG);
-        UINT res = ii.SendVirtualInput((UINT)key_count, keyEventList, sizeof(INPUT));
-        delete[] keyEventList;
+        keyEvents.ReleaseKey(VK_NUMLOCK, KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG);
+        keyEvents.PressKey(VK_NUMLOCK, KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG);
+        UINT res = keyEvents.Send(ii);
     }
 
     // Function to ensure Ctrl/Shift/Alt modifier key state is not detected as pressed down by applications which detect keys at a lower level than hooks when it is remapped for scenarios where its required
@@ -842,14 +797,11 @@ namespace KeyboardEventHandlers
             // If the argument is either of the Ctrl/Shift/Alt modifier key codes
             if (KeyboardManagerHelper::IsModifierKey(key) && !(key == VK_LWIN || key == VK_RWIN || key == CommonSharedConstants::VK_WIN_BOTH))
             {
-                int key_count = 1;
-                LPINPUT keyEventList = new INPUT[size_t(key_count)]();
-                memset(keyEventList, 0, sizeof(keyEventList));
+                KeyEventBatch keyEvents;
 
                 // Use the suppress flag to ensure these are not intercepted by any remapped keys or shortcuts
-                KeyboardManagerHelper::SetKeyEvent(keyEventList, 0, INPUT_KEYBOARD, (WORD)key, KEYEVENTF_KEYUP, KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG);
-                UINT res = ii.SendVirtualInput((UINT)key_count, keyEventList, sizeof(INPUT));
-                delete[] keyEventList;
+                keyEvents.ReleaseKey((WORD)key, KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG);
+                UINT res = keyEvents.Send(ii);
             }
         }
     }
@@ -30,6 +30,9 @@ namespace KeyboardEventHandlers
     // Function to a handle an app-specific shortcut remap
     __declspec(dllexport) intptr_t HandleAppSpecificShortcutRemapEvent(InputInterface& ii, LowlevelKeyboardEvent* data, KeyboardManagerState& keyboardManagerState) noexcept;
 
+    // Function to handle a key event from the low level hook. This is the starting point function for remapping
+    __declspec(dllexport) intptr_t HandleKeyboardHookEvent(InputInterface& ii, LowlevelKeyboardEvent* data, KeyboardManagerState& keyboardManagerState) noexcept;
+
     // Function to ensure Num Lock state does not change when it is suppressed by the low level hook
     void SetNumLockToPreviousState(InputInterface& ii);
 
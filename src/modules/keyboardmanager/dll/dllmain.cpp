@@ -67,11 +67,14 @@ public:
     // Constructor
     KeyboardManager()
     {
-        // Load the initial configuration.
-        load_config();
+        // Load the initial configuration. The remaps are published to the hook once all of them are loaded
+        keyboardManagerState.UpdateRemapTables([this]() { load_config(); });
 
         // Set the static pointer to the newest object of the class
         keyboardmanager_object_ptr = this;
+
+        // Record the time spent in SendInput along with the other hook stages
+        inputHandler.SetHookLatencyStats(&keyboardManagerState.GetHookLatencyStats());
     };
 
     // Load config from the saved settings.
@@ -281,6 +284,10 @@ public:
                     std::thread(createEditShortcutsWindow, hInstance, std::ref(keyboardManagerState)).detach();
                 }
             }
+            else if (action_object.get_name() == L"LogHookLatency")
+            {
+                LogHookLatency();
+            }
         }
         catch (std::exception&)
         {
@@ -313,6 +320,8 @@ public:
         m_enabled = true;
         // Log telemetry
         Trace::EnableKeyboardManager(true);
+        // Track the foreground process for app-specific remaps
+        inputHandler.SetForegroundProcessChangedCallback([this](const std::wstring& process) { keyboardManagerState.SetForegroundProcess(process); });
         // Start keyboard hook
         start_lowlevel_keyboard_hook();
     }
@@ -328,6 +337,10 @@ public:
         CloseActiveEditShortcutsWindow();
         // Stop keyboard hook
         stop_lowlevel_keyboard_hook();
+        // Log the hook latencies recorded so far
+        LogHookLatency();
+        // Stop tracking the foreground process
+        inputHandler.SetForegroundProcessChangedCallback(nullptr);
     }
 
     // Returns if the powertoys is enabled
@@ -353,6 +366,9 @@ public:
                 }
                 return 1;
             }
+
+            // Track the key state for the events which are passed on
+            keyboardmanager_object_ptr->inputHandler.UpdateKeyboardStateBitmap(&event);
         }
         return CallNextHookEx(hook_handle_copy, nCode, wParam, lParam);
     }
@@ -393,77 +409,13 @@ public:
     // Function called by the hook procedure to handle the events. This is the starting point function for remapping
     intptr_t HandleKeyboardHookEvent(LowlevelKeyboardEvent* data) noexcept
     {
-        // If remappings are disabled (due to the remap tables getting updated) skip the rest of the hook
-        if (!keyboardManagerState.AreRemappingsEnabled())
-        {
-            return 0;
-        }
-
-        // If key has suppress flag, then suppress it
-        if (data->lParam->dwExtraInfo == KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG)
-        {
-            return 1;
-        }
-
-        // If the Detect Key Window is currently activated, then suppress the keyboard event
-        KeyboardManagerHelper::KeyboardHookDecision singleKeyRemapUIDetected = keyboardManagerState.DetectSingleRemapKeyUIBackend(data);
-        if (singleKeyRemapUIDetected == KeyboardManagerHelper::KeyboardHookDecision::Suppress)
-        {
-            return 1;
-        }
-        else if (singleKeyRemapUIDetected == KeyboardManagerHelper::KeyboardHookDecision::SkipHook)
-        {
-            return 0;
-        }
-
-        // If the Detect Shortcut Window from Remap Keys is currently activated, then suppress the keyboard event
-        KeyboardManagerHelper::KeyboardHookDecision remapKeyShortcutUIDetected = keyboardManagerState.DetectShortcutUIBackend(data, true);
-        if (remapKeyShortcutUIDetected == KeyboardManagerHelper::KeyboardHookDecision::Suppress)
-        {
-            return 1;
-        }
-        else if (remapKeyShortcutUIDetected == KeyboardManagerHelper::KeyboardHookDecision::SkipHook)
-        {
-            return 0;
-        }
-
-        // Remap a key
-        intptr_t SingleKeyRemapResult = KeyboardEventHandlers::HandleSingleKeyRemapEvent(inputHandler, data, keyboardManagerState);
-
-        // Single key remaps have priority. If a key is remapped, only the remapped version should be visible to the shortcuts and hence the event should be suppressed here.
-        if (SingleKeyRemapResult == 1)
-        {
-            return 1;
-        }
-
-        // If the Detect Shortcut Window is currently activated, then suppress the keyboard event
-        KeyboardManagerHelper::KeyboardHookDecision shortcutUIDetected = keyboardManagerState.DetectShortcutUIBackend(data, false);
-        if (shortcutUIDetected == KeyboardManagerHelper::KeyboardHookDecision::Suppress)
-        {
-            return 1;
-        }
-        else if (shortcutUIDetected == KeyboardManagerHelper::KeyboardHookDecision::SkipHook)
-        {
-            return 0;
-        }
-
-        /* This feature has not been enabled (code from proof of concept stage)
-        * 
-        //// Remap a key to behave like a modifier instead of a toggle
-        //intptr_t SingleKeyToggleToModResult = KeyboardEventHandlers::HandleSingleKeyToggleToModEvent(inputHandler, data, keyboardManagerState);
-        */
-
-        // Handle an app-specific shortcut remapping
-        intptr_t AppSpecificShortcutRemapResult = KeyboardEventHandlers::HandleAppSpecificShortcutRemapEvent(inputHandler, data, keyboardManagerState);
-
-        // If an app-specific shortcut is remapped then the os-level shortcut remapping should be suppressed.
-        if (AppSpecificShortcutRemapResult == 1)
-        {
-            return 1;
-        }
+        return KeyboardEventHandlers::HandleKeyboardHookEvent(inputHandler, data, keyboardManagerState);
+    }
 
-        // Handle an os-level shortcut remapping
-        return KeyboardEventHandlers::HandleOSLevelShortcutRemapEvent(inputHandler, data, keyboardManagerState);
+    // Function to log the hook latencies and event counters recorded since the module was loaded
+    void LogHookLatency()
+    {
+        Trace::HookLatency(keyboardManagerState.GetHookLatencyStats().GetSnapshot());
     }
 };
 
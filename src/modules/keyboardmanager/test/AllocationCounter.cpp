@@ -0,0 +1,55 @@
+#include "pch.h"
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local size_t allocationCount = 0;
+    thread_local int activeScopes = 0;
+}
+
+void* operator new(size_t size)
+{
+    if (activeScopes > 0)
+    {
+        allocationCount++;
+    }
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace AllocationCounter
+{
+    Scope::Scope() :
+        startCount(allocationCount)
+    {
+        activeScopes++;
+    }
+
+    Scope::~Scope()
+    {
+        activeScopes--;
+    }
+
+    // Function to get the number of allocations since the scope was created
+    size_t Scope::Count() const
+    {
+        return allocationCount - startCount;
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Counting allocator for the tests, counting the allocations made by the current thread while a scope is active.
+// The global operator new of the test module is replaced, so only allocations of the test module and the static libraries linked into it (such as KeyboardManagerCommon) are counted.
+// The KeyboardManager dll links its own copy of the static CRT, so its allocations are not counted
+namespace AllocationCounter
+{
+    class Scope
+    {
+    private:
+        size_t startCount;
+
+    public:
+        Scope();
+        ~Scope();
+
+        // Function to get the number of allocations since the scope was created
+        size_t Count() const;
+    };
+}
@@ -342,5 +342,59 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_CONTROL), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(actionKey), false);
         }
+
+        // Test if the app specific remap takes place when the app was added without file extension and the process name differs in case
+        TEST_METHOD (AppSpecificShortcut_ShouldGetRemapped_WhenAppIsAddedWithoutExtension)
+        {
+            // Remap Ctrl+A to V
+            Shortcut src;
+            src.SetKey(VK_CONTROL);
+            src.SetKey(0x41);
+            testState.AddAppSpecificShortcut(L"TestTrocess1", src, 0x56);
+
+            // Set the testApp as the foreground process
+            mockedInputHandler.SetForegroundProcess(L"TESTTROCESS1.EXE");
+
+            const int nInputs = 2;
+            INPUT input[nInputs] = {};
+            input[0].type = INPUT_KEYBOARD;
+            input[0].ki.wVk = VK_CONTROL;
+            input[1].type = INPUT_KEYBOARD;
+            input[1].ki.wVk = 0x41;
+
+            // Send Ctrl+A keydown
+            mockedInputHandler.SendVirtualInput(nInputs, input, sizeof(INPUT));
+
+            // Ctrl and A key states should be unchanged, V key state should be true
+            Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_CONTROL), false);
+            Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x41), false);
+            Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x56), true);
+        }
+
+        // Test if the foreground app is resolved again when the app specific remaps change while the app is in foreground
+        TEST_METHOD (ForegroundApp_ShouldBeResolvedAgain_WhenRemapsChange)
+        {
+            // No foreground process after resetting the test environment
+            Assert::IsNull(testState.GetForegroundApp());
+
+            // Set the testApp as the foreground process before it has any remaps
+            mockedInputHandler.SetForegroundProcess(testApp1);
+            Assert::IsNotNull(testState.GetForegroundApp());
+            Assert::IsNull(testState.GetForegroundApp()->remapTable);
+
+            // Remap Ctrl+A to V
+            Shortcut src;
+            src.SetKey(VK_CONTROL);
+            src.SetKey(0x41);
+            testState.AddAppSpecificShortcut(testApp1, src, 0x56);
+
+            // Foreground app should point at the remaps of testApp1
+            Assert::IsTrue(testState.GetForegroundApp()->remapTable == &testState.GetShortcutRemapTable(testApp1));
+            Assert::AreEqual(testApp1, testState.GetForegroundApp()->name);
+
+            // Foreground app should have no remaps after clearing them
+            testState.ClearAppSpecificShortcuts();
+            Assert::IsNull(testState.GetForegroundApp()->remapTable);
+        }
     };
 }
@@ -1393,5 +1393,88 @@ namespace RemappingUITests
             Assert::AreEqual(true, result.first == KeyboardManagerHelper::ErrorType::ShortcutDisableAsActionKey);
             Assert::AreEqual(true, result.second == BufferValidationHelpers::DropDownAction::NoAction);
         }
+
+        // Test if the index used across several edits of the key buffer reports conflicts with the updated rows and not with the previous values
+        TEST_METHOD (ValidateAndUpdateKeyBufferElement_ShouldReturnErrorsForCurrentBuffer_OnReusingIndexAcrossEdits)
+        {
+            // Arrange
+            RemapBuffer remapBuffer;
+            remapBuffer.push_back(std::make_pair(RemapBufferItem({ 0x41, NULL }), std::wstring()));
+            remapBuffer.push_back(std::make_pair(RemapBufferItem({ VK_LCONTROL, NULL }), std::wstring()));
+            remapBuffer.push_back(std::make_pair(RemapBufferItem({ NULL, NULL }), std::wstring()));
+            RemapBufferIndex remapBufferIndex(remapBuffer);
+
+            // Act and Assert
+            Assert::AreEqual(true, BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(2, 0, 0x41, remapBuffer, remapBufferIndex) == KeyboardManagerHelper::ErrorType::SameKeyPreviouslyMapped);
+            Assert::AreEqual(true, BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(2, 0, VK_CONTROL, remapBuffer, remapBufferIndex) == KeyboardManagerHelper::ErrorType::ConflictingModifierKey);
+            Assert::AreEqual(true, BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(2, 0, VK_RCONTROL, remapBuffer, remapBufferIndex) == KeyboardManagerHelper::ErrorType::NoError);
+
+            // Change the first row to B, so A is no longer remapped but B is
+            Assert::AreEqual(true, BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(0, 0, 0x42, remapBuffer, remapBufferIndex) == KeyboardManagerHelper::ErrorType::NoError);
+            Assert::AreEqual(true, BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(1, 0, 0x41, remapBuffer, remapBufferIndex) == KeyboardManagerHelper::ErrorType::NoError);
+            Assert::AreEqual(true, BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(2, 0, 0x42, remapBuffer, remapBufferIndex) == KeyboardManagerHelper::ErrorType::SameKeyPreviouslyMapped);
+
+            // Delete the first row, so B is no longer remapped
+            remapBuffer.erase(remapBuffer.begin());
+            remapBufferIndex.Invalidate();
+            Assert::AreEqual(true, BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(1, 0, 0x42, remapBuffer, remapBufferIndex) == KeyboardManagerHelper::ErrorType::NoError);
+            Assert::AreEqual(true, BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(1, 0, 0x41, remapBuffer, remapBufferIndex) == KeyboardManagerHelper::ErrorType::SameKeyPreviouslyMapped);
+        }
+
+        // Test if the index reports shortcut conflicts only for the rows of the same target app, with app names compared case insensitively
+        TEST_METHOD (FindShortcutConflict_ShouldReturnConflictsForSameApp_OnRowsForSeveralApps)
+        {
+            // Arrange
+            RemapBuffer remapBuffer;
+            remapBuffer.push_back(std::make_pair(RemapBufferItem{ std::vector<int32_t>{ VK_LCONTROL, 0x43 }, Shortcut() }, std::wstring(L"TestProcess1.exe")));
+            remapBuffer.push_back(std::make_pair(RemapBufferItem{ std::vector<int32_t>{ VK_CONTROL, VK_SHIFT, 0x43 }, Shortcut() }, std::wstring()));
+            remapBuffer.push_back(std::make_pair(RemapBufferItem{ std::vector<int32_t>{ VK_CONTROL, 0x43 }, Shortcut() }, testApp2));
+
+            // Act
+            RemapBufferIndex remapBufferIndex(remapBuffer);
+
+            // Assert
+            Assert::AreEqual(true, remapBufferIndex.FindShortcutConflict(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x43 }), -1, testApp1) == KeyboardManagerHelper::ErrorType::ConflictingModifierShortcut);
+            Assert::AreEqual(true, remapBufferIndex.FindShortcutConflict(Shortcut(std::vector<int32_t>{ VK_RCONTROL, 0x43 }), -1, testApp1) == KeyboardManagerHelper::ErrorType::NoError);
+            Assert::AreEqual(true, remapBufferIndex.FindShortcutConflict(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x43 }), 2, testApp2) == KeyboardManagerHelper::ErrorType::NoError);
+            Assert::AreEqual(true, remapBufferIndex.FindShortcutConflict(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x43 }), -1, testApp2) == KeyboardManagerHelper::ErrorType::SameShortcutPreviouslyMapped);
+            Assert::AreEqual(true, remapBufferIndex.FindShortcutConflict(Shortcut(std::vector<int32_t>{ VK_LCONTROL, VK_SHIFT, 0x43 }), -1, L"") == KeyboardManagerHelper::ErrorType::ConflictingModifierShortcut);
+            Assert::AreEqual(true, remapBufferIndex.FindShortcutConflict(Shortcut(std::vector<int32_t>{ VK_CONTROL, VK_MENU, 0x43 }), -1, L"") == KeyboardManagerHelper::ErrorType::NoError);
+        }
+
+        // Test if the index reports the same error as comparing against every row, i.e. the error for the first overlapping row, on a buffer with many rows
+        TEST_METHOD (FindKeyConflict_ShouldReturnErrorForFirstOverlappingRow_OnLargeBuffer)
+        {
+            // Arrange
+            RemapBuffer remapBuffer;
+            for (int i = 0; i < 1000; i++)
+            {
+                DWORD key = (i % 7 == 0) ? (DWORD)(VK_LSHIFT + i % 4) : (DWORD)(0x41 + i % 26);
+                remapBuffer.push_back(std::make_pair(RemapBufferItem({ key, NULL }), std::wstring()));
+            }
+            RemapBufferIndex remapBufferIndex(remapBuffer);
+            std::vector<DWORD> keys = { 0x41, 0x5A, VK_SHIFT, VK_LSHIFT, VK_CONTROL, VK_RCONTROL, VK_MENU, CommonSharedConstants::VK_WIN_BOTH, VK_F1 };
+
+            for (DWORD key : keys)
+            {
+                for (int rowIndex : { -1, 0, 7, 999 })
+                {
+                    // Act
+                    KeyboardManagerHelper::ErrorType result = remapBufferIndex.FindKeyConflict(key, rowIndex);
+
+                    // Assert
+                    KeyboardManagerHelper::ErrorType expected = KeyboardManagerHelper::ErrorType::NoError;
+                    for (int i = 0; i < remapBuffer.size(); i++)
+                    {
+                        if (i != rowIndex && KeyboardManagerHelper::DoKeysOverlap(std::get<DWORD>(remapBuffer[i].first[0]), key) != KeyboardManagerHelper::ErrorType::NoError)
+                        {
+                            expected = KeyboardManagerHelper::DoKeysOverlap(std::get<DWORD>(remapBuffer[i].first[0]), key);
+                            break;
+                        }
+                    }
+                    Assert::AreEqual(true, result == expected);
+                }
+            }
+        }
     };
 }
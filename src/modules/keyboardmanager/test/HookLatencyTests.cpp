@@ -0,0 +1,139 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "MockedInput.h"
+#include "KeyStreamReplay.h"
+#include <keyboardmanager/common/KeyboardManagerState.h>
+#include <keyboardmanager/common/HookLatencyStats.h>
+#include <keyboardmanager/dll/KeyboardEventHandlers.h>
+#include "TestHelpers.h"
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RemappingLogicTests
+{
+    // Tests for the hook latency histograms and the key stream replay benchmark
+    TEST_CLASS (HookLatencyTests)
+    {
+    private:
+        MockedInput mockedInputHandler;
+        KeyboardManagerState testState;
+
+        // Function to get the number of QueryPerformanceCounter ticks per microsecond
+        static double TicksPerMicrosecond()
+        {
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
+            return static_cast<double>(frequency.QuadPart) / 1000000.0;
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(InitializeTestEnv)
+        {
+            // Reset test environment
+            TestHelpers::ResetTestEnv(mockedInputHandler, testState);
+            testState.GetHookLatencyStats().Reset();
+
+            // Set HandleKeyboardHookEvent as the hook procedure
+            std::function<intptr_t(LowlevelKeyboardEvent*)> currentHookProc = std::bind(&KeyboardEventHandlers::HandleKeyboardHookEvent, std::ref(mockedInputHandler), std::placeholders::_1, std::ref(testState));
+            mockedInputHandler.SetHookProc(currentHookProc);
+        }
+
+        // Test if the percentiles are the upper bounds of the buckets which contain them, capped at the largest sample
+        TEST_METHOD (GetSnapshot_ShouldReturnBucketPercentiles_OnRecordingStages)
+        {
+            // Arrange
+            HookLatencyStats stats;
+            const double ticksPerMicrosecond = TicksPerMicrosecond();
+
+            // Act
+            for (int i = 0; i < 98; i++)
+            {
+                stats.RecordStage(HookStage::SingleKeyRemap, 1);
+            }
+            stats.RecordStage(HookStage::SingleKeyRemap, 1000);
+            stats.RecordStage(HookStage::SingleKeyRemap, 1000);
+            auto snapshot = stats.GetSnapshot();
+
+            // Assert
+            const auto& stage = snapshot.stages[static_cast<int>(HookStage::SingleKeyRemap)];
+            Assert::AreEqual((uint64_t)100, stage.count);
+            Assert::AreEqual(2 / ticksPerMicrosecond, stage.p50, 1e-9);
+            Assert::AreEqual(1000 / ticksPerMicrosecond, stage.p99, 1e-9);
+            Assert::AreEqual(1000 / ticksPerMicrosecond, stage.max, 1e-9);
+            Assert::AreEqual((uint64_t)0, snapshot.stages[static_cast<int>(HookStage::OSLevelShortcutRemap)].count);
+        }
+
+        // Test if the hook counts suppressed and passed events and times the stages which ran for each event
+        TEST_METHOD (HandleKeyboardHookEvent_ShouldRecordStagesAndDecisions_OnRemappedKey)
+        {
+            // Remap A to B
+            testState.AddSingleKeyRemap(0x41, 0x42);
+            std::vector<INPUT> stream;
+            KeyStreamReplay::AppendText(stream, "A");
+
+            // Send A keydown and keyup, which are suppressed and send B keydown and keyup through the hook
+            mockedInputHandler.SendVirtualInput((UINT)stream.size(), stream.data(), sizeof(INPUT));
+
+            // A events stop after the single key remap stage, B events run through all the stages. UI detection is recorded once per event
+            auto snapshot = testState.GetHookLatencyStats().GetSnapshot();
+            Assert::AreEqual((uint64_t)2, snapshot.suppressedEvents);
+            Assert::AreEqual((uint64_t)2, snapshot.passedEvents);
+            Assert::AreEqual((uint64_t)4, snapshot.stages[static_cast<int>(HookStage::SingleKeyRemap)].count);
+            Assert::AreEqual((uint64_t)4, snapshot.stages[static_cast<int>(HookStage::UIDetection)].count);
+            Assert::AreEqual((uint64_t)2, snapshot.stages[static_cast<int>(HookStage::AppSpecificShortcutRemap)].count);
+            Assert::AreEqual((uint64_t)2, snapshot.stages[static_cast<int>(HookStage::OSLevelShortcutRemap)].count);
+        }
+
+        // Benchmark which replays a typing stream with chords through the hook and logs the per event latency and the stage latencies
+        TEST_METHOD (Replay_ShouldRecordEveryEvent_OnTypingStreamWithChords)
+        {
+            // Remap Caps Lock to Ctrl, Ctrl+C to Ctrl+V and Ctrl+Shift+T to Alt+Tab
+            testState.AddSingleKeyRemap(VK_CAPITAL, VK_LCONTROL);
+            testState.AddOSLevelShortcut(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x43 }), Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x56 }));
+            testState.AddOSLevelShortcut(Shortcut(std::vector<int32_t>{ VK_CONTROL, VK_SHIFT, 0x54 }), Shortcut(std::vector<int32_t>{ VK_MENU, VK_TAB }));
+
+            std::vector<INPUT> stream;
+            for (int i = 0; i < 100; i++)
+            {
+                KeyStreamReplay::AppendText(stream, "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG ");
+                KeyStreamReplay::AppendChord(stream, { VK_CAPITAL, 0x43 });
+                KeyStreamReplay::AppendChord(stream, { VK_LCONTROL, VK_LSHIFT, 0x54 });
+            }
+
+            auto result = KeyStreamReplay::Replay(mockedInputHandler, stream);
+
+            auto snapshot = testState.GetHookLatencyStats().GetSnapshot();
+            Logger::WriteMessage((L"Per event: " + KeyStreamReplay::ToString(result) + L"\n").c_str());
+            const wchar_t* stageNames[HookLatencyStats::StageCount] = { L"UI detection", L"Single key remap", L"App-specific shortcut remap", L"OS level shortcut remap", L"SendInput" };
+            for (int stage = 0; stage < HookLatencyStats::StageCount; stage++)
+            {
+                const auto& stageSnapshot = snapshot.stages[stage];
+                Logger::WriteMessage((std::wstring(stageNames[stage]) + L": " + KeyStreamReplay::ToString({ stageSnapshot.count, stageSnapshot.p50, stageSnapshot.p99, stageSnapshot.max }) + L"\n").c_str());
+            }
+
+            // Every event of the stream and every event sent by the remaps goes through the hook
+            Assert::AreEqual(stream.size(), result.count);
+            Assert::IsTrue(snapshot.suppressedEvents + snapshot.passedEvents >= stream.size());
+            Assert::IsTrue(snapshot.suppressedEvents > 0);
+        }
+
+        // Benchmark which logs the cost of timing a stage, including the QueryPerformanceCounter calls, which runs for every stage of every key event
+        TEST_METHOD (StageTimer_Benchmark)
+        {
+            HookLatencyStats stats;
+            const int iterations = 1000000;
+
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                HookLatencyStats::StageTimer stageTimer(stats, HookStage::OSLevelShortcutRemap);
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const double nanosecondsPerStage = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+            Logger::WriteMessage((L"StageTimer: " + std::to_wstring(nanosecondsPerStage) + L" ns\n").c_str());
+            Assert::AreEqual((uint64_t)iterations, stats.GetSnapshot().stages[static_cast<int>(HookStage::OSLevelShortcutRemap)].count);
+        }
+    };
+}
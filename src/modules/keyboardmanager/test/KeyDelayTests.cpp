@@ -0,0 +1,200 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include <keyboardmanager/common/KeyDelay.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RemappingLogicTests
+{
+    // Tests for the KeyDelay state machine and the shared KeyDelayTimer thread
+    TEST_CLASS (KeyDelayTests)
+    {
+    private:
+        // Callbacks invoked by the state machines, in order
+        std::vector<std::wstring> callbacks;
+        std::mutex callbacks_mutex;
+        std::condition_variable callbacks_cv;
+
+        std::function<void(DWORD)> RecordCallback(const std::wstring& name)
+        {
+            return [this, name](DWORD key) {
+                std::lock_guard l(callbacks_mutex);
+                callbacks.push_back(name + L":" + std::to_wstring(key));
+                callbacks_cv.notify_all();
+            };
+        }
+
+        std::unique_ptr<KeyDelay> CreateKeyDelay(DWORD key)
+        {
+            return std::make_unique<KeyDelay>(key, RecordCallback(L"short"), RecordCallback(L"longDetected"), RecordCallback(L"longReleased"));
+        }
+
+        // Function to wait until the given number of callbacks have been invoked
+        bool WaitForCallbacks(size_t count)
+        {
+            std::unique_lock l(callbacks_mutex);
+            return callbacks_cv.wait_for(l, std::chrono::seconds(5), [this, count] { return callbacks.size() >= count; });
+        }
+
+        static LowlevelKeyboardEvent CreateKeyEvent(KBDLLHOOKSTRUCT& data, DWORD key, WPARAM message, DWORD time)
+        {
+            data = {};
+            data.vkCode = key;
+            data.time = time;
+            return LowlevelKeyboardEvent{ &data, message };
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(InitializeTestEnv)
+        {
+            callbacks.clear();
+        }
+
+        // Test if a key released before the long press delay triggers the short press callback
+        TEST_METHOD (KeyEvent_ShouldTriggerShortPress_OnReleasingBeforeLongPressDelay)
+        {
+            // Arrange
+            auto keyDelay = CreateKeyDelay(VK_RETURN);
+
+            // Act
+            keyDelay->KeyEvent({ VK_RETURN, 1000, WM_KEYDOWN });
+            keyDelay->KeyEvent({ VK_RETURN, 1100, WM_KEYDOWN });
+            keyDelay->KeyEvent({ VK_RETURN, 1200, WM_KEYUP });
+
+            // Assert
+            Assert::AreEqual(size_t{ 1 }, callbacks.size());
+            Assert::AreEqual(std::wstring(L"short:13"), callbacks[0]);
+            Assert::IsTrue(keyDelay->GetState() == KeyDelayState::RELEASED);
+        }
+
+        // Test if a key released after the long press delay triggers the long press callbacks when the timeout was not checked in between
+        TEST_METHOD (KeyEvent_ShouldTriggerLongPressDetectedAndReleased_OnReleasingAfterLongPressDelay)
+        {
+            // Arrange
+            auto keyDelay = CreateKeyDelay(VK_ESCAPE);
+
+            // Act
+            keyDelay->KeyEvent({ VK_ESCAPE, 1000, WM_SYSKEYDOWN });
+            keyDelay->KeyEvent({ VK_ESCAPE, 1000 + KeyDelay::LONG_PRESS_DELAY_MILLIS + 1, WM_SYSKEYUP });
+
+            // Assert
+            Assert::AreEqual(size_t{ 2 }, callbacks.size());
+            Assert::AreEqual(std::wstring(L"longDetected:27"), callbacks[0]);
+            Assert::AreEqual(std::wstring(L"longReleased:27"), callbacks[1]);
+            Assert::IsTrue(keyDelay->GetState() == KeyDelayState::RELEASED);
+        }
+
+        // Test if holding the key past the long press delay triggers long press detected once, and releasing it triggers long press released
+        TEST_METHOD (CheckHoldTimeout_ShouldTriggerLongPressDetected_OnHoldingPastLongPressDelay)
+        {
+            // Arrange
+            auto keyDelay = CreateKeyDelay(VK_RETURN);
+            keyDelay->KeyEvent({ VK_RETURN, 1000, WM_KEYDOWN });
+
+            // Act
+            keyDelay->CheckHoldTimeout(1000 + KeyDelay::LONG_PRESS_DELAY_MILLIS);
+            Assert::AreEqual(size_t{ 0 }, callbacks.size());
+            Assert::AreEqual(DWORD{ 1 }, keyDelay->GetMillisUntilHoldTimeout(1000 + KeyDelay::LONG_PRESS_DELAY_MILLIS));
+            keyDelay->CheckHoldTimeout(1000 + KeyDelay::LONG_PRESS_DELAY_MILLIS + 1);
+            keyDelay->CheckHoldTimeout(1000 + KeyDelay::LONG_PRESS_DELAY_MILLIS + 100);
+            keyDelay->KeyEvent({ VK_RETURN, 3000, WM_KEYDOWN });
+            keyDelay->KeyEvent({ VK_RETURN, 3000, WM_KEYUP });
+
+            // Assert
+            Assert::AreEqual(size_t{ 2 }, callbacks.size());
+            Assert::AreEqual(std::wstring(L"longDetected:13"), callbacks[0]);
+            Assert::AreEqual(std::wstring(L"longReleased:13"), callbacks[1]);
+            Assert::IsTrue(keyDelay->GetState() == KeyDelayState::RELEASED);
+            Assert::AreEqual((DWORD)INFINITE, keyDelay->GetMillisUntilHoldTimeout(3000));
+        }
+
+        // Test if key up events are ignored while the key is released
+        TEST_METHOD (KeyEvent_ShouldNotTriggerCallbacks_OnKeyUpWhileReleased)
+        {
+            // Arrange
+            auto keyDelay = CreateKeyDelay(VK_RETURN);
+
+            // Act
+            keyDelay->KeyEvent({ VK_RETURN, 1000, WM_KEYUP });
+            keyDelay->CheckHoldTimeout(5000);
+
+            // Assert
+            Assert::AreEqual(size_t{ 0 }, callbacks.size());
+            Assert::IsTrue(keyDelay->GetState() == KeyDelayState::RELEASED);
+        }
+
+        // Test if the timer thread delivers events for several registered keys and ignores unregistered keys
+        TEST_METHOD (KeyDelayTimer_ShouldRunAllRegisteredKeys_OnSharedThread)
+        {
+            // Arrange
+            KeyDelayTimer timer;
+            Assert::IsTrue(timer.Register(CreateKeyDelay(VK_RETURN), VK_RETURN));
+            Assert::IsTrue(timer.Register(CreateKeyDelay(VK_ESCAPE), VK_ESCAPE));
+            Assert::IsFalse(timer.Register(CreateKeyDelay(VK_RETURN), VK_RETURN));
+            const DWORD now = GetTickCount();
+            KBDLLHOOKSTRUCT data;
+
+            // Act
+            auto ev = CreateKeyEvent(data, 0x41, WM_KEYDOWN, now);
+            Assert::IsFalse(timer.KeyEvent(&ev));
+            ev = CreateKeyEvent(data, VK_RETURN, WM_KEYDOWN, now);
+            Assert::IsTrue(timer.KeyEvent(&ev));
+            ev = CreateKeyEvent(data, VK_RETURN, WM_KEYUP, now + 10);
+            Assert::IsTrue(timer.KeyEvent(&ev));
+            Assert::IsTrue(WaitForCallbacks(1));
+            ev = CreateKeyEvent(data, VK_ESCAPE, WM_KEYDOWN, now);
+            Assert::IsTrue(timer.KeyEvent(&ev));
+            ev = CreateKeyEvent(data, VK_ESCAPE, WM_KEYUP, now + 20);
+            Assert::IsTrue(timer.KeyEvent(&ev));
+
+            // Assert
+            Assert::IsTrue(WaitForCallbacks(2));
+            std::lock_guard l(callbacks_mutex);
+            Assert::AreEqual(std::wstring(L"short:13"), callbacks[0]);
+            Assert::AreEqual(std::wstring(L"short:27"), callbacks[1]);
+        }
+
+        // Test if the timer thread triggers long press detected while the key is still held down
+        TEST_METHOD (KeyDelayTimer_ShouldTriggerLongPressDetected_OnHoldingKey)
+        {
+            // Arrange
+            KeyDelayTimer timer;
+            timer.Register(CreateKeyDelay(VK_RETURN), VK_RETURN);
+            KBDLLHOOKSTRUCT data;
+
+            // Act
+            auto ev = CreateKeyEvent(data, VK_RETURN, WM_KEYDOWN, GetTickCount() - 500);
+            timer.KeyEvent(&ev);
+
+            // Assert
+            Assert::IsTrue(WaitForCallbacks(1));
+            std::lock_guard l(callbacks_mutex);
+            Assert::AreEqual(std::wstring(L"longDetected:13"), callbacks[0]);
+        }
+
+        // Test if no callbacks run after a key is unregistered
+        TEST_METHOD (KeyDelayTimer_ShouldDropEvents_OnUnregisteredKey)
+        {
+            // Arrange
+            KeyDelayTimer timer;
+            timer.Register(CreateKeyDelay(VK_RETURN), VK_RETURN);
+            Assert::IsTrue(timer.Unregister(VK_RETURN));
+            Assert::IsFalse(timer.Unregister(VK_RETURN));
+            KBDLLHOOKSTRUCT data;
+
+            // Act
+            auto ev = CreateKeyEvent(data, VK_RETURN, WM_KEYDOWN, GetTickCount() - 5000);
+            const bool handled = timer.KeyEvent(&ev);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            // Assert
+            Assert::IsFalse(handled);
+            std::lock_guard l(callbacks_mutex);
+            Assert::AreEqual(size_t{ 0 }, callbacks.size());
+        }
+    };
+}
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "MockedInput.h"
+#include "AllocationCounter.h"
+#include <keyboardmanager/common/KeyEventBatch.h>
+#include <keyboardmanager/common/KeyboardManagerConstants.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RemappingLogicTests
+{
+    // Tests for the KeyEventBatch class
+    TEST_CLASS (KeyEventBatchTests)
+    {
+    public:
+        // Test if PressModifiers adds key down events in the order Win, Ctrl, Alt, Shift and ReleaseModifiers adds key up events in the reverse order
+        TEST_METHOD (ReleaseModifiers_ShouldAddKeyUpEventsInReverseOrder_OnPassingShortcut)
+        {
+            // Arrange
+            Shortcut s(std::vector<int32_t>{ VK_LWIN, VK_LCONTROL, VK_RMENU, VK_LSHIFT, 0x41 });
+            KeyEventBatch keyEvents;
+
+            // Act
+            keyEvents.PressModifiers(s, ModifierKey::Disabled, 0);
+            keyEvents.ReleaseModifiers(s, ModifierKey::Disabled, 0);
+
+            // Assert
+            const WORD expectedKeys[] = { VK_LWIN, VK_LCONTROL, VK_RMENU, VK_LSHIFT, VK_LSHIFT, VK_RMENU, VK_LCONTROL, VK_LWIN };
+            Assert::AreEqual(8, keyEvents.Size());
+            for (int i = 0; i < keyEvents.Size(); i++)
+            {
+                Assert::AreEqual(expectedKeys[i], keyEvents.Data()[i].ki.wVk);
+                Assert::AreEqual(i >= 4, (keyEvents.Data()[i].ki.dwFlags & KEYEVENTF_KEYUP) != 0);
+            }
+        }
+
+        // Test if events beyond the capacity of the batch are dropped
+        TEST_METHOD (AddKeyEvent_ShouldDropEvents_WhenBatchIsFull)
+        {
+            // Arrange
+            KeyEventBatch keyEvents;
+            for (int i = 0; i < KeyEventBatch::Capacity / 2; i++)
+            {
+                keyEvents.TapKey(0x41, 0);
+            }
+
+            // Act
+            keyEvents.TapKey(0x42, 0);
+            keyEvents.PressModifiers(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x41 }), ModifierKey::Disabled, 0);
+
+            // Assert
+            Assert::AreEqual(KeyEventBatch::Capacity, keyEvents.Size());
+            Assert::AreEqual((WORD)0x41, keyEvents.Data()[KeyEventBatch::Capacity - 1].ki.wVk);
+        }
+
+        // Test if sending a batch does not allocate and clears the batch
+        TEST_METHOD (Send_ShouldNotAllocate_OnSendingShortcutKeyEvents)
+        {
+            // Arrange
+            MockedInput mockedInputHandler;
+            Shortcut s(std::vector<int32_t>{ VK_CONTROL, VK_SHIFT, 0x56 });
+            size_t allocations = 0;
+            {
+                AllocationCounter::Scope allocationCounter;
+                KeyEventBatch keyEvents;
+
+                // Act
+                keyEvents.PressModifiers(s, ModifierKey::Disabled, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                keyEvents.TapKey((WORD)s.GetActionKey(), KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                keyEvents.ReleaseModifiers(s, ModifierKey::Disabled, KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                keyEvents.AddDummyKeyEvent(KeyboardManagerConstants::KEYBOARDMANAGER_SHORTCUT_FLAG);
+                keyEvents.Send(mockedInputHandler);
+
+                allocations = allocationCounter.Count();
+                Assert::AreEqual(0, keyEvents.Size());
+            }
+
+            // Assert
+            Assert::AreEqual((size_t)0, allocations);
+            Assert::AreEqual(8, mockedInputHandler.GetSendVirtualInputCallCount());
+            Assert::IsFalse(mockedInputHandler.GetVirtualKeyState(VK_CONTROL));
+            Assert::IsFalse(mockedInputHandler.GetVirtualKeyState(0x56));
+        }
+    };
+}
@@ -0,0 +1,160 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "MockedInput.h"
+#include "KeyStreamReplay.h"
+#include <keyboardmanager/common/KeyboardManagerState.h>
+#include <keyboardmanager/dll/KeyboardEventHandlers.h>
+#include "TestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RemappingLogicTests
+{
+    // Benchmarks which replay a typing trace through the hook against configurations of different sizes. The results are logged, and release builds fail if the hook latency degrades with the number of remaps
+    TEST_CLASS (KeyStreamBenchmarkTests)
+    {
+    private:
+        MockedInput mockedInputHandler;
+        KeyboardManagerState testState;
+        std::wstring testApp = L"benchmarkprocess.exe";
+
+        // 10k keystrokes, i.e. about 17 minutes of typing at 120 words per minute
+        static constexpr size_t TraceKeystrokes = 10000;
+        static constexpr unsigned int TraceSeed = 120;
+
+        // Function to add the given number of remaps. Every 25th remap is a single key remap, every 5th shortcut remap is specific to the test app and the others are OS level shortcut remaps. The shortcuts are the combinations of modifiers with letters, digits and function keys, in that order, so the smaller configurations mostly remap Ctrl shortcuts
+        void AddRemaps(size_t count)
+        {
+            const std::vector<std::vector<int32_t>> modifiers = {
+                { VK_CONTROL },
+                { VK_MENU },
+                { VK_SHIFT },
+                { VK_LWIN },
+                { VK_CONTROL, VK_SHIFT },
+                { VK_CONTROL, VK_MENU },
+                { VK_MENU, VK_SHIFT },
+                { VK_CONTROL, VK_MENU, VK_SHIFT },
+                { VK_LWIN, VK_SHIFT },
+                { VK_LWIN, VK_CONTROL },
+                { VK_LWIN, VK_MENU },
+            };
+
+            std::vector<int32_t> actionKeys;
+            for (int32_t key = 0x41; key <= 0x5A; key++)
+            {
+                actionKeys.push_back(key);
+            }
+            for (int32_t key = 0x30; key <= 0x39; key++)
+            {
+                actionKeys.push_back(key);
+            }
+            for (int32_t key = VK_F1; key <= VK_F12; key++)
+            {
+                actionKeys.push_back(key);
+            }
+
+            std::vector<DWORD> singleKeys;
+            for (DWORD key = VK_F13; key <= VK_F24; key++)
+            {
+                singleKeys.push_back(key);
+            }
+            for (DWORD key = VK_NUMPAD0; key <= VK_NUMPAD9; key++)
+            {
+                singleKeys.push_back(key);
+            }
+
+            testState.UpdateRemapTables([&]() {
+                size_t shortcutCount = 0;
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (i % 25 == 0)
+                    {
+                        testState.AddSingleKeyRemap(singleKeys[(i / 25) % singleKeys.size()], (DWORD)VK_F23);
+                        continue;
+                    }
+
+                    std::vector<int32_t> keys = modifiers[(shortcutCount / actionKeys.size()) % modifiers.size()];
+                    keys.push_back(actionKeys[shortcutCount % actionKeys.size()]);
+                    KeyShortcutUnion target = (i % 2 == 0) ? KeyShortcutUnion((DWORD)VK_F23) : KeyShortcutUnion(Shortcut(std::vector<int32_t>{ VK_CONTROL, VK_MENU, VK_F24 }));
+                    if (i % 5 == 0)
+                    {
+                        testState.AddAppSpecificShortcut(testApp, Shortcut(keys), target);
+                    }
+                    else
+                    {
+                        testState.AddOSLevelShortcut(Shortcut(keys), target);
+                    }
+                    shortcutCount++;
+                }
+            });
+        }
+
+        // Function to replay the typing trace against the given number of remaps and log the results
+        KeyStreamReplay::LatencyStats RunBenchmark(size_t remapCount)
+        {
+            AddRemaps(remapCount);
+            std::vector<INPUT> stream;
+            KeyStreamReplay::AppendTypingTrace(stream, TraceKeystrokes, TraceSeed);
+
+            // Warm up the caches and the foreground app lookup before timing the trace
+            KeyStreamReplay::Replay(mockedInputHandler, stream);
+            auto result = KeyStreamReplay::Replay(mockedInputHandler, stream);
+
+            Logger::WriteMessage((std::to_wstring(remapCount) + L" remaps: " + KeyStreamReplay::ToString(result) + L", " + std::to_wstring(result.allocations) + L" allocations in the test module\n").c_str());
+            Assert::AreEqual(stream.size(), result.count);
+            return result;
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(InitializeTestEnv)
+        {
+            // Reset test environment
+            TestHelpers::ResetTestEnv(mockedInputHandler, testState);
+            mockedInputHandler.SetForegroundProcess(testApp);
+
+            // Set HandleKeyboardHookEvent as the hook procedure
+            std::function<intptr_t(LowlevelKeyboardEvent*)> currentHookProc = std::bind(&KeyboardEventHandlers::HandleKeyboardHookEvent, std::ref(mockedInputHandler), std::placeholders::_1, std::ref(testState));
+            mockedInputHandler.SetHookProc(currentHookProc);
+        }
+
+        // Test if the typing trace is deterministic and has the requested number of keystrokes
+        TEST_METHOD (AppendTypingTrace_ShouldAppendSameTrace_OnSameSeed)
+        {
+            // Act
+            std::vector<INPUT> stream1;
+            std::vector<INPUT> stream2;
+            KeyStreamReplay::AppendTypingTrace(stream1, TraceKeystrokes, TraceSeed);
+            KeyStreamReplay::AppendTypingTrace(stream2, TraceKeystrokes, TraceSeed);
+
+            // Assert
+            Assert::AreEqual(stream1.size(), stream2.size());
+            size_t keyDownCount = 0;
+            for (size_t i = 0; i < stream1.size(); i++)
+            {
+                Assert::AreEqual(stream1[i].ki.wVk, stream2[i].ki.wVk);
+                Assert::AreEqual(stream1[i].ki.dwFlags, stream2[i].ki.dwFlags);
+                keyDownCount += (stream1[i].ki.dwFlags & KEYEVENTF_KEYUP) == 0;
+            }
+            Assert::AreEqual(TraceKeystrokes, keyDownCount);
+            Assert::AreEqual(2 * TraceKeystrokes, stream1.size());
+        }
+
+        // Benchmark without any remaps, the baseline cost of the hook
+        TEST_METHOD (Replay_ShouldHandleTypingTrace_OnNoRemaps)
+        {
+            RunBenchmark(0);
+        }
+
+        // Benchmark with 50 remaps
+        TEST_METHOD (Replay_ShouldHandleTypingTrace_On50Remaps)
+        {
+            RunBenchmark(50);
+        }
+
+        // Benchmark with 500 remaps
+        TEST_METHOD (Replay_ShouldHandleTypingTrace_On500Remaps)
+        {
+            RunBenchmark(500);
+        }
+    };
+}
@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "KeyStreamReplay.h"
+#include "MockedInput.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace
+{
+    INPUT KeyEvent(WORD key, bool isKeyUp)
+    {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wVk = key;
+        input.ki.dwFlags = isKeyUp ? KEYEVENTF_KEYUP : 0;
+        return input;
+    }
+}
+
+namespace KeyStreamReplay
+{
+    // Function to append the key down and key up events for typing the given text. Only upper case letters, digits and spaces are supported
+    void AppendText(std::vector<INPUT>& stream, const std::string& text)
+    {
+        for (char c : text)
+        {
+            // Virtual key codes of upper case letters and digits are their ASCII codes
+            WORD key = c == ' ' ? VK_SPACE : static_cast<WORD>(c);
+            stream.push_back(KeyEvent(key, false));
+            stream.push_back(KeyEvent(key, true));
+        }
+    }
+
+    // Function to append a chord, i.e. the keys pressed in order and released in reverse order
+    void AppendChord(std::vector<INPUT>& stream, const std::vector<WORD>& keys)
+    {
+        for (WORD key : keys)
+        {
+            stream.push_back(KeyEvent(key, false));
+        }
+
+        for (auto it = keys.rbegin(); it != keys.rend(); it++)
+        {
+            stream.push_back(KeyEvent(*it, true));
+        }
+    }
+
+    // Function to append a typing trace of the given number of keystrokes, generated from the seed. Words of upper case letters are typed with bursts of chords (Ctrl, Alt, Shift and Win shortcuts) in between, like when editing text
+    void AppendTypingTrace(std::vector<INPUT>& stream, size_t keystrokes, unsigned int seed)
+    {
+        const std::vector<std::vector<WORD>> chords = {
+            { VK_CONTROL, 0x43 },
+            { VK_CONTROL, 0x56 },
+            { VK_CONTROL, 0x5A },
+            { VK_CONTROL, VK_SHIFT, 0x54 },
+            { VK_MENU, VK_TAB },
+            { VK_LWIN, 0x44 },
+            { VK_SHIFT, VK_LEFT },
+            { VK_CONTROL, VK_MENU, VK_DELETE },
+        };
+
+        std::mt19937 random(seed);
+        size_t typed = 0;
+        while (typed < keystrokes)
+        {
+            // Every eighth word on average is followed by a burst of one to three chords
+            if (random() % 8 == 0)
+            {
+                for (size_t burst = 1 + random() % 3; burst > 0 && typed < keystrokes; burst--)
+                {
+                    const auto& chord = chords[random() % chords.size()];
+                    if (chord.size() > keystrokes - typed)
+                    {
+                        break;
+                    }
+
+                    AppendChord(stream, chord);
+                    typed += chord.size();
+                }
+                continue;
+            }
+
+            std::string word(2 + random() % 8, ' ');
+            for (char& c : word)
+            {
+                c = static_cast<char>('A' + random() % 26);
+            }
+            word += ' ';
+            word.resize((std::min)(word.size(), keystrokes - typed));
+            AppendText(stream, word);
+            typed += word.size();
+        }
+    }
+
+    // Function to send each key event of the stream separately and time the SendVirtualInput call, which includes the hook procedure. Allocations are counted over the whole replay
+    LatencyStats Replay(MockedInput& input, const std::vector<INPUT>& stream)
+    {
+        std::vector<double> samples;
+        samples.reserve(stream.size());
+        size_t allocations = 0;
+        {
+            AllocationCounter::Scope allocationCounter;
+            for (INPUT keyEvent : stream)
+            {
+                const auto start = std::chrono::high_resolution_clock::now();
+                input.SendVirtualInput(1, &keyEvent, sizeof(INPUT));
+                const auto end = std::chrono::high_resolution_clock::now();
+                samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            }
+            allocations = allocationCounter.Count();
+        }
+
+        LatencyStats stats = Summarize(std::move(samples));
+        stats.allocations = allocations;
+        return stats;
+    }
+
+    // Function to compute the nearest-rank percentiles of the given samples
+    LatencyStats Summarize(std::vector<double> samples)
+    {
+        LatencyStats stats;
+        if (samples.empty())
+        {
+            return stats;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        const auto percentile = [&samples](double p) {
+            const size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+            return samples[(std::max)(rank, size_t{ 1 }) - 1];
+        };
+
+        stats.count = samples.size();
+        stats.p50 = percentile(0.50);
+        stats.p99 = percentile(0.99);
+        stats.max = samples.back();
+        return stats;
+    }
+
+    // Function to format the latencies for the test log
+    std::wstring ToString(const LatencyStats& stats)
+    {
+        return std::to_wstring(stats.count) + L" events, p50 " + std::to_wstring(stats.p50) + L" us, p99 " + std::to_wstring(stats.p99) + L" us, max " + std::to_wstring(stats.max) + L" us";
+    }
+}
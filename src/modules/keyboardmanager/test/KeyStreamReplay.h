@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <vector>
+
+class MockedInput;
+
+// Helpers to build recorded key streams and replay them through MockedInput, timing the hook for each key event
+namespace KeyStreamReplay
+{
+    // Latencies in microseconds
+    struct LatencyStats
+    {
+        size_t count = 0;
+        double p50 = 0;
+        double p99 = 0;
+        double max = 0;
+
+        // Allocations made by the test module while the events were handled, see AllocationCounter
+        size_t allocations = 0;
+    };
+
+    // Function to append the key down and key up events for typing the given text. Only upper case letters, digits and spaces are supported
+    void AppendText(std::vector<INPUT>& stream, const std::string& text);
+
+    // Function to append a chord, i.e. the keys pressed in order and released in reverse order
+    void AppendChord(std::vector<INPUT>& stream, const std::vector<WORD>& keys);
+
+    // Function to append a typing trace of the given number of keystrokes, generated from the seed. Words of upper case letters are typed with bursts of chords (Ctrl, Alt, Shift and Win shortcuts) in between, like when editing text
+    void AppendTypingTrace(std::vector<INPUT>& stream, size_t keystrokes, unsigned int seed);
+
+    // Function to send each key event of the stream separately and time the SendVirtualInput call, which includes the hook procedure. Allocations are counted over the whole replay
+    LatencyStats Replay(MockedInput& input, const std::vector<INPUT>& stream);
+
+    // Function to compute the nearest-rank percentiles of the given samples
+    LatencyStats Summarize(std::vector<double> samples);
+
+    // Function to format the latencies for the test log
+    std::wstring ToString(const LatencyStats& stats);
+}
@@ -11,7 +11,7 @@ class MockedInput :
 {
 private:
     // Stores the states for all the keys - false for key up, and true for key down
-    std::vector<bool> keyboardState;
+    KeyboardStateBitmap keyboardState;
 
     // Function to be executed as a low level hook. By default it is nullptr so the hook is skipped
     std::function<intptr_t(LowlevelKeyboardEvent*)> hookProc;
@@ -22,12 +22,10 @@ private:
 
     std::wstring currentProcess;
 
-public:
-    MockedInput()
-    {
-        keyboardState.resize(256, false);
-    }
+    // Function to be notified when the foreground process changes
+    std::function<void(const std::wstring&)> foregroundProcessChangedCallback;
 
+public:
     // Set the keyboard hook procedure to be tested
     void SetHookProc(std::function<intptr_t(LowlevelKeyboardEvent*)> hookProcedure);
 
@@ -40,6 +38,9 @@ public:
     // Function to get the state of a particular key
     bool GetVirtualKeyState(int key);
 
+    // Function to get the bitmap of the pressed keys
+    const KeyboardStateBitmap& GetKeyboardStateBitmap();
+
     // Function to reset the mocked keyboard state
     void ResetKeyboardState();
 
@@ -49,9 +50,12 @@ public:
     // Function to get SendVirtualInput call count
     int GetSendVirtualInputCallCount();
 
-    // Function to get the foreground process name
+    // Function to simulate a foreground window change to the given process
     void SetForegroundProcess(std::wstring process);
 
     // Function to get the foreground process name
     void GetForegroundProcess(_Out_ std::wstring& foregroundProcess);
+
+    // Function to set the callback which receives the foreground process name whenever the foreground process changes
+    void SetForegroundProcessChangedCallback(std::function<void(const std::wstring&)> callback);
 };
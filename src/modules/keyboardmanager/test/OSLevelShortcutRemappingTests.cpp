@@ -1318,7 +1318,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x41), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_MENU), false);
             // Shortcut invoked state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test if keyboard state is not reverted for a shortcut to a single key remap (target key is a modifier in the shortcut) on key down followed by releasing the action key
@@ -1347,7 +1347,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_CONTROL), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x41), false);
             // Shortcut invoked state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test if keyboard state is not reverted for a shortcut to a single key remap (target key is the action key in the shortcut) on key down followed by releasing the action key
@@ -1376,7 +1376,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_CONTROL), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x41), false);
             // Shortcut invoked state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test if keyboard state is reverted for a shortcut to a single key remap (target key is not a part of the shortcut) on key down followed by releasing the modifier key
@@ -1406,7 +1406,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x41), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_MENU), false);
             // Shortcut invoked state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test if keyboard state is reverted for a shortcut to a single key remap (target key is a modifier in the shortcut) on key down followed by releasing the modifier key
@@ -1435,7 +1435,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_CONTROL), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x41), false);
             // Shortcut invoked state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test if keyboard state is reverted for a shortcut to a single key remap (target key is the action key in the shortcut) on key down followed by releasing the modifier key
@@ -1523,7 +1523,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(false, mockedInputHandler.GetVirtualKeyState(VK_MENU));
             Assert::AreEqual(true, mockedInputHandler.GetVirtualKeyState(0x42));
             // Shortcut invoked state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test that remap is not invoked for a shortcut to a single key remap when a larger remapped shortcut to shortcut containing those shortcut keys is invoked
@@ -1620,7 +1620,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_MENU), true);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x42), true);
             // Shortcut invoked state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
 
             input[0].type = INPUT_KEYBOARD;
             input[0].ki.wVk = 0x41;
@@ -1635,7 +1635,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_MENU), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x42), true);
             // Shortcut invoked state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test if remap is invoked and then reverted to physical keys for a shortcut to a single key remap when the shortcut is invoked along with other keys pressed after it and modifier key is released
@@ -1665,7 +1665,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_MENU), true);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x42), true);
             // Shortcut invoked state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
 
             input[0].type = INPUT_KEYBOARD;
             input[0].ki.wVk = VK_CONTROL;
@@ -1680,7 +1680,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_MENU), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x42), true);
             // Shortcut invoked state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test if remap is invoked and then reverted to physical keys for a shortcut to a single key remap when the shortcut is invoked and action key is released and then other keys pressed after it
@@ -1710,7 +1710,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x41), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_MENU), false);
             // Shortcut invoked state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
 
             input[0].type = INPUT_KEYBOARD;
             input[0].ki.wVk = 0x42;
@@ -1725,7 +1725,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_MENU), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x42), true);
             // Shortcut invoked state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test if Windows left key state is set when a shortcut remap to Win both is invoked
@@ -2176,7 +2176,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x56), true);
 
             // Shortcut invoked state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Tests for shortcut disable remappings
@@ -2267,7 +2267,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(actionKey), true);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x42), true);
             // Shortcut invoked state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test that shortcut is not disabled if the shortcut which was remapped to Disable is pressed and the action key is released, followed by pressing another key
@@ -2298,7 +2298,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(VK_CONTROL), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(actionKey), false);
             // Shortcut invoked state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
 
             input[0].type = INPUT_KEYBOARD;
             input[0].ki.wVk = 0x42;
@@ -2310,7 +2310,7 @@ namespace RemappingLogicTests
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(actionKey), false);
             Assert::AreEqual(mockedInputHandler.GetVirtualKeyState(0x42), true);
             // Shortcut invoked state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isShortcutInvoked);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isShortcutInvoked);
         }
 
         // Test that the isOriginalActionKeyPressed flag is set to true on exact match of the shortcut
@@ -2335,7 +2335,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(nInputs, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
         }
 
         // Test that the isOriginalActionKeyPressed flag is set to false on releasing the action key
@@ -2360,7 +2360,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(nInputs, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
 
             input[0].type = INPUT_KEYBOARD;
             input[0].ki.wVk = actionKey;
@@ -2370,7 +2370,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(1, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
         }
 
         // Test that the isOriginalActionKeyPressed flag is set to true on pressing the action key again after releasing the action key
@@ -2398,7 +2398,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(nInputs, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
 
             input[0].type = INPUT_KEYBOARD;
             input[0].ki.wVk = actionKey;
@@ -2408,7 +2408,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(1, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
         }
 
         // Test that the isOriginalActionKeyPressed flag is set to false on releasing the modifier key
@@ -2433,7 +2433,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(nInputs, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
 
             input[0].type = INPUT_KEYBOARD;
             input[0].ki.wVk = VK_CONTROL;
@@ -2443,7 +2443,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(1, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
         }
 
         // Test that the isOriginalActionKeyPressed flag is set to false on pressing another key
@@ -2468,7 +2468,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(nInputs, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be true
-            Assert::AreEqual(true, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(true, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
 
             input[0].type = INPUT_KEYBOARD;
             input[0].ki.wVk = 0x42;
@@ -2478,7 +2478,7 @@ namespace RemappingLogicTests
             mockedInputHandler.SendVirtualInput(1, input, sizeof(INPUT));
 
             // IsOriginalActionKeyPressed state should be false
-            Assert::AreEqual(false, testState.osLevelShortcutReMap[src].isOriginalActionKeyPressed);
+            Assert::AreEqual(false, testState.GetShortcutRemapTable(std::nullopt)[src].isOriginalActionKeyPressed);
         }
 
         // Tests for dummy key events in shortcut remaps
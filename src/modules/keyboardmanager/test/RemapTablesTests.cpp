@@ -0,0 +1,149 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "MockedInput.h"
+#include "KeyStreamReplay.h"
+#include <keyboardmanager/common/KeyboardManagerState.h>
+#include <keyboardmanager/dll/KeyboardEventHandlers.h>
+#include "TestHelpers.h"
+#include <common/shared_constants.h>
+#include <atomic>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RemappingLogicTests
+{
+    // Tests for publishing the remap tables to the hook
+    TEST_CLASS (RemapTablesTests)
+    {
+    private:
+        MockedInput mockedInputHandler;
+        KeyboardManagerState testState;
+        std::wstring testApp1 = L"testprocess1.exe";
+
+        // Number of physical A key events which the hook passed on without remapping them
+        std::atomic<int> unremappedKeyEventCount = 0;
+
+    public:
+        TEST_METHOD_INITIALIZE(InitializeTestEnv)
+        {
+            // Reset test environment
+            TestHelpers::ResetTestEnv(mockedInputHandler, testState);
+            unremappedKeyEventCount = 0;
+
+            // Set HandleKeyboardHookEvent as the hook procedure, counting the A key events which are not remapped
+            mockedInputHandler.SetHookProc([this](LowlevelKeyboardEvent* data) {
+                intptr_t result = KeyboardEventHandlers::HandleKeyboardHookEvent(mockedInputHandler, data, testState);
+                if (result == 0 && data->lParam->vkCode == 0x41 && !(data->lParam->dwExtraInfo & CommonSharedConstants::KEYBOARDMANAGER_INJECTED_FLAG))
+                {
+                    unremappedKeyEventCount++;
+                }
+                return result;
+            });
+        }
+
+        // Test if the hook keeps using the previous remaps until an update is complete
+        TEST_METHOD (UpdateRemapTables_ShouldPublishChangesAsAWhole_OnUpdatingRemaps)
+        {
+            // Remap A to B
+            testState.AddSingleKeyRemap(0x41, 0x42);
+            const int nInputs = 1;
+
+            INPUT input[nInputs] = {};
+            input[0].type = INPUT_KEYBOARD;
+            input[0].ki.wVk = 0x41;
+
+            testState.UpdateRemapTables([&]() {
+                // Remap A to C
+                testState.ClearSingleKeyRemaps();
+                testState.AddSingleKeyRemap(0x41, 0x43);
+
+                // Send A keydown while the update is in progress, it should still be remapped to B
+                mockedInputHandler.SendVirtualInput(nInputs, input, sizeof(INPUT));
+                Assert::IsTrue(mockedInputHandler.GetVirtualKeyState(0x42));
+                Assert::IsFalse(mockedInputHandler.GetVirtualKeyState(0x43));
+            });
+
+            // Send A keydown after the update, it should be remapped to C
+            mockedInputHandler.ResetKeyboardState();
+            mockedInputHandler.SendVirtualInput(nInputs, input, sizeof(INPUT));
+            Assert::IsFalse(mockedInputHandler.GetVirtualKeyState(0x42));
+            Assert::IsTrue(mockedInputHandler.GetVirtualKeyState(0x43));
+            Assert::AreEqual(0, unremappedKeyEventCount.load());
+        }
+
+        // Test if the edited remaps are published even if the update fails
+        TEST_METHOD (UpdateRemapTables_ShouldPublishChanges_WhenMethodThrows)
+        {
+            Assert::ExpectException<std::runtime_error>([&]() {
+                testState.UpdateRemapTables([&]() {
+                    testState.AddSingleKeyRemap(0x41, 0x42);
+                    throw std::runtime_error("Invalid remap");
+                });
+            });
+
+            Assert::IsTrue(testState.GetSingleKeyRemapLookup().GetEntry(0x41).IsRemapped());
+        }
+
+        // Test if the foreground app is resolved against the published app-specific remaps
+        TEST_METHOD (UpdateRemapTables_ShouldResolveForegroundApp_AfterPublishing)
+        {
+            mockedInputHandler.SetForegroundProcess(testApp1);
+            Shortcut src(std::vector<int32_t>{ VK_CONTROL, 0x41 });
+
+            testState.UpdateRemapTables([&]() {
+                testState.AddAppSpecificShortcut(testApp1, src, 0x56);
+                Assert::IsNull(testState.GetForegroundApp()->remapTable);
+            });
+
+            Assert::IsTrue(testState.GetForegroundApp()->remapTable == &testState.GetShortcutRemapTable(testApp1));
+        }
+
+        // Stress test which reloads the remaps on another thread while key streams are replayed through the hook. Every A key event should be remapped
+        TEST_METHOD (UpdateRemapTables_ShouldNotDropRemaps_OnConcurrentReloads)
+        {
+            // Arrange
+            Shortcut appShortcut(std::vector<int32_t>{ VK_CONTROL, 0x43 });
+            auto reload = [&]() {
+                testState.UpdateRemapTables([&]() {
+                    testState.ClearSingleKeyRemaps();
+                    testState.ClearOSLevelShortcuts();
+                    testState.ClearAppSpecificShortcuts();
+                    testState.AddSingleKeyRemap(0x41, 0x42);
+                    testState.AddOSLevelShortcut(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x56 }), Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x58 }));
+                    testState.AddAppSpecificShortcut(testApp1, appShortcut, 0x44);
+                });
+            };
+            reload();
+            mockedInputHandler.SetForegroundProcess(testApp1);
+
+            std::vector<INPUT> stream;
+            KeyStreamReplay::AppendText(stream, "A QUICK BROWN FOX AAA ");
+            KeyStreamReplay::AppendChord(stream, { VK_CONTROL, 0x43 });
+            KeyStreamReplay::AppendChord(stream, { VK_CONTROL, 0x56 });
+
+            // Act
+            std::atomic_bool reloading = true;
+            std::thread reloadThread([&]() {
+                for (int i = 0; i < 2000; i++)
+                {
+                    reload();
+                }
+                reloading = false;
+            });
+
+            int replayCount = 0;
+            while (reloading || replayCount == 0)
+            {
+                KeyStreamReplay::Replay(mockedInputHandler, stream);
+                replayCount++;
+            }
+            reloadThread.join();
+
+            // Assert
+            Logger::WriteMessage((L"Replayed the key stream " + std::to_wstring(replayCount) + L" times during 2000 reloads\n").c_str());
+            Assert::AreEqual(0, unremappedKeyEventCount.load());
+            Assert::IsFalse(mockedInputHandler.GetVirtualKeyState(0x42));
+        }
+    };
+}
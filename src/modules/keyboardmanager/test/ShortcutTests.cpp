@@ -2,8 +2,11 @@
 #include "CppUnitTest.h"
 #include <keyboardmanager/common/Shortcut.h>
 #include <keyboardmanager/common/Helpers.h>
+#include <keyboardmanager/common/KeyboardManagerState.h>
+#include "MockedInput.h"
 #include "TestHelpers.h"
 #include "../common/keyboard_layout.h"
+#include "../common/shared_constants.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -172,5 +175,127 @@ namespace KeyboardManagerCommonTests
             // Assert
             Assert::IsTrue(result == KeyboardManagerHelper::ErrorType::NoError);
         }
+
+        // Test if the IsKeyboardStateClearExceptShortcut method returns true if only the shortcut keys and ignored keys are pressed
+        TEST_METHOD (IsKeyboardStateClearExceptShortcut_ShouldReturnTrue_OnPressingOnlyShortcutAndIgnoredKeys)
+        {
+            // Arrange
+            MockedInput mockedInputHandler;
+            Shortcut s(std::vector<int32_t>{ VK_CONTROL, VK_LSHIFT, 0x41 });
+            std::vector<INPUT> input(4);
+            input[0].type = INPUT_KEYBOARD;
+            input[0].ki.wVk = VK_RCONTROL;
+            input[1].type = INPUT_KEYBOARD;
+            input[1].ki.wVk = VK_LSHIFT;
+            input[2].type = INPUT_KEYBOARD;
+            input[2].ki.wVk = 0x41;
+            input[3].type = INPUT_KEYBOARD;
+            input[3].ki.wVk = VK_LBUTTON;
+
+            // Act
+            mockedInputHandler.SendVirtualInput((UINT)input.size(), input.data(), sizeof(INPUT));
+
+            // Assert
+            Assert::IsTrue(s.IsKeyboardStateClearExceptShortcut(mockedInputHandler));
+        }
+
+        // Test if the IsKeyboardStateClearExceptShortcut method returns false if a key apart from the shortcut is pressed
+        TEST_METHOD (IsKeyboardStateClearExceptShortcut_ShouldReturnFalse_OnPressingKeyApartFromShortcut)
+        {
+            // Arrange
+            MockedInput mockedInputHandler;
+            Shortcut s(std::vector<int32_t>{ VK_CONTROL, VK_LSHIFT, 0x41 });
+            std::vector<WORD> otherKeys = { VK_RSHIFT, VK_LWIN, 0x42, VK_F24 };
+
+            for (WORD key : otherKeys)
+            {
+                mockedInputHandler.ResetKeyboardState();
+                std::vector<INPUT> input(3);
+                input[0].type = INPUT_KEYBOARD;
+                input[0].ki.wVk = VK_LCONTROL;
+                input[1].type = INPUT_KEYBOARD;
+                input[1].ki.wVk = VK_LSHIFT;
+                input[2].type = INPUT_KEYBOARD;
+                input[2].ki.wVk = key;
+
+                // Act
+                mockedInputHandler.SendVirtualInput((UINT)input.size(), input.data(), sizeof(INPUT));
+
+                // Assert
+                Assert::IsFalse(s.IsKeyboardStateClearExceptShortcut(mockedInputHandler));
+            }
+        }
+    };
+
+    // Tests for the compiled shortcut remap table
+    TEST_CLASS (ShortcutMatcherTests)
+    {
+    public:
+        // Test if the GetEntries method only returns the remaps with the given action key, in priority order
+        TEST_METHOD (GetEntries_ShouldReturnRemapsWithActionKeyInPriorityOrder_OnPassingActionKey)
+        {
+            // Arrange
+            KeyboardManagerState testState;
+            testState.AddOSLevelShortcut(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x41 }), (DWORD)0x42);
+            testState.AddOSLevelShortcut(Shortcut(std::vector<int32_t>{ VK_CONTROL, VK_SHIFT, 0x41 }), (DWORD)0x43);
+            testState.AddOSLevelShortcut(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x44 }), (DWORD)0x45);
+
+            // Act
+            auto entries = testState.GetShortcutMatcher(std::nullopt).GetEntries(0x41);
+
+            // Assert
+            Assert::AreEqual((ptrdiff_t)2, entries.end() - entries.begin());
+            Assert::AreEqual((size_t)3, entries.begin()->remap->first.Size());
+            Assert::AreEqual((size_t)2, (entries.begin() + 1)->remap->first.Size());
+            Assert::IsTrue(testState.GetShortcutMatcher(std::nullopt).GetEntries(0x42).empty());
+            Assert::AreEqual((ptrdiff_t)3, testState.GetShortcutMatcher(std::nullopt).GetEntries().end() - testState.GetShortcutMatcher(std::nullopt).GetEntries().begin());
+        }
+
+        // Test if the CheckModifiers method matches either win key for a shortcut with the win key set to both
+        TEST_METHOD (CheckModifiers_ShouldReturnTrue_OnPassingEitherWinKeyForShortcutWithBothWinKeys)
+        {
+            // Arrange
+            ShortcutRemapTable table;
+            Shortcut s(std::vector<int32_t>{ CommonSharedConstants::VK_WIN_BOTH, VK_LCONTROL, 0x41 });
+            auto it = table.insert({ s, RemapShortcut((DWORD)0x42) }).first;
+
+            // Act
+            auto entry = ShortcutMatcher::Compile(s, it);
+
+            // Assert
+            Assert::IsTrue(entry.CheckModifiers(ModifierBit::LWin | ModifierBit::LCtrl));
+            Assert::IsTrue(entry.CheckModifiers(ModifierBit::RWin | ModifierBit::LCtrl | ModifierBit::Ctrl));
+            Assert::IsFalse(entry.CheckModifiers(ModifierBit::LWin | ModifierBit::RCtrl | ModifierBit::Ctrl));
+            Assert::IsFalse(entry.CheckModifiers(ModifierBit::LCtrl));
+        }
+
+        // Test if the GetModifierState method returns the same result as CheckModifiersKeyboardState
+        TEST_METHOD (GetModifierState_ShouldMatchCheckModifiersKeyboardState_OnPressingModifiers)
+        {
+            // Arrange
+            MockedInput mockedInputHandler;
+            ShortcutRemapTable table;
+            Shortcut s(std::vector<int32_t>{ VK_CONTROL, VK_RMENU, 0x41 });
+            auto it = table.insert({ s, RemapShortcut((DWORD)0x42) }).first;
+            auto entry = ShortcutMatcher::Compile(s, it);
+            std::vector<std::vector<WORD>> keyStates = { { VK_LCONTROL }, { VK_LCONTROL, VK_RMENU }, { VK_RCONTROL, VK_LMENU }, { VK_RCONTROL, VK_RMENU, VK_LSHIFT } };
+
+            for (const auto& keys : keyStates)
+            {
+                mockedInputHandler.ResetKeyboardState();
+                std::vector<INPUT> input(keys.size());
+                for (size_t i = 0; i < keys.size(); i++)
+                {
+                    input[i].type = INPUT_KEYBOARD;
+                    input[i].ki.wVk = keys[i];
+                }
+
+                // Act
+                mockedInputHandler.SendVirtualInput((UINT)input.size(), input.data(), sizeof(INPUT));
+
+                // Assert
+                Assert::AreEqual(s.CheckModifiersKeyboardState(mockedInputHandler), entry.CheckModifiers(ShortcutMatcher::GetModifierState(mockedInputHandler)));
+            }
+        }
     };
 }
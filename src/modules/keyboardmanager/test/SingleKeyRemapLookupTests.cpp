@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include <keyboardmanager/common/SingleKeyRemapLookup.h>
+#include "../common/shared_constants.h"
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RemappingLogicTests
+{
+    // Tests for the SingleKeyRemapLookup class
+    TEST_CLASS (SingleKeyRemapLookupTests)
+    {
+    public:
+        // Test if key, disabled and shortcut remaps are compiled into the table and other keys are not remapped
+        TEST_METHOD (GetEntry_ShouldReturnCompiledRemap_OnRemappedKeys)
+        {
+            // Arrange
+            SingleKeyRemapTable table;
+            table[0x41] = (DWORD)0x42;
+            table[0x43] = CommonSharedConstants::VK_DISABLED;
+            table[0x44] = CommonSharedConstants::VK_WIN_BOTH;
+            table[0x45] = Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x56 });
+
+            // Act
+            SingleKeyRemapLookup lookup(table);
+
+            // Assert
+            Assert::IsTrue(lookup.GetEntry(0x41).type == SingleKeyRemapLookup::TargetType::Key);
+            Assert::AreEqual((uint16_t)0x42, lookup.GetEntry(0x41).target);
+            Assert::IsTrue(lookup.GetEntry(0x43).type == SingleKeyRemapLookup::TargetType::Disabled);
+            Assert::IsTrue(lookup.GetEntry(0x44).type == SingleKeyRemapLookup::TargetType::Key);
+            Assert::AreEqual((uint16_t)VK_LWIN, lookup.GetEntry(0x44).target);
+            Assert::IsTrue(lookup.GetEntry(0x45).type == SingleKeyRemapLookup::TargetType::Shortcut);
+            Assert::IsTrue(Shortcut(std::vector<int32_t>{ VK_CONTROL, 0x56 }) == lookup.GetShortcut(lookup.GetEntry(0x45)));
+            Assert::IsFalse(lookup.GetEntry(0x46).IsRemapped());
+            Assert::IsFalse(lookup.GetEntry(0).IsRemapped());
+        }
+
+        // Test if keys out of the virtual key range are never remapped
+        TEST_METHOD (GetEntry_ShouldReturnNoRemap_OnKeyOutOfRange)
+        {
+            // Arrange
+            SingleKeyRemapTable table;
+            table[0x100] = (DWORD)0x42;
+            table[0x41] = (DWORD)0x42;
+
+            // Act
+            SingleKeyRemapLookup lookup(table);
+
+            // Assert
+            Assert::IsFalse(lookup.GetEntry(0x100).IsRemapped());
+            Assert::IsFalse(lookup.GetEntry(0xFFFFFFFF).IsRemapped());
+            Assert::IsTrue(lookup.GetEntry(0x41).IsRemapped());
+        }
+
+        // Benchmark for the cost of looking up a key which is not remapped, compared to the unordered map used for editing
+        TEST_METHOD (GetEntry_ShouldBeCheaperThanMapLookup_OnKeysWhichAreNotRemapped)
+        {
+            SingleKeyRemapTable table;
+            for (DWORD key = 0x70; key < 0x80; key++)
+            {
+                table[key] = (DWORD)0x41;
+            }
+            SingleKeyRemapLookup lookup(table);
+            const int iterations = 1000000;
+
+            size_t mapHits = 0;
+            const auto mapStart = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                mapHits += table.find(0x41 + (i & 0x1F)) != table.end();
+            }
+            const auto mapEnd = std::chrono::high_resolution_clock::now();
+
+            size_t lookupHits = 0;
+            const auto lookupStart = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                lookupHits += lookup.GetEntry(0x41 + (i & 0x1F)).IsRemapped();
+            }
+            const auto lookupEnd = std::chrono::high_resolution_clock::now();
+
+            const double mapNanoseconds = std::chrono::duration<double, std::nano>(mapEnd - mapStart).count() / iterations;
+            const double lookupNanoseconds = std::chrono::duration<double, std::nano>(lookupEnd - lookupStart).count() / iterations;
+            Logger::WriteMessage((L"unordered_map::find: " + std::to_wstring(mapNanoseconds) + L" ns\n").c_str());
+            Logger::WriteMessage((L"SingleKeyRemapLookup::GetEntry: " + std::to_wstring(lookupNanoseconds) + L" ns\n").c_str());
+            Assert::AreEqual(size_t{ 0 }, mapHits);
+            Assert::AreEqual(size_t{ 0 }, lookupHits);
+#ifdef NDEBUG
+            Assert::IsTrue(lookupNanoseconds < mapNanoseconds);
+#endif
+        }
+    };
+}
@@ -11,6 +11,7 @@ namespace TestHelpers
         input.ResetKeyboardState();
         input.SetHookProc(nullptr);
         input.SetSendVirtualInputTestHandler(nullptr);
+        input.SetForegroundProcessChangedCallback([&state](const std::wstring& process) { state.SetForegroundProcess(process); });
         input.SetForegroundProcess(L"");
         state.ClearSingleKeyRemaps();
         state.ClearOSLevelShortcuts();
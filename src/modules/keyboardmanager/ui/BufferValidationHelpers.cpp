@@ -8,8 +8,16 @@ namespace BufferValidationHelpers
 {
     // Function to validate and update an element of the key remap buffer when the selection has changed
     KeyboardManagerHelper::ErrorType ValidateAndUpdateKeyBufferElement(int rowIndex, int colIndex, int selectedKeyCode, RemapBuffer& remapBuffer)
+    {
+        RemapBufferIndex remapBufferIndex(remapBuffer);
+        return ValidateAndUpdateKeyBufferElement(rowIndex, colIndex, selectedKeyCode, remapBuffer, remapBufferIndex);
+    }
+
+    // Function to validate and update an element of the key remap buffer when the selection has changed, using an index of the buffer to check for conflicts with the other rows
+    KeyboardManagerHelper::ErrorType ValidateAndUpdateKeyBufferElement(int rowIndex, int colIndex, int selectedKeyCode, RemapBuffer& remapBuffer, RemapBufferIndex& remapBufferIndex)
     {
         KeyboardManagerHelper::ErrorType errorType = KeyboardManagerHelper::ErrorType::NoError;
+        remapBufferIndex.Sync(remapBuffer);
 
         // Check if the element was not found or the index exceeds the known keys
         if (selectedKeyCode != -1)
@@ -27,24 +35,8 @@ namespace BufferValidationHelpers
 
             if (errorType == KeyboardManagerHelper::ErrorType::NoError && colIndex == 0)
             {
-                // Check if the key is already remapped to something else
-                for (int i = 0; i < remapBuffer.size(); i++)
-                {
-                    if (i != rowIndex)
-                    {
-                        if (remapBuffer[i].first[colIndex].index() == 0)
-                        {
-                            KeyboardManagerHelper::ErrorType result = KeyboardManagerHelper::DoKeysOverlap(std::get<DWORD>(remapBuffer[i].first[colIndex]), selectedKeyCode);
-                            if (result != KeyboardManagerHelper::ErrorType::NoError)
-                            {
-                                errorType = result;
-                                break;
-                            }
-                        }
-
-                        // If one column is shortcut and other is key no warning required
-                    }
-                }
+                // Check if the key is already remapped to something else. If one column is shortcut and other is key no warning required
+                errorType = remapBufferIndex.FindKeyConflict(selectedKeyCode, rowIndex);
             }
 
             // If there is no error, set the buffer
@@ -63,11 +55,23 @@ namespace BufferValidationHelpers
             remapBuffer[rowIndex].first[colIndex] = NULL;
         }
 
+        if (colIndex == 0)
+        {
+            remapBufferIndex.UpdateRow(remapBuffer, rowIndex);
+        }
+
         return errorType;
     }
 
     // Function to validate an element of the shortcut remap buffer when the selection has changed
     std::pair<KeyboardManagerHelper::ErrorType, DropDownAction> ValidateShortcutBufferElement(int rowIndex, int colIndex, uint32_t dropDownIndex, const std::vector<int32_t>& selectedCodes, std::wstring appName, bool isHybridControl, const RemapBuffer& remapBuffer, bool dropDownFound)
+    {
+        RemapBufferIndex remapBufferIndex(remapBuffer);
+        return ValidateShortcutBufferElement(rowIndex, colIndex, dropDownIndex, selectedCodes, appName, isHybridControl, remapBuffer, remapBufferIndex, dropDownFound);
+    }
+
+    // Function to validate an element of the shortcut remap buffer when the selection has changed, using an index of the buffer to check for conflicts with the other rows
+    std::pair<KeyboardManagerHelper::ErrorType, DropDownAction> ValidateShortcutBufferElement(int rowIndex, int colIndex, uint32_t dropDownIndex, const std::vector<int32_t>& selectedCodes, std::wstring appName, bool isHybridControl, const RemapBuffer& remapBuffer, RemapBufferIndex& remapBufferIndex, bool dropDownFound)
     {
         BufferValidationHelpers::DropDownAction dropDownAction = BufferValidationHelpers::DropDownAction::NoAction;
         KeyboardManagerHelper::ErrorType errorType = KeyboardManagerHelper::ErrorType::NoError;
@@ -255,43 +259,16 @@ namespace BufferValidationHelpers
             if (errorType == KeyboardManagerHelper::ErrorType::NoError && colIndex == 0)
             {
                 // Check if the key is already remapped to something else for the same target app
-                for (int i = 0; i < remapBuffer.size(); i++)
+                remapBufferIndex.Sync(remapBuffer);
+                if (tempShortcut.index() == 0)
                 {
-                    std::wstring currAppName = remapBuffer[i].second;
-                    std::transform(currAppName.begin(), currAppName.end(), currAppName.begin(), towlower);
-
-                    if (i != rowIndex && currAppName == appName)
-                    {
-                        KeyboardManagerHelper::ErrorType result = KeyboardManagerHelper::ErrorType::NoError;
-                        if (!isHybridControl)
-                        {
-                            result = Shortcut::DoKeysOverlap(std::get<Shortcut>(remapBuffer[i].first[colIndex]), std::get<Shortcut>(tempShortcut));
-                        }
-                        else
-                        {
-                            if (tempShortcut.index() == 0 && remapBuffer[i].first[colIndex].index() == 0)
-                            {
-                                if (std::get<DWORD>(tempShortcut) != NULL && std::get<DWORD>(remapBuffer[i].first[colIndex]) != NULL)
-                                {
-                                    result = KeyboardManagerHelper::DoKeysOverlap(std::get<DWORD>(remapBuffer[i].first[colIndex]), std::get<DWORD>(tempShortcut));
-                                }
-                            }
-                            else if (tempShortcut.index() == 1 && remapBuffer[i].first[colIndex].index() == 1)
-                            {
-                                if (std::get<Shortcut>(tempShortcut).IsValidShortcut() && std::get<Shortcut>(remapBuffer[i].first[colIndex]).IsValidShortcut())
-                                {
-                                    result = Shortcut::DoKeysOverlap(std::get<Shortcut>(remapBuffer[i].first[colIndex]), std::get<Shortcut>(tempShortcut));
-                                }
-                            }
-                            // Other scenarios not possible since key to shortcut is with key to key, and shortcut to key is with shortcut to shortcut
-                        }
-                        if (result != KeyboardManagerHelper::ErrorType::NoError)
-                        {
-                            errorType = result;
-                            break;
-                        }
-                    }
+                    errorType = remapBufferIndex.FindKeyConflict(std::get<DWORD>(tempShortcut), rowIndex, true, appName);
+                }
+                else
+                {
+                    errorType = remapBufferIndex.FindShortcutConflict(std::get<Shortcut>(tempShortcut), rowIndex, appName);
                 }
+                // Other scenarios not possible since key to shortcut is with key to key, and shortcut to key is with shortcut to shortcut
             }
 
             if (errorType == KeyboardManagerHelper::ErrorType::NoError && tempShortcut.index() == 1)
@@ -3,6 +3,7 @@
 #include <variant>
 #include <vector>
 #include "keyboardmanager/common/Shortcut.h"
+#include "RemapBufferIndex.h"
 
 namespace BufferValidationHelpers
 {
@@ -17,6 +18,12 @@ namespace BufferValidationHelpers
     // Function to validate and update an element of the key remap buffer when the selection has changed
     KeyboardManagerHelper::ErrorType ValidateAndUpdateKeyBufferElement(int rowIndex, int colIndex, int selectedKeyCode, RemapBuffer& remapBuffer);
 
+    // Function to validate and update an element of the key remap buffer when the selection has changed, using an index of the buffer to check for conflicts with the other rows
+    KeyboardManagerHelper::ErrorType ValidateAndUpdateKeyBufferElement(int rowIndex, int colIndex, int selectedKeyCode, RemapBuffer& remapBuffer, RemapBufferIndex& remapBufferIndex);
+
     // Function to validate an element of the shortcut remap buffer when the selection has changed
     std::pair<KeyboardManagerHelper::ErrorType, DropDownAction> ValidateShortcutBufferElement(int rowIndex, int colIndex, uint32_t dropDownIndex, const std::vector<int32_t>& selectedCodes, std::wstring appName, bool isHybridControl, const RemapBuffer& remapBuffer, bool dropDownFound);
+
+    // Function to validate an element of the shortcut remap buffer when the selection has changed, using an index of the buffer to check for conflicts with the other rows
+    std::pair<KeyboardManagerHelper::ErrorType, DropDownAction> ValidateShortcutBufferElement(int rowIndex, int colIndex, uint32_t dropDownIndex, const std::vector<int32_t>& selectedCodes, std::wstring appName, bool isHybridControl, const RemapBuffer& remapBuffer, RemapBufferIndex& remapBufferIndex, bool dropDownFound);
 }
@@ -246,6 +246,7 @@ void createEditKeyboardWindow(HINSTANCE hInst, KeyboardManagerState& keyboardMan
     KeyDropDownControl::keyboardManagerState = &keyboardManagerState;
     // Clear the single key remap buffer
     SingleKeyRemapControl::singleKeyRemapBuffer.clear();
+    SingleKeyRemapControl::singleKeyRemapIndex.Invalidate();
     // Vector to store dynamically allocated control objects to avoid early destruction
     std::vector<std::vector<std::unique_ptr<SingleKeyRemapControl>>> keyboardRemapControlObjects;
 
@@ -272,8 +273,8 @@ void createEditKeyboardWindow(HINSTANCE hInst, KeyboardManagerState& keyboardMan
     header.SetLeftOf(applyButton, cancelButton);
 
     auto ApplyRemappings = [&keyboardManagerState, _hWndEditKeyboardWindow]() {
-        // Disable the remappings while the remapping table is updated
-        keyboardManagerState.RemappingsDisabledWrapper(
+        // Publish the remappings to the hook once the remapping table is updated
+        keyboardManagerState.UpdateRemapTables(
             [&keyboardManagerState]() {
                 LoadingAndSavingRemappingHelper::ApplySingleKeyRemappings(keyboardManagerState, SingleKeyRemapControl::singleKeyRemapBuffer, true);
                 // Save the updated shortcuts remaps to file.
@@ -220,6 +220,7 @@ void createEditShortcutsWindow(HINSTANCE hInst, KeyboardManagerState& keyboardMa
     KeyDropDownControl::keyboardManagerState = &keyboardManagerState;
     // Clear the shortcut remap buffer
     ShortcutControl::shortcutRemapBuffer.clear();
+    ShortcutControl::shortcutRemapIndex.Invalidate();
     // Vector to store dynamically allocated control objects to avoid early destruction
     std::vector<std::vector<std::unique_ptr<ShortcutControl>>> keyboardRemapControlObjects;
 
@@ -259,8 +260,8 @@ void createEditShortcutsWindow(HINSTANCE hInst, KeyboardManagerState& keyboardMa
     header.SetLeftOf(applyButton, cancelButton);
 
     auto ApplyRemappings = [&keyboardManagerState, _hWndEditShortcutsWindow]() {
-        // Disable the remappings while the remapping table is updated
-        keyboardManagerState.RemappingsDisabledWrapper(
+        // Publish the remappings to the hook once the remapping table is updated
+        keyboardManagerState.UpdateRemapTables(
             [&keyboardManagerState]() {
                 LoadingAndSavingRemappingHelper::ApplyShortcutRemappings(keyboardManagerState, ShortcutControl::shortcutRemapBuffer, true);
                 // Save the updated key remaps to file.
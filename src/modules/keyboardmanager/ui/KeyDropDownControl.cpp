@@ -3,6 +3,8 @@
 #include "keyboardmanager/common/Helpers.h"
 #include <keyboardmanager/common/KeyboardManagerState.h>
 #include "BufferValidationHelpers.h"
+#include "SingleKeyRemapControl.h"
+#include "ShortcutControl.h"
 #include <common\shared_constants.h>
 #include <common\keyboard_layout_impl.h>
 #include <modules\keyboardmanager\common\Helpers.h>
@@ -116,7 +118,7 @@ void KeyDropDownControl::SetSelectionHandler(Grid& table, StackPanel singleKeyCo
             int rowIndex = table.GetRow(singleKeyControl) - 1;
 
             // Validate current remap selection
-            KeyboardManagerHelper::ErrorType errorType = BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(rowIndex, colIndex, selectedKeyCode, singleKeyRemapBuffer);
+            KeyboardManagerHelper::ErrorType errorType = BufferValidationHelpers::ValidateAndUpdateKeyBufferElement(rowIndex, colIndex, selectedKeyCode, singleKeyRemapBuffer, SingleKeyRemapControl::singleKeyRemapIndex);
 
             // If there is an error set the warning flyout
             if (errorType != KeyboardManagerHelper::ErrorType::NoError)
@@ -166,7 +168,8 @@ std::pair<KeyboardManagerHelper::ErrorType, int> KeyDropDownControl::ValidateSho
         }
 
         // Validate shortcut element
-        validationResult = BufferValidationHelpers::ValidateShortcutBufferElement(rowIndex, colIndex, dropDownIndex, selectedCodes, appName, isHybridControl, shortcutRemapBuffer, dropDownFound);
+        RemapBufferIndex& remapBufferIndex = isSingleKeyWindow ? SingleKeyRemapControl::singleKeyRemapIndex : ShortcutControl::shortcutRemapIndex;
+        validationResult = BufferValidationHelpers::ValidateShortcutBufferElement(rowIndex, colIndex, dropDownIndex, selectedCodes, appName, isHybridControl, shortcutRemapBuffer, remapBufferIndex, dropDownFound);
 
         // Add or clear unused drop downs
         if (validationResult.second == BufferValidationHelpers::DropDownAction::AddDropDown)
@@ -275,6 +278,11 @@ void KeyDropDownControl::SetSelectionHandler(Grid& table, StackPanel shortcutCon
                     shortcutRemapBuffer[validationResult.second].second = targetApp.Text().c_str();
                 }
             }
+
+            if (!isSingleKeyWindow)
+            {
+                ShortcutControl::shortcutRemapIndex.UpdateRow(shortcutRemapBuffer, validationResult.second);
+            }
         }
 
         // If the user searches for a key the selection handler gets invoked however if they click away it reverts back to the previous state. This can result in dangling references to added drop downs which were then reset.
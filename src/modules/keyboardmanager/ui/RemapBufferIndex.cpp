@@ -0,0 +1,193 @@
+#include "pch.h"
+#include "RemapBufferIndex.h"
+#include <common\shared_constants.h>
+
+namespace
+{
+    // Keys which can overlap with a key other than themselves, i.e. the modifier keys
+    const DWORD modifierKeys[] = { CommonSharedConstants::VK_WIN_BOTH, VK_LWIN, VK_RWIN, VK_CONTROL, VK_LCONTROL, VK_RCONTROL, VK_MENU, VK_LMENU, VK_RMENU, VK_SHIFT, VK_LSHIFT, VK_RSHIFT };
+}
+
+// Build the index for all the rows of the buffer
+RemapBufferIndex::RemapBufferIndex(const RemapBuffer& remapBuffer)
+{
+    Sync(remapBuffer);
+}
+
+// Function to rebuild the index if it was invalidated or the number of rows changed
+void RemapBufferIndex::Sync(const RemapBuffer& remapBuffer)
+{
+    if (isValid && rows.size() == remapBuffer.size())
+    {
+        return;
+    }
+
+    rows.clear();
+    keyRows.clear();
+    shortcutRows.clear();
+    rows.resize(remapBuffer.size());
+    for (int i = 0; i < (int)remapBuffer.size(); i++)
+    {
+        rows[i].original = remapBuffer[i].first[0];
+        rows[i].appName = remapBuffer[i].second;
+        std::transform(rows[i].appName.begin(), rows[i].appName.end(), rows[i].appName.begin(), towlower);
+        AddToBuckets(i);
+    }
+
+    isValid = true;
+}
+
+// Function to index the current original key or shortcut and target app of a row
+void RemapBufferIndex::UpdateRow(const RemapBuffer& remapBuffer, int rowIndex)
+{
+    if (!isValid || rows.size() != remapBuffer.size())
+    {
+        Sync(remapBuffer);
+        return;
+    }
+
+    RemoveFromBuckets(rowIndex);
+    rows[rowIndex].original = remapBuffer[rowIndex].first[0];
+    rows[rowIndex].appName = remapBuffer[rowIndex].second;
+    std::transform(rows[rowIndex].appName.begin(), rows[rowIndex].appName.end(), rows[rowIndex].appName.begin(), towlower);
+    AddToBuckets(rowIndex);
+}
+
+// Function to mark the index for a rebuild, required after rows are added to or removed from the buffer
+void RemapBufferIndex::Invalidate()
+{
+    isValid = false;
+}
+
+// Function to find the first row other than rowIndex whose original key overlaps with the given key, equivalent to calling KeyboardManagerHelper::DoKeysOverlap on every row. If filterApp is set, only rows with a non-null key for the given lower case app are checked
+KeyboardManagerHelper::ErrorType RemapBufferIndex::FindKeyConflict(DWORD key, int rowIndex, bool filterApp, const std::wstring& appName) const
+{
+    if (filterApp && key == NULL)
+    {
+        return KeyboardManagerHelper::ErrorType::NoError;
+    }
+
+    int conflictingRow = -1;
+    KeyboardManagerHelper::ErrorType errorType = KeyboardManagerHelper::ErrorType::NoError;
+
+    // Function to update the result with the first row of the bucket of a key which overlaps with the given key, if it comes before the current result
+    auto checkBucket = [&](DWORD rowKey) {
+        auto it = keyRows.find(rowKey);
+        if (it == keyRows.end())
+        {
+            return;
+        }
+
+        for (int i : it->second)
+        {
+            if (conflictingRow != -1 && i >= conflictingRow)
+            {
+                break;
+            }
+
+            if (i != rowIndex && (!filterApp || rows[i].appName == appName))
+            {
+                conflictingRow = i;
+                errorType = KeyboardManagerHelper::DoKeysOverlap(rowKey, key);
+                break;
+            }
+        }
+    };
+
+    // A key overlaps with itself, and a modifier key also overlaps with the keys of the same modifier type other than its left/right counterpart
+    checkBucket(key);
+    if (KeyboardManagerHelper::GetKeyType(key) != KeyboardManagerHelper::KeyType::Action)
+    {
+        for (DWORD modifierKey : modifierKeys)
+        {
+            if (modifierKey != key && KeyboardManagerHelper::DoKeysOverlap(modifierKey, key) != KeyboardManagerHelper::ErrorType::NoError)
+            {
+                checkBucket(modifierKey);
+            }
+        }
+    }
+
+    return errorType;
+}
+
+// Function to find the first row other than rowIndex for the given lower case app whose original shortcut overlaps with the given shortcut, equivalent to calling Shortcut::DoKeysOverlap on every row of the app
+KeyboardManagerHelper::ErrorType RemapBufferIndex::FindShortcutConflict(const Shortcut& shortcut, int rowIndex, const std::wstring& appName) const
+{
+    // Shortcut::DoKeysOverlap only reports overlaps between valid shortcuts
+    if (!shortcut.IsValidShortcut())
+    {
+        return KeyboardManagerHelper::ErrorType::NoError;
+    }
+
+    auto it = shortcutRows.find(GetShortcutBucket(shortcut));
+    if (it == shortcutRows.end())
+    {
+        return KeyboardManagerHelper::ErrorType::NoError;
+    }
+
+    for (int i : it->second)
+    {
+        if (i != rowIndex && rows[i].appName == appName)
+        {
+            KeyboardManagerHelper::ErrorType result = Shortcut::DoKeysOverlap(std::get<Shortcut>(rows[i].original), shortcut);
+            if (result != KeyboardManagerHelper::ErrorType::NoError)
+            {
+                return result;
+            }
+        }
+    }
+
+    return KeyboardManagerHelper::ErrorType::NoError;
+}
+
+// Function to get the bucket of a valid shortcut, which combines the action key with the types of modifiers that are set
+uint64_t RemapBufferIndex::GetShortcutBucket(const Shortcut& shortcut)
+{
+    uint64_t modifierTypes = (shortcut.GetWinKey(ModifierKey::Disabled) != NULL ? 1 : 0) |
+                             (shortcut.GetCtrlKey() != NULL ? 2 : 0) |
+                             (shortcut.GetAltKey() != NULL ? 4 : 0) |
+                             (shortcut.GetShiftKey() != NULL ? 8 : 0);
+    return ((uint64_t)shortcut.GetActionKey() << 4) | modifierTypes;
+}
+
+void RemapBufferIndex::AddToBuckets(int rowIndex)
+{
+    const KeyShortcutUnion& original = rows[rowIndex].original;
+    if (original.index() == 0)
+    {
+        keyRows[std::get<DWORD>(original)].insert(rowIndex);
+    }
+    else if (std::get<Shortcut>(original).IsValidShortcut())
+    {
+        shortcutRows[GetShortcutBucket(std::get<Shortcut>(original))].insert(rowIndex);
+    }
+}
+
+void RemapBufferIndex::RemoveFromBuckets(int rowIndex)
+{
+    const KeyShortcutUnion& original = rows[rowIndex].original;
+    if (original.index() == 0)
+    {
+        auto it = keyRows.find(std::get<DWORD>(original));
+        if (it != keyRows.end())
+        {
+            it->second.erase(rowIndex);
+            if (it->second.empty())
+            {
+                keyRows.erase(it);
+            }
+        }
+    }
+    else if (std::get<Shortcut>(original).IsValidShortcut())
+    {
+        auto it = shortcutRows.find(GetShortcutBucket(std::get<Shortcut>(original)));
+        if (it != shortcutRows.end())
+        {
+            it->second.erase(rowIndex);
+            if (it->second.empty())
+            {
+                shortcutRows.erase(it);
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "keyboardmanager/common/Helpers.h"
+#include "keyboardmanager/common/Shortcut.h"
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Index of the original keys and shortcuts (first column) of a remap buffer, used to find the rows which conflict with an edited row without comparing it against every row.
+// Rows are bucketed by key code, and shortcuts by action key and modifier types, since only keys and shortcuts in the same bucket can overlap. Each bucket keeps its rows in order, so the first conflicting row is the same as with a scan of the buffer.
+// The index has to be kept in sync with the buffer: UpdateRow after the first column or the target app of a row changes, and Invalidate after rows are added or removed.
+class RemapBufferIndex
+{
+public:
+    RemapBufferIndex() = default;
+
+    // Build the index for all the rows of the buffer
+    explicit RemapBufferIndex(const RemapBuffer& remapBuffer);
+
+    // Function to rebuild the index if it was invalidated or the number of rows changed
+    void Sync(const RemapBuffer& remapBuffer);
+
+    // Function to index the current original key or shortcut and target app of a row
+    void UpdateRow(const RemapBuffer& remapBuffer, int rowIndex);
+
+    // Function to mark the index for a rebuild, required after rows are added to or removed from the buffer
+    void Invalidate();
+
+    // Function to find the first row other than rowIndex whose original key overlaps with the given key, equivalent to calling KeyboardManagerHelper::DoKeysOverlap on every row. If filterApp is set, only rows with a non-null key for the given lower case app are checked
+    KeyboardManagerHelper::ErrorType FindKeyConflict(DWORD key, int rowIndex, bool filterApp = false, const std::wstring& appName = L"") const;
+
+    // Function to find the first row other than rowIndex for the given lower case app whose original shortcut overlaps with the given shortcut, equivalent to calling Shortcut::DoKeysOverlap on every row of the app
+    KeyboardManagerHelper::ErrorType FindShortcutConflict(const Shortcut& shortcut, int rowIndex, const std::wstring& appName) const;
+
+private:
+    struct Row
+    {
+        KeyShortcutUnion original;
+
+        // Lower case target app name
+        std::wstring appName;
+    };
+
+    // Function to get the bucket of a valid shortcut, which combines the action key with the types of modifiers that are set
+    static uint64_t GetShortcutBucket(const Shortcut& shortcut);
+
+    void AddToBuckets(int rowIndex);
+    void RemoveFromBuckets(int rowIndex);
+
+    std::vector<Row> rows;
+    bool isValid = false;
+
+    // Rows with an original key, by key code
+    std::unordered_map<DWORD, std::set<int>> keyRows;
+
+    // Rows with a valid original shortcut, by shortcut bucket
+    std::unordered_map<uint64_t, std::set<int>> shortcutRows;
+};
@@ -13,6 +13,7 @@ HWND ShortcutControl::EditShortcutsWindowHandle = nullptr;
 KeyboardManagerState* ShortcutControl::keyboardManagerState = nullptr;
 // Initialized as new vector
 RemapBuffer ShortcutControl::shortcutRemapBuffer;
+RemapBufferIndex ShortcutControl::shortcutRemapIndex;
 
 ShortcutControl::ShortcutControl(Grid table, const int colIndex, TextBox targetApp)
 {
@@ -168,6 +169,7 @@ void ShortcutControl::AddNewShortcutControlRow(Grid& parent, std::vector<std::ve
         {
             shortcutRemapBuffer[rowIndex].second = targetAppTextBox.Text().c_str();
         }
+        shortcutRemapIndex.UpdateRow(shortcutRemapBuffer, rowIndex);
 
         // To set the accessibile name of the target app text box when focus is lost
         ShortcutControl::SetAccessibleNameForTextBox(targetAppTextBox, rowIndex + 1);
@@ -229,6 +231,8 @@ void ShortcutControl::AddNewShortcutControlRow(Grid& parent, std::vector<std::ve
         parent.RowDefinitions().RemoveAt(bufferIndex + 1);
         // delete the row from the buffer
         shortcutRemapBuffer.erase(shortcutRemapBuffer.begin() + bufferIndex);
+        // the rows after the deleted one have moved, so the index has to be rebuilt
+        shortcutRemapIndex.Invalidate();
         // delete the ShortcutControl objects so that they get destructed
         keyboardRemapControlObjects.erase(keyboardRemapControlObjects.begin() + bufferIndex);
     });
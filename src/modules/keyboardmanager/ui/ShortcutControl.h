@@ -1,6 +1,7 @@
 #pragma once
 #include "keyboardmanager/common/Shortcut.h"
 #include <variant>
+#include "RemapBufferIndex.h"
 
 class KeyboardManagerState;
 class KeyDropDownControl;
@@ -41,6 +42,8 @@ public:
     static KeyboardManagerState* keyboardManagerState;
     // Stores the current list of remappings
     static RemapBuffer shortcutRemapBuffer;
+    // Index of the original shortcuts in the remap buffer, used to validate edits
+    static RemapBufferIndex shortcutRemapIndex;
     // Vector to store dynamically allocated KeyDropDownControl objects to avoid early destruction
     std::vector<std::unique_ptr<KeyDropDownControl>> keyDropDownControlObjects;
 
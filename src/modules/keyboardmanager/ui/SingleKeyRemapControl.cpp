@@ -14,6 +14,7 @@ HWND SingleKeyRemapControl::EditKeyboardWindowHandle = nullptr;
 KeyboardManagerState* SingleKeyRemapControl::keyboardManagerState = nullptr;
 // Initialized as new vector
 RemapBuffer SingleKeyRemapControl::singleKeyRemapBuffer;
+RemapBufferIndex SingleKeyRemapControl::singleKeyRemapIndex;
 
 SingleKeyRemapControl::SingleKeyRemapControl(Grid table, const int colIndex)
 {
@@ -173,6 +174,8 @@ void SingleKeyRemapControl::AddNewControlKeyRemapRow(Grid& parent, std::vector<s
         parent.RowDefinitions().RemoveAt(bufferIndex + 1);
         // delete the row from the buffer.
         singleKeyRemapBuffer.erase(singleKeyRemapBuffer.begin() + bufferIndex);
+        // the rows after the deleted one have moved, so the index has to be rebuilt
+        singleKeyRemapIndex.Invalidate();
         // delete the SingleKeyRemapControl objects so that they get destructed
         keyboardRemapControlObjects.erase(keyboardRemapControlObjects.begin() + bufferIndex);
     });
@@ -1,6 +1,7 @@
 #pragma once
 #include "KeyDropDownControl.h"
 #include <keyboardmanager/common/Shortcut.h>
+#include "RemapBufferIndex.h"
 
 class KeyboardManagerState;
 namespace winrt::Windows::UI::Xaml
@@ -38,6 +39,8 @@ public:
     static KeyboardManagerState* keyboardManagerState;
     // Stores the current list of remappings
     static RemapBuffer singleKeyRemapBuffer;
+    // Index of the original keys in the remap buffer, used to validate edits
+    static RemapBufferIndex singleKeyRemapIndex;
 
     // constructor
     SingleKeyRemapControl(Grid table, const int colIndex);
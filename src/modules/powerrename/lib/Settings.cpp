@@ -2,6 +2,7 @@
 #include "Settings.h"
 #include "PowerRenameInterfaces.h"
 #include "settings_helpers.h"
+#include "shell_extension_settings.h"
 
 #include <filesystem>
 #include <commctrl.h>
@@ -264,7 +265,7 @@ void MRUListHandler::ParseJson()
                 }
             }
         }
-        catch (const winrt::hresult_error&) { }
+        catch (const json::JsonError&) { }
     }
 }
 
@@ -415,12 +416,27 @@ void CSettings::Save()
     jsonData.SetNamedValue(c_searchText,              json::value(settings.searchText));
     jsonData.SetNamedValue(c_replaceText,             json::value(settings.replaceText));
 
-    json::to_file(jsonFilePath, jsonData);
+    // Other processes are only told to reload the settings once they were saved
+    if (!json::to_file(jsonFilePath, jsonData))
+    {
+        return;
+    }
+
     GetSystemTimeAsFileTime(&lastLoadedTime);
+    if (const uint64_t generation = ShellExtensionSettings::publish(ShellExtensionSettings::Module::PowerRename, GetSharedFlags()))
+    {
+        loadedGeneration = generation;
+    }
 }
 
 void CSettings::Load()
 {
+    // Read the generation before the file, so settings saved in the meantime are loaded again on the next check.
+    if (const auto sharedState = ShellExtensionSettings::read(ShellExtensionSettings::Module::PowerRename))
+    {
+        loadedGeneration = sharedState->generation;
+    }
+
     if (!std::filesystem::exists(jsonFilePath))
     {
         MigrateFromRegistry();
@@ -437,6 +453,20 @@ void CSettings::Load()
 
 void CSettings::Reload()
 {
+    // Every save publishes a new generation, so the file only has to be parsed again when the generation changed.
+    // The flags are taken from the shared memory, so a file read while it was being written can't change them.
+    if (const auto sharedState = ShellExtensionSettings::read(ShellExtensionSettings::Module::PowerRename))
+    {
+        if (sharedState->generation != loadedGeneration)
+        {
+            Load();
+        }
+        settings.enabled = sharedState->flags & ShellExtensionSettings::Enabled;
+        settings.extendedContextMenuOnly = sharedState->flags & ShellExtensionSettings::ExtendedContextMenuOnly;
+        settings.showIconOnMenu = sharedState->flags & ShellExtensionSettings::ShowIcon;
+        return;
+    }
+
     // Load json settings from data file if it is modified in the meantime.
     FILETIME lastModifiedTime{};
     if (LastModifiedTime(jsonFilePath, &lastModifiedTime) &&
@@ -500,9 +530,20 @@ void CSettings::ParseJson()
                 settings.replaceText = jsonSettings.GetNamedString(c_replaceText);
             }
         }
-        catch (const winrt::hresult_error&) { }
+        catch (const json::JsonError&) { }
     }
     GetSystemTimeAsFileTime(&lastLoadedTime);
+    if (const uint64_t generation = ShellExtensionSettings::publish_loaded(ShellExtensionSettings::Module::PowerRename, GetSharedFlags()))
+    {
+        loadedGeneration = generation;
+    }
+}
+
+uint8_t CSettings::GetSharedFlags() const
+{
+    return static_cast<uint8_t>((settings.enabled ? ShellExtensionSettings::Enabled : 0) |
+                                (settings.extendedContextMenuOnly ? ShellExtensionSettings::ExtendedContextMenuOnly : 0) |
+                                (settings.showIconOnMenu ? ShellExtensionSettings::ShowIcon : 0));
 }
 
 void CSettings::ReadFlags()
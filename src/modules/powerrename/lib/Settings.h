@@ -128,10 +128,13 @@ private:
     void ReadFlags();
     void WriteFlags();
 
+    uint8_t GetSharedFlags() const;
+
     Settings settings;
     std::wstring jsonFilePath;
     std::wstring UIFlagsFilePath;
     FILETIME lastLoadedTime;
+    uint64_t loadedGeneration{ 0 };
 };
 
 CSettings& CSettingsInstance();
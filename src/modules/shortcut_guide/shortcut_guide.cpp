@@ -190,6 +190,79 @@ void OverlayWindow::set_config(const wchar_t* config)
     }
 }
 
+// Applies the changes of single values without parsing the whole configuration, which is all the settings page can change.
+bool OverlayWindow::set_config_changes(const ConfigChange* changes, size_t count)
+{
+    const std::wstring press_time_path = std::wstring{ L"/properties/" } + pressTime.name + L"/value";
+    const std::wstring overlay_opacity_path = std::wstring{ L"/properties/" } + overlayOpacity.name + L"/value";
+    const std::wstring theme_path = std::wstring{ L"/properties/" } + theme.name + L"/value";
+
+    std::optional<int> press_time;
+    std::optional<int> overlay_opacity;
+    std::optional<std::wstring> theme_value;
+    try
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (changes[i].value == nullptr)
+            {
+                return false;
+            }
+
+            const auto value = json::JsonValue::Parse(changes[i].value);
+            if (changes[i].path == press_time_path && value.ValueType() == json::JsonValueType::Number)
+            {
+                press_time = static_cast<int>(value.GetNumber());
+            }
+            else if (changes[i].path == overlay_opacity_path && value.ValueType() == json::JsonValueType::Number)
+            {
+                overlay_opacity = static_cast<int>(value.GetNumber());
+            }
+            else if (changes[i].path == theme_path && value.ValueType() == json::JsonValueType::String)
+            {
+                theme_value = value.GetString().c_str();
+            }
+            else
+            {
+                return false;
+            }
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    if (press_time)
+    {
+        pressTime.value = *press_time;
+        if (target_state)
+        {
+            target_state->set_delay(*press_time);
+        }
+    }
+    if (overlay_opacity)
+    {
+        overlayOpacity.value = *overlay_opacity;
+        if (winkey_popup)
+        {
+            winkey_popup->apply_overlay_opacity(((float)overlayOpacity.value) / 100.0f);
+        }
+    }
+    if (theme_value)
+    {
+        theme.value = std::move(*theme_value);
+        if (winkey_popup)
+        {
+            winkey_popup->set_theme(theme.value);
+        }
+    }
+
+    save_settings();
+    Trace::SettingsChanged(pressTime.value, overlayOpacity.value, theme.value);
+    return true;
+}
+
 constexpr int alternative_switch_hotkey_id = 0x2;
 constexpr UINT alternative_switch_modifier_mask = MOD_WIN | MOD_SHIFT;
 constexpr UINT alternative_switch_vk_code = VK_OEM_2;
@@ -359,3 +432,19 @@ void OverlayWindow::init_settings()
         // Error while loading from the settings file. Just let default values stay as they are.
     }
 }
+
+void OverlayWindow::save_settings()
+{
+    try
+    {
+        PowerToysSettings::PowerToyValues values(get_name(), get_key());
+        values.add_property(pressTime.name, pressTime.value);
+        values.add_property(overlayOpacity.name, overlayOpacity.value);
+        values.add_property(theme.name, theme.value);
+        values.save_to_settings_file();
+    }
+    catch (...)
+    {
+        // Error while saving the settings file. The values still apply until PowerToys restarts.
+    }
+}
@@ -21,6 +21,7 @@ public:
     virtual bool get_config(wchar_t* buffer, int* buffer_size) override;
 
     virtual void set_config(const wchar_t* config) override;
+    virtual bool set_config_changes(const ConfigChange* changes, size_t count) override;
     virtual void enable() override;
     virtual void disable() override;
     virtual bool is_enabled() override;
@@ -46,6 +47,7 @@ private:
     HHOOK hook_handle;
 
     void init_settings();
+    void save_settings();
     void disable(bool trace_event);
 
     struct PressTime
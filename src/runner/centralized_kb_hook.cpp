@@ -2,6 +2,8 @@
 #include "centralized_kb_hook.h"
 #include <common/common.h>
 #include <common/debug_control.h>
+#include <common/hotkey_dispatch_table.h>
+#include <atomic>
 
 namespace CentralizedKeyboardHook
 {
@@ -10,16 +12,23 @@ namespace CentralizedKeyboardHook
         Hotkey hotkey;
         std::wstring moduleName;
         std::function<bool()> action;
-
-        bool operator<(const HotkeyDescriptor& other) const 
-        {
-            return hotkey < other.hotkey;
-        };
-
     };
 
-    std::multiset<HotkeyDescriptor> hotkeyDescriptors;
+    // Registered hotkeys in registration order. They are only used to build the dispatch table, the hook doesn't read them
+    std::vector<HotkeyDescriptor> hotkeyDescriptors;
     std::mutex mutex;
+
+    // Table of the registered hotkeys published to the hook
+    std::atomic<const HotkeyDispatchTable*> dispatchTable;
+
+    // Incremented when the hook starts and finishes handling a key down, so it is odd while the hook may be using the dispatch table
+    std::atomic<uint64_t> hookEventEpoch;
+
+    // Tables replaced while the hook was handling a key down, with the epoch at that time. They are released once the hook has finished that key down
+    std::vector<std::pair<uint64_t, std::unique_ptr<const HotkeyDispatchTable>>> retiredTables;
+
+    // Left and right modifier keys which are pressed, maintained by the hook
+    uint8_t pressedModifiers = 0;
     HHOOK hHook{};
 
     struct DestroyOnExit
@@ -27,78 +36,159 @@ namespace CentralizedKeyboardHook
         ~DestroyOnExit()
         {
             Stop();
+            delete dispatchTable.exchange(nullptr);
         }
     } destroyOnExitObj;
 
+    // Returns the bit of a modifier key in pressedModifiers, 0 for other keys
+    uint8_t GetModifierKeyBit(DWORD vkCode) noexcept
+    {
+        switch (vkCode)
+        {
+        case VK_LWIN:
+            return 1 << 0;
+        case VK_RWIN:
+            return 1 << 1;
+        case VK_CONTROL:
+        case VK_LCONTROL:
+            return 1 << 2;
+        case VK_RCONTROL:
+            return 1 << 3;
+        case VK_SHIFT:
+        case VK_LSHIFT:
+            return 1 << 4;
+        case VK_RSHIFT:
+            return 1 << 5;
+        case VK_MENU:
+        case VK_LMENU:
+            return 1 << 6;
+        case VK_RMENU:
+            return 1 << 7;
+        default:
+            return 0;
+        }
+    }
+
+    uint8_t GetModifierMask(uint8_t modifierKeys) noexcept
+    {
+        return HotkeyDispatchTable::modifier_mask(modifierKeys & 0x03, modifierKeys & 0x0C, modifierKeys & 0x30, modifierKeys & 0xC0);
+    }
+
+    // Reads the pressed modifier keys from the keyboard state
+    uint8_t ReadPressedModifiers() noexcept
+    {
+        uint8_t modifierKeys = 0;
+        for (DWORD vkCode : { VK_LWIN, VK_RWIN, VK_LCONTROL, VK_RCONTROL, VK_LSHIFT, VK_RSHIFT, VK_LMENU, VK_RMENU })
+        {
+            if (GetAsyncKeyState(vkCode) & 0x8000)
+            {
+                modifierKeys |= GetModifierKeyBit(vkCode);
+            }
+        }
+
+        return modifierKeys;
+    }
+
     LRESULT CALLBACK KeyboardHookProc(_In_ int nCode, _In_ WPARAM wParam, _In_ LPARAM lParam)
     {
-        if (nCode < 0 || ((wParam != WM_KEYDOWN) && (wParam != WM_SYSKEYDOWN)))
+        if (nCode < 0)
         {
             return CallNextHookEx(hHook, nCode, wParam, lParam);
         }
 
         const auto& keyPressInfo = *reinterpret_cast<KBDLLHOOKSTRUCT*>(lParam);
+        const bool isKeyDown = (wParam == WM_KEYDOWN) || (wParam == WM_SYSKEYDOWN);
 
-        Hotkey hotkey{
-            .win = (GetAsyncKeyState(VK_LWIN) & 0x8000) || (GetAsyncKeyState(VK_RWIN) & 0x8000),
-            .ctrl = static_cast<bool>(GetAsyncKeyState(VK_CONTROL) & 0x8000),
-            .shift = static_cast<bool>(GetAsyncKeyState(VK_SHIFT) & 0x8000),
-            .alt = static_cast<bool>(GetAsyncKeyState(VK_MENU) & 0x8000),
-            .key = static_cast<unsigned char>(keyPressInfo.vkCode)
-        };
+        const uint8_t modifierKeyBit = GetModifierKeyBit(keyPressInfo.vkCode);
+        if (modifierKeyBit)
+        {
+            pressedModifiers = isKeyDown ? (pressedModifiers | modifierKeyBit) : (pressedModifiers & ~modifierKeyBit);
+        }
 
-        std::function<bool()> action;
+        if (!isKeyDown)
         {
-            // Hold the lock for the shortest possible duration
-            std::unique_lock lock{ mutex };
-            HotkeyDescriptor dummy{ .hotkey = hotkey };
-            auto it = hotkeyDescriptors.find(dummy);
-            if (it != hotkeyDescriptors.end())
-            {
-                action = it->action;
-            }
+            return CallNextHookEx(hHook, nCode, wParam, lParam);
         }
 
-        if (action)
+        // The hook doesn't see the keys released while the secure desktop was shown (e.g. after Ctrl+Alt+Del or Win+L), so modifiers which seem to be pressed are checked against the keyboard state.
+        // The keyboard state doesn't include the key down being handled yet
+        if (pressedModifiers)
         {
-            if (action())
+            pressedModifiers = ReadPressedModifiers() | modifierKeyBit;
+        }
+
+        const auto key = static_cast<unsigned char>(keyPressInfo.vkCode);
+        bool swallowKey = false;
+
+        hookEventEpoch.fetch_add(1);
+        if (const HotkeyDispatchTable* table = dispatchTable.load())
+        {
+            const std::function<bool()>* action = table->find(key, GetModifierMask(pressedModifiers));
+            if (action && !pressedModifiers)
             {
-                // After invoking the hotkey send a dummy key to prevent Start Menu from activating
-                INPUT dummyEvent[1] = {};
-                dummyEvent[0].type = INPUT_KEYBOARD;
-                dummyEvent[0].ki.wVk = 0xFF;
-                dummyEvent[0].ki.dwFlags = KEYEVENTF_KEYUP;
-                SendInput(1, dummyEvent, sizeof(INPUT));
-
-                // Swallow the key press
-                return 1;
+                // The hook also doesn't see the keys pressed before it was started or while the secure desktop was shown, so the modifiers are checked before running an action without modifiers
+                const uint8_t modifierKeys = ReadPressedModifiers();
+                if (modifierKeys)
+                {
+                    action = table->find(key, GetModifierMask(modifierKeys));
+                    pressedModifiers = modifierKeys;
+                }
             }
+
+            swallowKey = action && (*action)();
+        }
+        hookEventEpoch.fetch_add(1);
+
+        if (swallowKey)
+        {
+            // After invoking the hotkey send a dummy key to prevent Start Menu from activating
+            INPUT dummyEvent[1] = {};
+            dummyEvent[0].type = INPUT_KEYBOARD;
+            dummyEvent[0].ki.wVk = 0xFF;
+            dummyEvent[0].ki.dwFlags = KEYEVENTF_KEYUP;
+            SendInput(1, dummyEvent, sizeof(INPUT));
+
+            // Swallow the key press
+            return 1;
         }
 
         return CallNextHookEx(hHook, nCode, wParam, lParam);
     }
 
+    // Builds the dispatch table from the registered hotkeys and publishes it to the hook. Must be called with the mutex held
+    void PublishDispatchTable()
+    {
+        std::vector<HotkeyDispatchTable::Entry> entries;
+        entries.reserve(hotkeyDescriptors.size());
+        for (const auto& descriptor : hotkeyDescriptors)
+        {
+            const auto& hotkey = descriptor.hotkey;
+            entries.push_back({ .key = hotkey.key, .modifiers = HotkeyDispatchTable::modifier_mask(hotkey.win, hotkey.ctrl, hotkey.shift, hotkey.alt), .action = descriptor.action });
+        }
+
+        std::unique_ptr<const HotkeyDispatchTable> previousTable{ dispatchTable.exchange(new HotkeyDispatchTable(std::move(entries))) };
+
+        // Key downs which start after the exchange use the new table. The hook can be using the previous one only if it is handling a key down, which can also be the one running this function through a hotkey action
+        const uint64_t epoch = hookEventEpoch.load();
+        std::erase_if(retiredTables, [epoch](const auto& retiredTable) { return retiredTable.first < epoch; });
+        if (previousTable && (epoch & 1))
+        {
+            retiredTables.emplace_back(epoch, std::move(previousTable));
+        }
+    }
+
     void SetHotkeyAction(const std::wstring& moduleName, const Hotkey& hotkey, std::function<bool()>&& action) noexcept
     {
         std::unique_lock lock{ mutex };
-        hotkeyDescriptors.insert({ .hotkey = hotkey, .moduleName = moduleName, .action = std::move(action) });
+        hotkeyDescriptors.push_back({ .hotkey = hotkey, .moduleName = moduleName, .action = std::move(action) });
+        PublishDispatchTable();
     }
 
     void ClearModuleHotkeys(const std::wstring& moduleName) noexcept
     {
         std::unique_lock lock{ mutex };
-        auto it = hotkeyDescriptors.begin();
-        while (it != hotkeyDescriptors.end())
-        {
-            if (it->moduleName == moduleName)
-            {
-                it = hotkeyDescriptors.erase(it);
-            }
-            else
-            {
-                ++it;
-            }
-        }
+        std::erase_if(hotkeyDescriptors, [&moduleName](const HotkeyDescriptor& descriptor) { return descriptor.moduleName == moduleName; });
+        PublishDispatchTable();
     }
 
     void Start() noexcept
@@ -112,6 +202,7 @@ namespace CentralizedKeyboardHook
         {
             if (!hHook)
             {
+                pressedModifiers = ReadPressedModifiers();
                 hHook = SetWindowsHookExW(WH_KEYBOARD_LL, KeyboardHookProc, NULL, NULL);
                 if (!hHook)
                 {
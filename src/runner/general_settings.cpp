@@ -6,6 +6,7 @@
 #include <common/common.h>
 #include <common/settings_helpers.h>
 #include "powertoy_module.h"
+#include "module_loader.h"
 #include <common/windows_colors.h>
 #include <common/winstore.h>
 
@@ -106,9 +107,20 @@ GeneralSettings get_general_settings()
         settings.isModulesEnabledMap[name] = powertoy->is_enabled();
     }
 
+    // Powertoys are only deferred while they are disabled
+    for (const auto& name : deferred_powertoys())
+    {
+        settings.isModulesEnabledMap[name] = false;
+    }
+
     return settings;
 }
 
+bool get_download_updates_automatically()
+{
+    return download_updates_automatically && check_user_is_admin();
+}
+
 void apply_general_settings(const json::JsonObject& general_configs, bool save)
 {
     run_as_elevated = general_configs.GetNamedBoolean(L"run_elevated", false);
@@ -163,24 +175,29 @@ void apply_general_settings(const json::JsonObject& general_configs, bool save)
                 continue;
             }
             const std::wstring name{ enabled_element.Key().c_str() };
+            const bool target_enabled = value.GetBoolean();
+            if (target_enabled)
+            {
+                // Load the powertoy if its loading was deferred while it was disabled
+                load_deferred_powertoy(name);
+            }
             const bool found = modules().find(name) != modules().end();
             if (!found)
             {
                 continue;
             }
             const bool module_inst_enabled = modules().at(name)->is_enabled();
-            const bool target_enabled = value.GetBoolean();
             if (module_inst_enabled == target_enabled)
             {
                 continue;
             }
             if (target_enabled)
             {
-                modules().at(name)->enable();
+                enable_powertoy(name, modules().at(name));
             }
             else
             {
-                modules().at(name)->disable();
+                modules().at(name).disable();
             }
         }
     }
@@ -198,7 +215,7 @@ void apply_general_settings(const json::JsonObject& general_configs, bool save)
     }
 }
 
-void start_initial_powertoys()
+std::unordered_set<std::wstring> load_disabled_powertoys()
 {
     std::unordered_set<std::wstring> powertoys_to_disable;
 
@@ -222,11 +239,18 @@ void start_initial_powertoys()
     {
     }
 
+    return powertoys_to_disable;
+}
+
+void start_initial_powertoys()
+{
+    const std::unordered_set<std::wstring> powertoys_to_disable = load_disabled_powertoys();
+
     if (powertoys_to_disable.empty())
     {
         for (auto& [name, powertoy] : modules())
         {
-            powertoy->enable();
+            enable_powertoy(name, powertoy);
         }
     }
     else
@@ -235,7 +259,7 @@ void start_initial_powertoys()
         {
             if (powertoys_to_disable.find(name) == powertoys_to_disable.end())
             {
-                powertoy->enable();
+                enable_powertoy(name, powertoy);
             }
         }
     }
@@ -20,6 +20,11 @@ struct GeneralSettings
 };
 
 json::JsonObject load_general_settings();
+// Reads the state of the modules, so it must be called on the main thread
 GeneralSettings get_general_settings();
+// Can be called from any thread
+bool get_download_updates_automatically();
 void apply_general_settings(const json::JsonObject& general_configs, bool save = true);
+// Returns the keys of the powertoys which are disabled in the general settings
+std::unordered_set<std::wstring> load_disabled_powertoys();
 void start_initial_powertoys();
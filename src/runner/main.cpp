@@ -4,6 +4,7 @@
 #include <filesystem>
 #include "tray_icon.h"
 #include "powertoy_module.h"
+#include "module_loader.h"
 #include "trace.h"
 #include "general_settings.h"
 #include "restart_elevated.h"
@@ -16,6 +17,7 @@
 #include <common/notifications.h>
 #include <common/processApi.h>
 #include <common/RestartManagement.h>
+#include <common/shell_extension_settings.h>
 #include <common/toast_dont_show_again.h>
 #include <common/updating/updating.h>
 #include <common/winstore.h>
@@ -40,7 +42,6 @@ extern updating::notifications::strings Strings;
 namespace
 {
     const wchar_t PT_URI_PROTOCOL_SCHEME[] = L"powertoys://";
-    const wchar_t POWER_TOYS_MODULE_LOAD_FAIL[] = L"Failed to load "; // Module name will be appended on this message and it is not localized.
 }
 
 void chdir_current_executable()
@@ -110,36 +111,25 @@ int runner(bool isProcessElevated)
         notifications::register_background_toast_handler();
 
         chdir_current_executable();
+        // Shell extensions check the generations of their settings here, so it has to exist before the modules save them
+        wil::unique_handle shellExtensionSettings{ ShellExtensionSettings::create() };
+
         // Load Powertoys DLLs
 
-        const std::array<std::wstring_view, 8> knownModules = {
-            L"modules/FancyZones/fancyzones.dll",
-            L"modules/FileExplorerPreview/powerpreview.dll",
-            L"modules/ImageResizer/ImageResizerExt.dll",
-            L"modules/KeyboardManager/KeyboardManager.dll",
-            L"modules/Launcher/Microsoft.Launcher.dll",
-            L"modules/PowerRename/PowerRenameExt.dll",
-            L"modules/ShortcutGuide/ShortcutGuide.dll",
-            L"modules/ColorPicker/ColorPicker.dll",
-        };
-
-        for (const auto& moduleSubdir : knownModules)
-        {
-            try
-            {
-                auto module = load_powertoy(moduleSubdir);
-                modules().emplace(module->get_key(), std::move(module));
-            }
-            catch (...)
-            {
-                std::wstring errorMessage = POWER_TOYS_MODULE_LOAD_FAIL;
-                errorMessage += moduleSubdir;
-                MessageBoxW(NULL,
-                            errorMessage.c_str(),
-                            L"PowerToys",
-                            MB_OK | MB_ICONERROR);
-            }
-        }
+        const std::array<KnownPowertoy, 8> knownModules = { {
+            { L"FancyZones", L"modules/FancyZones/fancyzones.dll" },
+            // File Explorer updates the registration of the preview handlers when it's created, even if it's disabled
+            { L"File Explorer", L"modules/FileExplorerPreview/powerpreview.dll", false },
+            { L"Image Resizer", L"modules/ImageResizer/ImageResizerExt.dll" },
+            { L"Keyboard Manager", L"modules/KeyboardManager/KeyboardManager.dll" },
+            { L"PowerToys Run", L"modules/Launcher/Microsoft.Launcher.dll" },
+            { L"PowerRename", L"modules/PowerRename/PowerRenameExt.dll" },
+            { L"Shortcut Guide", L"modules/ShortcutGuide/ShortcutGuide.dll" },
+            { L"ColorPicker", L"modules/ColorPicker/ColorPicker.dll" },
+        } };
+
+        // Disabled powertoys are loaded once they are enabled or the settings window needs them
+        load_powertoys(knownModules, load_disabled_powertoys());
         // Start initial powertoys
         start_initial_powertoys();
 
@@ -0,0 +1,154 @@
+#include "pch.h"
+#include "module_loader.h"
+#include "trace.h"
+
+#include <atomic>
+#include <map>
+
+namespace
+{
+    const wchar_t POWER_TOYS_MODULE_LOAD_FAIL[] = L"Failed to load "; // Module name will be appended on this message and it is not localized.
+
+    // Maximum number of threads loading DLLs on startup, including the main thread
+    const size_t MAX_LOADER_THREADS = 4;
+
+    using Clock = std::chrono::steady_clock;
+
+    // Paths of the powertoys whose loading was deferred, by key
+    std::map<std::wstring, std::wstring> deferred;
+
+    struct LoadedLibrary
+    {
+        HMODULE handle = nullptr;
+        DWORD error = ERROR_SUCCESS;
+        uint64_t load_time_us = 0;
+    };
+
+    uint64_t elapsed_us(Clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    }
+
+    LoadedLibrary load_library(std::wstring_view path)
+    {
+        LoadedLibrary result;
+        const auto start = Clock::now();
+        result.handle = LoadLibraryW(std::wstring{ path }.c_str());
+        result.error = result.handle ? ERROR_SUCCESS : GetLastError();
+        result.load_time_us = elapsed_us(start);
+        return result;
+    }
+
+    // Creates the module from the loaded DLL and adds it to modules(), or shows an error if either failed.
+    bool register_powertoy(std::wstring_view path, const LoadedLibrary& library, bool was_deferred)
+    {
+        try
+        {
+            if (!library.handle)
+            {
+                winrt::throw_hresult(HRESULT_FROM_WIN32(library.error));
+            }
+
+            const auto start = Clock::now();
+            auto module = create_powertoy(library.handle);
+            const uint64_t create_time_us = elapsed_us(start);
+
+            const std::wstring key = module->get_key();
+            Trace::ModuleLoaded(key, library.load_time_us, create_time_us, was_deferred);
+            modules().emplace(key, std::move(module));
+            return true;
+        }
+        catch (...)
+        {
+            std::wstring errorMessage = POWER_TOYS_MODULE_LOAD_FAIL;
+            errorMessage += path;
+            MessageBoxW(NULL,
+                        errorMessage.c_str(),
+                        L"PowerToys",
+                        MB_OK | MB_ICONERROR);
+            return false;
+        }
+    }
+}
+
+void load_powertoys(std::span<const KnownPowertoy> powertoys, const std::unordered_set<std::wstring>& disabled_powertoys)
+{
+    std::vector<const KnownPowertoy*> to_load;
+    for (const auto& powertoy : powertoys)
+    {
+        if (powertoy.can_defer && disabled_powertoys.contains(std::wstring{ powertoy.key }))
+        {
+            deferred.emplace(powertoy.key, powertoy.path);
+        }
+        else
+        {
+            to_load.push_back(&powertoy);
+        }
+    }
+
+    // Only LoadLibraryW runs on the pool, since on a cold start it's mostly waiting for the DLLs and their dependencies to be read.
+    // The modules are created on this thread, as some of them create windows or hooks which need the main message loop.
+    std::vector<LoadedLibrary> libraries(to_load.size());
+    std::atomic<size_t> next_library = 0;
+    auto load_libraries = [&] {
+        for (size_t i = next_library++; i < to_load.size(); i = next_library++)
+        {
+            libraries[i] = load_library(to_load[i]->path);
+        }
+    };
+
+    const size_t thread_count = (std::min)({ MAX_LOADER_THREADS, static_cast<size_t>((std::max)(1u, std::thread::hardware_concurrency())), to_load.size() });
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; i++)
+    {
+        threads.emplace_back(load_libraries);
+    }
+    load_libraries();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < to_load.size(); i++)
+    {
+        register_powertoy(to_load[i]->path, libraries[i], false);
+    }
+}
+
+bool load_deferred_powertoy(const std::wstring& key)
+{
+    auto it = deferred.find(key);
+    if (it == deferred.end())
+    {
+        return false;
+    }
+
+    const std::wstring path = std::move(it->second);
+    deferred.erase(it);
+    return register_powertoy(path, load_library(path), true);
+}
+
+void load_deferred_powertoys()
+{
+    while (!deferred.empty())
+    {
+        load_deferred_powertoy(std::wstring{ deferred.begin()->first });
+    }
+}
+
+std::vector<std::wstring> deferred_powertoys()
+{
+    std::vector<std::wstring> result;
+    for (const auto& [key, path] : deferred)
+    {
+        result.push_back(key);
+    }
+    return result;
+}
+
+void enable_powertoy(const std::wstring& key, PowertoyModule& powertoy)
+{
+    const auto start = Clock::now();
+    powertoy.enable();
+    Trace::ModuleEnabled(key, elapsed_us(start));
+}
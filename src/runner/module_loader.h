@@ -0,0 +1,34 @@
+#pragma once
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "powertoy_module.h"
+
+struct KnownPowertoy
+{
+    // Key returned by the module's get_key, used to defer loading it while it's disabled
+    std::wstring_view key;
+    std::wstring_view path;
+    // False for modules which have to be created on startup even when disabled
+    bool can_defer = true;
+};
+
+// Loads the DLLs of the powertoys concurrently, then creates the modules and adds them to modules() in the order of the list.
+// Powertoys whose key is in disabled_powertoys and which can be deferred are not loaded until load_deferred_powertoy is called.
+// Must be called on the main thread, as are the other functions below.
+void load_powertoys(std::span<const KnownPowertoy> powertoys, const std::unordered_set<std::wstring>& disabled_powertoys);
+
+// Loads a powertoy whose loading was deferred and adds it to modules(). Returns false if the powertoy was not deferred or failed to load.
+bool load_deferred_powertoy(const std::wstring& key);
+
+// Loads all the powertoys whose loading was deferred.
+void load_deferred_powertoys();
+
+// Returns the keys of the powertoys whose loading was deferred and which are not loaded yet.
+std::vector<std::wstring> deferred_powertoys();
+
+// Enables the powertoy and logs how long it took.
+void enable_powertoy(const std::wstring& key, PowertoyModule& powertoy);
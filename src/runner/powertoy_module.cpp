@@ -10,7 +10,11 @@ std::map<std::wstring, PowertoyModule>& modules()
 
 PowertoyModule load_powertoy(const std::wstring_view filename)
 {
-    auto handle = winrt::check_pointer(LoadLibraryW(filename.data()));
+    return create_powertoy(winrt::check_pointer(LoadLibraryW(filename.data())));
+}
+
+PowertoyModule create_powertoy(HMODULE handle)
+{
     auto create = reinterpret_cast<powertoy_create_func>(GetProcAddress(handle, "powertoy_create"));
     if (!create)
     {
@@ -28,12 +32,76 @@ PowertoyModule load_powertoy(const std::wstring_view filename)
 
 json::JsonObject PowertoyModule::json_config() const
 {
+    if (cached_config_generation == config_generation)
+    {
+        return cached_config;
+    }
+
     int size = 0;
     module->get_config(nullptr, &size);
     std::wstring result;
     result.resize(size - 1);
     module->get_config(result.data(), &size);
-    return json::JsonObject::Parse(result);
+    cached_config = json::JsonObject::Parse(result);
+    cached_config_generation = config_generation;
+    return cached_config;
+}
+
+void PowertoyModule::enable()
+{
+    module->enable();
+    config_generation++;
+}
+
+void PowertoyModule::disable()
+{
+    module->disable();
+    config_generation++;
+}
+
+void PowertoyModule::set_config(const wchar_t* config)
+{
+    module->set_config(config);
+    config_generation++;
+}
+
+void PowertoyModule::call_custom_action(const wchar_t* action)
+{
+    module->call_custom_action(action);
+    config_generation++;
+
+    // The action might have changed the settings of the module, so the next configuration is sent in full
+    last_sent_config = nullptr;
+}
+
+bool PowertoyModule::update_config(const json::JsonObject& config)
+{
+    if (last_sent_config)
+    {
+        const auto changes = json::diff(last_sent_config, config);
+        if (changes.empty())
+        {
+            return false;
+        }
+
+        std::vector<PowertoyModuleIface::ConfigChange> module_changes;
+        module_changes.reserve(changes.size());
+        for (const auto& change : changes)
+        {
+            module_changes.push_back({ change.path.c_str(), change.value ? change.value->c_str() : nullptr });
+        }
+
+        last_sent_config = config;
+        if (module->set_config_changes(module_changes.data(), module_changes.size()))
+        {
+            config_generation++;
+            return true;
+        }
+    }
+
+    last_sent_config = config;
+    set_config(config.Stringify().c_str());
+    return true;
 }
 
 PowertoyModule::PowertoyModule(PowertoyModuleIface* module, HMODULE handle) :
@@ -38,14 +38,37 @@ public:
         return module.get();
     }
 
+    // Returns the parsed configuration of the module. It's cached and only rebuilt after a call below which can change it,
+    // so the returned object must not be modified.
     json::JsonObject json_config() const;
 
+    // Calls to the module which can change its configuration
+    void enable();
+    void disable();
+    void set_config(const wchar_t* config);
+    void call_custom_action(const wchar_t* action);
+
+    // Sends the configuration from the settings to the module. If the module was already sent one, only the values which
+    // changed are passed to set_config_changes, and the module isn't called at all if nothing changed.
+    // Returns false in that case.
+    bool update_config(const json::JsonObject& config);
+
     void update_hotkeys();
 
 private:
     std::unique_ptr<HMODULE, PowertoyModuleDLLDeleter> handle;
     std::unique_ptr<PowertoyModuleIface, PowertoyModuleDeleter> module;
+
+    // Bumped by the calls which can change the configuration of the module
+    uint64_t config_generation = 1;
+    mutable uint64_t cached_config_generation = 0;
+    mutable json::JsonObject cached_config{ nullptr };
+
+    // Configuration last sent to the module by update_config, which the next one is compared to
+    json::JsonObject last_sent_config{ nullptr };
 };
 
 PowertoyModule load_powertoy(const std::wstring_view filename);
+// Creates the module of a loaded powertoy DLL, the DLL is freed if that fails
+PowertoyModule create_powertoy(HMODULE handle);
 std::map<std::wstring, PowertoyModule>& modules();
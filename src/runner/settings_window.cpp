@@ -5,6 +5,7 @@
 #include <aclapi.h>
 
 #include "powertoy_module.h"
+#include "module_loader.h"
 #include <common/two_way_pipe_message_ipc.h>
 #include "tray_icon.h"
 #include "general_settings.h"
@@ -27,6 +28,9 @@ std::atomic_bool g_isLaunchInProgress = false;
 
 json::JsonObject get_power_toys_settings()
 {
+    // The settings window shows the configuration of every powertoy, including the disabled ones which were not loaded yet
+    load_deferred_powertoys();
+
     json::JsonObject result;
     for (const auto& [name, powertoy] : modules())
     {
@@ -95,22 +99,22 @@ std::optional<std::wstring> dispatch_json_action_to_module(const json::JsonObjec
             {
             }
         }
-        else if (modules().find(name) != modules().end())
+        else if (load_deferred_powertoy(name) || modules().find(name) != modules().end())
         {
             const auto element = powertoy_element.Value().Stringify();
-            modules().at(name)->call_custom_action(element.c_str());
+            modules().at(name).call_custom_action(element.c_str());
         }
     }
 
     return result;
 }
 
-void send_json_config_to_module(const std::wstring& module_key, const std::wstring& settings)
+void send_json_config_to_module(const std::wstring& module_key, const json::JsonObject& settings)
 {
+    load_deferred_powertoy(module_key);
     auto moduleIt = modules().find(module_key);
-    if (moduleIt != modules().end())
+    if (moduleIt != modules().end() && moduleIt->second.update_config(settings))
     {
-        moduleIt->second->set_config(settings.c_str());
         moduleIt->second.update_hotkeys();
     }
 }
@@ -119,8 +123,10 @@ void dispatch_json_config_to_modules(const json::JsonObject& powertoys_configs)
 {
     for (const auto& powertoy_element : powertoys_configs)
     {
-        const auto element = powertoy_element.Value().Stringify();
-        send_json_config_to_module(powertoy_element.Key().c_str(), element.c_str());
+        if (powertoy_element.Value().ValueType() == json::JsonValueType::Object)
+        {
+            send_json_config_to_module(powertoy_element.Key().c_str(), powertoy_element.Value().GetObjectW());
+        }
     }
 };
 
@@ -247,7 +253,8 @@ BOOL run_settings_non_elevated(LPCWSTR executable_path, LPWSTR executable_args,
 
 DWORD g_settings_process_id = 0;
 
-void run_settings_window()
+// Runs on a separate thread, so the general settings are read on the main thread before
+void run_settings_window(GeneralSettings general_settings)
 {
     g_isLaunchInProgress = true;
 
@@ -292,17 +299,14 @@ void run_settings_window()
     DWORD powertoys_pid = GetCurrentProcessId();
 
     // Arg 4: settings theme.
-    const std::wstring settings_theme_setting{ get_general_settings().theme };
+    const std::wstring settings_theme_setting{ general_settings.theme };
     std::wstring settings_theme = L"system";
     if (settings_theme_setting == L"dark" || (settings_theme_setting == L"system" && WindowsColors::is_dark_mode()))
     {
         settings_theme = L"dark";
     }
 
-    // Arg 4: settings theme.
-    GeneralSettings save_settings = get_general_settings();
-
-    bool isElevated{ get_general_settings().isElevated };
+    bool isElevated{ general_settings.isElevated };
     std::wstring settings_elevatedStatus;
     settings_elevatedStatus = isElevated;
 
@@ -315,7 +319,7 @@ void run_settings_window()
         settings_elevatedStatus = L"false";
     }
 
-    bool isAdmin{ get_general_settings().isAdmin };
+    bool isAdmin{ general_settings.isAdmin };
     std::wstring settings_isUserAnAdmin;
 
     if (isAdmin)
@@ -329,7 +333,7 @@ void run_settings_window()
 
     // create general settings file to initialze the settings file with installation configurations like :
     // 1. Run on start up.
-    PTSettingsHelper::save_general_settings(save_settings.to_json());
+    PTSettingsHelper::save_general_settings(general_settings.to_json());
 
     std::wstring executable_args = L"\"";
     executable_args.append(executable_path);
@@ -459,7 +463,7 @@ void open_settings_window()
     {
         if (!g_isLaunchInProgress)
         {
-            std::thread(run_settings_window).detach();
+            std::thread(run_settings_window, get_general_settings()).detach();
         }
     }
 }
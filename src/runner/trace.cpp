@@ -61,3 +61,29 @@ void Trace::SettingsChanged(const GeneralSettings& settings)
         TraceLoggingBoolean(TRUE, "UTCReplace_AppSessionGuid"),
         TraceLoggingKeyword(PROJECT_KEYWORD_MEASURE));
 }
+
+void Trace::ModuleLoaded(const std::wstring& moduleKey, uint64_t loadTimeUs, uint64_t createTimeUs, bool wasDeferred)
+{
+    TraceLoggingWrite(
+        g_hProvider,
+        "Runner_ModuleLoaded",
+        TraceLoggingWideString(moduleKey.c_str(), "Module"),
+        TraceLoggingUInt64(loadTimeUs, "LoadTimeUs"),
+        TraceLoggingUInt64(createTimeUs, "CreateTimeUs"),
+        TraceLoggingBoolean(wasDeferred, "Deferred"),
+        ProjectTelemetryPrivacyDataTag(ProjectTelemetryTag_ProductAndServicePerformance),
+        TraceLoggingBoolean(TRUE, "UTCReplace_AppSessionGuid"),
+        TraceLoggingKeyword(PROJECT_KEYWORD_MEASURE));
+}
+
+void Trace::ModuleEnabled(const std::wstring& moduleKey, uint64_t enableTimeUs)
+{
+    TraceLoggingWrite(
+        g_hProvider,
+        "Runner_ModuleEnabled",
+        TraceLoggingWideString(moduleKey.c_str(), "Module"),
+        TraceLoggingUInt64(enableTimeUs, "EnableTimeUs"),
+        ProjectTelemetryPrivacyDataTag(ProjectTelemetryTag_ProductAndServicePerformance),
+        TraceLoggingBoolean(TRUE, "UTCReplace_AppSessionGuid"),
+        TraceLoggingKeyword(PROJECT_KEYWORD_MEASURE));
+}
@@ -9,4 +9,6 @@ public:
     static void UnregisterProvider();
     static void EventLaunch(const std::wstring& versionNumber, bool isProcessElevated);
     static void SettingsChanged(const GeneralSettings& settings);
+    static void ModuleLoaded(const std::wstring& moduleKey, uint64_t loadTimeUs, uint64_t createTimeUs, bool wasDeferred);
+    static void ModuleEnabled(const std::wstring& moduleKey, uint64_t enableTimeUs);
 };
@@ -58,7 +58,7 @@ void github_update_worker()
         }
 
         std::this_thread::sleep_for(std::chrono::minutes(sleep_minutes_till_next_update));
-        const bool download_updates_automatically = get_general_settings().downloadUpdatesAutomatically;
+        const bool download_updates_automatically = get_download_updates_automatically();
         try
         {
             updating::try_autoupdate(download_updates_automatically, Strings).get();
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Minimal benchmark harness. Every sample times a batch of iterations, results are reported per iteration.
+namespace Benchmark
+{
+    struct Result
+    {
+        double mean;
+        double p50;
+        double p99;
+        double max;
+    };
+
+    // Keeps the optimizer from discarding computed values.
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+        static const void* volatile sink;
+        sink = &value;
+    }
+
+    inline Result Summarize(std::vector<double>& samples)
+    {
+        Result result{};
+        if (samples.empty())
+        {
+            return result;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        double total = 0;
+        for (double sample : samples)
+        {
+            total += sample;
+        }
+
+        result.mean = total / samples.size();
+        result.p50 = samples[samples.size() / 2];
+        result.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        result.max = samples.back();
+        return result;
+    }
+
+    inline void Report(const char* name, const Result& result)
+    {
+        std::printf("%-48s mean %10.1f ns   p50 %10.1f ns   p99 %10.1f ns   max %10.1f ns\n", name, result.mean, result.p50, result.p99, result.max);
+    }
+
+    template<typename Fn>
+    Result Run(const char* name, size_t samples, size_t iterationsPerSample, Fn fn)
+    {
+        // Warm up caches and branch predictors
+        for (size_t i = 0; i < iterationsPerSample; i++)
+        {
+            fn(i);
+        }
+
+        std::vector<double> durations;
+        durations.reserve(samples);
+        for (size_t sample = 0; sample < samples; sample++)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < iterationsPerSample; i++)
+            {
+                fn(sample * iterationsPerSample + i);
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+            durations.push_back(std::chrono::duration<double, std::nano>(end - start).count() / iterationsPerSample);
+        }
+
+        const Result result = Summarize(durations);
+        Report(name, result);
+        return result;
+    }
+}
@@ -0,0 +1,190 @@
+#include "Benchmark.h"
+
+#include <modules/fancyzones/lib/JsonStreamReader.h>
+
+#include <windows.h>
+#include <winrt/base.h>
+#include <winrt/Windows.Data.Json.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#pragma comment(lib, "windowsapp")
+
+namespace
+{
+    using namespace winrt::Windows::Data::Json;
+
+    constexpr size_t HistoryFileSize = 5 * 1024 * 1024;
+
+    struct HistoryEntry
+    {
+        std::wstring deviceId;
+        std::wstring zoneSetUuid;
+        std::vector<size_t> zoneIndexSet;
+    };
+
+    using HistoryMap = std::unordered_map<std::wstring, std::vector<HistoryEntry>>;
+
+    // App zone history shaped like app-zone-history.json of a long running installation
+    std::string GenerateAppZoneHistory(size_t minimumSize)
+    {
+        std::string json = "{\"app-zone-history\":[";
+        for (size_t app = 0; json.size() < minimumSize; app++)
+        {
+            if (app > 0)
+            {
+                json += ",";
+            }
+
+            const std::string index = std::to_string(app);
+            json += "{\"app-path\":\"C:\\\\Program Files\\\\Application" + index + "\\\\application" + index + ".exe\",\"history\":[";
+            for (size_t desktop = 0; desktop < 2; desktop++)
+            {
+                json += desktop > 0 ? "," : "";
+                json += "{\"zone-index-set\":[" + std::to_string(app % 5) + "," + std::to_string(app % 5 + 1) + "],";
+                json += "\"device-id\":\"AOC2460#4&fe3a015&0&UID65793_1920_1200_{39B25DD2-130D-4B5D-8851-4791D66B153" + std::to_string(desktop) + "}\",";
+                json += "\"zoneset-uuid\":\"{33A2B101-06E0-437B-A61E-CDBECF502906}\"}";
+            }
+            json += "]}";
+        }
+        json += "]}";
+        return json;
+    }
+
+    // Previous loading path: read the file into a string, convert it to hstring, parse a DOM and walk it
+    HistoryMap LoadWithDom(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string content{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+        const JsonObject root = JsonValue::Parse(winrt::to_hstring(content)).GetObject();
+
+        HistoryMap result;
+        const JsonArray apps = root.GetNamedArray(L"app-zone-history");
+        for (uint32_t i = 0; i < apps.Size(); i++)
+        {
+            const JsonObject app = apps.GetObjectAt(i);
+            std::vector<HistoryEntry> entries;
+            const JsonArray history = app.GetNamedArray(L"history");
+            for (uint32_t j = 0; j < history.Size(); j++)
+            {
+                const JsonObject item = history.GetObjectAt(j);
+                HistoryEntry entry{ std::wstring{ item.GetNamedString(L"device-id") }, std::wstring{ item.GetNamedString(L"zoneset-uuid") } };
+                for (const auto& index : item.GetNamedArray(L"zone-index-set"))
+                {
+                    entry.zoneIndexSet.push_back(static_cast<size_t>(index.GetNumber()));
+                }
+                entries.push_back(std::move(entry));
+            }
+            result[std::wstring{ app.GetNamedString(L"app-path") }] = std::move(entries);
+        }
+
+        return result;
+    }
+
+    // Streaming path: map the file and fill the map straight from the reader
+    HistoryMap LoadWithStreamReader(const std::filesystem::path& path)
+    {
+        HistoryMap result;
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER size{};
+        GetFileSizeEx(file, &size);
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+        JsonStreamReader reader{ std::string_view{ static_cast<const char*>(view), static_cast<size_t>(size.QuadPart) } };
+        std::wstring name, appPath;
+        double index;
+        reader.BeginObject();
+        while (reader.NextMember(name))
+        {
+            if (name != L"app-zone-history" || !reader.BeginArray())
+            {
+                reader.SkipValue();
+                continue;
+            }
+
+            while (reader.NextElement() && reader.BeginObject())
+            {
+                std::vector<HistoryEntry> entries;
+                while (reader.NextMember(name))
+                {
+                    if (name == L"app-path")
+                    {
+                        reader.ReadString(appPath);
+                    }
+                    else if (name == L"history" && reader.BeginArray())
+                    {
+                        while (reader.NextElement() && reader.BeginObject())
+                        {
+                            HistoryEntry entry;
+                            while (reader.NextMember(name))
+                            {
+                                if (name == L"device-id")
+                                {
+                                    reader.ReadString(entry.deviceId);
+                                }
+                                else if (name == L"zoneset-uuid")
+                                {
+                                    reader.ReadString(entry.zoneSetUuid);
+                                }
+                                else if (name == L"zone-index-set" && reader.BeginArray())
+                                {
+                                    while (reader.NextElement() && reader.ReadNumber(index))
+                                    {
+                                        entry.zoneIndexSet.push_back(static_cast<size_t>(index));
+                                    }
+                                }
+                                else
+                                {
+                                    reader.SkipValue();
+                                }
+                            }
+                            entries.push_back(std::move(entry));
+                        }
+                    }
+                    else
+                    {
+                        reader.SkipValue();
+                    }
+                }
+                result[appPath] = std::move(entries);
+            }
+        }
+
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return result;
+    }
+}
+
+void RunDataLoadingBenchmarks()
+{
+    winrt::init_apartment();
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / L"FancyZones_Benchmark_app-zone-history.json";
+    const std::string json = GenerateAppZoneHistory(HistoryFileSize);
+    std::ofstream{ path, std::ios::binary } << json;
+
+    const size_t apps = LoadWithDom(path).size();
+    if (apps != LoadWithStreamReader(path).size())
+    {
+        std::printf("Data loading: parsers disagree on %s\n", path.string().c_str());
+        return;
+    }
+    std::printf("Data loading: %zu KB app zone history, %zu applications\n", json.size() / 1024, apps);
+
+    Benchmark::Run("Load 5 MB app zone history, DOM (previous)", 20, 1, [&](size_t) {
+        Benchmark::DoNotOptimize(LoadWithDom(path));
+    });
+
+    Benchmark::Run("Load 5 MB app zone history, stream reader", 20, 1, [&](size_t) {
+        Benchmark::DoNotOptimize(LoadWithStreamReader(path));
+    });
+
+    std::filesystem::remove(path);
+}
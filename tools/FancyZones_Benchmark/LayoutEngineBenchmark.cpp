@@ -0,0 +1,108 @@
+#include "Benchmark.h"
+
+#include <modules/fancyzones/lib/ZoneLayoutEngine.h>
+
+using namespace ZoneLayoutEngine;
+
+namespace
+{
+    struct WorkArea
+    {
+        long width;
+        long height;
+    };
+
+    constexpr WorkArea workAreas[] = {
+        { 1280, 720 },
+        { 1920, 1040 },
+        { 2560, 1400 },
+        { 3840, 2120 },
+        { 5120, 1400 },
+    };
+
+    constexpr int spacings[] = { 0, 16 };
+    constexpr int maxZoneCount = 40;
+
+    std::vector<LayoutInput> BuildPredefinedConfigurations()
+    {
+        std::vector<LayoutInput> inputs;
+        for (const auto& workArea : workAreas)
+        {
+            for (auto kind : { LayoutKind::Focus, LayoutKind::Columns, LayoutKind::Rows, LayoutKind::Grid, LayoutKind::PriorityGrid })
+            {
+                for (int zoneCount = 1; zoneCount <= maxZoneCount; zoneCount++)
+                {
+                    for (int spacing : spacings)
+                    {
+                        LayoutInput input{};
+                        input.workAreaWidth = workArea.width;
+                        input.workAreaHeight = workArea.height;
+                        input.layout.kind = kind;
+                        input.layout.zoneCount = zoneCount;
+                        input.spacing = spacing;
+                        input.dpi = DEFAULT_DPI;
+                        inputs.push_back(input);
+                    }
+                }
+            }
+        }
+        return inputs;
+    }
+}
+
+void RunLayoutEngineBenchmarks()
+{
+    std::printf("Zone layout engine\n");
+
+    const auto inputs = BuildPredefinedConfigurations();
+    std::printf("  %zu predefined layout configurations\n", inputs.size());
+
+    std::vector<Zone> zones;
+    Benchmark::Run("CalculateLayout, predefined layouts", 100, inputs.size(), [&](size_t i) {
+        CalculateLayout(inputs[i % inputs.size()], zones);
+        Benchmark::DoNotOptimize(zones.data());
+    });
+
+    // 16x16 custom grid with irregular percents, every cell is its own zone
+    constexpr int gridSize = 16;
+    std::vector<int> percents(gridSize, C_MULTIPLIER / gridSize);
+    std::vector<int> cells(gridSize * gridSize);
+    for (int i = 0; i < gridSize * gridSize; i++)
+    {
+        cells[i] = i;
+    }
+
+    LayoutInput gridInput{};
+    gridInput.workAreaWidth = 3840;
+    gridInput.workAreaHeight = 2120;
+    gridInput.layout.kind = LayoutKind::CustomGrid;
+    gridInput.layout.grid = { gridSize, gridSize, percents.data(), percents.data(), cells.data() };
+    gridInput.spacing = 8;
+    gridInput.dpi = DEFAULT_DPI;
+
+    Benchmark::Run("CalculateLayout, 16x16 custom grid", 100, 1000, [&](size_t) {
+        CalculateLayout(gridInput, zones);
+        Benchmark::DoNotOptimize(zones.data());
+    });
+
+    // Canvas layout with a large number of zones
+    std::vector<CanvasZone> canvasZones;
+    for (int i = 0; i < 256; i++)
+    {
+        canvasZones.push_back({ (i % 16) * 120, (i / 16) * 67, 120, 67 });
+    }
+
+    LayoutInput canvasInput{};
+    canvasInput.workAreaWidth = 3840;
+    canvasInput.workAreaHeight = 2120;
+    canvasInput.layout.kind = LayoutKind::CustomCanvas;
+    canvasInput.layout.canvas = { canvasZones.data(), canvasZones.size() };
+    canvasInput.dpi = 144;
+
+    Benchmark::Run("CalculateLayout, 256 zone canvas", 100, 1000, [&](size_t) {
+        CalculateLayout(canvasInput, zones);
+        Benchmark::DoNotOptimize(zones.data());
+    });
+
+    std::printf("\n");
+}
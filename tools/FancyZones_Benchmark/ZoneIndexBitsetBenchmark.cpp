@@ -0,0 +1,101 @@
+#include "Benchmark.h"
+
+#include <modules/fancyzones/lib/ZoneIndexBitset.h>
+
+#include <iterator>
+
+using namespace ZoneLayoutEngine;
+
+namespace
+{
+    // Combined zone range as calculated before the bounds table was introduced, kept as a baseline
+    std::vector<size_t> CombinedZoneRangeBaseline(const std::vector<Zone>& zones, std::vector<size_t> initialZones, std::vector<size_t> finalZones)
+    {
+        std::vector<size_t> combinedZones, result;
+        std::set_union(begin(initialZones), end(initialZones), begin(finalZones), end(finalZones), std::back_inserter(combinedZones));
+
+        ZoneRect boundingRect{};
+        bool boundingRectEmpty = true;
+        for (size_t zoneId : combinedZones)
+        {
+            const auto& rect = zones[zoneId].rect;
+            if (boundingRectEmpty)
+            {
+                boundingRect = rect;
+                boundingRectEmpty = false;
+            }
+            else
+            {
+                boundingRect.left = (std::min)(boundingRect.left, rect.left);
+                boundingRect.top = (std::min)(boundingRect.top, rect.top);
+                boundingRect.right = (std::max)(boundingRect.right, rect.right);
+                boundingRect.bottom = (std::max)(boundingRect.bottom, rect.bottom);
+            }
+        }
+
+        for (size_t zoneId = 0; zoneId < zones.size(); zoneId++)
+        {
+            const auto& rect = zones[zoneId].rect;
+            if (boundingRect.left <= rect.left && rect.right <= boundingRect.right &&
+                boundingRect.top <= rect.top && rect.bottom <= boundingRect.bottom)
+            {
+                result.push_back(zoneId);
+            }
+        }
+
+        return result;
+    }
+}
+
+void RunZoneIndexBitsetBenchmarks()
+{
+    std::printf("Zone index bitset\n");
+
+    // 16x16 custom grid, every cell is its own zone
+    constexpr int gridSize = 16;
+    std::vector<int> percents(gridSize, C_MULTIPLIER / gridSize);
+    std::vector<int> cells(gridSize * gridSize);
+    for (int i = 0; i < gridSize * gridSize; i++)
+    {
+        cells[i] = i;
+    }
+
+    LayoutInput input{};
+    input.workAreaWidth = 3840;
+    input.workAreaHeight = 2120;
+    input.layout.kind = LayoutKind::CustomGrid;
+    input.layout.grid = { gridSize, gridSize, percents.data(), percents.data(), cells.data() };
+    input.spacing = 8;
+    input.dpi = DEFAULT_DPI;
+
+    std::vector<Zone> zones;
+    CalculateLayout(input, zones);
+
+    ZoneBoundsTable table;
+    for (const auto& zone : zones)
+    {
+        table.Add(zone.id, zone.rect);
+    }
+
+    // Selections from a fixed corner to every zone of the grid, as when Ctrl-dragging across the work area
+    const size_t zoneCount = zones.size();
+    std::vector<ZoneIndexBitset> targets(zoneCount);
+    for (size_t i = 0; i < zoneCount; i++)
+    {
+        targets[i].Set(i);
+    }
+
+    // Selected zone count is accumulated so the selection can't be optimized away
+    volatile size_t selected = 0;
+
+    const ZoneIndexBitset initial({ 0 });
+    Benchmark::Run("CombinedRange, 256 zones, bounds table", 100, 1000, [&](size_t i) {
+        selected = selected + table.CombinedRange(initial, targets[i % zoneCount]).Count();
+    });
+
+    Benchmark::Run("CombinedRange, 256 zones, vector baseline", 100, 1000, [&](size_t i) {
+        selected = selected + CombinedZoneRangeBaseline(zones, { 0 }, { i % zoneCount }).size();
+    });
+
+    std::printf("\n");
+}
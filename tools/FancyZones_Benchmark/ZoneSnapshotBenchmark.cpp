@@ -0,0 +1,163 @@
+#include "Benchmark.h"
+
+#include <modules/fancyzones/lib/AtomicSnapshot.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr size_t Monitors = 3;
+    constexpr size_t ZonesPerMonitor = 64;
+    constexpr size_t ReaderThreads = 2;
+    constexpr size_t ReadsPerThread = 200000;
+
+    // Time a rebuild spends creating zone windows after the new layout was calculated
+    constexpr auto ZoneWindowCreationTime = std::chrono::microseconds(500);
+
+    // Reads slower than this are counted as stalls
+    constexpr double StallThreshold = 50'000.0;
+
+    struct ZoneRect
+    {
+        int32_t left;
+        int32_t top;
+        int32_t right;
+        int32_t bottom;
+    };
+
+    // Zone geometry of all work areas on the current virtual desktop, keyed by monitor
+    using Geometry = std::map<size_t, std::vector<ZoneRect>>;
+
+    Geometry CalculateGeometry(size_t generation)
+    {
+        Geometry geometry;
+        for (size_t monitor = 0; monitor < Monitors; monitor++)
+        {
+            auto& zones = geometry[monitor];
+            const int32_t offset = static_cast<int32_t>(generation % 16);
+            for (size_t zone = 0; zone < ZonesPerMonitor; zone++)
+            {
+                const int32_t left = static_cast<int32_t>(zone % 8) * 240 + offset;
+                const int32_t top = static_cast<int32_t>(zone / 8) * 135 + offset;
+                zones.push_back({ left, top, left + 240, top + 135 });
+            }
+        }
+        return geometry;
+    }
+
+    size_t ZonesFromPoint(const Geometry& geometry, size_t monitor, int32_t x, int32_t y)
+    {
+        size_t captured = 0;
+        auto it = geometry.find(monitor);
+        if (it != geometry.end())
+        {
+            for (const auto& zone : it->second)
+            {
+                captured += (zone.left <= x && x < zone.right && zone.top <= y && y < zone.bottom) ? 1 : 0;
+            }
+        }
+        return captured;
+    }
+
+    template<typename Read, typename Rebuild>
+    Benchmark::Result MeasureReadsDuringRebuild(const char* name, Read read, Rebuild rebuild)
+    {
+        std::atomic<bool> done = false;
+        std::thread writer([&] {
+            for (size_t generation = 1; !done; generation++)
+            {
+                rebuild(generation);
+            }
+        });
+
+        std::vector<std::vector<double>> latencies(ReaderThreads);
+        std::vector<std::thread> readers;
+        for (size_t thread = 0; thread < ReaderThreads; thread++)
+        {
+            readers.emplace_back([&, thread] {
+                auto& samples = latencies[thread];
+                samples.reserve(ReadsPerThread);
+                size_t captured = 0;
+                for (size_t i = 0; i < ReadsPerThread; i++)
+                {
+                    const int32_t x = static_cast<int32_t>((i * 37) % 1920);
+                    const int32_t y = static_cast<int32_t>((i * 11) % 1080);
+                    const auto start = std::chrono::high_resolution_clock::now();
+                    captured += read(i % Monitors, x, y);
+                    const auto end = std::chrono::high_resolution_clock::now();
+                    samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+                }
+                Benchmark::DoNotOptimize(captured);
+            });
+        }
+
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+        done = true;
+        writer.join();
+
+        std::vector<double> samples;
+        for (const auto& threadSamples : latencies)
+        {
+            samples.insert(samples.end(), threadSamples.begin(), threadSamples.end());
+        }
+
+        const size_t stalls = std::count_if(samples.begin(), samples.end(), [](double sample) { return sample > StallThreshold; });
+        const Benchmark::Result result = Benchmark::Summarize(samples);
+        Benchmark::Report(name, result);
+        std::printf("%-48s %zu of %zu reads stalled for more than %.0f us\n", "", stalls, samples.size(), StallThreshold / 1000);
+        return result;
+    }
+
+    void SimulateZoneWindowCreation()
+    {
+        // Zone window creation mostly waits for the window manager
+        std::this_thread::sleep_for(ZoneWindowCreationTime);
+    }
+}
+
+void RunZoneSnapshotBenchmarks()
+{
+    std::printf("Zone geometry: %zu readers hit-testing while a writer keeps rebuilding %zu work areas\n", ReaderThreads, Monitors);
+
+    // Previous scheme: readers share a reader-writer lock that the rebuild holds exclusively
+    {
+        Geometry geometry = CalculateGeometry(0);
+        std::shared_mutex lock;
+        MeasureReadsDuringRebuild(
+            "ZonesFromPoint during rebuild, shared_mutex",
+            [&](size_t monitor, int32_t x, int32_t y) {
+                std::shared_lock readLock(lock);
+                return ZonesFromPoint(geometry, monitor, x, y);
+            },
+            [&](size_t generation) {
+                std::unique_lock writeLock(lock);
+                geometry = CalculateGeometry(generation);
+                SimulateZoneWindowCreation();
+            });
+    }
+
+    // Snapshots: the rebuild happens off to the side and is swapped in once complete
+    {
+        AtomicSnapshot<Geometry> geometry{ CalculateGeometry(0) };
+        MeasureReadsDuringRebuild(
+            "ZonesFromPoint during rebuild, snapshot",
+            [&](size_t monitor, int32_t x, int32_t y) {
+                return ZonesFromPoint(*geometry.Load(), monitor, x, y);
+            },
+            [&](size_t generation) {
+                Geometry rebuilt = CalculateGeometry(generation);
+                SimulateZoneWindowCreation();
+                geometry.Store(std::move(rebuilt));
+            });
+    }
+}
@@ -0,0 +1,15 @@
+#include <cstdio>
+
+void RunLayoutEngineBenchmarks();
+void RunZoneIndexBitsetBenchmarks();
+void RunDataLoadingBenchmarks();
+void RunZoneSnapshotBenchmarks();
+
+int main()
+{
+    RunLayoutEngineBenchmarks();
+    RunZoneIndexBitsetBenchmarks();
+    RunDataLoadingBenchmarks();
+    RunZoneSnapshotBenchmarks();
+    return 0;
+}
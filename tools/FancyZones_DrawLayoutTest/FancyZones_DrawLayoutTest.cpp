@@ -1,6 +1,8 @@
 #include "framework.h"
 #include "FancyZones_DrawLayoutTest.h"
 
+#include "../../src/modules/fancyzones/lib/ZoneLayoutEngine.h"
+
 #include <Uxtheme.h>
 #include <objidl.h>
 #include <gdiplus.h>
@@ -45,18 +47,18 @@ inline const int RectHeight(const RECT& rect)
 
 std::vector<RECT> BuildColumnZoneLayout(int zoneCount, const RECT& workArea)
 {
-    // Builds column layout with specified number of zones (columns).
-    int zoneWidth = RectWidth(workArea) / zoneCount;
-    int zoneHeight = RectHeight(workArea);
-    std::vector<RECT> zones(zoneCount);
-    for (int i = 0; i < zoneCount; ++i)
-    {
-        int left   = workArea.left + i * zoneWidth;
-        int top    = workArea.top;
-        int right  = left + zoneWidth;
-        int bottom = top + zoneHeight;
+    // Builds column layout with specified number of zones (columns), using the same geometry as FancyZones.
+    std::vector<ZoneLayoutEngine::Zone> layout;
+    ZoneLayoutEngine::CalculateColumnsAndRowsLayout(RectWidth(workArea), RectHeight(workArea), ZoneLayoutEngine::LayoutKind::Columns, zoneCount, 0, layout);
 
-        zones[i] = { left, top, right, bottom };
+    std::vector<RECT> zones;
+    zones.reserve(layout.size());
+    for (const auto& zone : layout)
+    {
+        zones.push_back({ workArea.left + zone.rect.left,
+                          workArea.top + zone.rect.top,
+                          workArea.left + zone.rect.right,
+                          workArea.top + zone.rect.bottom });
     }
     return zones;
 }